@@ -33,11 +33,13 @@
 #include "logics/logic_2d_movements.h"
 #include "logics/logic_recorded.h"
 #include <mash-utils/stringutils.h>
+#include <mash/imageutils.h>
 #include <sstream>
 #include <iostream>
 #include <sys/stat.h> 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
 
 
@@ -53,7 +55,7 @@ GoalPlanningSimulator::tTaskList GoalPlanningSimulator::TASKS;
 /************************* CONSTRUCTION / DESTRUCTION *************************/
 
 GoalPlanningSimulator::GoalPlanningSimulator()
-: _logic(0)
+: _logic(0), _bRawViewsPreferred(false)
 {
 }
 
@@ -249,6 +251,31 @@ unsigned char* GoalPlanningSimulator::getView(const std::string& viewName, size_
 
     mimetype = "image/png";
     nbBytes = 0;
+
+    // Send the pixels if the client prefers them (the images are decoded only
+    // once, the recordings often reuse the same files)
+    if (_bRawViewsPreferred)
+    {
+        tViewsList views = _logic->getViews();
+        for (tViewsIterator iter = views.begin(); iter != views.end(); ++iter)
+        {
+            if (iter->name != viewName)
+                continue;
+
+            const tPixelsBuffer* pPixels = getPixels(strFileName, iter->width,
+                                                     iter->height);
+            if (!pPixels)
+                break;
+
+            mimetype = "raw";
+            nbBytes = pPixels->size();
+
+            unsigned char* pBuffer = new unsigned char[nbBytes];
+            memcpy(pBuffer, &(*pPixels)[0], nbBytes);
+
+            return pBuffer;
+        }
+    }
     
     FILE* pFile = fopen(strFileName.c_str(), "rb");
     if (!pFile)
@@ -268,6 +295,27 @@ unsigned char* GoalPlanningSimulator::getView(const std::string& viewName, size_
 }
 
 
+bool GoalPlanningSimulator::getViewFile(const std::string& viewName,
+                                        std::string &strFileName,
+                                        std::string &mimetype)
+{
+    // The client would rather have the pixels: let getView() decode the file
+    if (_bRawViewsPreferred)
+        return false;
+
+    strFileName = _environment.url + _logic->getViewFileName(viewName);
+    mimetype = "image/png";
+
+    return true;
+}
+
+
+void GoalPlanningSimulator::setRawViewsPreferred(bool bPreferred)
+{
+    _bRawViewsPreferred = bPreferred;
+}
+
+
 bool GoalPlanningSimulator::performAction(const std::string& action, float &reward,
                                           bool &finished, bool &failed,
                                           std::string &event)
@@ -308,3 +356,33 @@ bool GoalPlanningSimulator::getEnvironment(const std::string& goal,
     
     return false;
 }
+
+
+const GoalPlanningSimulator::tPixelsBuffer* GoalPlanningSimulator::getPixels(
+                                                const std::string& strFileName,
+                                                unsigned int width,
+                                                unsigned int height)
+{
+    tPixelsBuffersIterator iter = _pixels.find(strFileName);
+    if (iter != _pixels.end())
+        return &iter->second;
+
+    Image* pImage = ImageUtils::loadImage(strFileName);
+    if (!pImage)
+        return 0;
+
+    if ((pImage->width() != width) || (pImage->height() != height) ||
+        !ImageUtils::convertImageToPixelFormats(pImage, Image::PIXELFORMAT_RGB))
+    {
+        delete pImage;
+        return 0;
+    }
+
+    tPixelsBuffer& pixels = _pixels[strFileName];
+    pixels.resize(3 * width * height);
+    memcpy(&pixels[0], pImage->rgbBuffer(), pixels.size());
+
+    delete pImage;
+
+    return &pixels;
+}
@@ -57,6 +57,10 @@ public:
     typedef std::map<std::string, tEnvironmentList> tTaskList;
     typedef tTaskList::iterator                     tTaskIterator;
 
+    typedef std::vector<unsigned char>                  tPixelsBuffer;
+    typedef std::map<std::string, tPixelsBuffer>        tPixelsBuffersList;
+    typedef tPixelsBuffersList::iterator                tPixelsBuffersIterator;
+
 
     //_____ Construction / Destruction __________
 public:
@@ -176,6 +180,25 @@ public:
     //--------------------------------------------------------------------------
     virtual unsigned char* getView(const std::string& view, size_t &nbBytes,
                                    std::string &mimetype);
+
+    //--------------------------------------------------------------------------
+    /// @brief Indicates if the client would rather receive the pixels of
+    ///        the views than encoded images
+    ///
+    /// @param  bPreferred  'true' if the raw buffers are preferred
+    //--------------------------------------------------------------------------
+    virtual void setRawViewsPreferred(bool bPreferred);
+
+    //--------------------------------------------------------------------------
+    /// @brief Returns the file containing one of the views, if any
+    ///
+    /// @param[in]  view        The name of the view
+    /// @param[out] strFileName Path to the file
+    /// @param[out] mimetype    The MIME type of the content of the file
+    /// @return                 'true' if the view is a file
+    //--------------------------------------------------------------------------
+    virtual bool getViewFile(const std::string& view, std::string &strFileName,
+                             std::string &mimetype);
     
     //--------------------------------------------------------------------------
     /// @brief Performs an action
@@ -206,6 +229,17 @@ public:
 protected:
     bool getEnvironment(const std::string& goal, const std::string& environment,
                         tEnvironment* pEnvironment);
+
+    //--------------------------------------------------------------------------
+    /// @brief Returns the pixels of an image file, decoded only once
+    ///
+    /// @param  strFileName     Path to the image file
+    /// @param  width           Expected width of the image
+    /// @param  height          Expected height of the image
+    /// @return                 The RGB pixels, 0 if failed
+    //--------------------------------------------------------------------------
+    const tPixelsBuffer* getPixels(const std::string& strFileName,
+                                   unsigned int width, unsigned int height);
     
 
     //_____ Static attributes __________
@@ -218,6 +252,8 @@ protected:
     ILogic*                     _logic;
     Mash::RandomNumberGenerator _generator;
     tEnvironment                _environment;
+    bool                        _bRawViewsPreferred;
+    tPixelsBuffersList          _pixels;
 };
 
 #endif
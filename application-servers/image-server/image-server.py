@@ -41,7 +41,7 @@ from optparse import OptionParser
 from database import Database, DatabaseException
 
 
-PROTOCOL = '1.2'
+PROTOCOL = '1.3'
 
 
 ############################### SERVER LISTENER ################################
@@ -81,6 +81,7 @@ class ImageServerListener(ServerListener):
         'DISABLE_PREPROCESSED_IMAGES':  'handleDisablePreprocessedImagesCommand',
         
         'LIST_OBJECTS':                 'handleListObjectsCommand',
+        'LIST_IMAGES':                  'handleListImagesCommand',
 
         'REPORT_URL_PREFIX':            'handleReportUrlPrefixCommand',
         'IMAGE':                        'handleImageCommand',
@@ -550,43 +551,21 @@ class ImageServerListener(ServerListener):
 
             return ServerListener.ACTION_NONE
 
-        if self.backgroundImagesEnabled or (self.enabledImages is None):
-            indices = range(0, self.database.imagesCount())
-        else:
-            indices = self.enabledImages
-        
+        indices = self._enabledImagesIndices()
+
         for i in range(0, len(indices)):
             index = indices[i]
-            objects = self.database.objectsInImage(index)
+            filtered_objects = self._enabledObjectsInImage(index)
 
-            if self.enabledLabels is not None:
-                filtered_objects = []
-                for obj in objects:
-                    if obj.label in self.enabledLabels:
-                        filtered_objects.append(obj)
-            else:
-                filtered_objects = objects
-            
             self.sendResponse(Message('IMAGE', [i]))
             
             size = self.database.imageSize(index)
             self.sendResponse(Message('IMAGE_SIZE', [size[0], size[1]]))
-
-            image_set = self.database.imageSet(index)
-            if image_set == Database.TRAINING_SET:
-                self.sendResponse(Message('SET', ['TRAINING']))
-            elif image_set == Database.TEST_SET:
-                self.sendResponse(Message('SET', ['TEST']))
-            else:
-                self.sendResponse(Message('SET', ['NONE']))
-
+            self.sendResponse(Message('SET', [self._imageSetName(index)]))
             self.sendResponse(Message('NB_OBJECTS', [len(filtered_objects)]))
             
-            for obj in filtered_objects:
-                if self.enabledLabels is not None:
-                    self.sendResponse(Message('OBJECT_LABEL', [self.enabledLabels.index(obj.label)]))
-                else:
-                    self.sendResponse(Message('OBJECT_LABEL', [obj.label]))
+            for (label, obj) in filtered_objects:
+                self.sendResponse(Message('OBJECT_LABEL', [label]))
                 self.sendResponse(Message('OBJECT_COORDINATES', [obj.topLeft[0], obj.topLeft[1], obj.bottomRight[0], obj.bottomRight[1]]))
 
         if not(self.sendResponse('END_LIST_OBJECTS')):
@@ -594,6 +573,61 @@ class ImageServerListener(ServerListener):
 
         return ServerListener.ACTION_NONE
 
+    #---------------------------------------------------------------------------
+    # Called when a 'LIST_IMAGES' command was received
+    #
+    # Sends everything known about a range of images (name, size, set and
+    # objects), with one 'IMAGE_INFOS' response per image:
+    #
+    #   IMAGE_INFOS <index> <name> <width> <height> <set> <nb_objects>
+    #               [<label> <left> <top> <right> <bottom>]*
+    #
+    # @param arguments  Arguments of the command: index of the first image and
+    #                   number of images
+    # @return           The action to perform
+    #---------------------------------------------------------------------------
+    def handleListImagesCommand(self, arguments):
+        if self.database is None:
+            if not(self.sendResponse('NO_DATABASE_SELECTED')):
+                return ServerListener.ACTION_CLOSE_CONNECTION
+
+            return ServerListener.ACTION_NONE
+
+        if (arguments is None) or (len(arguments) != 2):
+            if not(self.sendResponse(Message('INVALID_ARGUMENTS', arguments))):
+                return ServerListener.ACTION_CLOSE_CONNECTION
+
+            return ServerListener.ACTION_NONE
+
+        first = int(arguments[0])
+        count = int(arguments[1])
+
+        indices = self._enabledImagesIndices()
+
+        if (first < 0) or (count < 0) or (first + count > len(indices)):
+            if not(self.sendResponse('UNKNOWN_IMAGE')):
+                return ServerListener.ACTION_CLOSE_CONNECTION
+
+            return ServerListener.ACTION_NONE
+
+        for i in range(first, first + count):
+            index = indices[i]
+            filtered_objects = self._enabledObjectsInImage(index)
+            size = self.database.imageSize(index)
+
+            parameters = [i, self.database.fullImageName(index), size[0], size[1],
+                          self._imageSetName(index), len(filtered_objects)]
+
+            for (label, obj) in filtered_objects:
+                parameters.extend([label, obj.topLeft[0], obj.topLeft[1], obj.bottomRight[0], obj.bottomRight[1]])
+
+            self.sendResponse(Message('IMAGE_INFOS', parameters))
+
+        if not(self.sendResponse('END_LIST_IMAGES')):
+            return ServerListener.ACTION_CLOSE_CONNECTION
+
+        return ServerListener.ACTION_NONE
+
     #---------------------------------------------------------------------------
     # Called when a 'REPORT_URL_PREFIX' command was received
     #
@@ -639,10 +673,7 @@ class ImageServerListener(ServerListener):
 
         index = int(arguments[0])
 
-        if self.backgroundImagesEnabled or (self.enabledImages is None):
-            indices = range(0, self.database.imagesCount())
-        else:
-            indices = self.enabledImages
+        indices = self._enabledImagesIndices()
 
         if (index >= len(indices)) or (index < 0):
             if not(self.sendResponse('UNKNOWN_IMAGE')):
@@ -655,6 +686,39 @@ class ImageServerListener(ServerListener):
 
         return ServerListener.ACTION_NONE
 
+    #---------------------------------------------------------------------------
+    # Returns the indices (in the database) of the images that are enabled
+    #---------------------------------------------------------------------------
+    def _enabledImagesIndices(self):
+        if self.backgroundImagesEnabled or (self.enabledImages is None):
+            return range(0, self.database.imagesCount())
+
+        return self.enabledImages
+
+    #---------------------------------------------------------------------------
+    # Returns the enabled objects of an image, as a list of (label, object)
+    # tuples (the labels being remapped if only some of them are enabled)
+    #---------------------------------------------------------------------------
+    def _enabledObjectsInImage(self, index):
+        objects = self.database.objectsInImage(index)
+
+        if self.enabledLabels is None:
+            return [ (obj.label, obj) for obj in objects ]
+
+        return [ (self.enabledLabels.index(obj.label), obj) for obj in objects if obj.label in self.enabledLabels ]
+
+    #---------------------------------------------------------------------------
+    # Returns the name of the set of an image, as sent to the clients
+    #---------------------------------------------------------------------------
+    def _imageSetName(self, index):
+        image_set = self.database.imageSet(index)
+        if image_set == Database.TRAINING_SET:
+            return 'TRAINING'
+        elif image_set == Database.TEST_SET:
+            return 'TEST'
+
+        return 'NONE'
+
     def _computeDatabaseInfos(self):
         if self.database is None:
             return (0, 0, 0)
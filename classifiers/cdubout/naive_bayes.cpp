@@ -117,6 +117,20 @@ public:
 						  const coordinates_t& position,
 						  tClassificationResults &results);
 
+	//--------------------------------------------------------------------------
+	/// @brief	Classify the content of an image at several positions
+	///
+	/// @param	input_set	The Classifier Input Set to use
+	/// @param	image		Index of the image (in the Input Set)
+	/// @param	positions	Centers of the regions-of-interest (in the image)
+	/// @retval results		Classification results, one per position
+	/// @return				'true' if successful
+	//--------------------------------------------------------------------------
+	virtual bool classifyBatch(IClassifierInputSet* input_set,
+							   unsigned int image,
+							   const tCoordinatesList& positions,
+							   tClassificationResultsList &results);
+
 	//--------------------------------------------------------------------------
 	/// @brief	Populates the provided list with the features used by the
 	///			classifier
@@ -333,6 +347,22 @@ bool NaiveBayes::classify(IClassifierInputSet* input_set,
 						  unsigned int image,
 						  const coordinates_t& position,
 						  tClassificationResults &results) {
+	tCoordinatesList positions(1, position);
+	tClassificationResultsList batch(1);
+
+	if (!classifyBatch(input_set, image, positions, batch)) {
+		return false;
+	}
+
+	results.swap(batch[0]);
+
+	return true;
+}
+
+bool NaiveBayes::classifyBatch(IClassifierInputSet* input_set,
+							   unsigned int image,
+							   const tCoordinatesList& positions,
+							   tClassificationResultsList &results) {
 	// Redirect std::cout to the classifier's outStream
 //	StreamBuf cout(outStream);
 
@@ -362,36 +392,46 @@ bool NaiveBayes::classify(IClassifierInputSet* input_set,
 		needLoading_ = false;
 	}
 
-	// Add the sample to the dataset
-	dataset_->pushSample(0, image, position);
-
-	// Computes the distribution of memberships
-	std::vector<double> distr(dataset_->nbLabels());
+	// Add all the samples to the dataset at once
+	const unsigned int first = dataset_->nbSamples();
 
-	try {
-		classifier_->distribution(*dataset_, dataset_->nbSamples() - 1, &distr[0]);
-	}
-	catch (std::exception& e) {
-		outStream << "Exception raised in classify: " << e.what() << std::endl;
-		return false;
+	for (unsigned int p = 0; p < positions.size(); ++p) {
+		dataset_->pushSample(0, image, positions[p]);
 	}
 
-	// Remove the sample
-	dataset_->popSample();
+	// Computes the distributions of memberships
+	std::vector<double> distr(dataset_->nbLabels());
+	bool success = true;
 
-	// Recopy the distribution into results
-	if (distr.size() <= input_set->nbLabels()) {
-		for (unsigned int l = 0; l < distr.size(); ++l) {
-			results[l] = distr[l];
+	for (unsigned int p = 0; p < positions.size(); ++p) {
+		try {
+			classifier_->distribution(*dataset_, first + p, &distr[0]);
 		}
-	}
-	else {
-		for (unsigned int l = 0; l < input_set->nbLabels(); ++l) {
-			results[l] = distr[l] - distr.back();
+		catch (std::exception& e) {
+			outStream << "Exception raised in classify: " << e.what() << std::endl;
+			success = false;
+			break;
+		}
+
+		// Recopy the distribution into results
+		if (distr.size() <= input_set->nbLabels()) {
+			for (unsigned int l = 0; l < distr.size(); ++l) {
+				results[p][l] = distr[l];
+			}
+		}
+		else {
+			for (unsigned int l = 0; l < input_set->nbLabels(); ++l) {
+				results[p][l] = distr[l] - distr.back();
+			}
 		}
 	}
 
-	return true;
+	// Remove the samples
+	for (unsigned int p = 0; p < positions.size(); ++p) {
+		dataset_->popSample();
+	}
+
+	return success;
 }
 
 bool NaiveBayes::reportFeaturesUsed(tFeatureList &list) {
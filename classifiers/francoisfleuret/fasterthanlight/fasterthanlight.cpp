@@ -54,6 +54,7 @@
 #include <mash-classification/classifier.h>
 
 #include <cmath>
+#include <algorithm>
 
 using namespace Mash;
 using namespace std;
@@ -145,6 +146,12 @@ public:
                         unsigned int image,
                         const coordinates_t& position,
                         tClassificationResults &results);
+  virtual bool getCascadeStages(std::vector<scalar_t> &thresholds);
+  virtual bool classifyStage(IClassifierInputSet* input_set,
+                             unsigned int image,
+                             const coordinates_t& position,
+                             unsigned int stage,
+                             tClassificationResults &results);
   virtual bool reportFeaturesUsed(tFeatureList &list);
   virtual bool saveModel(PredictorModel &model);
 
@@ -156,6 +163,13 @@ protected:
   unsigned int _nb_features_for_optimizing;
   unsigned int _nb_stumps_per_block;
 
+  // When a reject threshold is given, the stumps of each heuristic are
+  // evaluated as one stage of a cascade during the detection
+  bool _cascade;
+  scalar_t _reject_threshold;
+  std::vector<unsigned int> _stage_heuristics;
+  std::vector<unsigned int> _stage_offsets;
+
   unsigned int *_nb_features_from_heuristic;
   scalar_t *_stump_thresholds;
   scalar_t *_stump_weights0;
@@ -218,6 +232,11 @@ FasterThanLight::FasterThanLight() {
   _nb_features_for_optimizing = 100;
   _nb_stumps_per_block = 10;
 
+  _cascade = false;
+  _reject_threshold = 0;
+
+  _nb_features_from_heuristic = 0;
+
   _stump_thresholds = 0;
   _stump_weights0 = 0;
   _stump_weights1 = 0;
@@ -295,6 +314,14 @@ bool FasterThanLight::setup(const tExperimentParametersList& parameters) {
                 << endl;
     }
 
+    else if(iter->first == "REJECT_THRESHOLD") {
+      _cascade = true;
+      _reject_threshold = iter->second.getFloat(0);
+      outStream << "SETUP REJECT_THRESHOLD "
+                << _reject_threshold
+                << endl;
+    }
+
     else {
       outStream << "Warning: unknown parameter '" << iter->first << "'."
                 << std::endl;
@@ -764,6 +791,93 @@ bool FasterThanLight::classify(IClassifierInputSet* input_set,
   return true;
 }
 
+// The stumps are grouped by heuristic after the training, and each group is a
+// stage of the cascade. A position is rejected after a stage only if no label
+// can reach the reject threshold anymore, even with the biggest weights of the
+// remaining stumps: the positions kept are exactly the ones whose final score
+// is above the threshold.
+bool FasterThanLight::getCascadeStages(std::vector<scalar_t> &thresholds) {
+  if(!_cascade || !_nb_features_from_heuristic) {
+    return false;
+  }
+
+  _stage_heuristics.clear();
+  _stage_offsets.clear();
+
+  int q = 0;
+  for(unsigned int h = 0; h < _nb_heuristics; h++) {
+    if(_nb_features_from_heuristic[h] > 0) {
+      _stage_heuristics.push_back(h);
+      _stage_offsets.push_back(q);
+    }
+    q += _nb_features_from_heuristic[h];
+  }
+
+  thresholds.resize(_stage_heuristics.size());
+
+  scalar_t *remaining_weights = new scalar_t[_nb_labels];
+
+  for(unsigned int l = 0; l < _nb_labels; l++) {
+    remaining_weights[l] = 0;
+  }
+
+  for(int s = _stage_heuristics.size() - 1; s >= 0; s--) {
+    scalar_t max_remaining_weight = remaining_weights[0];
+    for(unsigned int l = 1; l < _nb_labels; l++) {
+      max_remaining_weight = max(max_remaining_weight, remaining_weights[l]);
+    }
+
+    thresholds[s] = _reject_threshold - max_remaining_weight;
+
+    unsigned int h = _stage_heuristics[s];
+    for(unsigned int q = _stage_offsets[s]; q < _stage_offsets[s] + _nb_features_from_heuristic[h]; q++) {
+      remaining_weights[_stump_labels[q]] += max(_stump_weights0[q], _stump_weights1[q]);
+    }
+  }
+
+  delete[] remaining_weights;
+
+  return true;
+}
+
+bool FasterThanLight::classifyStage(IClassifierInputSet* input_set,
+                                    unsigned int image,
+                                    const coordinates_t& position,
+                                    unsigned int stage,
+                                    tClassificationResults &results) {
+  ASSERT(stage < _stage_heuristics.size());
+
+  unsigned int h = _stage_heuristics[stage];
+  unsigned int nb_stumps = _nb_features_from_heuristic[h];
+  unsigned int *stump_features = _stump_features + _stage_offsets[stage];
+
+  scalar_t *feature_responses = new scalar_t[nb_stumps];
+
+  if(!input_set->computeSomeFeatures(image, position, h, nb_stumps,
+                                     stump_features, feature_responses)) {
+    delete[] feature_responses;
+    return false;
+  }
+
+  if(stage == 0) {
+    for(unsigned int l = 0; l < _nb_labels; l++) {
+      results[l] = 0;
+    }
+  }
+
+  for(unsigned int k = 0; k < nb_stumps; k++) {
+    unsigned int q = _stage_offsets[stage] + k;
+    if(feature_responses[k] >= _stump_thresholds[q]) {
+      results[_stump_labels[q]] += _stump_weights1[q];
+    } else {
+      results[_stump_labels[q]] += _stump_weights0[q];
+    }
+  }
+
+  delete[] feature_responses;
+  return true;
+}
+
 bool FasterThanLight::reportFeaturesUsed(tFeatureList &list) {
   for(unsigned int q = 0; q <  _nb_stump_blocks * _nb_stumps_per_block * _nb_labels; q++) {
     list.push_back(tFeature(_stump_heuristics[q],
@@ -0,0 +1,99 @@
+#include <mash-classification/classifier.h>
+#include <math.h>
+
+using namespace Mash;
+
+
+class CascadeScorer: public Classifier
+{
+    //_____ Construction / Destruction __________
+public:
+    CascadeScorer()
+    {
+    }
+    
+    virtual ~CascadeScorer()
+    {
+    }
+
+
+    //_____ Implementation of Classifier __________
+public:
+    virtual bool setup(const tExperimentParametersList& parameters)
+    {
+        return true;
+    }
+
+    virtual bool loadModel(PredictorModel &model, DataReader &internal_data)
+    {
+        return true;
+    }
+
+    virtual bool train(IClassifierInputSet* input_set, scalar_t &train_error)
+    {
+        return true;
+    }
+
+    virtual bool classify(IClassifierInputSet* input_set,
+                          unsigned int image,
+                          const coordinates_t& position,
+                          tClassificationResults &results)
+    {
+        for (unsigned int stage = 0; stage < 3; ++stage)
+        {
+            if (!classifyStage(input_set, image, position, stage, results))
+                return false;
+        }
+
+        return true;
+    }
+
+    virtual bool getCascadeStages(std::vector<scalar_t> &thresholds)
+    {
+        thresholds.push_back(64.0f);
+        thresholds.push_back(128.0f);
+        thresholds.push_back(-HUGE_VAL);
+        return true;
+    }
+
+    // Each stage needs one feature: the first one adds the x coordinate of the
+    // position to the score of the label 0, the second one its y coordinate,
+    // and the last one gives a score to the label 1
+    virtual bool classifyStage(IClassifierInputSet* input_set,
+                               unsigned int image,
+                               const coordinates_t& position,
+                               unsigned int stage,
+                               tClassificationResults &results)
+    {
+        unsigned int index = stage;
+        scalar_t value;
+
+        if (!input_set->computeSomeFeatures(image, position, 0, 1, &index, &value))
+            return false;
+
+        if (stage == 0)
+            results[0] = (scalar_t) position.x;
+        else if (stage == 1)
+            results[0] += (scalar_t) position.y;
+        else
+            results[1] = 1.0f;
+
+        return true;
+    }
+
+    virtual bool reportFeaturesUsed(tFeatureList &list)
+    {
+        return true;
+    }
+
+    virtual bool saveModel(PredictorModel &model)
+    {
+        return true;
+    }
+};
+
+
+extern "C" Classifier* new_classifier()
+{
+    return new CascadeScorer();
+}
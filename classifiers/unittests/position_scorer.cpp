@@ -0,0 +1,65 @@
+#include <mash-classification/classifier.h>
+
+using namespace Mash;
+
+
+class PositionScorer: public Classifier
+{
+    //_____ Construction / Destruction __________
+public:
+    PositionScorer()
+    {
+    }
+    
+    virtual ~PositionScorer()
+    {
+    }
+
+
+    //_____ Implementation of Classifier __________
+public:
+    virtual bool setup(const tExperimentParametersList& parameters)
+    {
+        return true;
+    }
+
+    virtual bool loadModel(PredictorModel &model, DataReader &internal_data)
+    {
+        return true;
+    }
+
+    virtual bool train(IClassifierInputSet* input_set, scalar_t &train_error)
+    {
+        return true;
+    }
+
+    virtual bool classify(IClassifierInputSet* input_set,
+                          unsigned int image,
+                          const coordinates_t& position,
+                          tClassificationResults &results)
+    {
+        results[0] = (scalar_t) position.x;
+        results[1] = (scalar_t) position.y;
+
+        if (image > 0)
+            results[-1] = (scalar_t) image;
+
+        return true;
+    }
+    
+    virtual bool reportFeaturesUsed(tFeatureList &list)
+    {
+        return true;
+    }
+
+    virtual bool saveModel(PredictorModel &model)
+    {
+        return true;
+    }
+};
+
+
+extern "C" Classifier* new_classifier()
+{
+    return new PositionScorer();
+}
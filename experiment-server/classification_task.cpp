@@ -33,9 +33,14 @@
 #include "listener.h"
 #include <mash-utils/random_number_generator.h>
 #include <mash-utils/errors.h>
+#include <mash-utils/stringutils.h>
+#include <mash-utils/data_writer.h>
+#include <mash-utils/data_reader.h>
 #include <mash-classification/object_intersecter.h>
+#include <mash-classification/non_maximum_suppressor.h>
 #include <mash/sandboxed_heuristics_set.h>
 #include <mash/trusted_heuristics_set.h>
+#include <mash/heuristics_manager.h>
 #include <mash-classification/sandboxed_classifier.h>
 #include <mash-classification/trusted_classifier.h>
 #include <mash-instrumentation/sandboxed_instruments_set.h>
@@ -44,30 +49,118 @@
 #include <algorithm>
 #include <limits>
 #include <numeric>
+#include <fstream>
+#include <sstream>
 #include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
 #include <math.h>
 #include <memory.h>
 #include <assert.h>
+#include <sys/stat.h>
 
 
 using namespace std;
 using namespace Mash;
 
 
+/********************************** CONSTANTS *********************************/
+
+// Maximum number of features per request exchanged through shared memory (the
+// bigger requests go through the communication channels)
+const unsigned int SHARED_FEATURES_CAPACITY = 16384;
+
+// Minimum number of test images evaluated between two checkpoints
+const unsigned int CHECKPOINT_INTERVAL = 100;
+
+// Default port of the features server
+const unsigned int FEATURES_SERVER_PORT = 12000;
+
+
 /****************************** UTILITY FUNCTIONS *****************************/
 
-bool value_comparer(Classifier::tClassificationResults::value_type &i1,
-                    Classifier::tClassificationResults::value_type &i2)
+bool value_comparer(const Classifier::tClassificationResults::value_type &i1,
+                    const Classifier::tClassificationResults::value_type &i2)
 {
     return i1.second < i2.second;
 }
 
 
+ClassificationTask::tResult sendGlobalSeed(Client* pClient, unsigned int seed)
+{
+    string strResponse;
+    ArgumentsList args;
+
+    if (!pClient->sendCommand("USE_GLOBAL_SEED", ArgumentsList((int) seed)))
+        return ClassificationTask::tResult(ERROR_NETWORK_REQUEST_FAILURE);
+
+    if (!pClient->waitResponse(&strResponse, &args))
+        return ClassificationTask::tResult(ERROR_NETWORK_RESPONSE_FAILURE);
+
+    if (strResponse != "OK")
+        return ClassificationTask::tResult(ERROR_APPSERVER_UNEXPECTED_RESPONSE, strResponse + " (expected: OK)");
+
+    return ClassificationTask::tResult();
+}
+
+
+string hashSignature(const std::string& strSignature)
+{
+    // 64-bit FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+
+    for (unsigned int i = 0; i < strSignature.size(); ++i)
+    {
+        hash ^= (unsigned char) strSignature[i];
+        hash *= 1099511628211ULL;
+    }
+
+    char buffer[17];
+    sprintf(buffer, "%016llx", (unsigned long long) hash);
+
+    return buffer;
+}
+
+
+bool fileExists(const std::string& strFileName)
+{
+    struct stat fileInfo;
+    return (stat(strFileName.c_str(), &fileInfo) == 0);
+}
+
+
+bool copyFile(const std::string& strSource, const std::string& strDestination)
+{
+    ifstream source(strSource.c_str(), ios::binary);
+    if (!source.is_open())
+        return false;
+
+    // Write a temporary file first, to never leave an incomplete copy
+    string strTemp = strDestination + ".tmp";
+
+    ofstream destination(strTemp.c_str(), ios::binary);
+    if (!destination.is_open())
+        return false;
+
+    if (source.peek() != ifstream::traits_type::eof())
+        destination << source.rdbuf();
+
+    destination.close();
+
+    if (destination.fail())
+        return false;
+
+    return (rename(strTemp.c_str(), strDestination.c_str()) == 0);
+}
+
+
 /************************* CONSTRUCTION / DESTRUCTION *************************/
 
 ClassificationTask::ClassificationTask(Listener* pListener, bool detection)
 : TaskController(pListener), _pClassifierDelegate(0), _inputSet(200, detection),
-  _bUseModel(false)
+  _bUseModel(false), _bTrained(false), _bModelSaved(false), _bSandboxedPredictor(false),
+  _pEvaluator(0), _nbTestWorkers(0), _predictorSeed(0), _bPredictorSetup(false),
+  _bModelFromCheckpoint(false), _pFeaturesStore(0)
 {
     setGlobalSeed(time(0));
 }
@@ -75,7 +168,9 @@ ClassificationTask::ClassificationTask(Listener* pListener, bool detection)
 
 ClassificationTask::~ClassificationTask()
 {
+    delete _pEvaluator;
     delete _pClassifierDelegate;
+    delete _pFeaturesStore;
 }
 
 
@@ -87,14 +182,39 @@ tError ClassificationTask::setup(const tTaskControllerConfiguration& configurati
     assert(!_pClassifierDelegate);
     assert(!_pInstrumentsSet);
 
+    // Creates the buffer through which the sandboxes of the predictor and of
+    // the heuristics exchange the features (if enabled). Failing to create it
+    // isn't fatal: the features are then transferred through the channels.
+    tSandboxConfiguration heuristicsSandboxConfiguration;
+    tSandboxConfiguration predictorSandboxConfiguration;
+
+    if (configuration.heuristicsSandboxConfiguration)
+        heuristicsSandboxConfiguration = *configuration.heuristicsSandboxConfiguration;
+
+    if (configuration.predictorSandboxConfiguration)
+        predictorSandboxConfiguration = *configuration.predictorSandboxConfiguration;
+
+    if (configuration.bSharedFeatures && configuration.heuristicsSandboxConfiguration &&
+        configuration.predictorSandboxConfiguration &&
+        _sharedFeatures.create(SHARED_FEATURES_CAPACITY, heuristicsSandboxConfiguration.strTempDir))
+    {
+        // The classifier must not be able to modify the features once
+        // computed, so it only gets a read-only access to the buffer
+        heuristicsSandboxConfiguration.sharedFeaturesFd = _sharedFeatures.fd();
+        predictorSandboxConfiguration.sharedFeaturesFd  = _sharedFeatures.readOnlyFd();
+    }
+
     // Creates the Heuristics Set
     if (configuration.heuristicsSandboxConfiguration)
     {
         SandboxedHeuristicsSet* pHeuristicsSet = new SandboxedHeuristicsSet();
         _inputSet.featuresComputer()->setHeuristicsSet(pHeuristicsSet);
 
-        if (!pHeuristicsSet->createSandbox(*configuration.heuristicsSandboxConfiguration))
+        if (!pHeuristicsSet->createSandbox(heuristicsSandboxConfiguration))
             return pHeuristicsSet->getLastError();
+
+        if (_sharedFeatures.isValid())
+            pHeuristicsSet->setSharedFeaturesBuffer(&_sharedFeatures);
     }
     else
     {
@@ -107,25 +227,17 @@ tError ClassificationTask::setup(const tTaskControllerConfiguration& configurati
     if (!getFeaturesComputer()->heuristicsSet()->setHeuristicsFolder(configuration.strHeuristicsFolder))
         return getFeaturesComputer()->getLastError();
 
-    // Creates the Classifier Delegate
-    if (configuration.predictorSandboxConfiguration)
-    {
-        SandboxedClassifier* pDelegate = new SandboxedClassifier();
-        _pClassifierDelegate = pDelegate;
+    // Creates the Classifier Delegate (the settings are remembered, to be able
+    // to create it again if the checkpoint of a previous run can't be used)
+    _bSandboxedPredictor            = (configuration.predictorSandboxConfiguration != 0);
+    _predictorSandboxConfiguration  = predictorSandboxConfiguration;
+    _strPredictorsFolder            = configuration.strPredictorsFolder;
+    _strLogFolder                   = configuration.strLogFolder;
+    _strReportFolder                = configuration.strReportFolder;
 
-        if (!pDelegate->createSandbox(*configuration.predictorSandboxConfiguration))
-            return pDelegate->getLastError();
-    }
-    else
-    {
-        TrustedClassifier* pDelegate = new TrustedClassifier();
-        _pClassifierDelegate = pDelegate;
-
-        pDelegate->configure(configuration.strLogFolder, configuration.strReportFolder);
-    }
-    
-    if (!_pClassifierDelegate->setClassifiersFolder(configuration.strPredictorsFolder))
-        return _pClassifierDelegate->getLastError();
+    tError error = createClassifierDelegate();
+    if (error != ERROR_NONE)
+        return error;
 
     // Creates the Instruments Set
     if (configuration.instrumentsSandboxConfiguration)
@@ -151,6 +263,41 @@ tError ClassificationTask::setup(const tTaskControllerConfiguration& configurati
     _listener.pInstrumentsSet = _pInstrumentsSet;
     _inputSet.setListener(&_listener);
 
+    // Remember the settings needed to create the workers evaluating the test
+    // images in parallel (only possible when the plugins are sandboxed)
+    if (configuration.predictorSandboxConfiguration && configuration.heuristicsSandboxConfiguration)
+    {
+        _nbTestWorkers                  = configuration.nbTestWorkers;
+        _heuristicsSandboxConfiguration = heuristicsSandboxConfiguration;
+        _strHeuristicsFolder            = configuration.strHeuristicsFolder;
+    }
+
+    // Remember the settings needed to save the checkpoints
+    _strCheckpointsFolder = configuration.strCheckpointFolder;
+
+    // Connect to the features store (if any)
+    if (!configuration.strFeaturesStore.empty())
+    {
+        string strHost = configuration.strFeaturesStore;
+        unsigned int port = FEATURES_SERVER_PORT;
+
+        size_t offset = strHost.find_last_of(":");
+        if (offset != string::npos)
+        {
+            port = StringUtils::parseUnsignedInt(strHost.substr(offset + 1));
+            strHost = strHost.substr(0, offset);
+        }
+
+        _pFeaturesStore = new FeaturesStoreClient();
+
+        error = _pFeaturesStore->connect(strHost, port);
+        if (error != ERROR_NONE)
+            return error;
+
+        _strHeuristicsSources   = configuration.strHeuristicsSources;
+        _strHeuristicsLibraries = configuration.strHeuristicsFolder;
+    }
+
     return ERROR_NONE;
 }
 
@@ -185,22 +332,16 @@ Mash::Client* ClassificationTask::getClient()
 ClassificationTask::tResult ClassificationTask::setParameters(const Mash::tExperimentParametersList& parameters)
 {
     // Send its global seed to the application server
-    string strResponse;
-    ArgumentsList args;
-
-    if (!getClient()->sendCommand("USE_GLOBAL_SEED", ArgumentsList((int) _seeds[SEED_APPSERVER])))
-        return tResult(ERROR_NETWORK_REQUEST_FAILURE);
-
-    if (!getClient()->waitResponse(&strResponse, &args))
-        return tResult(ERROR_NETWORK_RESPONSE_FAILURE);
-
-    if (strResponse != "OK")
-        return tResult(ERROR_APPSERVER_UNEXPECTED_RESPONSE, strResponse + " (expected: OK)");
+    tResult result = sendGlobalSeed(getClient(), _seeds[SEED_APPSERVER]);
+    if (result.error != ERROR_NONE)
+        return result;
 
     Mash::tError error = _inputSet.setParameters(parameters, _seeds[SEED_IMAGES]);
     if (error != ERROR_NONE)
         return tResult(error, _inputSet.getLastExperimentParameterError());
 
+    _parameters = parameters;
+
     return tResult();
 }
 
@@ -213,17 +354,37 @@ ClassificationTask::tResult ClassificationTask::loadPredictor(const std::string
     // Assertions
     assert(_pClassifierDelegate);
 
-    if (!_pClassifierDelegate->loadClassifierPlugin(strName, strModelFile, strInternalDataFile))
+    _predictorSeed = ((seed == 0) ? _seeds[SEED_CLASSIFIER] : seed);
+
+    _strPredictorName    = strName;
+    _strModelFile        = strModelFile;
+    _strInternalDataFile = strInternalDataFile;
+
+    // Look for the checkpoint of a previous run of the same experiment. If
+    // the predictor was already trained (and no model was provided), its
+    // model is loaded instead of training it again.
+    string strPluginModelFile        = strModelFile;
+    string strPluginInternalDataFile = strInternalDataFile;
+
+    if (!_strCheckpointsFolder.empty())
     {
-        if (_pClassifierDelegate->getLastError() == ERROR_CHANNEL_SLAVE_CRASHED)
-            return tResult(ERROR_CLASSIFIER_CRASHED);
-        else
-            return tResult(_pClassifierDelegate->getLastError());
-    }
+        _strCheckpointFolder = _strCheckpointsFolder + checkpointKey(false) + "/";
 
-    _pClassifierDelegate->setNotifier(&_notifier);
+        if (loadCheckpoint() && _checkpoint.bTrained && strModelFile.empty() &&
+            fileExists(_strCheckpointFolder + "predictor.model"))
+        {
+            strPluginModelFile = _strCheckpointFolder + "predictor.model";
+
+            if (fileExists(_strCheckpointFolder + "predictor.internal"))
+                strPluginInternalDataFile = _strCheckpointFolder + "predictor.internal";
+
+            _bModelFromCheckpoint = true;
+        }
+    }
 
-    _pClassifierDelegate->setSeed((seed == 0) ? _seeds[SEED_CLASSIFIER] : seed);
+    tError error = loadPredictorPlugin(strPluginModelFile, strPluginInternalDataFile);
+    if (error != ERROR_NONE)
+        return tResult(error);
 
     _bUseModel = !strModelFile.empty();
     _bPredictorLoaded = true;
@@ -237,6 +398,9 @@ bool ClassificationTask::setupPredictor(const Mash::tExperimentParametersList& p
     // Assertions
     assert(_pClassifierDelegate);
 
+    _predictorParameters = parameters;
+    _bPredictorSetup = true;
+
     return _pClassifierDelegate->setup(parameters);
 }
 
@@ -276,6 +440,8 @@ ServerListener::tAction ClassificationTask::train()
         }
     }
 
+    setupFeaturesStore();
+
     // If necessary, load the predictor model
     if (_bUseModel)
     {
@@ -310,24 +476,73 @@ ServerListener::tAction ClassificationTask::train()
         return ServerListener::ACTION_NONE;
     }
 
-    // Train the classifier
     scalar_t train_error = 0 * log(0);
-    if (!_pClassifierDelegate->train(&_inputSet, train_error))
+
+    error = discardUnusableCheckpoint();
+    if (error != ERROR_NONE)
     {
-        if (!_pListener->sendResponse("ERROR", getErrorDescription(_pClassifierDelegate->getLastError())))
+        if (!_pListener->sendResponse("ERROR", getErrorDescription(error)))
             return ServerListener::ACTION_CLOSE_CONNECTION;
 
         return ServerListener::ACTION_NONE;
     }
 
-    // Retrieve the train error
-    if (isnan(train_error) && !classify(&train_error, false))
+    string strCheckpointKey;
+    if (!_strCheckpointFolder.empty())
+        strCheckpointKey = checkpointKey(true);
+
+    // Resume from the checkpoint of a previous run of the same experiment if
+    // the predictor was already trained: the model saved at that time is
+    // loaded instead
+    bool bCheckpointNeeded = false;
+
+    if (_bModelFromCheckpoint && _checkpoint.bTrained && (_checkpoint.strKey == strCheckpointKey))
     {
-        if (!_pListener->sendResponse("ERROR", getErrorDescription(_pClassifierDelegate->getLastError())))
-            return ServerListener::ACTION_CLOSE_CONNECTION;
+        if (!_pClassifierDelegate->loadModel(&_inputSet))
+        {
+            if (!_pListener->sendResponse("ERROR", ArgumentsList("Failed to load the predictor model")))
+                return ServerListener::ACTION_CLOSE_CONNECTION;
 
-        return ServerListener::ACTION_NONE;
+            return ServerListener::ACTION_NONE;
+        }
+
+        train_error = _checkpoint.train_error;
+        _bTrained = true;
     }
+    else
+    {
+        // Train the classifier
+        if (!_pClassifierDelegate->train(&_inputSet, train_error))
+        {
+            if (!_pListener->sendResponse("ERROR", getErrorDescription(_pClassifierDelegate->getLastError())))
+                return ServerListener::ACTION_CLOSE_CONNECTION;
+
+            return ServerListener::ACTION_NONE;
+        }
+
+        _bTrained = true;
+
+        // Retrieve the train error
+        if (isnan(train_error) && !classify(&train_error, false))
+        {
+            if (!_pListener->sendResponse("ERROR", getErrorDescription(_pClassifierDelegate->getLastError())))
+                return ServerListener::ACTION_CLOSE_CONNECTION;
+
+            return ServerListener::ACTION_NONE;
+        }
+
+        _checkpoint             = tCheckpoint();
+        _checkpoint.strKey      = strCheckpointKey;
+        _checkpoint.bTrained    = true;
+        _checkpoint.train_error = train_error;
+
+        bCheckpointNeeded = !_strCheckpointFolder.empty();
+    }
+
+    // Send the computed features to the features store (failing to do so
+    // isn't fatal)
+    if (_pFeaturesStore)
+        _pFeaturesStore->flush();
 
     // Notify the instruments
     if (!_pInstrumentsSet->onClassifierTrainingDone(&_inputSet, train_error))
@@ -344,6 +559,11 @@ ServerListener::tAction ClassificationTask::train()
     if (!bSuccess)
         return action;
 
+    // Save a checkpoint, now that the model of the predictor knows about the
+    // heuristics it uses (failing to do so isn't fatal)
+    if (bCheckpointNeeded)
+        saveCheckpoint(true);
+
     // Sends a response to the client
     if (!_pListener->sendResponse("TRAIN_ERROR", train_error))
         return ServerListener::ACTION_CLOSE_CONNECTION;
@@ -387,6 +607,8 @@ Mash::ServerListener::tAction ClassificationTask::test()
             }
         }
 
+        setupFeaturesStore();
+
         // If necessary, load the predictor model
         if (!_pClassifierDelegate->loadModel(&_inputSet))
         {
@@ -419,11 +641,71 @@ Mash::ServerListener::tAction ClassificationTask::test()
         return ServerListener::ACTION_NONE;
     }
 
+    // Resume the evaluation of the test images from the checkpoint of a
+    // previous run of the same experiment (if any)
+    if (!_strCheckpointFolder.empty())
+    {
+        tError error = discardUnusableCheckpoint();
+        if (error != ERROR_NONE)
+        {
+            if (!_pListener->sendResponse("ERROR", getErrorDescription(error)))
+                return ServerListener::ACTION_CLOSE_CONNECTION;
+
+            return ServerListener::ACTION_NONE;
+        }
+
+        string strCheckpointKey = checkpointKey(true);
+
+        if (_checkpoint.strKey != strCheckpointKey)
+        {
+            _checkpoint = tCheckpoint();
+            _checkpoint.strKey = strCheckpointKey;
+        }
+    }
+
+    // Distribute the test images among several pairs of sandboxes if
+    // requested (they are evaluated sequentially if that isn't possible)
+    if (_nbTestWorkers > 1)
+    {
+        if (createTestWorkers())
+            _pListener->outStream() << "Test images distributed among " << _nbTestWorkers << " workers" << endl;
+        else
+            _pListener->outStream() << "Failed to create the test workers, the test images are evaluated sequentially" << endl;
+    }
+
     // Classification
     scalar_t test_error;
-    if (!classify(&test_error, true))
+    bool bSuccess = classify(&test_error, true);
+
+    tError error = ERROR_NONE;
+    string strErrorContext;
+    if (!bSuccess)
+    {
+        if (_pEvaluator && (_pEvaluator->failedWorker() >= 0))
+        {
+            error = logTestWorkerFailure();
+            strErrorContext = " (test worker #" + StringUtils::toString(_pEvaluator->failedWorker()) +
+                              ", test image #" + StringUtils::toString(_pEvaluator->failedImage()) + ")";
+        }
+        else
+        {
+            error = _pClassifierDelegate->getLastError();
+        }
+    }
+
+    // The statistics of the sandboxes of the workers and the crash reports of
+    // their plugins are dropped here
+    delete _pEvaluator;
+    _pEvaluator = 0;
+
+    // Send the computed features to the features store (failing to do so
+    // isn't fatal)
+    if (_pFeaturesStore)
+        _pFeaturesStore->flush();
+
+    if (!bSuccess)
     {
-        if (!_pListener->sendResponse("ERROR", getErrorDescription(_pClassifierDelegate->getLastError())))
+        if (!_pListener->sendResponse("ERROR", getErrorDescription(error) + strErrorContext))
             return ServerListener::ACTION_CLOSE_CONNECTION;
 
         return ServerListener::ACTION_NONE;
@@ -461,8 +743,12 @@ bool ClassificationTask::savePredictorModel()
     // Assertions
     assert(_pClassifierDelegate);
 
-    // Ask the classifier
-    return _pClassifierDelegate->saveModel();
+    // Ask the classifier (unless the model was already saved for the workers
+    // evaluating the test images)
+    if (!_bModelSaved)
+        _bModelSaved = _pClassifierDelegate->saveModel();
+
+    return _bModelSaved;
 }
 
 
@@ -619,6 +905,22 @@ int ClassificationTask::getLogFileContent(unsigned int index, std::string& strNa
 }
 
 
+std::string ClassificationTask::getIPCStatisticsReport()
+{
+    string strReport;
+
+    SandboxedHeuristicsSet* pSandboxedHeuristicsSet = dynamic_cast<SandboxedHeuristicsSet*>(getFeaturesComputer()->heuristicsSet());
+    if (pSandboxedHeuristicsSet && pSandboxedHeuristicsSet->sandboxController()->getStatistics())
+        strReport += "SANDBOX heuristics\n" + pSandboxedHeuristicsSet->sandboxController()->getStatisticsReport();
+
+    SandboxedClassifier* pSandboxedClassifier = dynamic_cast<SandboxedClassifier*>(_pClassifierDelegate);
+    if (pSandboxedClassifier && pSandboxedClassifier->sandboxController()->getStatistics())
+        strReport += "SANDBOX classifier\n" + pSandboxedClassifier->sandboxController()->getStatisticsReport();
+
+    return strReport + TaskController::getIPCStatisticsReport();
+}
+
+
 void ClassificationTask::fillReport(const std::string& strReportFolder)
 {
     // Report the list of labels
@@ -716,11 +1018,17 @@ bool ClassificationTask::classify(scalar_t* result, bool bDoingTest)
     const unsigned int roi_extent = stepper->roiExtent();
     const unsigned int roi_size = roi_extent * 2 + 1;
 
+    // When testing, the images already evaluated before the last checkpoint
+    // are skipped
+    const bool bCheckpoints = bDoingTest && !_strCheckpointFolder.empty();
+    const unsigned int first_test_image = (bDoingTest ? min(_checkpoint.next_test_image, _inputSet.nbImages()) : 0);
+    unsigned int last_checkpoint = first_test_image;
+
     // Classification
     if (!stepper->isDoingDetection())
     {
         // The number of missclassifications
-        unsigned int nbErrors = 0;
+        unsigned int nbErrors = (bDoingTest ? _checkpoint.nb_errors : 0);
 
         if (bDoingTest)
             _notifier.onTestStepDone(0, _inputSet.nbImages());
@@ -732,27 +1040,22 @@ bool ClassificationTask::classify(scalar_t* result, bool bDoingTest)
         else if (_inputSet.nbImages() >= 100)
             _notifier.setReductor(10);
 
-        for (unsigned int image = 0; image < _inputSet.nbImages(); ++image)
+        for (unsigned int image = first_test_image; image < _inputSet.nbImages(); ++image)
         {
             // Get the dimensions of the image
             dim_t image_size = _inputSet.imageSize(image);
 
             // The stepper should return only one position (the center)
-            tCoordinatesList positions;
-            stepper->getPositions(image_size, &positions);
+            const tCoordinatesList& positions = stepper->positions(image_size);
             assert(positions.size() == 1);
 
-            _inputSet.restrictAccess(true);
-
             // Obtain the classifier response at that position
-            Classifier::tClassificationResults results;
-            bool ret = _pClassifierDelegate->classify(&_inputSet, image, positions.front(), results);
-
-            _inputSet.restrictAccess(false);
-
-            if (!ret)
+            Classifier::tClassificationResultsList resultsList;
+            if (!computeResults(image, positions, resultsList, bDoingTest) || resultsList.empty())
                 return false;
 
+            Classifier::tClassificationResults& results = resultsList.front();
+
             // Assume that the classifier made an error for the moment
             ++nbErrors;
 
@@ -792,6 +1095,17 @@ bool ClassificationTask::classify(scalar_t* result, bool bDoingTest)
                 _notifier.onTestStepDone(image + 1);
             else
                 _notifier.onTrainErrorComputationStepDone(image + 1);
+
+            // Save a checkpoint if necessary
+            if (bCheckpoints && ((image + 1 - last_checkpoint >= CHECKPOINT_INTERVAL) ||
+                                 (image + 1 == _inputSet.nbImages())))
+            {
+                _checkpoint.next_test_image = image + 1;
+                _checkpoint.nb_errors = nbErrors;
+                saveCheckpoint();
+
+                last_checkpoint = image + 1;
+            }
         }
 
         _notifier.setReductor(0);
@@ -811,16 +1125,17 @@ bool ClassificationTask::classify(scalar_t* result, bool bDoingTest)
         string previous_name;
 
         // The first index of the current image
-        unsigned int first_image = 0;
+        unsigned int first_image = first_test_image;
 
         // Detections of the current image (accross scales)
+        NonMaximumSuppressor<tDetection> suppressor(roi_extent, 0.25f);
         vector<tDetection> detections;
 
         // Number of correctly detected and incorrectly or non detected objects
-        unsigned int nb_detected = 0;
-        unsigned int nb_non_detected = 0;
+        unsigned int nb_detected = (bDoingTest ? _checkpoint.nb_detected : 0);
+        unsigned int nb_non_detected = (bDoingTest ? _checkpoint.nb_non_detected : 0);
 
-        for (unsigned int image = 0; image <= _inputSet.nbImages(); ++image)
+        for (unsigned int image = first_test_image; image <= _inputSet.nbImages(); ++image)
         {
             // Get the info of the current image
             string image_name;
@@ -841,6 +1156,8 @@ bool ClassificationTask::classify(scalar_t* result, bool bDoingTest)
             // If the image is really a new one, report the detections of the previous one
             if (image_name != previous_name || image == _inputSet.nbImages())
             {
+                suppressor.getDetections(&detections);
+
                 // Get all the objects at all the scales
                 vector<tObjectsList> objects(image - first_image);
 
@@ -935,7 +1252,20 @@ bool ClassificationTask::classify(scalar_t* result, bool bDoingTest)
 
                 first_image = image;
                 previous_name = image_name;
-                vector<tDetection>().swap(detections);
+                suppressor.clear();
+
+                // Save a checkpoint if necessary (only between two images, as
+                // the detections are accumulated accross the scales)
+                if (bCheckpoints && ((image - last_checkpoint >= CHECKPOINT_INTERVAL) ||
+                                     ((image == _inputSet.nbImages()) && (image > last_checkpoint))))
+                {
+                    _checkpoint.next_test_image = image;
+                    _checkpoint.nb_detected = nb_detected;
+                    _checkpoint.nb_non_detected = nb_non_detected;
+                    saveCheckpoint();
+
+                    last_checkpoint = image;
+                }
             }
 
             // Break if there is no image after this one
@@ -945,28 +1275,25 @@ bool ClassificationTask::classify(scalar_t* result, bool bDoingTest)
             // Get the dimensions of the image (with scaling applied)
             image_size = _inputSet.imageSize(image);
 
-            // Iterate over all the positions returned by the stepper
-            tCoordinatesList positions;
-            stepper->getPositions(image_size, &positions);
+            // Iterate over all the positions returned by the stepper (shared
+            // by all the images of the same dimensions)
+            const tCoordinatesList& positions = stepper->positions(image_size);
 
             // There should always be at least one position (the center)
             assert(positions.size() > 0);
 
-            // Scanning (at each position find the label with the biggest score)
-            // TODO: do clustering here rather than later to improve efficiency
-            tCoordinatesIterator iter, iterEnd;
-            for (iter = positions.begin(), iterEnd = positions.end(); iter != iterEnd; ++iter)
+            // Obtain the classifier responses at all the positions at once
+            Classifier::tClassificationResultsList resultsList;
+            if (!computeResults(image, positions, resultsList, bDoingTest) ||
+                (resultsList.size() != positions.size()))
             {
-                _inputSet.restrictAccess(true);
-
-                // Obtain the classifier response at that position
-                Classifier::tClassificationResults results;
-                bool ret = _pClassifierDelegate->classify(&_inputSet, image, *iter, results);
-
-                _inputSet.restrictAccess(false);
+                return false;
+            }
 
-                if (!ret)
-                    return false;
+            // Scanning (at each position find the label with the biggest score)
+            for (unsigned int i = 0; i < positions.size(); ++i)
+            {
+                const Classifier::tClassificationResults& results = resultsList[i];
 
                 // No need to consider the empty case (no result => no detection => zero detection rate)
                 if (!results.empty())
@@ -979,27 +1306,16 @@ bool ClassificationTask::classify(scalar_t* result, bool bDoingTest)
                     tDetection detection;
                     detection.label = iterResult->first;
                     detection.target = false;
-                    detection.roi_position = *iter;
+                    detection.roi_position = positions[i];
                     detection.roi_extent = roi_extent;
                     detection.score = iterResult->second;
                     detection.image = image;
                 //  detection.results.swap(results);
 
-                    // Look if there is already a detection with a higher score intersecting with this one
-                    tObjectIntersecter intersecter(detection, 0.25f);
-
-                    vector<tDetection>::const_iterator iter2, iterEnd2;
-                    for (iter2 = detections.begin(), iterEnd2 = detections.end(); iter2 != iterEnd2; ++iter2)
-                        if (iter2->score >= detection.score && intersecter(*iter2))
-                            break;
-
-                    // Remove all the previous detection intersecting with this one before adding it
-                    if (iter2 == iterEnd2)
-                    {
-                        iter2 = remove_if(detections.begin(), detections.end(), intersecter);
-                        detections.resize(iter2 - detections.begin());
-                        detections.push_back(detection);
-                    }
+                    // Only keep it if there is no detection with a higher score
+                    // intersecting with it (the ones with a lower score are
+                    // removed)
+                    suppressor.add(detection);
                 }
             }
         }
@@ -1009,3 +1325,472 @@ bool ClassificationTask::classify(scalar_t* result, bool bDoingTest)
         return true;
     }
 }
+
+
+bool ClassificationTask::computeResults(unsigned int image, const tCoordinatesList& positions,
+                                        Classifier::tClassificationResultsList& results,
+                                        bool bDoingTest)
+{
+    // The test images might be evaluated by the workers
+    if (bDoingTest && _pEvaluator)
+        return _pEvaluator->waitResults(image, results, &_listener);
+
+    bool ret;
+
+    _inputSet.restrictAccess(true);
+
+    if (!isDoingDetection())
+    {
+        results.resize(1);
+        ret = _pClassifierDelegate->classify(&_inputSet, image, positions.front(), results[0]);
+    }
+    else
+    {
+        ret = _pClassifierDelegate->classifyBatch(&_inputSet, image, positions, results);
+    }
+
+    _inputSet.restrictAccess(false);
+
+    return ret;
+}
+
+
+bool ClassificationTask::createTestWorkers()
+{
+    // Assertions
+    assert(!_pEvaluator);
+    assert(_nbTestWorkers > 1);
+
+    if (_strApplicationServerAddress.empty())
+        return false;
+
+    // The classifiers of the workers load the model of the predictor: the
+    // one it saved if it was trained, the one it loaded otherwise
+    string strModelFile = _strModelFile;
+    string strInternalDataFile = _strInternalDataFile;
+
+    if (_bTrained)
+    {
+        if (!savePredictorModel())
+            return false;
+
+        strModelFile        = _predictorSandboxConfiguration.strOutputDir + "predictor.model";
+        strInternalDataFile = _predictorSandboxConfiguration.strOutputDir + "predictor.internal";
+    }
+
+    if (strModelFile.empty())
+        return false;
+
+    // Create the workers (in the main thread)
+    _pEvaluator = new ParallelEvaluator();
+
+    bool bSuccess = true;
+    for (unsigned int i = 0; bSuccess && (i < _nbTestWorkers); ++i)
+        bSuccess = createTestWorker(i, strModelFile, strInternalDataFile);
+
+    if (!bSuccess || !_pEvaluator->start(_checkpoint.next_test_image))
+    {
+        delete _pEvaluator;
+        _pEvaluator = 0;
+        return false;
+    }
+
+    return true;
+}
+
+
+bool ClassificationTask::createTestWorker(unsigned int index, const std::string& strModelFile,
+                                          const std::string& strInternalDataFile)
+{
+    // Assertions
+    assert(_pEvaluator);
+
+    Client* pClient = new Client();
+    ClassifierInputSet* pInputSet = new ClassifierInputSet(200, isDoingDetection());
+    SandboxedClassifier* pDelegate = new SandboxedClassifier();
+
+    _pEvaluator->addWorker(pInputSet, pDelegate, pClient);
+
+    // Each worker has its own folder for the log files and the outputs of its
+    // sandboxes (the predictor one writes its model there)
+    string strFolder = _heuristicsSandboxConfiguration.strTempDir + "test_worker_" +
+                       StringUtils::toString(index) + "/";
+
+    mkdir(strFolder.c_str(), S_IRUSR | S_IWUSR | S_IXUSR | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH);
+
+    tSandboxConfiguration heuristicsSandboxConfiguration = _heuristicsSandboxConfiguration;
+    heuristicsSandboxConfiguration.strLogDir        = strFolder;
+    heuristicsSandboxConfiguration.sharedFeaturesFd = -1;
+
+    tSandboxConfiguration predictorSandboxConfiguration = _predictorSandboxConfiguration;
+    predictorSandboxConfiguration.strLogDir         = strFolder;
+    predictorSandboxConfiguration.strOutputDir      = strFolder;
+    predictorSandboxConfiguration.sharedFeaturesFd  = -1;
+
+    // Retrieve the same images than the main Input Set
+    if (!pClient->connect(_strApplicationServerAddress, _applicationServerPort) ||
+        (pInputSet->setClient(pClient) != ERROR_NONE) ||
+        (sendGlobalSeed(pClient, _seeds[SEED_APPSERVER]).error != ERROR_NONE) ||
+        (pInputSet->setParameters(_parameters, _seeds[SEED_IMAGES]) != ERROR_NONE))
+    {
+        return false;
+    }
+
+    // Load the same heuristics, with the same seeds
+    FeaturesComputer* pFeaturesComputer = pInputSet->featuresComputer();
+
+    SandboxedHeuristicsSet* pHeuristicsSet = new SandboxedHeuristicsSet();
+    pFeaturesComputer->setHeuristicsSet(pHeuristicsSet);
+    pFeaturesComputer->setSeed(_seeds[SEED_HEURISTICS]);
+
+    if (!pHeuristicsSet->createSandbox(heuristicsSandboxConfiguration) ||
+        !pHeuristicsSet->setHeuristicsFolder(_strHeuristicsFolder))
+    {
+        return false;
+    }
+
+    for (unsigned int i = 0; i < getFeaturesComputer()->nbHeuristics(); ++i)
+    {
+        if (!pFeaturesComputer->addHeuristic(getFeaturesComputer()->heuristicsSet()->heuristicName(i),
+                                             getFeaturesComputer()->heuristicSeed(i)))
+        {
+            return false;
+        }
+    }
+
+    if (!pFeaturesComputer->init(1, pInputSet->getDataSet()->roiExtent()))
+        return false;
+
+    // Load the predictor and its model
+    if (!pDelegate->createSandbox(predictorSandboxConfiguration) ||
+        !pDelegate->setClassifiersFolder(_strPredictorsFolder) ||
+        !pDelegate->loadClassifierPlugin(_strPredictorName, strModelFile, strInternalDataFile) ||
+        !pDelegate->setSeed(_predictorSeed) ||
+        (_bPredictorSetup && !pDelegate->setup(_predictorParameters)) ||
+        !pDelegate->loadModel(pInputSet))
+    {
+        return false;
+    }
+
+    // Select the test set
+    pInputSet->getDataSet()->setMode(DataSet::MODE_TEST);
+    pInputSet->onUpdated();
+
+    return (pInputSet->nbImages() == _inputSet.nbImages());
+}
+
+
+tError ClassificationTask::logTestWorkerFailure()
+{
+    // Assertions
+    assert(_pListener);
+    assert(_pEvaluator);
+    assert(_pEvaluator->failedWorker() >= 0);
+
+    IClassifierDelegate* pDelegate = _pEvaluator->failedDelegate();
+    SandboxedClassifier* pSandboxedClassifier = dynamic_cast<SandboxedClassifier*>(pDelegate);
+    FeaturesComputer* pFeaturesComputer = _pEvaluator->failedInputSet()->featuresComputer();
+
+    tError classifier_error = pDelegate->getLastError();
+    tError heuristic_error  = pFeaturesComputer->getLastError();
+
+    OutStream& stream = _pListener->outStream();
+
+    stream << "Test worker #" << _pEvaluator->failedWorker() << " failed on the test image #"
+           << _pEvaluator->failedImage() << endl;
+
+    stream << "    Predictor error: " << getErrorDescription(classifier_error) << endl;
+
+    if (pSandboxedClassifier && !pSandboxedClassifier->getContext().empty())
+        stream << "    Predictor context: " << pSandboxedClassifier->getContext() << endl;
+
+    if (heuristic_error != ERROR_NONE)
+        stream << "    Heuristics error: " << getErrorDescription(heuristic_error) << endl;
+
+    stream << "    (the statistics of the sandboxes of the worker and the crash reports of its plugins are dropped)" << endl;
+
+    return (classifier_error != ERROR_NONE ? classifier_error : heuristic_error);
+}
+
+
+std::string ClassificationTask::checkpointKey(bool bFull)
+{
+    ostringstream signature;
+
+    signature << (isDoingDetection() ? "detection" : "classification") << endl;
+
+    for (unsigned int i = 0; i < COUNT_SEEDS; ++i)
+        signature << _seeds[i] << " ";
+    signature << endl;
+
+    // Experiment parameters
+    tExperimentParametersIterator iter, iterEnd;
+    for (iter = _parameters.begin(), iterEnd = _parameters.end(); iter != iterEnd; ++iter)
+    {
+        signature << iter->first;
+        for (int i = 0; i < iter->second.size(); ++i)
+            signature << " " << iter->second.getString(i);
+        signature << endl;
+    }
+
+    // Predictor (and the content of the model it must load, if any)
+    signature << _strPredictorName << " " << _predictorSeed << endl;
+
+    if (!_strModelFile.empty())
+    {
+        ifstream model(_strModelFile.c_str(), ios::binary);
+        if (model.is_open() && (model.peek() != ifstream::traits_type::eof()))
+            signature << model.rdbuf();
+        signature << endl;
+    }
+
+    if (bFull)
+    {
+        // Predictor parameters
+        for (iter = _predictorParameters.begin(), iterEnd = _predictorParameters.end(); iter != iterEnd; ++iter)
+        {
+            signature << iter->first;
+            for (int i = 0; i < iter->second.size(); ++i)
+                signature << " " << iter->second.getString(i);
+            signature << endl;
+        }
+
+        // Heuristics
+        for (unsigned int i = 0; i < getFeaturesComputer()->nbHeuristics(); ++i)
+            signature << getFeaturesComputer()->heuristicsSet()->heuristicName(i) << endl;
+    }
+
+    return hashSignature(signature.str());
+}
+
+
+bool ClassificationTask::loadCheckpoint()
+{
+    _checkpoint = tCheckpoint();
+
+    if (_strCheckpointFolder.empty())
+        return false;
+
+    DataReader reader;
+    if (!reader.open(_strCheckpointFolder + "checkpoint.state"))
+        return false;
+
+    tCheckpoint checkpoint;
+    string tags[7];
+    int trained = 0;
+
+    reader >> tags[0] >> checkpoint.strKey
+           >> tags[1] >> trained
+           >> tags[2] >> checkpoint.train_error
+           >> tags[3] >> checkpoint.next_test_image
+           >> tags[4] >> checkpoint.nb_errors
+           >> tags[5] >> checkpoint.nb_detected
+           >> tags[6] >> checkpoint.nb_non_detected;
+
+    if ((tags[0] != "KEY") || (tags[1] != "TRAINED") || (tags[2] != "TRAIN_ERROR") ||
+        (tags[3] != "NEXT_TEST_IMAGE") || (tags[4] != "NB_ERRORS") ||
+        (tags[5] != "NB_DETECTED") || (tags[6] != "NB_NON_DETECTED"))
+    {
+        return false;
+    }
+
+    checkpoint.bTrained = (trained != 0);
+
+    _checkpoint = checkpoint;
+
+    return true;
+}
+
+
+bool ClassificationTask::saveCheckpoint(bool bWithModel)
+{
+    if (_strCheckpointFolder.empty())
+        return false;
+
+    // The state is written in a temporary file first, to never leave an
+    // incomplete checkpoint (note: this also creates the checkpoint folder)
+    string strFileName = _strCheckpointFolder + "checkpoint.state";
+
+    DataWriter writer;
+    if (!writer.open(strFileName + ".tmp"))
+        return false;
+
+    // Save the model of the predictor (through the usual mechanism) and keep
+    // a copy of it
+    if (bWithModel)
+    {
+        if (!savePredictorModel() ||
+            !copyFile(_strReportFolder + "predictor.model", _strCheckpointFolder + "predictor.model"))
+        {
+            writer.deleteFile();
+            return false;
+        }
+
+        if (!copyFile(_strReportFolder + "predictor.internal", _strCheckpointFolder + "predictor.internal"))
+            remove((_strCheckpointFolder + "predictor.internal").c_str());
+    }
+
+    writer << Mash::setprecision(numeric_limits<scalar_t>::digits10 + 3)
+           << "KEY " << _checkpoint.strKey << endl
+           << "TRAINED " << (_checkpoint.bTrained ? 1 : 0) << endl
+           << "TRAIN_ERROR " << _checkpoint.train_error << endl
+           << "NEXT_TEST_IMAGE " << _checkpoint.next_test_image << endl
+           << "NB_ERRORS " << _checkpoint.nb_errors << endl
+           << "NB_DETECTED " << _checkpoint.nb_detected << endl
+           << "NB_NON_DETECTED " << _checkpoint.nb_non_detected << endl;
+
+    writer.close();
+
+    return (rename((strFileName + ".tmp").c_str(), strFileName.c_str()) == 0);
+}
+
+
+tError ClassificationTask::discardUnusableCheckpoint()
+{
+    // Assertions
+    assert(_pListener);
+    assert(_pInstrumentsSet);
+
+    // Nothing to resume from
+    if (_strCheckpointFolder.empty() || (_checkpoint.strKey != checkpointKey(true)) ||
+        (!_bModelFromCheckpoint && (_checkpoint.next_test_image == 0)))
+    {
+        return ERROR_NONE;
+    }
+
+    // The instruments only miss the per-image events
+    const unsigned int events = Instrument::EVENT_CLASSIFIER_CLASSIFICATION_DONE |
+                                Instrument::EVENT_FEATURES_COMPUTED_BY_CLASSIFIER;
+
+    if ((_pInstrumentsSet->subscribedEvents() & events) == 0)
+        return ERROR_NONE;
+
+    _pListener->outStream() << "Not resuming from the checkpoint in '" << _strCheckpointFolder
+                            << "': the instruments need the per-image events sent before it" << endl;
+
+    _checkpoint = tCheckpoint();
+
+    if (!_bModelFromCheckpoint)
+        return ERROR_NONE;
+
+    _bModelFromCheckpoint = false;
+
+    // The plugin of the predictor was loaded with the model of the checkpoint:
+    // load it again without it, in a new delegate, so it is trained exactly
+    // like in a run without checkpoint
+    _pListener->outStream() << "Loading the predictor again, without the model of the checkpoint" << endl;
+
+    delete _pClassifierDelegate;
+    _pClassifierDelegate = 0;
+
+    tError error = createClassifierDelegate();
+    if (error != ERROR_NONE)
+        return error;
+
+    error = loadPredictorPlugin(_strModelFile, _strInternalDataFile);
+    if (error != ERROR_NONE)
+        return error;
+
+    if (_bPredictorSetup && !_pClassifierDelegate->setup(_predictorParameters))
+    {
+        if (_pClassifierDelegate->getLastError() == ERROR_CHANNEL_SLAVE_CRASHED)
+            return ERROR_CLASSIFIER_CRASHED;
+        else
+            return _pClassifierDelegate->getLastError();
+    }
+
+    return ERROR_NONE;
+}
+
+
+tError ClassificationTask::createClassifierDelegate()
+{
+    // Assertions
+    assert(!_pClassifierDelegate);
+
+    if (_bSandboxedPredictor)
+    {
+        SandboxedClassifier* pDelegate = new SandboxedClassifier();
+        _pClassifierDelegate = pDelegate;
+
+        if (!pDelegate->createSandbox(_predictorSandboxConfiguration))
+            return pDelegate->getLastError();
+
+        if (_sharedFeatures.isValid())
+            pDelegate->setSharedFeaturesBuffer(&_sharedFeatures);
+    }
+    else
+    {
+        TrustedClassifier* pDelegate = new TrustedClassifier();
+        _pClassifierDelegate = pDelegate;
+
+        pDelegate->configure(_strLogFolder, _strReportFolder);
+    }
+
+    if (!_pClassifierDelegate->setClassifiersFolder(_strPredictorsFolder))
+        return _pClassifierDelegate->getLastError();
+
+    return ERROR_NONE;
+}
+
+
+tError ClassificationTask::loadPredictorPlugin(const std::string& strModelFile,
+                                               const std::string& strInternalDataFile)
+{
+    // Assertions
+    assert(_pClassifierDelegate);
+
+    if (!_pClassifierDelegate->loadClassifierPlugin(_strPredictorName, strModelFile, strInternalDataFile))
+    {
+        if (_pClassifierDelegate->getLastError() == ERROR_CHANNEL_SLAVE_CRASHED)
+            return ERROR_CLASSIFIER_CRASHED;
+        else
+            return _pClassifierDelegate->getLastError();
+    }
+
+    _pClassifierDelegate->setNotifier(&_notifier);
+    _pClassifierDelegate->setSeed(_predictorSeed);
+
+    return ERROR_NONE;
+}
+
+
+void ClassificationTask::setupFeaturesStore()
+{
+    if (!_pFeaturesStore)
+        return;
+
+    FeaturesComputer* pComputer = getFeaturesComputer();
+    tStringList sources = StringUtils::split(_strHeuristicsSources, ";");
+
+    for (unsigned int i = 0; i < pComputer->nbHeuristics(); ++i)
+    {
+        string strName = pComputer->heuristicsSet()->heuristicName(i);
+        string strHash;
+
+        tStringList::iterator iter, iterEnd;
+        for (iter = sources.begin(), iterEnd = sources.end();
+             (iter != iterEnd) && strHash.empty(); ++iter)
+        {
+            if (iter->empty())
+                continue;
+
+            string strFolder = *iter;
+            if (strFolder[strFolder.size() - 1] != '/')
+                strFolder += "/";
+
+            strHash = FeaturesStoreClient::hashFile(strFolder + HeuristicsManager::getSourceFilePath(strName));
+        }
+
+        if (strHash.empty())
+        {
+            strHash = FeaturesStoreClient::hashFile(_strHeuristicsLibraries +
+                                                    HeuristicsManager::getDynamicLibraryPath(strName));
+        }
+
+        // The features of a heuristic that can't be identified aren't stored
+        _pFeaturesStore->setHeuristic(i, strHash, pComputer->heuristicSeed(i));
+    }
+
+    _inputSet.setFeaturesStore(_pFeaturesStore);
+}
@@ -33,8 +33,11 @@
 #define _CLASSIFICATION_TASK_H_
 
 #include "task_controller.h"
+#include "parallel_evaluator.h"
 #include <mash-classification/classifier_input_set.h>
 #include <mash-classification/classifier_delegate.h>
+#include <mash-classification/features_store_client.h>
+#include <mash/shared_features_buffer.h>
 #include <mash-instrumentation/classifier_input_set_listener.h>
 
 
@@ -73,6 +76,110 @@ protected:
     //----------------------------------------------------------------------
     bool classify(Mash::scalar_t* result, bool bDoingTest);
 
+    //----------------------------------------------------------------------
+    /// @brief  Retrieve the classifier responses at the given positions of
+    ///         an image
+    ///
+    /// When testing, the responses are computed by the workers of the
+    /// Parallel Evaluator (if any)
+    //----------------------------------------------------------------------
+    bool computeResults(unsigned int image, const Mash::tCoordinatesList& positions,
+                        Mash::Classifier::tClassificationResultsList& results,
+                        bool bDoingTest);
+
+    //----------------------------------------------------------------------
+    /// @brief  Create the Parallel Evaluator used to distribute the test
+    ///         images among several pairs of sandboxes, with the model of
+    ///         the predictor loaded in each classifier
+    ///
+    /// @return 'false' if the workers couldn't be created (the test images
+    ///         must then be evaluated sequentially)
+    //----------------------------------------------------------------------
+    bool createTestWorkers();
+
+    //----------------------------------------------------------------------
+    /// @brief  Create one worker of the Parallel Evaluator, using the same
+    ///         settings and seeds than the main Input Set and classifier
+    //----------------------------------------------------------------------
+    bool createTestWorker(unsigned int index, const std::string& strModelFile,
+                          const std::string& strInternalDataFile);
+
+    //----------------------------------------------------------------------
+    /// @brief  Write the context of the failure of a worker of the Parallel
+    ///         Evaluator in the experiment log
+    ///
+    /// @return The error of the worker
+    ///
+    /// @remark The statistics of the sandboxes of the worker and the crash
+    ///         reports of its plugins are dropped with it: only this
+    ///         context remains
+    //----------------------------------------------------------------------
+    Mash::tError logTestWorkerFailure();
+
+    //----------------------------------------------------------------------
+    /// @brief  Returns the key identifying the current experiment in the
+    ///         checkpoints
+    ///
+    /// @param  bFull   Indicates if the settings only known once the
+    ///                 experiment is started (predictor parameters and
+    ///                 heuristics) must be taken into account
+    //----------------------------------------------------------------------
+    std::string checkpointKey(bool bFull);
+
+    //----------------------------------------------------------------------
+    /// @brief  Load the last checkpoint saved in the checkpoint folder
+    ///
+    /// @return 'false' if there is no (valid) checkpoint
+    //----------------------------------------------------------------------
+    bool loadCheckpoint();
+
+    //----------------------------------------------------------------------
+    /// @brief  Save the current checkpoint in the checkpoint folder
+    ///
+    /// @param  bWithModel  Indicates if the model of the predictor must be
+    ///                     saved too
+    //----------------------------------------------------------------------
+    bool saveCheckpoint(bool bWithModel = false);
+
+    //----------------------------------------------------------------------
+    /// @brief  Discard the checkpoint of a previous run of the experiment
+    ///         if the instruments can't resume from it
+    ///
+    /// The per-image events sent before the checkpoint aren't recorded, so
+    /// the instruments subscribed to them would miss some: the experiment is
+    /// started from scratch instead (and the experiment log says so). If the
+    /// plugin of the predictor was loaded with the model of the checkpoint,
+    /// it is loaded again (and setup) without it.
+    ///
+    /// @return The error that occured when loading the predictor again
+    //----------------------------------------------------------------------
+    Mash::tError discardUnusableCheckpoint();
+
+    //----------------------------------------------------------------------
+    /// @brief  Create the delegate of the classifier (sandboxed or not)
+    //----------------------------------------------------------------------
+    Mash::tError createClassifierDelegate();
+
+    //----------------------------------------------------------------------
+    /// @brief  Load the plugin of the predictor in the delegate of the
+    ///         classifier
+    ///
+    /// @param  strModelFile        The model given to the plugin (if any)
+    /// @param  strInternalDataFile The internal data given to the plugin
+    ///                             (if any)
+    //----------------------------------------------------------------------
+    Mash::tError loadPredictorPlugin(const std::string& strModelFile,
+                                     const std::string& strInternalDataFile);
+
+    //----------------------------------------------------------------------
+    /// @brief  Tell the features store about the heuristics used by the
+    ///         experiment, and let the Input Set use it
+    ///
+    /// The features of a heuristic are identified by the hash of its source
+    /// code (or of its dynamic library if the source code isn't available)
+    //----------------------------------------------------------------------
+    void setupFeaturesStore();
+
 
     //_____ Implementation of TaskController __________
 public:
@@ -155,6 +262,11 @@ public:
     virtual int getLogFileContent(unsigned int index, std::string& strName,
                                   unsigned char** pBuffer, int64_t max_size = 0);
 
+    //--------------------------------------------------------------------------
+    /// @copy TaskController::getIPCStatisticsReport
+    //--------------------------------------------------------------------------
+    virtual std::string getIPCStatisticsReport();
+
     //--------------------------------------------------------------------------
     /// @copy TaskController::fillReport
     //--------------------------------------------------------------------------
@@ -173,14 +285,72 @@ public:
         COUNT_SEEDS
     };
     
+    // Progress of the experiment saved in the checkpoints
+    struct tCheckpoint
+    {
+        tCheckpoint()
+        : bTrained(false), train_error(0), next_test_image(0), nb_errors(0),
+          nb_detected(0), nb_non_detected(0)
+        {
+        }
+
+        std::string     strKey;             ///< Key of the experiment
+        bool            bTrained;           ///< Indicates if the model of the trained
+                                            ///< predictor was saved
+        Mash::scalar_t  train_error;        ///< Train error of the predictor
+        unsigned int    next_test_image;    ///< Index of the first test image not
+                                            ///< evaluated yet
+        unsigned int    nb_errors;          ///< (Classification) Number of errors on
+                                            ///< the test images already evaluated
+        unsigned int    nb_detected;        ///< (Detection) Number of objects correctly
+                                            ///< detected in those images
+        unsigned int    nb_non_detected;    ///< (Detection) Number of objects incorrectly
+                                            ///< or not detected in those images
+    };
+
 
     //_____ Attributes __________
 protected:
+    Mash::SharedFeaturesBuffer          _sharedFeatures;
     Mash::IClassifierDelegate*          _pClassifierDelegate;
     Mash::ClassifierInputSet            _inputSet;
     Mash::ClassifierInputSetListener    _listener;
     unsigned int                        _seeds[COUNT_SEEDS];
     bool                                _bUseModel;
+    bool                                _bTrained;
+    bool                                _bModelSaved;
+
+    // Settings needed to create the delegate of the classifier again
+    bool                                _bSandboxedPredictor;
+    Mash::tSandboxConfiguration         _predictorSandboxConfiguration;
+    std::string                         _strPredictorsFolder;
+    std::string                         _strLogFolder;
+    std::string                         _strReportFolder;
+
+    // Settings needed to replicate the setup in the workers evaluating the
+    // test images
+    ParallelEvaluator*                  _pEvaluator;
+    unsigned int                        _nbTestWorkers;
+    Mash::tSandboxConfiguration         _heuristicsSandboxConfiguration;
+    std::string                         _strHeuristicsFolder;
+    Mash::tExperimentParametersList     _parameters;
+    std::string                         _strPredictorName;
+    std::string                         _strModelFile;
+    std::string                         _strInternalDataFile;
+    unsigned int                        _predictorSeed;
+    Mash::tExperimentParametersList     _predictorParameters;
+    bool                                _bPredictorSetup;
+
+    // Checkpoints of the progress of the experiment
+    std::string                         _strCheckpointsFolder;
+    std::string                         _strCheckpointFolder;
+    tCheckpoint                         _checkpoint;
+    bool                                _bModelFromCheckpoint;
+
+    // Store of the features shared with the other experiment servers
+    Mash::FeaturesStoreClient*          _pFeaturesStore;
+    std::string                         _strHeuristicsSources;
+    std::string                         _strHeuristicsLibraries;
 };
 
 #endif
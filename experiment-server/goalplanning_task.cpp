@@ -643,6 +643,22 @@ int GoalPlanningTask::getLogFileContent(unsigned int index, std::string& strName
 }
 
 
+std::string GoalPlanningTask::getIPCStatisticsReport()
+{
+    string strReport;
+
+    SandboxedHeuristicsSet* pSandboxedHeuristicsSet = dynamic_cast<SandboxedHeuristicsSet*>(getFeaturesComputer()->heuristicsSet());
+    if (pSandboxedHeuristicsSet && pSandboxedHeuristicsSet->sandboxController()->getStatistics())
+        strReport += "SANDBOX heuristics\n" + pSandboxedHeuristicsSet->sandboxController()->getStatisticsReport();
+
+    SandboxedPlanner* pSandboxedPlanner = dynamic_cast<SandboxedPlanner*>(_pPlannerDelegate);
+    if (pSandboxedPlanner && pSandboxedPlanner->sandboxController()->getStatistics())
+        strReport += "SANDBOX goalplanner\n" + pSandboxedPlanner->sandboxController()->getStatisticsReport();
+
+    return strReport + TaskController::getIPCStatisticsReport();
+}
+
+
 void GoalPlanningTask::fillReport(const std::string& strReportFolder)
 {
 }
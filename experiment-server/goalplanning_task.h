@@ -137,6 +137,11 @@ public:
     virtual int getLogFileContent(unsigned int index, std::string& strName,
                                   unsigned char** pBuffer, int64_t max_size = 0);
 
+    //--------------------------------------------------------------------------
+    /// @copy TaskController::getIPCStatisticsReport
+    //--------------------------------------------------------------------------
+    virtual std::string getIPCStatisticsReport();
+
     //--------------------------------------------------------------------------
     /// @copy TaskController::fillReport
     //--------------------------------------------------------------------------
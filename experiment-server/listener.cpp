@@ -60,6 +60,7 @@ using namespace Mash;
 
 Listener::tCommandHandlersList  Listener::handlers;
 tListenerConfiguration          Listener::configuration;
+ClientPool                      Listener::applicationServers;
 
 
 /****************************** UTILITY FUNCTIONS *****************************/
@@ -179,7 +180,9 @@ Listener::~Listener()
     Client* pClient = (_taskController ? _taskController->getClient() : 0);
 
     delete _taskController;
-    delete pClient;
+
+    if (pClient)
+        releaseApplicationServer(pClient, true);
 
     _clientStream.deleteFile();
 }
@@ -206,10 +209,10 @@ ServerListener::tAction Listener::handleCommand(const std::string& strCommand,
         ((_mode == MODE_INSTRUMENT_SETUP) && (strCommand == "END_INSTRUMENT_SETUP")) ||
         ((_mode == MODE_PREDICTOR_SETUP) && (strCommand == "END_PREDICTOR_SETUP")))
     {    
-        tCommandHandlersIterator iter = handlers.find(strCommand);
-        if (iter != handlers.end())
+        const tCommandHandler* pHandler = handlers.find(strCommand);
+        if (pHandler)
         {
-            tCommandHandler handler = iter->second;
+            tCommandHandler handler = *pHandler;
             return (this->*handler)(arguments);
         }
 
@@ -322,6 +325,59 @@ bool Listener::sendData(const unsigned char* data, int size)
 }
 
 
+bool Listener::sendResponse(const std::string& strResponse,
+                            const ArgumentsList& arguments,
+                            const unsigned char* data, int size)
+{
+    // Test if we are in server or standalone mode
+    if (!configuration.bStandalone)
+        return ServerListener::sendResponse(strResponse, arguments, data, size);
+
+    return sendResponse(strResponse, arguments) && sendData(data, size);
+}
+
+
+bool Listener::sendFile(const std::string& strResponse,
+                        const ArgumentsList& arguments,
+                        const std::string& strFileName,
+                        int64_t offset, int64_t size,
+                        const std::string& strPrefix)
+{
+    // Test if we are in server or standalone mode
+    if (!configuration.bStandalone)
+    {
+        return ServerListener::sendFile(strResponse, arguments, strFileName,
+                                        offset, size, strPrefix);
+    }
+
+    if (size < 0)
+    {
+        struct stat infos;
+        if (stat(strFileName.c_str(), &infos) != 0)
+            return false;
+
+        size = infos.st_size - offset;
+    }
+
+    FILE* pFile = fopen(strFileName.c_str(), "rb");
+    if (!pFile)
+        return false;
+
+    std::vector<unsigned char> buffer(strPrefix.size() + size);
+    memcpy(&buffer[0], strPrefix.data(), strPrefix.size());
+
+    fseek(pFile, offset, SEEK_SET);
+    size_t nb = fread(&buffer[strPrefix.size()], sizeof(unsigned char), size, pFile);
+    fclose(pFile);
+
+    if ((int64_t) nb != size)
+        return false;
+
+    return sendResponse(strResponse, arguments) &&
+           (buffer.empty() || sendData(&buffer[0], buffer.size()));
+}
+
+
 /******************************* STATIC METHODS *******************************/
 
 void Listener::initialize(const tListenerConfiguration& configuration)
@@ -396,6 +452,16 @@ void Listener::initialize(const tListenerConfiguration& configuration)
         removeDirectoryContent(Listener::configuration.strCaptureDir);
     }
 
+    // Note: the content of the checkpoint folder is kept, to be able to resume
+    // the experiments
+    if (Listener::configuration.strCheckpointDir.length() > 0)
+    {
+        if (Listener::configuration.strCheckpointDir.at(Listener::configuration.strCheckpointDir.length() - 1) != '/')
+            Listener::configuration.strCheckpointDir += "/";
+
+        makedirs(Listener::configuration.strCheckpointDir);
+    }
+
     if (Listener::configuration.strRepository.length() == 0)
         Listener::configuration.strRepository = "heuristics.git";
     else if (Listener::configuration.strRepository.at(Listener::configuration.strRepository.length() - 1) == '/')
@@ -538,28 +604,10 @@ ServerListener::tAction Listener::handleLogsCommand(const ArgumentsList& argumen
     
     unsigned char* pBuffer = 0;
     int size = 0;
-        
-    size = _outStream.dump(&pBuffer, MAX_SIZE);
-    if (size > 0)
-    {
-        ArgumentsList args;
-        args.add("ExperimentServer.log");
-        args.add(size);
-        sendResponse("LOG_FILE", args);
-        sendData((const unsigned char*) pBuffer, size);
-        delete[] pBuffer;
-    }
 
-    size = _clientStream.dump(&pBuffer, MAX_SIZE);
-    if (size > 0)
-    {
-        ArgumentsList args;
-        args.add("ExperimentServerClient.log");
-        args.add(size);
-        sendResponse("LOG_FILE", args);
-        sendData((const unsigned char*) pBuffer, size);
-        delete[] pBuffer;
-    }
+    // Our own log files are sent directly from the disk
+    sendLogFile(_outStream, "ExperimentServer.log", MAX_SIZE);
+    sendLogFile(_clientStream, "ExperimentServerClient.log", MAX_SIZE);
 
     for (unsigned int i = 0; i < _taskController->getNbLogFiles(); ++i)
     {
@@ -570,8 +618,7 @@ ServerListener::tAction Listener::handleLogsCommand(const ArgumentsList& argumen
             ArgumentsList args;
             args.add(strName + ".log");
             args.add(size);
-            sendResponse("LOG_FILE", args);
-            sendData((const unsigned char*) pBuffer, size);
+            sendResponse("LOG_FILE", args, (const unsigned char*) pBuffer, size);
             delete[] pBuffer;
         }
     }
@@ -603,8 +650,7 @@ ServerListener::tAction Listener::handleLogsCommand(const ArgumentsList& argumen
             ArgumentsList args;
             args.add(responseArgs.getString(0));
             args.add(size);
-            sendResponse("LOG_FILE", args);
-            sendData(pBuffer, size);
+            sendResponse("LOG_FILE", args, pBuffer, size);
 
             delete[] pBuffer;
         }
@@ -626,16 +672,20 @@ ServerListener::tAction Listener::handleSleepCommand(const ArgumentsList& argume
 
 ServerListener::tAction Listener::handleResetCommand(const ArgumentsList& arguments)
 {
-    if (_taskController && _taskController->getClient() &&
-        _taskController->getClient()->sendCommand("RESET", ArgumentsList()))
+    Client* pClient = (_taskController ? _taskController->getClient() : 0);
+
+    // When the connections are reused, the application server is left in the
+    // state described by the tag of the connection (the next experiment
+    // doesn't need to select the same database again)
+    if (pClient && (!configuration.bReuseConnections || pClient->tag().empty()) &&
+        pClient->sendCommand("RESET", ArgumentsList()))
     {
         string          strResponse;
         ArgumentsList   responseArgs;
 
-        _taskController->getClient()->waitResponse(&strResponse, &responseArgs);
+        pClient->waitResponse(&strResponse, &responseArgs);
+        pClient->setTag("");
     }
-
-    Client* pClient = (_taskController ? _taskController->getClient() : 0);
     bool bDetection = (dynamic_cast<ClassificationTask*>(_taskController) ?
                             dynamic_cast<ClassificationTask*>(_taskController)->isDoingDetection() :
                             false);
@@ -682,7 +732,7 @@ ServerListener::tAction Listener::handleResetCommand(const ArgumentsList& argume
         if (ret != ERROR_NONE)
         {
             delete _taskController;
-            delete pClient;
+            releaseApplicationServer(pClient, false);
             
             _taskController = 0;
             _task = TASK_NONE;
@@ -834,11 +884,10 @@ ServerListener::tAction Listener::handleUseApplicationServerCommand(const Argume
     }
 
     // Connect to the application server
-    Client* pClient = new Client(&_clientStream);
+    Client* pClient = connectToApplicationServer(arguments.getString(0), arguments.getInt(1));
     
-    if (!pClient->connect(arguments.getString(0), arguments.getInt(1)))
+    if (!pClient)
     {
-        delete pClient;
         
         if (!sendResponse("FAILED_TO_CONNECT", arguments))
             return ACTION_CLOSE_CONNECTION;
@@ -849,7 +898,7 @@ ServerListener::tAction Listener::handleUseApplicationServerCommand(const Argume
     // Check that the application server isn't busy
     if (!pClient->sendCommand("STATUS", ArgumentsList()))
     {
-        delete pClient;
+        releaseApplicationServer(pClient, false);
 
         if (!sendResponse("ERROR", ArgumentsList("Failed to communicate with the application server")))
             return ACTION_CLOSE_CONNECTION;
@@ -859,7 +908,7 @@ ServerListener::tAction Listener::handleUseApplicationServerCommand(const Argume
     
     if (!pClient->waitResponse(&strResponse, &responseArgs))
     {
-        delete pClient;
+        releaseApplicationServer(pClient, false);
         
         if (!sendResponse("ERROR", ArgumentsList("Failed to communicate with the application server")))
             return ACTION_CLOSE_CONNECTION;
@@ -869,7 +918,7 @@ ServerListener::tAction Listener::handleUseApplicationServerCommand(const Argume
 
     if (strResponse != "READY")
     {
-        delete pClient;
+        releaseApplicationServer(pClient, false);
         
         if (!sendResponse("APPLICATION_SERVER_BUSY", ArgumentsList()))
             return ACTION_CLOSE_CONNECTION;
@@ -882,7 +931,7 @@ ServerListener::tAction Listener::handleUseApplicationServerCommand(const Argume
     if (ret != ERROR_NONE)
     {
         delete _taskController;
-        delete pClient;
+        releaseApplicationServer(pClient, false);
             
         _taskController = 0;
         _task = TASK_NONE;
@@ -893,6 +942,8 @@ ServerListener::tAction Listener::handleUseApplicationServerCommand(const Argume
         return ACTION_NONE;
     }
 
+    _taskController->setApplicationServerAddress(arguments.getString(0), arguments.getInt(1));
+
 
     if (!sendResponse("OK", ArgumentsList()))
         return ACTION_CLOSE_CONNECTION;
@@ -1844,33 +1895,15 @@ ServerListener::tAction Listener::handleReportDataCommand(const ArgumentsList& a
     chdir(current_directory);
     free(current_directory);
 
-    // Sends the reports to the client
-    FILE* pFile = fopen((configuration.strOutputDir + "reports.tar.gz").c_str(), "rb");
-    fseek(pFile, 0, SEEK_END);
-    size_t size = ftell(pFile);
-    fseek(pFile, 0, SEEK_SET);
+    // Sends the reports to the client (directly from the disk)
+    string strFileName = configuration.strOutputDir + "reports.tar.gz";
 
-    bool result = sendResponse("DATA", ArgumentsList((int) size));
-    
-    const unsigned int MAX_SIZE = 1024 * 1024;
-    unsigned char buffer[MAX_SIZE];
-    size_t counter = 0;
-    
-    while (result && (counter < size))
-    {
-        size_t nb = fread(buffer, sizeof(unsigned char), MAX_SIZE, pFile);
-        if (nb <= 0)
-        {
-            result = false;
-            break;
-        }
+    struct stat infos;
+    if (stat(strFileName.c_str(), &infos) != 0)
+        return ACTION_CLOSE_CONNECTION;
 
-        result = sendData(buffer, nb);
-
-        counter += nb;
-    }
-    
-    fclose(pFile);
+    bool result = sendFile("DATA", ArgumentsList((int) infos.st_size), strFileName,
+                           0, infos.st_size);
 
     return (result ? ACTION_NONE : ACTION_CLOSE_CONNECTION);
 }
@@ -1911,6 +1944,7 @@ tError Listener::setupTaskController()
     predictorSandboxConfiguration.strScriptsDir         = configuration.strSandboxScriptsDir;
     predictorSandboxConfiguration.strTempDir            = configuration.strSandboxTempDir;
     predictorSandboxConfiguration.bDeleteAllLogFiles    = !configuration.bStandalone;
+    predictorSandboxConfiguration.bSeccomp              = configuration.bSandboxSeccomp;
 
     if (!configuration.strCoreDumpTemplate.empty())
         predictorSandboxConfiguration.strCoreDumpTemplate = configuration.strCoreDumpTemplate;
@@ -1942,6 +1976,11 @@ tError Listener::setupTaskController()
     cfg.strReportFolder         = configuration.strOutputDir;
     cfg.strCaptureFolder        = ((_task == TASK_GOALPLANNING) && configuration.bStandalone ? 
                                         configuration.strCaptureDir : "");
+    cfg.bSharedFeatures         = configuration.bSharedFeatures;
+    cfg.nbTestWorkers           = configuration.nbTestWorkers;
+    cfg.strCheckpointFolder     = (_task == TASK_CLASSIFICATION ? configuration.strCheckpointDir : "");
+    cfg.strFeaturesStore        = (_task == TASK_CLASSIFICATION ? configuration.strFeaturesStore : "");
+    cfg.strHeuristicsSources    = configuration.strSourceHeuristics;
 
     cfg.predictorSandboxConfiguration   = (configuration.sandboxingMechanisms & SANDBOXING_PREDICTOR ?
                                                 &predictorSandboxConfiguration : 0);
@@ -1994,9 +2033,101 @@ void Listener::generateReports()
     }
     
     
+    // Statistics about the messages exchanged with the sandboxes
+    string strIPCStatistics = _taskController->getIPCStatisticsReport();
+
+    if (!strIPCStatistics.empty())
+    {
+        _outStream << "IPC statistics:" << endl << strIPCStatistics;
+
+        if (writer.open(configuration.strOutputDir + "mash/ipc_statistics.data"))
+            writer << strIPCStatistics;
+    }
+    
     // Ask the predictor to save its model if necessary
     if (_bTrainingDone)
         _taskController->savePredictorModel();
     
     _bReportsGenerated = true;
 }
+
+
+Client* Listener::connectToApplicationServer(const std::string& strAddress,
+                                             unsigned int port)
+{
+    if (!configuration.bReuseConnections)
+    {
+        Client* pClient = new Client(&_clientStream);
+
+        if (!pClient->connect(strAddress, port))
+        {
+            delete pClient;
+            return 0;
+        }
+
+        return pClient;
+    }
+
+    // Look for a connection left with the database of the previous experiment
+    // selected (see ImageDatabase::setDatabase())
+    bool bReused = false;
+
+    Client* pClient = applicationServers.acquire(strAddress, port, _strApplicationServerTag,
+                                                 &_clientStream, &bReused);
+
+    if (pClient && bReused)
+    {
+        _outStream << "Reusing the connection to the application server '" << strAddress << ":" << port << "'";
+
+        if (!pClient->tag().empty())
+            _outStream << " (database: " << pClient->tag() << ")";
+
+        _outStream << endl;
+    }
+
+    return pClient;
+}
+
+
+void Listener::releaseApplicationServer(Client* pClient, bool bReusable)
+{
+    // Assertions
+    assert(pClient);
+
+    if (!configuration.bReuseConnections)
+    {
+        delete pClient;
+        return;
+    }
+
+    // The application server is left in its current state, described by the
+    // tag of the connection
+    if (bReusable)
+    {
+        _strApplicationServerTag = pClient->tag();
+        applicationServers.release(pClient, pClient->tag());
+    }
+    else
+    {
+        applicationServers.discard(pClient);
+    }
+}
+
+
+bool Listener::sendLogFile(OutStream& stream, const std::string& strName,
+                           int64_t maxSize)
+{
+    int64_t offset = 0;
+    int64_t size = stream.locateDump(&offset, maxSize);
+    if (size <= 0)
+        return true;
+
+    // Mark the truncated files like OutStream::dump() does
+    string strPrefix = (offset > 0 ? "...\n" : "");
+
+    ArgumentsList args;
+    args.add(strName);
+    args.add((int) (strPrefix.size() + size));
+
+    return sendFile("LOG_FILE", args, stream.getFileName(), offset, size, strPrefix);
+}
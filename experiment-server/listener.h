@@ -34,6 +34,8 @@
 
 #include "task_controller.h"
 #include <mash-network/server_listener.h>
+#include <mash-network/commands_table.h>
+#include <mash-network/client_pool.h>
 #include <tinyxml/tinyxml.h>
 #include <map>
 
@@ -55,7 +57,8 @@ struct tListenerConfiguration
       strPlannersDir("goalplanners/"), strInstrumentsDir("instruments/"),
       sandboxingMechanisms(SANDBOXING_HEURISTICS | SANDBOXING_PREDICTOR | SANDBOXING_INSTRUMENTS),
       strCoreDumpTemplate(""), strSandboxUsername(""), strSandboxJailDir("jail"), strSandboxScriptsDir(""),
-      strSandboxTempDir("./")
+      strSandboxTempDir("./"), bSandboxSeccomp(false), bSharedFeatures(false), nbTestWorkers(0),
+      strCheckpointDir(""), strFeaturesStore(""), bReuseConnections(false)
     {
     }
     
@@ -97,6 +100,21 @@ struct tListenerConfiguration
     std::string     strSourceClassifiers;   ///< Directory containing the source code of the classifiers
     std::string     strSourcePlanners;      ///< Directory containing the source code of the goal-planners
     std::string     strSourceInstruments;   ///< Directory containing the source code of the instruments
+    bool            bSandboxSeccomp;        ///< Indicates if the sandboxes must confine the plugins with a
+                                            ///  system call filter instead of intercepting their calls
+    bool            bSharedFeatures;        ///< Indicates if the features must be transferred between the
+                                            ///  sandboxes through shared memory
+    unsigned int    nbTestWorkers;          ///< Number of pairs of sandboxes (predictor and heuristics)
+                                            ///  among which the test images are distributed
+    std::string     strCheckpointDir;       ///< The directory into which the progress of the experiments
+                                            ///  is saved (empty to disable)
+    std::string     strFeaturesStore;       ///< Address (<host>:<port>) of the features server (empty
+                                            ///  to disable)
+
+    // Application servers
+    bool            bReuseConnections;      ///< (Server mode only) Indicates if the connections to the
+                                            ///  application servers are kept alive between the experiments
+                                            ///  of a client (without resetting the application server)
 };
 
 
@@ -128,11 +146,22 @@ public:
 
     bool sendData(const unsigned char* data, int size);
 
+    bool sendResponse(const std::string& strResponse,
+                      const Mash::ArgumentsList& arguments,
+                      const unsigned char* data, int size);
+
+    bool sendFile(const std::string& strResponse,
+                  const Mash::ArgumentsList& arguments,
+                  const std::string& strFileName,
+                  int64_t offset = 0, int64_t size = -1,
+                  const std::string& strPrefix = "");
+
 
     //_____ Methods __________
 public:
     inline bool failure() const { return _error; }
     inline tTask task() const { return _task; }
+    inline Mash::OutStream& outStream() { return _outStream; }
 
 
     //_____ Static methods __________
@@ -187,14 +216,17 @@ private:
 private:
     Mash::tError setupTaskController();
     void generateReports();
+    bool sendLogFile(Mash::OutStream& stream, const std::string& strName,
+                     int64_t maxSize);
+    Mash::Client* connectToApplicationServer(const std::string& strAddress, unsigned int port);
+    void releaseApplicationServer(Mash::Client* pClient, bool bReusable);
 
 
     //_____ Internal types __________
 private:
     typedef tAction (Listener::*tCommandHandler)(const Mash::ArgumentsList&);
     
-    typedef std::map<std::string, tCommandHandler>  tCommandHandlersList;
-    typedef tCommandHandlersList::iterator          tCommandHandlersIterator;
+    typedef Mash::CommandsTable<tCommandHandler>    tCommandHandlersList;
 
     enum tMode
     {
@@ -209,6 +241,7 @@ private:
 private:
     static tCommandHandlersList     handlers;
     static tListenerConfiguration   configuration;
+    static Mash::ClientPool         applicationServers;
 
     bool                            _bGlobalSeedSelected;
     tTask                           _task;
@@ -225,6 +258,7 @@ private:
     TiXmlDocument                   _xmlReportDocument;
     bool                            _bExperimentDone;
     bool                            _bReportsGenerated;
+    std::string                     _strApplicationServerTag;
 };
 
 #endif
@@ -67,10 +67,16 @@ enum tOptions
     OPT_SANDBOX_JAIL_DIR,
     OPT_SANDBOX_SCRIPTS_DIR,
     OPT_SANDBOX_TEMP_DIR,
+    OPT_SANDBOX_SECCOMP,
     OPT_SANDBOX_SOURCE_HEURISTICS,
     OPT_SANDBOX_SOURCE_CLASSIFIERS,
     OPT_SANDBOX_SOURCE_GOALPLANNERS,
     OPT_SANDBOX_SOURCE_INSTRUMENTS,
+    OPT_SHARED_FEATURES,
+    OPT_TEST_WORKERS,
+    OPT_CHECKPOINT_DIR,
+    OPT_FEATURES_STORE,
+    OPT_REUSE_CONNECTIONS,
 };
 
 
@@ -124,10 +130,16 @@ CSimpleOpt::SOption COMMAND_LINE_OPTIONS[] =
     { OPT_SANDBOX_JAIL_DIR,             "--sandbox-jaildir",            SO_REQ_CMB },
     { OPT_SANDBOX_SCRIPTS_DIR,          "--sandbox-scriptsdir",         SO_REQ_CMB },
     { OPT_SANDBOX_TEMP_DIR,             "--sandbox-tempdir",            SO_REQ_CMB },
+    { OPT_SANDBOX_SECCOMP,              "--sandbox-seccomp",            SO_NONE },
     { OPT_SANDBOX_SOURCE_HEURISTICS,    "--source-heuristics",          SO_REQ_CMB },
     { OPT_SANDBOX_SOURCE_CLASSIFIERS,   "--source-classifiers",         SO_REQ_CMB },
     { OPT_SANDBOX_SOURCE_GOALPLANNERS,  "--source-goalplanners",        SO_REQ_CMB },
     { OPT_SANDBOX_SOURCE_INSTRUMENTS,   "--source-instruments",         SO_REQ_CMB },
+    { OPT_SHARED_FEATURES,              "--shared-features",            SO_NONE },
+    { OPT_TEST_WORKERS,                 "--test-workers",               SO_REQ_CMB },
+    { OPT_CHECKPOINT_DIR,               "--checkpoint-folder",          SO_REQ_CMB },
+    { OPT_FEATURES_STORE,               "--features-store",             SO_REQ_CMB },
+    { OPT_REUSE_CONNECTIONS,            "--reuse-connections",          SO_NONE },
 
     SO_END_OF_OPTIONS
 };
@@ -153,6 +165,10 @@ void showUsage(const std::string& strApplicationName)
          << "    --host=<host>:           The host name or IP address that the server must listen on." << endl
          << "                             If not specified, the first available is used." << endl
          << "    --port=<post>:           The port that the server must listen on (default: 10000)" << endl
+         << "    --reuse-connections:     (Server mode only) Keep the connection to the application" << endl
+         << "                             server alive between the experiments of a client, without" << endl
+         << "                             resetting it, and don't select the database again if it" << endl
+         << "                             doesn't change" << endl
          << "    --settings=<FILE>:       Use the instructions found in FILE instead of" << endl
          << "                             those from a client (standalone mode)" << endl
          << "    --scriptsdir=<DIR>:      Path to the directory where the scripts used by the" << endl
@@ -224,6 +240,9 @@ void showUsage(const std::string& strApplicationName)
          << "                             same than --scriptsdir)" << endl
          << "    --sandbox-tempdir=<DIR>: Path to the directory to use to write temporary files" << endl
          << "                             during core dump analysis (default: the current one)" << endl
+         << "    --sandbox-seccomp:       Once the plugins are loaded, confine the sandboxes with a" << endl
+         << "                             seccomp system call filter instead of intercepting the calls" << endl
+         << "                             of the plugins (Linux only, the memory is still monitored)" << endl
          << "    --source-heuristics=<DIR>:" << endl
          << "                             Paths to the directories (separated by ;) where the source code" << endl
          << "                             files of the heuristics are located (default: When --no-compilation" << endl
@@ -244,7 +263,26 @@ void showUsage(const std::string& strApplicationName)
          << "                             Path to the directory where the source code files of the" << endl
          << "                             instruments are located (default: When executed from the" << endl
          << "                             build directory of the Framework, the value of the" << endl
-         << "                             ${MASH_INSTRUMENT_LOCATIONS} compilation setting. Otherwise, none)." << endl;
+         << "                             ${MASH_INSTRUMENT_LOCATIONS} compilation setting. Otherwise, none)." << endl
+         << "    --shared-features:       Transfer the features between the classifier and heuristics" << endl
+         << "                             sandboxes through shared memory instead of copying them" << endl
+         << "                             through the experiment server" << endl
+         << "    --test-workers=<N>:      (Classification only) Distribute the test images among N" << endl
+         << "                             classifier sandboxes (each one with its own heuristics" << endl
+         << "                             sandbox) evaluating them in parallel (default: 1). Requires" << endl
+         << "                             the sandboxing of the predictor and of the heuristics. The" << endl
+         << "                             statistics and crash reports of the sandboxes of the workers" << endl
+         << "                             are dropped (only the errors are written in the log)" << endl
+         << "    --checkpoint-folder=<DIR>:" << endl
+         << "                             (Classification only) Path to the directory where the progress" << endl
+         << "                             of the experiments is saved (trained model, evaluated test" << endl
+         << "                             images). A restarted experiment with the same settings and" << endl
+         << "                             seeds resumes from its last checkpoint, unless an instrument" << endl
+         << "                             needs the per-image events sent before it (default: none)" << endl
+         << "    --features-store=<HOST>:<PORT>:" << endl
+         << "                             (Classification only) Address of a features server, in which" << endl
+         << "                             the features are looked up before being computed, and to" << endl
+         << "                             which the computed ones are sent (default: none)" << endl;
 }
 
 
@@ -408,6 +446,10 @@ int main(int argc, char** argv)
                     configuration.strSandboxTempDir = args.OptionArg();
                     break;
 
+                case OPT_SANDBOX_SECCOMP:
+                    configuration.bSandboxSeccomp = true;
+                    break;
+
                 case OPT_SANDBOX_SOURCE_HEURISTICS:
                     configuration.strSourceHeuristics = args.OptionArg();
                     break;
@@ -423,6 +465,26 @@ int main(int argc, char** argv)
                 case OPT_SANDBOX_SOURCE_INSTRUMENTS:
                     configuration.strSourceInstruments = args.OptionArg();
                     break;
+
+                case OPT_SHARED_FEATURES:
+                    configuration.bSharedFeatures = true;
+                    break;
+
+                case OPT_TEST_WORKERS:
+                    configuration.nbTestWorkers = StringUtils::parseUnsignedInt(args.OptionArg());
+                    break;
+
+                case OPT_CHECKPOINT_DIR:
+                    configuration.strCheckpointDir = args.OptionArg();
+                    break;
+
+                case OPT_FEATURES_STORE:
+                    configuration.strFeaturesStore = args.OptionArg();
+                    break;
+
+                case OPT_REUSE_CONNECTIONS:
+                    configuration.bReuseConnections = true;
+                    break;
             }
         }
         else
@@ -0,0 +1,306 @@
+/*******************************************************************************
+* The MASH Framework contains the source code of all the servers in the
+* "computation farm" of the MASH project (http://www.mash-project.eu),
+* developed at the Idiap Research Institute (http://www.idiap.ch).
+*
+* Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+* Written by Philip Abbet (philip.abbet@idiap.ch)
+*
+* This file is part of the MASH Framework.
+*
+* The MASH Framework is free software: you can redistribute it and/or modify
+* it under the terms of either the GNU General Public License version 2 or
+* the GNU General Public License version 3 as published by the Free
+* Software Foundation, whichever suits the most your needs.
+*
+* The MASH Framework is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public Licenses
+* along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+/** @file   parallel_evaluator.cpp
+    @author Philip Abbet (philip.abbet@idiap.ch)
+
+    Implementation of the 'ParallelEvaluator' class
+*/
+
+#include "parallel_evaluator.h"
+#include <assert.h>
+#include <algorithm>
+
+
+using namespace std;
+using namespace Mash;
+
+
+/********************************** CONSTANTS *********************************/
+
+// Number of images that each worker is allowed to evaluate in advance of the
+// ones already retrieved
+const unsigned int MAX_IMAGES_IN_ADVANCE = 2;
+
+
+/************************* CONSTRUCTION / DESTRUCTION *************************/
+
+ParallelEvaluator::ParallelEvaluator()
+: _nbImages(0), _firstImage(0), _nextImage(0), _window(0), _failedWorker(-1), _failedImage(0),
+  _bStopping(false)
+{
+    pthread_mutex_init(&_mutex, 0);
+    pthread_cond_init(&_condition, 0);
+}
+
+
+ParallelEvaluator::~ParallelEvaluator()
+{
+    stop();
+
+    tWorkersList::iterator iter, iterEnd;
+    for (iter = _workers.begin(), iterEnd = _workers.end(); iter != iterEnd; ++iter)
+    {
+        delete (*iter)->pDelegate;
+        delete (*iter)->pInputSet;
+        delete (*iter)->pClient;
+        delete *iter;
+    }
+
+    pthread_cond_destroy(&_condition);
+    pthread_mutex_destroy(&_mutex);
+}
+
+
+/*********************************** METHODS **********************************/
+
+void ParallelEvaluator::addWorker(ClassifierInputSet* pInputSet,
+                                  IClassifierDelegate* pDelegate, Client* pClient)
+{
+    // Assertions
+    assert(pInputSet);
+    assert(pDelegate);
+    assert(pClient);
+
+    tWorker* pWorker = new tWorker();
+
+    pWorker->pEvaluator = this;
+    pWorker->index      = _workers.size();
+    pWorker->pInputSet  = pInputSet;
+    pWorker->pDelegate  = pDelegate;
+    pWorker->pClient    = pClient;
+    pWorker->bStarted   = false;
+
+    pInputSet->setListener(&pWorker->recorder);
+
+    _workers.push_back(pWorker);
+}
+
+
+bool ParallelEvaluator::start(unsigned int firstImage)
+{
+    // Assertions
+    assert(!_workers.empty());
+
+    _nbImages       = _workers[0]->pInputSet->nbImages();
+    _firstImage     = min(firstImage, _nbImages);
+    _nextImage      = _firstImage;
+    _window         = _workers.size() * MAX_IMAGES_IN_ADVANCE;
+    _failedWorker   = -1;
+    _failedImage    = 0;
+    _bStopping      = false;
+
+    _images.clear();
+    _images.resize(_nbImages);
+
+    tWorkersList::iterator iter, iterEnd;
+    for (iter = _workers.begin(), iterEnd = _workers.end(); iter != iterEnd; ++iter)
+    {
+        (*iter)->bStarted = (pthread_create(&(*iter)->thread, 0, workerThread, *iter) == 0);
+        if (!(*iter)->bStarted)
+        {
+            stop();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+bool ParallelEvaluator::waitResults(unsigned int image,
+                                    Classifier::tClassificationResultsList& results,
+                                    IClassifierInputSetListener* pListener)
+{
+    // Assertions
+    assert(image == _nextImage);
+    assert(image < _nbImages);
+
+    tFeaturesEventsList events;
+
+    pthread_mutex_lock(&_mutex);
+
+    while (!_images[image].bReady && (_failedWorker < 0))
+        pthread_cond_wait(&_condition, &_mutex);
+
+    bool bResult = _images[image].bReady;
+    if (bResult)
+    {
+        results.swap(_images[image].results);
+        events.swap(_images[image].events);
+
+        ++_nextImage;
+        pthread_cond_broadcast(&_condition);
+    }
+
+    pthread_mutex_unlock(&_mutex);
+
+    // Replay the events reported by the Input Set of the worker
+    if (pListener)
+    {
+        tFeaturesEventsList::iterator iter, iterEnd;
+        for (iter = events.begin(), iterEnd = events.end(); iter != iterEnd; ++iter)
+        {
+            if (iter->indexes.empty())
+                continue;
+
+            pListener->onFeaturesComputed(iter->detection, iter->training, image,
+                                          iter->original_image, iter->coords,
+                                          iter->roiExtent, iter->heuristic,
+                                          iter->indexes.size(), &iter->indexes[0],
+                                          &iter->values[0]);
+        }
+    }
+
+    return bResult;
+}
+
+
+void ParallelEvaluator::stop()
+{
+    pthread_mutex_lock(&_mutex);
+    _bStopping = true;
+    pthread_cond_broadcast(&_condition);
+    pthread_mutex_unlock(&_mutex);
+
+    tWorkersList::iterator iter, iterEnd;
+    for (iter = _workers.begin(), iterEnd = _workers.end(); iter != iterEnd; ++iter)
+    {
+        if ((*iter)->bStarted)
+        {
+            pthread_join((*iter)->thread, 0);
+            (*iter)->bStarted = false;
+        }
+    }
+}
+
+
+/****************************** INTERNAL METHODS ******************************/
+
+void* ParallelEvaluator::workerThread(void* pData)
+{
+    tWorker* pWorker = (tWorker*) pData;
+
+    pWorker->pEvaluator->evaluate(pWorker);
+
+    return 0;
+}
+
+
+void ParallelEvaluator::evaluate(tWorker* pWorker)
+{
+    ClassifierInputSet* pInputSet = pWorker->pInputSet;
+    const Stepper* stepper = pInputSet->getStepper();
+
+    for (unsigned int image = _firstImage + pWorker->index; image < _nbImages; image += _workers.size())
+    {
+        // Don't get too far in advance of the images already retrieved
+        pthread_mutex_lock(&_mutex);
+
+        while (!_bStopping && (_failedWorker < 0) && (image >= _nextImage + _window))
+            pthread_cond_wait(&_condition, &_mutex);
+
+        bool bContinue = !_bStopping && (_failedWorker < 0);
+
+        pthread_mutex_unlock(&_mutex);
+
+        if (!bContinue)
+            return;
+
+        // Obtain the classifier responses at all the positions returned by
+        // the stepper
+        const tCoordinatesList& positions = stepper->positions(pInputSet->imageSize(image));
+
+        Classifier::tClassificationResultsList results;
+        bool ret;
+
+        pInputSet->restrictAccess(true);
+
+        if (!stepper->isDoingDetection())
+        {
+            results.resize(1);
+            ret = pWorker->pDelegate->classify(pInputSet, image, positions.front(), results[0]);
+        }
+        else
+        {
+            ret = pWorker->pDelegate->classifyBatch(pInputSet, image, positions, results);
+        }
+
+        pInputSet->restrictAccess(false);
+
+        // Make the results available
+        pthread_mutex_lock(&_mutex);
+
+        if (ret)
+        {
+            _images[image].results.swap(results);
+            _images[image].events.swap(pWorker->recorder.events);
+            _images[image].bReady = true;
+        }
+        else if (_failedWorker < 0)
+        {
+            _failedWorker = pWorker->index;
+            _failedImage  = image;
+        }
+
+        pthread_cond_broadcast(&_condition);
+        pthread_mutex_unlock(&_mutex);
+
+        pWorker->recorder.events.clear();
+
+        if (!ret)
+            return;
+    }
+}
+
+
+/*************************** IMPLEMENTATION OF Recorder ***********************/
+
+void ParallelEvaluator::Recorder::onFeaturesComputed(bool detection,
+                                                     bool training,
+                                                     unsigned int image,
+                                                     unsigned int original_image,
+                                                     const coordinates_t& coords,
+                                                     unsigned int roiExtent,
+                                                     unsigned int heuristic,
+                                                     unsigned int nbFeatures,
+                                                     unsigned int* indexes,
+                                                     scalar_t* values)
+{
+    events.push_back(tFeaturesEvent());
+
+    tFeaturesEvent& event = events.back();
+
+    event.detection         = detection;
+    event.training          = training;
+    event.original_image    = original_image;
+    event.coords            = coords;
+    event.roiExtent         = roiExtent;
+    event.heuristic         = heuristic;
+
+    event.indexes.assign(indexes, indexes + nbFeatures);
+    event.values.assign(values, values + nbFeatures);
+}
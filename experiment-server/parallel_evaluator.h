@@ -0,0 +1,263 @@
+/*******************************************************************************
+* The MASH Framework contains the source code of all the servers in the
+* "computation farm" of the MASH project (http://www.mash-project.eu),
+* developed at the Idiap Research Institute (http://www.idiap.ch).
+*
+* Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+* Written by Philip Abbet (philip.abbet@idiap.ch)
+*
+* This file is part of the MASH Framework.
+*
+* The MASH Framework is free software: you can redistribute it and/or modify
+* it under the terms of either the GNU General Public License version 2 or
+* the GNU General Public License version 3 as published by the Free
+* Software Foundation, whichever suits the most your needs.
+*
+* The MASH Framework is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public Licenses
+* along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+/** @file   parallel_evaluator.h
+    @author Philip Abbet (philip.abbet@idiap.ch)
+
+    Declaration of the 'ParallelEvaluator' class
+*/
+
+#ifndef _PARALLEL_EVALUATOR_H_
+#define _PARALLEL_EVALUATOR_H_
+
+#include <mash-classification/classifier_input_set.h>
+#include <mash-classification/classifier_input_set_listener_interface.h>
+#include <mash-classification/classifier_delegate.h>
+#include <mash-network/client.h>
+#include <pthread.h>
+#include <vector>
+
+
+//------------------------------------------------------------------------------
+/// @brief  Evaluates the images of a test set with several classifiers at the
+///         same time, and returns their results in the original order
+///
+/// Each worker owns an Input Set (with its own connection to the application
+/// server and its own heuristics) and a classifier delegate in which the
+/// model of the predictor was loaded. The images are distributed in a
+/// round-robin fashion: the worker i processes the images i, i + N, i + 2N,
+/// ... in its own thread.
+///
+/// The results are retrieved in the original order with waitResults(), which
+/// also replays the events reported by the Input Set of the worker (the
+/// computed features) to the given listener: the instruments see the same
+/// sequence of notifications than with a sequential evaluation. The workers
+/// never get too far ahead of the images already retrieved, to bound the
+/// memory used by the buffered events.
+///
+/// All the objects of the workers must be created and configured in the main
+/// thread before start() is called (some tables shared by the proxies of the
+/// sandboxes are lazily initialised).
+///
+/// The objects of the workers are destroyed with the evaluator: the
+/// statistics of their sandboxes and the crash reports of their plugins are
+/// dropped (they aren't part of the reports sent to the client). When a worker
+/// fails, failedWorker(), failedImage(), failedDelegate() and failedInputSet()
+/// give the context of the failure until then.
+//------------------------------------------------------------------------------
+class ParallelEvaluator
+{
+    //_____ Construction / Destruction __________
+public:
+    //--------------------------------------------------------------------------
+    /// @brief  Constructor
+    //--------------------------------------------------------------------------
+    ParallelEvaluator();
+
+    //--------------------------------------------------------------------------
+    /// @brief  Destructor
+    //--------------------------------------------------------------------------
+    ~ParallelEvaluator();
+
+
+    //_____ Methods __________
+public:
+    //--------------------------------------------------------------------------
+    /// @brief  Add a worker
+    ///
+    /// @param  pInputSet   The Input Set of the worker, with the test set
+    ///                     selected
+    /// @param  pDelegate   The classifier delegate of the worker, with the
+    ///                     model loaded
+    /// @param  pClient     The connection to the application server used by
+    ///                     the Input Set
+    ///
+    /// @remark The evaluator takes the ownership of the objects
+    //--------------------------------------------------------------------------
+    void addWorker(Mash::ClassifierInputSet* pInputSet,
+                   Mash::IClassifierDelegate* pDelegate, Mash::Client* pClient);
+
+    //--------------------------------------------------------------------------
+    /// @brief  Returns the number of workers
+    //--------------------------------------------------------------------------
+    inline unsigned int nbWorkers() const
+    {
+        return _workers.size();
+    }
+
+    //--------------------------------------------------------------------------
+    /// @brief  Start the evaluation of the images by the workers
+    ///
+    /// @param  firstImage  Index of the first image to evaluate (the previous
+    ///                     ones are skipped)
+    /// @return             'false' if the threads couldn't be created
+    //--------------------------------------------------------------------------
+    bool start(unsigned int firstImage = 0);
+
+    //--------------------------------------------------------------------------
+    /// @brief  Wait for the results of the classifier on an image
+    ///
+    /// @param  image       Index of the image, must be the one following the
+    ///                     image of the previous call
+    /// @param[out] results The results at each position returned by the
+    ///                     stepper (only one in classification)
+    /// @param  pListener   (Optional) Listener to which the events reported by
+    ///                     the Input Set of the worker must be forwarded
+    /// @return             'false' if a worker failed (see failedWorker())
+    //--------------------------------------------------------------------------
+    bool waitResults(unsigned int image,
+                     Mash::Classifier::tClassificationResultsList& results,
+                     Mash::IClassifierInputSetListener* pListener);
+
+    //--------------------------------------------------------------------------
+    /// @brief  Stop the workers (the images not evaluated yet are skipped)
+    //--------------------------------------------------------------------------
+    void stop();
+
+    //--------------------------------------------------------------------------
+    /// @brief  Returns the index of the worker which failed (-1 if none)
+    //--------------------------------------------------------------------------
+    inline int failedWorker() const
+    {
+        return _failedWorker;
+    }
+
+    //--------------------------------------------------------------------------
+    /// @brief  Returns the index of the image on which the worker failed
+    //--------------------------------------------------------------------------
+    inline unsigned int failedImage() const
+    {
+        return _failedImage;
+    }
+
+    //--------------------------------------------------------------------------
+    /// @brief  Returns the classifier delegate of the worker which failed (if
+    ///         any)
+    //--------------------------------------------------------------------------
+    inline Mash::IClassifierDelegate* failedDelegate() const
+    {
+        return (_failedWorker >= 0 ? _workers[_failedWorker]->pDelegate : 0);
+    }
+
+    //--------------------------------------------------------------------------
+    /// @brief  Returns the Input Set of the worker which failed (if any), to
+    ///         retrieve the error of its heuristics
+    //--------------------------------------------------------------------------
+    inline Mash::ClassifierInputSet* failedInputSet() const
+    {
+        return (_failedWorker >= 0 ? _workers[_failedWorker]->pInputSet : 0);
+    }
+
+
+    //_____ Internal types __________
+private:
+    struct tFeaturesEvent
+    {
+        bool                        detection;
+        bool                        training;
+        unsigned int                original_image;
+        Mash::coordinates_t         coords;
+        unsigned int                roiExtent;
+        unsigned int                heuristic;
+        std::vector<unsigned int>   indexes;
+        std::vector<Mash::scalar_t> values;
+    };
+
+    typedef std::vector<tFeaturesEvent> tFeaturesEventsList;
+
+
+    //--------------------------------------------------------------------------
+    /// @brief  Records the events reported by the Input Set of a worker
+    //--------------------------------------------------------------------------
+    class Recorder: public Mash::IClassifierInputSetListener
+    {
+    public:
+        virtual void onFeaturesComputed(bool detection,
+                                        bool training,
+                                        unsigned int image,
+                                        unsigned int original_image,
+                                        const Mash::coordinates_t& coords,
+                                        unsigned int roiExtent,
+                                        unsigned int heuristic,
+                                        unsigned int nbFeatures,
+                                        unsigned int* indexes,
+                                        Mash::scalar_t* values);
+
+        tFeaturesEventsList events;
+    };
+
+
+    struct tWorker
+    {
+        ParallelEvaluator*          pEvaluator;
+        unsigned int                index;
+        Mash::ClassifierInputSet*   pInputSet;
+        Mash::IClassifierDelegate*  pDelegate;
+        Mash::Client*               pClient;
+        Recorder                    recorder;
+        pthread_t                   thread;
+        bool                        bStarted;
+    };
+
+    typedef std::vector<tWorker*> tWorkersList;
+
+
+    struct tImageResults
+    {
+        tImageResults()
+        : bReady(false)
+        {
+        }
+
+        bool                                        bReady;
+        Mash::Classifier::tClassificationResultsList results;
+        tFeaturesEventsList                         events;
+    };
+
+
+    //_____ Internal methods __________
+private:
+    static void* workerThread(void* pData);
+
+    void evaluate(tWorker* pWorker);
+
+
+    //_____ Attributes __________
+private:
+    tWorkersList                _workers;
+    std::vector<tImageResults>  _images;
+    unsigned int                _nbImages;
+    unsigned int                _firstImage;
+    unsigned int                _nextImage;
+    unsigned int                _window;
+    int                         _failedWorker;
+    unsigned int                _failedImage;
+    bool                        _bStopping;
+    pthread_mutex_t             _mutex;
+    pthread_cond_t              _condition;
+};
+
+#endif
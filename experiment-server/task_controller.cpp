@@ -66,7 +66,7 @@ bool features_equal(const tFeature& i1, const tFeature& i2)
 
 TaskController::TaskController(Listener* pListener)
 : _pListener(pListener), _bPredictorLoaded(false), _bInstrumentsCreated(false),
-  _pInstrumentsSet(0), _notifier(pListener)
+  _pInstrumentsSet(0), _notifier(pListener), _applicationServerPort(0)
 {
 }
 
@@ -107,6 +107,17 @@ int TaskController::getLogFileContent(unsigned int index, std::string& strName,
 }
 
 
+std::string TaskController::getIPCStatisticsReport()
+{
+    SandboxedInstrumentsSet* pSet = dynamic_cast<SandboxedInstrumentsSet*>(_pInstrumentsSet);
+    
+    if (pSet && pSet->sandboxController()->getStatistics())
+        return "SANDBOX instruments\n" + pSet->sandboxController()->getStatisticsReport();
+    
+    return "";
+}
+
+
 /********************************** METHODS ***********************************/
 
 TaskController::tResult TaskController::loadInstrument(const std::string strName)
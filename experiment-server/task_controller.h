@@ -49,7 +49,7 @@ struct tTaskControllerConfiguration
 {
     tTaskControllerConfiguration()
     : predictorSandboxConfiguration(0), heuristicsSandboxConfiguration(0),
-      instrumentsSandboxConfiguration(0)
+      instrumentsSandboxConfiguration(0), bSharedFeatures(false), nbTestWorkers(0)
     {
     }
     
@@ -63,6 +63,18 @@ struct tTaskControllerConfiguration
     Mash::tSandboxConfiguration*    predictorSandboxConfiguration;      ///< Configuration of the sandbox of the predictor (optional)
     Mash::tSandboxConfiguration*    heuristicsSandboxConfiguration;     ///< Configuration of the sandbox of the heuristics (optional)
     Mash::tSandboxConfiguration*    instrumentsSandboxConfiguration;    ///< Configuration of the sandbox of the instruments (optional)
+    bool                            bSharedFeatures;                    ///< (classification only) Indicates if the sandboxes of the
+                                                                        ///< predictor and of the heuristics must exchange the
+                                                                        ///< features through shared memory
+    unsigned int                    nbTestWorkers;                      ///< (classification only) Number of pairs of sandboxes
+                                                                        ///< (predictor and heuristics) among which the test
+                                                                        ///< images are distributed (0 or 1: no distribution)
+    std::string                     strCheckpointFolder;                ///< (classification only) Path to the folder where the
+                                                                        ///< progress of the experiment is saved (empty to disable)
+    std::string                     strFeaturesStore;                   ///< (classification only) Address (<host>:<port>) of the
+                                                                        ///< features server (empty to disable)
+    std::string                     strHeuristicsSources;               ///< Paths to the folders containing the source code of
+                                                                        ///< the heuristics (separated by ';')
 };
 
 
@@ -206,6 +218,12 @@ public:
     virtual int getLogFileContent(unsigned int index, std::string& strName,
                                   unsigned char** pBuffer, int64_t max_size = 0);
 
+    //--------------------------------------------------------------------------
+    /// @brief  Returns a report of the statistics about the messages exchanged
+    ///         with the sandboxes (one section per sandbox)
+    //--------------------------------------------------------------------------
+    virtual std::string getIPCStatisticsReport();
+
     //--------------------------------------------------------------------------
     /// @brief  Write task-specific data into the report data located at the
     ///         specified path
@@ -241,6 +259,18 @@ public:
     {
         return _pInstrumentsSet;
     }
+
+    //--------------------------------------------------------------------------
+    /// @brief  Set the address of the application server used by the client
+    ///
+    /// Used by the tasks needing additional connections to the same server
+    //--------------------------------------------------------------------------
+    inline void setApplicationServerAddress(const std::string& strAddress,
+                                            unsigned int port)
+    {
+        _strApplicationServerAddress = strAddress;
+        _applicationServerPort = port;
+    }
     
 
 protected:
@@ -277,6 +307,8 @@ protected:
     Mash::IInstrumentsSet*                          _pInstrumentsSet;
     std::vector<Mash::tExperimentParametersList>    _instrumentsParameters;
     Notifier                                        _notifier;
+    std::string                                     _strApplicationServerAddress;
+    unsigned int                                    _applicationServerPort;
 };
 
 #endif
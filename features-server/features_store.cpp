@@ -0,0 +1,353 @@
+/*******************************************************************************
+* The MASH Framework contains the source code of all the servers in the
+* "computation farm" of the MASH project (http://www.mash-project.eu),
+* developed at the Idiap Research Institute (http://www.idiap.ch).
+*
+* Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+* Written by Philip Abbet (philip.abbet@idiap.ch)
+*
+* This file is part of the MASH Framework.
+*
+* The MASH Framework is free software: you can redistribute it and/or modify
+* it under the terms of either the GNU General Public License version 2 or
+* the GNU General Public License version 3 as published by the Free
+* Software Foundation, whichever suits the most your needs.
+*
+* The MASH Framework is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public Licenses
+* along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+/** @file   features_store.cpp
+    @author Philip Abbet (philip.abbet@idiap.ch)
+
+    Implementation of the 'FeaturesStore' class
+*/
+
+#include "features_store.h"
+#include <algorithm>
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+
+using namespace std;
+
+
+/****************************** UTILITY FUNCTIONS *****************************/
+
+namespace
+{
+    // A block found in the storage folder when it is opened
+    struct tFoundBlock
+    {
+        time_t      time;
+        std::string strKey;
+        uint64_t    size;
+
+        bool operator<(const tFoundBlock& other) const
+        {
+            return (time < other.time);
+        }
+    };
+
+
+    bool createFolder(const std::string& strFolder)
+    {
+        return (mkdir(strFolder.c_str(), 0755) == 0) || (errno == EEXIST);
+    }
+}
+
+
+/************************* CONSTRUCTION / DESTRUCTION *************************/
+
+FeaturesStore::FeaturesStore()
+: _nbTempFiles(0)
+{
+    pthread_mutex_init(&_mutex, 0);
+
+    memset(&_statistics, 0, sizeof(tStatistics));
+}
+
+
+FeaturesStore::~FeaturesStore()
+{
+    pthread_mutex_destroy(&_mutex);
+}
+
+
+/********************************* METHODS ************************************/
+
+bool FeaturesStore::open(const std::string& strFolder, uint64_t maxSize)
+{
+    // Declarations
+    vector<tFoundBlock> found;
+    char buffer[10];
+
+    _strFolder = strFolder;
+    if (_strFolder.empty())
+        _strFolder = "./";
+    else if (_strFolder[_strFolder.size() - 1] != '/')
+        _strFolder += "/";
+
+    _blocks.clear();
+    _recency.clear();
+    memset(&_statistics, 0, sizeof(tStatistics));
+    _statistics.maxSize = maxSize;
+
+    if (!createFolder(_strFolder))
+        return false;
+
+    // List the blocks saved by a previous instance of the server (and delete
+    // the temporary files it left)
+    for (unsigned int i = 0; i < 256; ++i)
+    {
+        sprintf(buffer, "%02x/", i);
+        string strSubFolder = _strFolder + buffer;
+
+        if (!createFolder(strSubFolder))
+            return false;
+
+        DIR* pDir = opendir(strSubFolder.c_str());
+        if (!pDir)
+            return false;
+
+        struct dirent* pEntry;
+        while ((pEntry = readdir(pDir)) != 0)
+        {
+            string strName = pEntry->d_name;
+            string strPath = strSubFolder + strName;
+
+            if ((strName.size() > 4) && (strName.substr(strName.size() - 4) == ".tmp"))
+            {
+                unlink(strPath.c_str());
+                continue;
+            }
+
+            struct stat fileInfo;
+            if (!isValidKey(strName) || (stat(strPath.c_str(), &fileInfo) != 0) ||
+                !S_ISREG(fileInfo.st_mode))
+            {
+                continue;
+            }
+
+            tFoundBlock block;
+            block.time   = fileInfo.st_mtime;
+            block.strKey = strName;
+            block.size   = fileInfo.st_size;
+
+            found.push_back(block);
+        }
+
+        closedir(pDir);
+    }
+
+    // The most recently modified blocks are considered as the most recently
+    // used ones
+    sort(found.begin(), found.end());
+
+    for (unsigned int i = 0; i < found.size(); ++i)
+    {
+        _recency.push_front(found[i].strKey);
+
+        tBlock& block = _blocks[found[i].strKey];
+        block.size    = found[i].size;
+        block.recency = _recency.begin();
+
+        _statistics.size += found[i].size;
+    }
+
+    evict();
+
+    return true;
+}
+
+
+bool FeaturesStore::get(const std::string& strKey, std::vector<unsigned char>* data)
+{
+    // Assertions
+    assert(data);
+
+    pthread_mutex_lock(&_mutex);
+
+    tBlocksIterator iter = _blocks.find(strKey);
+    if (iter == _blocks.end())
+    {
+        ++_statistics.nbMisses;
+        pthread_mutex_unlock(&_mutex);
+        return false;
+    }
+
+    // The file is read while the mutex is locked, so the block can't be
+    // evicted in the meantime
+    bool bSuccess = false;
+
+    FILE* pFile = fopen(getPath(strKey).c_str(), "rb");
+    if (pFile)
+    {
+        data->resize(iter->second.size);
+        bSuccess = data->empty() ||
+                   (fread(&(*data)[0], 1, data->size(), pFile) == data->size());
+        fclose(pFile);
+    }
+
+    if (bSuccess)
+    {
+        _recency.splice(_recency.begin(), _recency, iter->second.recency);
+        ++_statistics.nbHits;
+    }
+    else
+    {
+        // The file was deleted or modified behind our back: forget the block
+        _statistics.size -= iter->second.size;
+        _recency.erase(iter->second.recency);
+        _blocks.erase(iter);
+        ++_statistics.nbMisses;
+    }
+
+    pthread_mutex_unlock(&_mutex);
+
+    return bSuccess;
+}
+
+
+bool FeaturesStore::put(const std::string& strKey, const unsigned char* data,
+                        unsigned int size)
+{
+    // Assertions
+    assert(data || (size == 0));
+
+    if (!isValidKey(strKey))
+        return false;
+
+    string strPath = getPath(strKey);
+
+    // The block is first written in a temporary file, renamed once complete:
+    // a block being read is never partially written
+    pthread_mutex_lock(&_mutex);
+    unsigned int tempFile = _nbTempFiles++;
+    pthread_mutex_unlock(&_mutex);
+
+    char buffer[20];
+    sprintf(buffer, ".%u.tmp", tempFile);
+    string strTempPath = strPath + buffer;
+
+    FILE* pFile = fopen(strTempPath.c_str(), "wb");
+    if (!pFile)
+        return false;
+
+    bool bSuccess = (size == 0) || (fwrite(data, 1, size, pFile) == size);
+    bSuccess = (fclose(pFile) == 0) && bSuccess;
+
+    if (!bSuccess)
+    {
+        unlink(strTempPath.c_str());
+        return false;
+    }
+
+    pthread_mutex_lock(&_mutex);
+
+    if (rename(strTempPath.c_str(), strPath.c_str()) != 0)
+    {
+        pthread_mutex_unlock(&_mutex);
+        unlink(strTempPath.c_str());
+        return false;
+    }
+
+    tBlocksIterator iter = _blocks.find(strKey);
+    if (iter != _blocks.end())
+    {
+        _statistics.size -= iter->second.size;
+        _recency.erase(iter->second.recency);
+    }
+
+    _recency.push_front(strKey);
+
+    tBlock& block = _blocks[strKey];
+    block.size    = size;
+    block.recency = _recency.begin();
+
+    _statistics.size += size;
+    ++_statistics.nbStored;
+
+    evict();
+
+    pthread_mutex_unlock(&_mutex);
+
+    return true;
+}
+
+
+FeaturesStore::tStatistics FeaturesStore::getStatistics()
+{
+    pthread_mutex_lock(&_mutex);
+
+    tStatistics statistics = _statistics;
+    statistics.nbBlocks = _blocks.size();
+
+    pthread_mutex_unlock(&_mutex);
+
+    return statistics;
+}
+
+
+bool FeaturesStore::isValidKey(const std::string& strKey)
+{
+    if (strKey.empty() || (strKey.size() > 128))
+        return false;
+
+    for (unsigned int i = 0; i < strKey.size(); ++i)
+    {
+        char c = strKey[i];
+        if (!(((c >= '0') && (c <= '9')) || ((c >= 'a') && (c <= 'f'))))
+            return false;
+    }
+
+    return true;
+}
+
+
+std::string FeaturesStore::getPath(const std::string& strKey) const
+{
+    // 8-bit FNV-1a hash of the key, to spread the blocks among the sub-folders
+    unsigned int hash = 2166136261U;
+    for (unsigned int i = 0; i < strKey.size(); ++i)
+    {
+        hash ^= (unsigned char) strKey[i];
+        hash *= 16777619U;
+    }
+
+    char buffer[10];
+    sprintf(buffer, "%02x/", hash & 0xFF);
+
+    return _strFolder + buffer + strKey;
+}
+
+
+void FeaturesStore::evict()
+{
+    while ((_statistics.size > _statistics.maxSize) && !_recency.empty())
+    {
+        const string& strKey = _recency.back();
+
+        unlink(getPath(strKey).c_str());
+
+        tBlocksIterator iter = _blocks.find(strKey);
+        _statistics.size -= iter->second.size;
+        _blocks.erase(iter);
+
+        _recency.pop_back();
+        ++_statistics.nbEvicted;
+    }
+}
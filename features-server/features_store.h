@@ -0,0 +1,169 @@
+/*******************************************************************************
+* The MASH Framework contains the source code of all the servers in the
+* "computation farm" of the MASH project (http://www.mash-project.eu),
+* developed at the Idiap Research Institute (http://www.idiap.ch).
+*
+* Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+* Written by Philip Abbet (philip.abbet@idiap.ch)
+*
+* This file is part of the MASH Framework.
+*
+* The MASH Framework is free software: you can redistribute it and/or modify
+* it under the terms of either the GNU General Public License version 2 or
+* the GNU General Public License version 3 as published by the Free
+* Software Foundation, whichever suits the most your needs.
+*
+* The MASH Framework is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public Licenses
+* along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+/** @file   features_store.h
+    @author Philip Abbet (philip.abbet@idiap.ch)
+
+    Declaration of the 'FeaturesStore' class
+*/
+
+#ifndef _FEATURES_STORE_H_
+#define _FEATURES_STORE_H_
+
+#include <pthread.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+
+
+//------------------------------------------------------------------------------
+/// @brief  Disk-based storage of the blocks of features shared by the
+///         experiment servers
+///
+/// The blocks are opaque to the store: they are identified by a key built by
+/// the clients (see Mash::FeaturesStoreClient), made of hexadecimal digits.
+/// Each block is saved in its own file, in one of 256 sub-folders of the
+/// storage folder.
+///
+/// The total size of the blocks is bounded: when it is exceeded, the least
+/// recently used blocks are deleted. The store is thread-safe.
+//------------------------------------------------------------------------------
+class FeaturesStore
+{
+    //_____ Internal types __________
+public:
+    struct tStatistics
+    {
+        unsigned int    nbBlocks;       ///< Number of blocks in the store
+        uint64_t        size;           ///< Total size of the blocks, in bytes
+        uint64_t        maxSize;        ///< Maximum total size of the blocks
+        uint64_t        nbHits;         ///< Number of blocks found
+        uint64_t        nbMisses;       ///< Number of blocks not found
+        uint64_t        nbStored;       ///< Number of blocks stored
+        uint64_t        nbEvicted;      ///< Number of blocks deleted to free
+                                        ///  some space
+    };
+
+
+    //_____ Construction / Destruction __________
+public:
+    //--------------------------------------------------------------------------
+    /// @brief  Constructor
+    //--------------------------------------------------------------------------
+    FeaturesStore();
+
+    //--------------------------------------------------------------------------
+    /// @brief  Destructor
+    //--------------------------------------------------------------------------
+    ~FeaturesStore();
+
+
+    //_____ Methods __________
+public:
+    //--------------------------------------------------------------------------
+    /// @brief  Open the store
+    ///
+    /// The blocks already present in the folder (saved by a previous
+    /// instance of the server) are available again.
+    ///
+    /// @param  strFolder   The storage folder
+    /// @param  maxSize     Maximum total size of the blocks, in bytes
+    /// @return             'false' if failed
+    //--------------------------------------------------------------------------
+    bool open(const std::string& strFolder, uint64_t maxSize);
+
+    //--------------------------------------------------------------------------
+    /// @brief  Retrieve a block
+    ///
+    /// @param  strKey      Key of the block
+    /// @retval data        Content of the block
+    /// @return             'false' if the block isn't in the store
+    //--------------------------------------------------------------------------
+    bool get(const std::string& strKey, std::vector<unsigned char>* data);
+
+    //--------------------------------------------------------------------------
+    /// @brief  Store a block (replacing the previous version, if any)
+    ///
+    /// @param  strKey      Key of the block
+    /// @param  data        Content of the block
+    /// @param  size        Size of the block, in bytes
+    /// @return             'false' if failed
+    //--------------------------------------------------------------------------
+    bool put(const std::string& strKey, const unsigned char* data,
+             unsigned int size);
+
+    //--------------------------------------------------------------------------
+    /// @brief  Returns some statistics about the usage of the store
+    //--------------------------------------------------------------------------
+    tStatistics getStatistics();
+
+    //--------------------------------------------------------------------------
+    /// @brief  Indicates if a string is a valid block key
+    //--------------------------------------------------------------------------
+    static bool isValidKey(const std::string& strKey);
+
+private:
+    //--------------------------------------------------------------------------
+    /// @brief  Returns the path to the file of a block
+    //--------------------------------------------------------------------------
+    std::string getPath(const std::string& strKey) const;
+
+    //--------------------------------------------------------------------------
+    /// @brief  Delete the least recently used blocks until the total size of
+    ///         the store is below its limit
+    ///
+    /// @remark The mutex must be locked
+    //--------------------------------------------------------------------------
+    void evict();
+
+
+    //_____ Internal types __________
+private:
+    typedef std::list<std::string>  tRecencyList;
+
+    struct tBlock
+    {
+        uint64_t                size;
+        tRecencyList::iterator  recency;
+    };
+
+    typedef std::map<std::string, tBlock>   tBlocksList;
+    typedef tBlocksList::iterator           tBlocksIterator;
+
+
+    //_____ Attributes __________
+private:
+    pthread_mutex_t     _mutex;
+    std::string         _strFolder;
+    tBlocksList         _blocks;
+    tRecencyList        _recency;       ///< Most recently used first
+    unsigned int        _nbTempFiles;
+    tStatistics         _statistics;
+};
+
+#endif
@@ -0,0 +1,243 @@
+/*******************************************************************************
+* The MASH Framework contains the source code of all the servers in the
+* "computation farm" of the MASH project (http://www.mash-project.eu),
+* developed at the Idiap Research Institute (http://www.idiap.ch).
+*
+* Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+* Written by Philip Abbet (philip.abbet@idiap.ch)
+*
+* This file is part of the MASH Framework.
+*
+* The MASH Framework is free software: you can redistribute it and/or modify
+* it under the terms of either the GNU General Public License version 2 or
+* the GNU General Public License version 3 as published by the Free
+* Software Foundation, whichever suits the most your needs.
+*
+* The MASH Framework is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public Licenses
+* along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+/** @file   listener.cpp
+    @author Philip Abbet (philip.abbet@idiap.ch)
+
+    Implementation of the 'Listener' class
+*/
+
+#include "listener.h"
+#include <mash-network/server.h>
+#include <mash-utils/stringutils.h>
+#include <stdio.h>
+
+
+using namespace std;
+using namespace Mash;
+
+
+/********************************** CONSTANTS *********************************/
+
+const char* PROTOCOL = "1.0";
+
+// Maximum size of a block accepted by the server
+const int MAX_BLOCK_SIZE = 64 * 1024 * 1024;
+
+
+/****************************** STATIC ATTRIBUTES *****************************/
+
+Listener::tCommandHandlersList  Listener::handlers;
+FeaturesStore                   Listener::store;
+
+
+/************************* CONSTRUCTION / DESTRUCTION *************************/
+
+Listener::Listener(int socket)
+: ServerListener(socket)
+{
+    char buffer1[50];
+    char buffer2[50];
+
+    sprintf(buffer1, "FeaturesServer #%d", socket);
+    sprintf(buffer2, "listener_%d_$TIMESTAMP.log", socket);
+
+    _outStream.setVerbosityLevel(1);
+    _outStream.open(buffer1, Server::strLogFolder + buffer2, 200 * 1024);
+}
+
+
+Listener::~Listener()
+{
+}
+
+
+/********************** IMPLEMENTATION OF ServerListener **********************/
+
+ServerListener::tAction Listener::handleCommand(const std::string& strCommand,
+                                                const ArgumentsList& arguments)
+{
+    const tCommandHandler* pHandler = handlers.find(strCommand);
+    if (pHandler)
+    {
+        tCommandHandler handler = *pHandler;
+        return (this->*handler)(arguments);
+    }
+
+    if (!sendResponse("UNKNOWN_COMMAND", ArgumentsList()))
+        return ACTION_CLOSE_CONNECTION;
+
+    return ACTION_NONE;
+}
+
+
+/******************************* STATIC METHODS *******************************/
+
+bool Listener::initialize(const std::string& strStoreFolder, uint64_t maxSize)
+{
+    handlers["STATUS"]      = &Listener::handleStatusCommand;
+    handlers["INFO"]        = &Listener::handleInfoCommand;
+    handlers["DONE"]        = &Listener::handleDoneCommand;
+    handlers["GET_BLOCKS"]  = &Listener::handleGetBlocksCommand;
+    handlers["PUT_BLOCK"]   = &Listener::handlePutBlockCommand;
+    handlers["STATISTICS"]  = &Listener::handleStatisticsCommand;
+
+    return store.open(strStoreFolder, maxSize);
+}
+
+
+ServerListener* Listener::createListener(int socket)
+{
+    return new Listener(socket);
+}
+
+
+std::string Listener::getProtocol()
+{
+    return PROTOCOL;
+}
+
+
+/****************************** COMMAND HANDLERS ******************************/
+
+ServerListener::tAction Listener::handleStatusCommand(const ArgumentsList& arguments)
+{
+    if (!sendResponse("READY", ArgumentsList()))
+        return ACTION_CLOSE_CONNECTION;
+
+    return ACTION_NONE;
+}
+
+
+ServerListener::tAction Listener::handleInfoCommand(const ArgumentsList& arguments)
+{
+    if (!sendResponse("TYPE", ArgumentsList("FeaturesServer")))
+        return ACTION_CLOSE_CONNECTION;
+
+    if (!sendResponse("PROTOCOL", ArgumentsList(PROTOCOL)))
+        return ACTION_CLOSE_CONNECTION;
+
+    return ACTION_NONE;
+}
+
+
+ServerListener::tAction Listener::handleDoneCommand(const ArgumentsList& arguments)
+{
+    sendResponse("GOODBYE", ArgumentsList());
+    return ACTION_CLOSE_CONNECTION;
+}
+
+
+ServerListener::tAction Listener::handleGetBlocksCommand(const ArgumentsList& arguments)
+{
+    vector<unsigned char> data;
+    unsigned int nbFound = 0;
+
+    for (int i = 0; i < arguments.size(); ++i)
+    {
+        bool bResult;
+
+        if (store.get(arguments.getString(i), &data) && !data.empty())
+        {
+            bResult = sendResponse("BLOCK", ArgumentsList((int) data.size()),
+                                   &data[0], (int) data.size());
+            ++nbFound;
+        }
+        else
+        {
+            bResult = sendResponse("BLOCK", ArgumentsList(0));
+        }
+
+        if (!bResult)
+            return ACTION_CLOSE_CONNECTION;
+    }
+
+    _outStream << nbFound << "/" << arguments.size() << " blocks found" << endl;
+
+    return ACTION_NONE;
+}
+
+
+ServerListener::tAction Listener::handlePutBlockCommand(const ArgumentsList& arguments)
+{
+    if (arguments.size() != 2)
+    {
+        if (!sendResponse("INVALID_ARGUMENTS", ArgumentsList()))
+            return ACTION_CLOSE_CONNECTION;
+
+        return ACTION_NONE;
+    }
+
+    // The content of the block must be received in all cases, to not
+    // interpret it as commands
+    int size = arguments.getInt(1);
+    if ((size < 0) || (size > MAX_BLOCK_SIZE))
+    {
+        sendResponse("ERROR", ArgumentsList("Invalid block size"));
+        return ACTION_CLOSE_CONNECTION;
+    }
+
+    vector<unsigned char> data(size);
+    if ((size > 0) && !waitData(&data[0], size))
+        return ACTION_CLOSE_CONNECTION;
+
+    bool bResult;
+    if (!FeaturesStore::isValidKey(arguments.getString(0)))
+        bResult = sendResponse("ERROR", ArgumentsList("Invalid block key"));
+    else if (!store.put(arguments.getString(0), (size > 0 ? &data[0] : 0), size))
+        bResult = sendResponse("ERROR", ArgumentsList("Failed to store the block"));
+    else
+        bResult = sendResponse("OK", ArgumentsList());
+
+    if (!bResult)
+        return ACTION_CLOSE_CONNECTION;
+
+    return ACTION_NONE;
+}
+
+
+ServerListener::tAction Listener::handleStatisticsCommand(const ArgumentsList& arguments)
+{
+    FeaturesStore::tStatistics statistics = store.getStatistics();
+
+    uint64_t values[] = { statistics.nbBlocks, statistics.size, statistics.maxSize,
+                          statistics.nbHits, statistics.nbMisses, statistics.nbStored,
+                          statistics.nbEvicted };
+
+    ArgumentsList args;
+    char buffer[30];
+
+    for (unsigned int i = 0; i < sizeof(values) / sizeof(uint64_t); ++i)
+    {
+        sprintf(buffer, "%llu", (unsigned long long) values[i]);
+        args.add(buffer);
+    }
+
+    if (!sendResponse("STATISTICS", args))
+        return ACTION_CLOSE_CONNECTION;
+
+    return ACTION_NONE;
+}
@@ -0,0 +1,100 @@
+/*******************************************************************************
+* The MASH Framework contains the source code of all the servers in the
+* "computation farm" of the MASH project (http://www.mash-project.eu),
+* developed at the Idiap Research Institute (http://www.idiap.ch).
+*
+* Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+* Written by Philip Abbet (philip.abbet@idiap.ch)
+*
+* This file is part of the MASH Framework.
+*
+* The MASH Framework is free software: you can redistribute it and/or modify
+* it under the terms of either the GNU General Public License version 2 or
+* the GNU General Public License version 3 as published by the Free
+* Software Foundation, whichever suits the most your needs.
+*
+* The MASH Framework is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public Licenses
+* along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+/** @file   listener.h
+    @author Philip Abbet (philip.abbet@idiap.ch)
+
+    Declaration of the 'Listener' class
+*/
+
+#ifndef _LISTENER_H_
+#define _LISTENER_H_
+
+#include "features_store.h"
+#include <mash-network/server_listener.h>
+#include <mash-network/commands_table.h>
+
+
+//------------------------------------------------------------------------------
+/// @brief  Server listener of the Features Server
+///
+/// All the listeners share the same store (the server uses the
+/// ENGINE_EVENTS engine).
+///
+/// Commands (in addition to STATUS, INFO and DONE):
+///   - GET_BLOCKS <key1> <key2> ...: for each key (in order), answers with
+///     'BLOCK <size>' followed by the content of the block, or with
+///     'BLOCK 0' if the block isn't in the store
+///   - PUT_BLOCK <key> <size>, followed by the content of the block: answers
+///     with 'OK'
+///   - STATISTICS: answers with 'STATISTICS <nb_blocks> <size> <max_size>
+///     <nb_hits> <nb_misses> <nb_stored> <nb_evicted>'
+//------------------------------------------------------------------------------
+class Listener: public Mash::ServerListener
+{
+    //_____ Construction / Destruction __________
+public:
+    Listener(int socket);
+    virtual ~Listener();
+
+
+    //_____ Implementation of ServerListener __________
+public:
+    virtual tAction handleCommand(const std::string& strCommand,
+                                  const Mash::ArgumentsList& arguments);
+
+
+    //_____ Static methods __________
+public:
+    static bool initialize(const std::string& strStoreFolder, uint64_t maxSize);
+    static ServerListener* createListener(int socket);
+    static std::string getProtocol();
+
+
+    //_____ Command handling __________
+private:
+    tAction handleStatusCommand(const Mash::ArgumentsList& arguments);
+    tAction handleInfoCommand(const Mash::ArgumentsList& arguments);
+    tAction handleDoneCommand(const Mash::ArgumentsList& arguments);
+    tAction handleGetBlocksCommand(const Mash::ArgumentsList& arguments);
+    tAction handlePutBlockCommand(const Mash::ArgumentsList& arguments);
+    tAction handleStatisticsCommand(const Mash::ArgumentsList& arguments);
+
+
+    //_____ Internal types __________
+private:
+    typedef tAction (Listener::*tCommandHandler)(const Mash::ArgumentsList&);
+
+    typedef Mash::CommandsTable<tCommandHandler>    tCommandHandlersList;
+
+
+    //_____ Static attributes __________
+private:
+    static tCommandHandlersList handlers;
+    static FeaturesStore        store;
+};
+
+#endif
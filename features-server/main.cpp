@@ -0,0 +1,147 @@
+#include "listener.h"
+#include <mash-network/server.h>
+#include <mash-utils/stringutils.h>
+#include <SimpleOpt.h>
+#include <iostream>
+
+using namespace Mash;
+using namespace std;
+
+
+/**************************** COMMAND-LINE PARSING ****************************/
+
+enum tOptions
+{
+    OPT_HOST,
+    OPT_PORT,
+    OPT_STORE_FOLDER,
+    OPT_MAX_SIZE,
+    OPT_WORKERS,
+    OPT_LOG_FOLDER,
+    OPT_VERBOSE,
+    OPT_HELP,
+};
+
+CSimpleOpt::SOption COMMAND_LINE_OPTIONS[] =
+{
+    { OPT_HOST,         "--host",           SO_REQ_CMB },
+    { OPT_PORT,         "--port",           SO_REQ_CMB },
+    { OPT_STORE_FOLDER, "--storefolder",    SO_REQ_CMB },
+    { OPT_MAX_SIZE,     "--maxsize",        SO_REQ_CMB },
+    { OPT_WORKERS,      "--workers",        SO_REQ_CMB },
+    { OPT_LOG_FOLDER,   "--logfolder",      SO_REQ_CMB },
+    { OPT_VERBOSE,      "--verbose",        SO_NONE    },
+    { OPT_HELP,         "--help",           SO_NONE    },
+    { OPT_HELP,         "-h",               SO_NONE    },
+    SO_END_OF_OPTIONS
+};
+
+
+/********************************** FUNCTIONS *********************************/
+
+void showUsage(const std::string& strApplicationName)
+{
+    cout << "MASH Features Server" << endl
+         << "Usage: " << strApplicationName << " [options]" << endl
+         << endl
+         << "Stores the features computed by the experiment servers, so the other ones (or" << endl
+         << "the next experiments) can retrieve them instead of computing them again." << endl
+         << endl
+         << "Options:" << endl
+         << "    --help, -h:           Display this help" << endl
+         << "    --host=<host>:        The host name or IP address that the server must listen on." << endl
+         << "                          If not specified, the first available is used." << endl
+         << "    --port=<port>:        The port that the server must listen on (default: 12000)" << endl
+         << "    --storefolder=<path>: Path to the folder where the features are stored" << endl
+         << "                          (default: 'features/')" << endl
+         << "    --maxsize=<MB>:       Maximum size of the stored features, in megabytes. The least" << endl
+         << "                          recently used ones are deleted when it is exceeded" << endl
+         << "                          (default: 1024)" << endl
+         << "    --workers=<N>:        Number of threads processing the requests (default: 4)" << endl
+         << "    --logfolder=<path>:   Path to the location of the log files (default: 'logs/')" << endl
+         << "    --verbose:            Verbose output" << endl;
+}
+
+
+int main(int argc, char** argv)
+{
+    // Declarations
+    string          strHost = "";
+    unsigned int    port = 12000;
+    string          strStoreFolder = "features/";
+    unsigned int    maxSize = 1024;
+    unsigned int    nbWorkers = 4;
+
+
+    // Parse the command-line arguments
+    CSimpleOpt args(argc, argv, COMMAND_LINE_OPTIONS);
+    while (args.Next())
+    {
+        if (args.LastError() == SO_SUCCESS)
+        {
+            switch (args.OptionId())
+            {
+                case OPT_HELP:
+                    showUsage(argv[0]);
+                    return 0;
+
+                case OPT_HOST:
+                    strHost = args.OptionArg();
+                    break;
+
+                case OPT_PORT:
+                    port = StringUtils::parseUnsignedInt(args.OptionArg());
+                    break;
+
+                case OPT_STORE_FOLDER:
+                    strStoreFolder = args.OptionArg();
+                    break;
+
+                case OPT_MAX_SIZE:
+                    maxSize = StringUtils::parseUnsignedInt(args.OptionArg());
+                    break;
+
+                case OPT_WORKERS:
+                    nbWorkers = StringUtils::parseUnsignedInt(args.OptionArg());
+                    if (nbWorkers == 0)
+                        nbWorkers = 1;
+                    break;
+
+                case OPT_LOG_FOLDER:
+                    Server::strLogFolder = args.OptionArg();
+                    if (Server::strLogFolder[Server::strLogFolder.size() - 1] != '/')
+                        Server::strLogFolder += "/";
+                    break;
+
+                case OPT_VERBOSE:
+                    OutStream::verbosityLevel = 1;
+                    break;
+            }
+        }
+        else
+        {
+            cerr << "Invalid argument: " << args.OptionText() << endl;
+            return -1;
+        }
+    }
+
+
+    cout << "********************************************************************************" << endl
+         << "* Features Server" << endl
+         << "* Protocol: " << Listener::getProtocol() << endl
+         << "********************************************************************************" << endl
+         << endl;
+
+    // Open the store
+    if (!Listener::initialize(strStoreFolder, (uint64_t) maxSize * 1024 * 1024))
+    {
+        cerr << "Failed to open the store in '" << strStoreFolder << "'" << endl;
+        return -1;
+    }
+
+    // Start the server. All the connections are handled by this process, so
+    // the listeners share the store.
+    Server server(0, 100, "FeaturesServer", Server::ENGINE_EVENTS, nbWorkers);
+
+    return (server.listen(strHost, port, Listener::createListener) ? 0 : -1);
+}
@@ -103,6 +103,11 @@ extern "C" Instrument* new_instrument()
 
 FeatureList::FeatureList()
 {
+    // The number of features of each heuristic is retrieved when the
+    // experiment starts
+    events = EVENT_CLASSIFICATION_EXPERIMENT_STARTED |
+             EVENT_PLANNER_LEARNING_STARTED |
+             EVENT_FEATURE_LIST_REPORTED;
 }
 
 
@@ -0,0 +1,80 @@
+#include <mash-instrumentation/instrument.h>
+
+using namespace Mash;
+using namespace std;
+
+
+// Logs the per-image events of the classifier with all their arguments, to
+// compare the streams of events of two runs of an experiment
+class EventsLoggerInstrument: public Instrument
+{
+    //_____ Construction / Destruction __________
+public:
+    EventsLoggerInstrument()
+    {
+        events = EVENT_CLASSIFIER_TEST_STARTED | EVENT_CLASSIFIER_TEST_DONE |
+                 EVENT_CLASSIFIER_CLASSIFICATION_DONE | EVENT_FEATURES_COMPUTED_BY_CLASSIFIER;
+    }
+
+    virtual ~EventsLoggerInstrument()
+    {
+    }
+
+
+    //_____ Classifier-related events __________
+public:
+    virtual void onClassifierTestStarted(IClassifierInputSet* input_set)
+    {
+        writer << "onClassifierTestStarted" << endl;
+    }
+
+    virtual void onClassifierTestDone(IClassifierInputSet* input_set,
+                                      scalar_t test_error)
+    {
+        writer << "onClassifierTestDone " << test_error << endl;
+    }
+
+    virtual void onClassifierClassificationDone(IClassifierInputSet* input_set,
+                                                unsigned int image,
+                                                unsigned int original_image,
+                                                const coordinates_t& position,
+                                                const Classifier::tClassificationResults& results,
+                                                tClassificationError error)
+    {
+        writer << "onClassifierClassificationDone " << image << " " << original_image
+               << " " << position.x << " " << position.y << " " << error;
+
+        Classifier::tClassificationResults::const_iterator iter, iterEnd;
+        for (iter = results.begin(), iterEnd = results.end(); iter != iterEnd; ++iter)
+            writer << " " << iter->first << ":" << iter->second;
+
+        writer << endl;
+    }
+
+    virtual void onFeaturesComputedByClassifier(bool detection,
+                                                bool training,
+                                                unsigned int image,
+                                                unsigned int original_image,
+                                                const coordinates_t& coords,
+                                                unsigned int roiExtent,
+                                                unsigned int heuristic,
+                                                unsigned int nbFeatures,
+                                                unsigned int* indexes,
+                                                scalar_t* values)
+    {
+        writer << "onFeaturesComputedByClassifier " << detection << " " << training
+               << " " << image << " " << original_image << " " << coords.x << " "
+               << coords.y << " " << roiExtent << " " << heuristic;
+
+        for (unsigned int i = 0; i < nbFeatures; ++i)
+            writer << " " << indexes[i] << ":" << values[i];
+
+        writer << endl;
+    }
+};
+
+
+extern "C" Instrument* new_instrument()
+{
+    return new EventsLoggerInstrument();
+}
@@ -0,0 +1,105 @@
+#include <mash-instrumentation/instrument.h>
+
+using namespace Mash;
+using namespace std;
+
+
+// Crashes in all the classifier-related events, but only declares to consume
+// the 'feature list reported' one: the other events must never reach it
+class UnsubscribedEventsInstrument: public Instrument
+{
+    //_____ Construction / Destruction __________
+public:
+    UnsubscribedEventsInstrument()
+    {
+        events = EVENT_FEATURE_LIST_REPORTED;
+    }
+
+    virtual ~UnsubscribedEventsInstrument()
+    {
+    }
+    
+
+    //_____ General events __________
+public:
+    virtual void onExperimentDone()
+    {
+        crash();
+    }
+
+
+    //_____ Classifier-related events __________
+public:
+    virtual void onExperimentStarted(IClassifierInputSet* input_set)
+    {
+        crash();
+    }
+
+    virtual void onClassifierTrainingStarted(IClassifierInputSet* input_set)
+    {
+        crash();
+    }
+
+    virtual void onClassifierTrainingDone(IClassifierInputSet* input_set,
+                                          scalar_t train_error)
+    {
+        crash();
+    }
+
+    virtual void onClassifierTestStarted(IClassifierInputSet* input_set)
+    {
+        crash();
+    }
+
+    virtual void onClassifierTestDone(IClassifierInputSet* input_set,
+                                      scalar_t test_error)
+    {
+        crash();
+    }
+
+    virtual void onClassifierClassificationDone(IClassifierInputSet* input_set,
+                                                unsigned int image,
+                                                unsigned int original_image,
+                                                const coordinates_t& position,
+                                                const Classifier::tClassificationResults& results,
+                                                tClassificationError error)
+    {
+        crash();
+    }
+
+    virtual void onFeaturesComputedByClassifier(bool detection,
+                                                bool training,
+                                                unsigned int image,
+                                                unsigned int original_image,
+                                                const coordinates_t& coords,
+                                                unsigned int roiExtent,
+                                                unsigned int heuristic,
+                                                unsigned int nbFeatures,
+                                                unsigned int* indexes,
+                                                scalar_t* values)
+    {
+        crash();
+    }
+
+
+    //_____ Predictor-related events __________
+public:
+    virtual void onFeatureListReported(const tFeatureList& features)
+    {
+    }
+
+
+    //_____ Internal methods __________
+protected:
+    void crash()
+    {
+        int* p = 0;
+        *p = 4;
+    }
+};
+
+
+extern "C" Instrument* new_instrument()
+{
+    return new UnsubscribedEventsInstrument();
+}
@@ -188,6 +188,31 @@ namespace Mash
         //----------------------------------------------------------------------
         virtual unsigned char* getView(const std::string& view, size_t &nbBytes,
                                        std::string &mimetype) = 0;
+
+        //----------------------------------------------------------------------
+        /// @brief Returns the file containing one of the views, if any
+        ///
+        /// Allows to send the view directly from the disk, without loading it
+        /// in memory. getView() is used if this method returns 'false'.
+        ///
+        /// @param[in]  view        The name of the view
+        /// @param[out] strFileName Path to the file
+        /// @param[out] mimetype    The MIME type of the content of the file
+        /// @return                 'true' if the view is a file
+        //----------------------------------------------------------------------
+        virtual bool getViewFile(const std::string& view, std::string &strFileName,
+                                 std::string &mimetype) { return false; }
+
+        //----------------------------------------------------------------------
+        /// @brief Indicates if the client would rather receive the pixels of
+        ///        the views than encoded images
+        ///
+        /// When set, getView() should return 'raw' buffers if it can. This is
+        /// only a hint: encoded images are still sent to the client as-is.
+        ///
+        /// @param  bPreferred  'true' if the raw buffers are preferred
+        //----------------------------------------------------------------------
+        virtual void setRawViewsPreferred(bool bPreferred) {}
         
         //----------------------------------------------------------------------
         /// @brief Performs an action
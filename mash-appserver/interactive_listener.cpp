@@ -32,10 +32,12 @@
 #include "interactive_listener.h"
 #include <mash-network/server.h>
 #include <mash-utils/stringutils.h>
+#include <mash-utils/compression.h>
 #include <sstream>
 #include <iostream>
 #include <sys/stat.h> 
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
 
@@ -45,7 +47,7 @@ using namespace Mash;
 
 /********************************** CONSTANTS *********************************/
 
-const char* PROTOCOL = "1.4";
+const char* PROTOCOL = "1.5";
 
 
 /****************************** STATIC ATTRIBUTES *****************************/
@@ -60,7 +62,8 @@ struct timeval                              InteractiveListener::timeout = { 0 }
 
 InteractiveListener::InteractiveListener(int socket)
 : ServerListener(socket), _pApplicationServer(0), _bDoingSetup(false),
-  _bGlobalSeedSelected(false), _mode(GPMODE_STANDARD)
+  _bGlobalSeedSelected(false), _mode(GPMODE_STANDARD),
+  _viewEncoding(VIEW_ENCODING_DEFAULT)
 {
     char buffer1[50];
     char buffer2[50];
@@ -89,10 +92,10 @@ ServerListener::tAction InteractiveListener::handleCommand(
                                         const std::string& strCommand,
                                         const ArgumentsList& arguments)
 {
-    tCommandHandlersIterator iter = handlers.find(strCommand);
-    if (iter != handlers.end())
+    const tCommandHandler* pHandler = handlers.find(strCommand);
+    if (pHandler)
     {
-        tCommandHandler handler = iter->second;
+        tCommandHandler handler = *pHandler;
         return (this->*handler)(arguments);
     }
 
@@ -142,6 +145,7 @@ void InteractiveListener::initialize(bool bVerbose,
     handlers["GET_TRAJECTORY_LENGTH"]   = &InteractiveListener::handleGetTrajectoryLengthCommand;
     handlers["GET_VIEW"]                = &InteractiveListener::handleGetViewCommand;
     handlers["ACTION"]                  = &InteractiveListener::handleActionCommand;
+    handlers["USE_VIEW_ENCODING"]       = &InteractiveListener::handleUseViewEncodingCommand;
     
     InteractiveListener::bVerbose      = bVerbose;
     InteractiveListener::pConstructor  = applicationServerConstructor;
@@ -207,18 +211,18 @@ ServerListener::tAction InteractiveListener::handleLogsCommand(const ArgumentsLi
 {
     const int MAX_SIZE = 200 * 1024;
     
-    unsigned char* pData = 0;
-    int size = 0;
-    
-    size = _outStream.dump(&pData, MAX_SIZE);
+    // The log file is sent directly from the disk
+    int64_t offset = 0;
+    int64_t size = _outStream.locateDump(&offset, MAX_SIZE);
     if (size > 0)
     {
+        // Mark the truncated file like OutStream::dump() does
+        string strPrefix = (offset > 0 ? "...\n" : "");
+
         ArgumentsList args;
         args.add("ApplicationServer.log");
-        args.add(size);
-        sendResponse("LOG_FILE", args);
-        sendData((const unsigned char*) pData, size);
-        delete[] pData;
+        args.add((int) (strPrefix.size() + size));
+        sendFile("LOG_FILE", args, _outStream.getFileName(), offset, size, strPrefix);
     }
     
     if (!sendResponse("END_LOGS", ArgumentsList()))
@@ -241,6 +245,8 @@ ServerListener::tAction InteractiveListener::handleResetCommand(const Mash::Argu
 
     _bDoingSetup = false;
     _bGlobalSeedSelected = false;
+    _viewEncoding = VIEW_ENCODING_DEFAULT;
+    _previousViews.clear();
 
     _pApplicationServer = pConstructor();
 
@@ -418,6 +424,7 @@ ServerListener::tAction InteractiveListener::handleInitializeTaskCommand(const A
     
     // Send the list of views to the client
     _views = _pApplicationServer->getViews(strGoal, strEnvironment);
+    _previousViews.clear();
     responseArguments.clear();
 
     IApplicationServer::tViewsIterator iter2, iterEnd2;
@@ -647,6 +654,26 @@ ServerListener::tAction InteractiveListener::handleGetViewCommand(const Argument
     size_t data_size = 0;
     string mime_type;
     bool bRaw = false;
+
+    // Files are sent directly from the disk if the client doesn't want the
+    // pixels
+    string strFileName;
+    struct stat infos;
+    if ((_viewEncoding == VIEW_ENCODING_DEFAULT) &&
+        _pApplicationServer->getViewFile(iter->name, strFileName, mime_type) &&
+        (stat(strFileName.c_str(), &infos) == 0) && (infos.st_size > 0))
+    {
+        ArgumentsList responseArgs;
+        responseArgs.add(iter->name);
+        responseArgs.add(mime_type);
+        responseArgs.add((int) infos.st_size);
+
+        if (!sendFile("VIEW", responseArgs, strFileName, 0, infos.st_size))
+            return ACTION_CLOSE_CONNECTION;
+
+        return ACTION_NONE;
+    }
+
     unsigned char* pImage = _pApplicationServer->getView(iter->name, data_size, mime_type);
     if (!pImage)
         return ACTION_CLOSE_CONNECTION;
@@ -658,53 +685,139 @@ ServerListener::tAction InteractiveListener::handleGetViewCommand(const Argument
         data_size = 8 + 3 * iter->width * iter->height;
     }
 
+    // Pixels: prepend the header of the MASH Image Format, and convert them to
+    // the selected encoding
+    if (bRaw)
+    {
+        tViewBuffer view(data_size);
+        view[0] = 'M';
+        view[1] = 'I';
+        view[2] = 'F';
+        view[3] = 1;
+        view[4] = iter->width % 256;
+        view[5] = iter->width / 256;
+        view[6] = iter->height % 256;
+        view[7] = iter->height / 256;
+        memcpy(&view[8], pImage, data_size - 8);
+
+        delete[] pImage;
+
+        bool bResult = sendView(iter->name, &view);
+
+        return (bResult ? ACTION_NONE : ACTION_CLOSE_CONNECTION);
+    }
+
     ArgumentsList responseArgs;
     responseArgs.add(iter->name);
     responseArgs.add(mime_type);
     responseArgs.add((int) data_size);
     
-    if (!sendResponse("VIEW", responseArgs))
+    bool bResult = sendResponse("VIEW", responseArgs, pImage, data_size);
+
+    delete[] pImage;
+
+    return (bResult ? ACTION_NONE : ACTION_CLOSE_CONNECTION);
+}
+
+
+ServerListener::tAction InteractiveListener::handleUseViewEncodingCommand(const ArgumentsList& arguments)
+{
+    // Check the arguments
+    if (arguments.size() != 1)
     {
-        delete[] pImage;
-        return ACTION_CLOSE_CONNECTION;
+        if (!sendResponse("INVALID_ARGUMENTS", arguments))
+            return ACTION_CLOSE_CONNECTION;
+
+        return ACTION_NONE;
     }
 
-    if (bRaw)
+    string strEncoding = arguments.getString(0);
+
+    if (strEncoding == "DEFAULT")
     {
-        unsigned char header[8];
-        header[0] = 'M';
-        header[1] = 'I';
-        header[2] = 'F';
-        header[3] = 1;
-        header[4] = iter->width % 256;
-        header[5] = iter->width / 256;
-        header[6] = iter->height % 256;
-        header[7] = iter->height / 256;
-    
-        if (!sendData((const unsigned char*) header, 8))
-        {
-            delete[] pImage;
+        _viewEncoding = VIEW_ENCODING_DEFAULT;
+    }
+    else if (strEncoding == "RAW")
+    {
+        _viewEncoding = VIEW_ENCODING_RAW;
+    }
+    else if (strEncoding == "LZ4")
+    {
+        _viewEncoding = VIEW_ENCODING_LZ4;
+    }
+    else if (strEncoding == "DELTA")
+    {
+        _viewEncoding = VIEW_ENCODING_DELTA;
+    }
+    else
+    {
+        if (!sendResponse("UNSUPPORTED_VIEW_ENCODING", arguments))
             return ACTION_CLOSE_CONNECTION;
-        }
 
-        if (!sendData(pImage, data_size - 8))
-        {
-            delete[] pImage;
-            return ACTION_CLOSE_CONNECTION;
-        }
+        return ACTION_NONE;
     }
-    else
+
+    _previousViews.clear();
+
+    // Ask the application server to provide the pixels of the views instead of
+    // encoded images, if possible
+    _pApplicationServer->setRawViewsPreferred(_viewEncoding != VIEW_ENCODING_DEFAULT);
+
+    if (!sendResponse("OK", ArgumentsList()))
+        return ACTION_CLOSE_CONNECTION;
+
+    return ACTION_NONE;
+}
+
+
+bool InteractiveListener::sendView(const std::string& strName,
+                                   std::vector<unsigned char>* pView)
+{
+    // Assertions
+    assert(pView);
+
+    // Declarations
+    string strMimeType = "image/mif";
+    const unsigned char* pData = &(*pView)[0];
+    unsigned int size = pView->size();
+    tViewBuffer compressed;
+
+    if ((_viewEncoding != VIEW_ENCODING_DEFAULT) && (_viewEncoding != VIEW_ENCODING_RAW))
     {
-        if (!sendData(pImage, data_size))
+        // Only transmit the difference with the previous version of the view,
+        // which is kept (as known by the client)
+        if (_viewEncoding == VIEW_ENCODING_DELTA)
         {
-            delete[] pImage;
-            return ACTION_CLOSE_CONNECTION;
+            tViewBuffer& previous = _previousViews[strName];
+
+            if (previous.size() == pView->size())
+            {
+                previous.swap(*pView);
+                Compression::xorBuffers(&(*pView)[0], &previous[0], size);
+                strMimeType = "image/mif+lz4-delta";
+            }
+            else
+            {
+                previous = *pView;
+                strMimeType = "image/mif+lz4";
+            }
+        }
+        else
+        {
+            strMimeType = "image/mif+lz4";
         }
+
+        compressed.resize(Compression::compressBound(size));
+        size = Compression::compress(&(*pView)[0], size, &compressed[0], compressed.size());
+        pData = &compressed[0];
     }
 
-    delete[] pImage;
+    ArgumentsList responseArgs;
+    responseArgs.add(strName);
+    responseArgs.add(strMimeType);
+    responseArgs.add((int) size);
 
-    return ACTION_NONE;
+    return sendResponse("VIEW", responseArgs, pData, size);
 }
 
 
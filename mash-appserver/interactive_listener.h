@@ -34,8 +34,10 @@
 
 #include "application_server_interface.h"
 #include <mash-network/server_listener.h>
+#include <mash-network/commands_table.h>
 #include <mash-utils/declarations.h>
 #include <map>
+#include <vector>
 
 
 namespace Mash
@@ -88,17 +90,42 @@ namespace Mash
         tAction handleGetNbTrajectoriesCommand(const Mash::ArgumentsList& arguments);
         tAction handleGetTrajectoryLengthCommand(const Mash::ArgumentsList& arguments);
         tAction handleGetViewCommand(const Mash::ArgumentsList& arguments);
+        tAction handleUseViewEncodingCommand(const Mash::ArgumentsList& arguments);
         tAction handleActionCommand(const Mash::ArgumentsList& arguments);
 
         void chooseGlobalSeed();
+
+        //----------------------------------------------------------------------
+        /// @brief  Sends a view to the client, using the selected encoding
+        ///
+        /// @param  strName     Name of the view
+        /// @param  pView       The view, in MIF format (modified)
+        /// @return             'false' if failed
+        //----------------------------------------------------------------------
+        bool sendView(const std::string& strName, std::vector<unsigned char>* pView);
         
 
         //_____ Internal types __________
     private:
         typedef tAction (InteractiveListener::*tCommandHandler)(const Mash::ArgumentsList&);
     
-        typedef std::map<std::string, tCommandHandler>  tCommandHandlersList;
-        typedef tCommandHandlersList::iterator          tCommandHandlersIterator;
+        typedef Mash::CommandsTable<tCommandHandler>    tCommandHandlersList;
+
+        //----------------------------------------------------------------------
+        /// @brief  The encodings of the views (see the 'USE_VIEW_ENCODING'
+        ///         command)
+        //----------------------------------------------------------------------
+        enum tViewEncoding
+        {
+            VIEW_ENCODING_DEFAULT,      ///< As provided by the application server
+            VIEW_ENCODING_RAW,          ///< Uncompressed pixels ('image/mif')
+            VIEW_ENCODING_LZ4,          ///< Compressed pixels ('image/mif+lz4')
+            VIEW_ENCODING_DELTA,        ///< Compressed difference with the previous
+                                        ///  version of the view ('image/mif+lz4-delta')
+        };
+
+        typedef std::vector<unsigned char>              tViewBuffer;
+        typedef std::map<std::string, tViewBuffer>      tViewBuffersList;
 
 
         //_____ Attributes __________
@@ -117,6 +144,9 @@ namespace Mash
         tStringList                     _actions;
         IApplicationServer::tViewsList  _views;
         tGoalPlanningMode               _mode;
+        tViewEncoding                   _viewEncoding;
+        tViewBuffersList                _previousViews;     ///< Last version of each view sent
+                                                            ///  (VIEW_ENCODING_DELTA only)
     };
 
 
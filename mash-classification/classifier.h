@@ -69,6 +69,12 @@ namespace Mash
         //----------------------------------------------------------------------
         typedef std::map<int, scalar_t> tClassificationResults;
 
+        //----------------------------------------------------------------------
+        /// @brief  Contains the results of the classification of several
+        ///         positions (see classifyBatch())
+        //----------------------------------------------------------------------
+        typedef std::vector<tClassificationResults> tClassificationResultsList;
+
 
         //_____ Construction / Destruction __________
     public:
@@ -145,6 +151,109 @@ namespace Mash
                               const coordinates_t& position,
                               tClassificationResults &results) = 0;
 
+        //----------------------------------------------------------------------
+        /// @brief  Classify the content of an image at several positions
+        ///
+        /// @param  input_set   The Classifier Input Set to use
+        /// @param  image       Index of the image (in the Input Set)
+        /// @param  positions   Centers of the regions-of-interest (in the
+        ///                     image)
+        /// @retval results     Classification results, one per position (the
+        ///                     list is resized by the caller beforehand)
+        /// @return             'true' if successful
+        ///
+        /// Used during the detection, to scan an image. The default
+        /// implementation calls classify() for each position (or evaluates
+        /// the stages of the cascade, see getCascadeStages()): classifiers
+        /// able to share some work between the positions of an image should
+        /// override it.
+        ///
+        /// @remark The implementation of this method is optional
+        //----------------------------------------------------------------------
+        virtual bool classifyBatch(IClassifierInputSet* input_set,
+                                   unsigned int image,
+                                   const tCoordinatesList& positions,
+                                   tClassificationResultsList &results)
+        {
+            std::vector<scalar_t> thresholds;
+            if (getCascadeStages(thresholds))
+            {
+                for (unsigned int i = 0; i < positions.size(); ++i)
+                {
+                    if (!classifyWithCascade(input_set, image, positions[i],
+                                             thresholds, results[i]))
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            for (unsigned int i = 0; i < positions.size(); ++i)
+            {
+                if (!classify(input_set, image, positions[i], results[i]))
+                    return false;
+            }
+
+            return true;
+        }
+
+        //----------------------------------------------------------------------
+        /// @brief  Indicates if the classifier is organized as a cascade of
+        ///         stages, and retrieve their reject thresholds
+        ///
+        /// @retval thresholds  The reject threshold of each stage
+        /// @return             'true' if the classifier is a cascade
+        ///
+        /// During the detection, the stages are evaluated one after the other
+        /// by classifyStage(), and a position is rejected (no result) as soon
+        /// as the biggest score accumulated so far is below the threshold of
+        /// the stage: the features needed by the remaining stages aren't
+        /// computed at all for that position. Since most of the positions
+        /// scanned in an image are background, a few cheap stages are usually
+        /// enough to discard them.
+        ///
+        /// A position going through all the stages gets the accumulated
+        /// scores as results (which must be the ones classify() would return).
+        ///
+        /// @note   This method is called once per image to scan, after the
+        ///         classifier was trained (or its model loaded)
+        ///
+        /// @remark The implementation of this method is optional
+        //----------------------------------------------------------------------
+        virtual bool getCascadeStages(std::vector<scalar_t> &thresholds)
+        {
+            return false;
+        }
+
+        //----------------------------------------------------------------------
+        /// @brief  Evaluate one stage of the cascade at a specific position
+        ///
+        /// @param      input_set   The Classifier Input Set to use
+        /// @param      image       Index of the image (in the Input Set)
+        /// @param      position    Center of the region-of-interest (in the
+        ///                         image)
+        /// @param      stage       Index of the stage
+        /// @param[in,out] results  The scores accumulated by the previous
+        ///                         stages (empty for the first one), to
+        ///                         update with the ones of this stage
+        /// @return                 'true' if successful
+        ///
+        /// Only the features needed by the stage should be computed here.
+        ///
+        /// @remark The implementation of this method is mandatory if
+        ///         getCascadeStages() returns 'true'
+        //----------------------------------------------------------------------
+        virtual bool classifyStage(IClassifierInputSet* input_set,
+                                   unsigned int image,
+                                   const coordinates_t& position,
+                                   unsigned int stage,
+                                   tClassificationResults &results)
+        {
+            return false;
+        }
+
         //----------------------------------------------------------------------
         /// @brief  Populates the provided list with the features used by the
         ///         classifier
@@ -181,6 +290,56 @@ namespace Mash
         virtual bool saveModel(PredictorModel &model) = 0;
 
 
+        //_____ Internal methods __________
+    protected:
+        //----------------------------------------------------------------------
+        /// @brief  Evaluate the stages of the cascade at a specific position,
+        ///         until it is rejected
+        ///
+        /// @param  input_set   The Classifier Input Set to use
+        /// @param  image       Index of the image (in the Input Set)
+        /// @param  position    Center of the region-of-interest (in the image)
+        /// @param  thresholds  The reject threshold of each stage
+        /// @retval results     Classification results (empty if the position
+        ///                     was rejected)
+        /// @return             'true' if successful
+        //----------------------------------------------------------------------
+        bool classifyWithCascade(IClassifierInputSet* input_set,
+                                 unsigned int image,
+                                 const coordinates_t& position,
+                                 const std::vector<scalar_t>& thresholds,
+                                 tClassificationResults &results)
+        {
+            results.clear();
+
+            for (unsigned int stage = 0; stage < thresholds.size(); ++stage)
+            {
+                if (!classifyStage(input_set, image, position, stage, results))
+                    return false;
+
+                bool bRejected = true;
+
+                tClassificationResults::const_iterator iter, iterEnd;
+                for (iter = results.begin(), iterEnd = results.end(); iter != iterEnd; ++iter)
+                {
+                    if (iter->second >= thresholds[stage])
+                    {
+                        bRejected = false;
+                        break;
+                    }
+                }
+
+                if (bRejected)
+                {
+                    results.clear();
+                    break;
+                }
+            }
+
+            return true;
+        }
+
+
         //_____ Attributes __________
     public:
         OutStream               outStream;          ///< The stream to use for logging
@@ -142,6 +142,21 @@ namespace Mash
                               const coordinates_t& position,
                               Classifier::tClassificationResults &results) = 0;
 
+        //----------------------------------------------------------------------
+        /// @brief  Classify the content of an image at several positions
+        ///
+        /// @param  input_set   The Classifier Input Set to use
+        /// @param  image       Index of the image (in the Input Set)
+        /// @param  positions   Centers of the regions-of-interest (in the
+        ///                     image)
+        /// @retval results     Classification results, one per position
+        /// @return             'true' if successful
+        //----------------------------------------------------------------------
+        virtual bool classifyBatch(IClassifierInputSet* input_set,
+                                   unsigned int image,
+                                   const tCoordinatesList& positions,
+                                   Classifier::tClassificationResultsList &results) = 0;
+
         //----------------------------------------------------------------------
         /// @brief  Populates the provided list with the features used by the
         ///         classifier
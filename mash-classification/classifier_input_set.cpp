@@ -31,6 +31,7 @@
 
 #include "classifier_input_set.h"
 #include "object_intersecter.h"
+#include "features_store_client.h"
 #include <mash/imageutils.h>
 #include <algorithm>
 #include <assert.h>
@@ -49,7 +50,8 @@ using namespace Mash;
 ClassifierInputSet::ClassifierInputSet(unsigned int maxNbSamplesInCaches,
                                        bool detection)
 : _id(0), _database(maxNbSamplesInCaches), _dataset(maxNbSamplesInCaches),
-  _stepper(detection), _pListener(0), _bRestrictedAccess(false), _bReadOnly(false)
+  _stepper(detection), _pListener(0), _bRestrictedAccess(false), _bReadOnly(false),
+  _pFeaturesStore(0)
 {
 }
 
@@ -198,6 +200,8 @@ tError ClassifierInputSet::setParameters(const tExperimentParametersList& parame
     _dataset.setup(&_database, roiExtent, &_stepper, bUseStandardSets,
                    ratioTrainingSamples, imagesSeed, &_computer);
 
+    _imageKeys.clear();
+
     return ERROR_NONE;
 }
 
@@ -268,17 +272,41 @@ bool ClassifierInputSet::computeSomeFeatures(unsigned int image,
         (coordinates.y < roiExtent) || (coordinates.y + roiExtent >= pImage->height()))
         return false;
 
+    unsigned int imageIndex = _dataset.getImageIndex(image);
+    bool success = false;
+    bool bUseStore = false;
+
+    // Look up the features in the store first (if any)
+    if (_pFeaturesStore && _pFeaturesStore->isConnected())
+    {
+        std::map<unsigned int, std::string>::iterator iter = _imageKeys.find(imageIndex);
+        if (iter == _imageKeys.end())
+        {
+            iter = _imageKeys.insert(make_pair(imageIndex,
+                                               FeaturesStoreClient::hashImage(pImage, roiExtent))).first;
+        }
+
+        bUseStore = _pFeaturesStore->selectImage(iter->second);
+        success = bUseStore && _pFeaturesStore->lookup(heuristic, coordinates, nbFeatures,
+                                                       indexes, values);
+    }
+
     // Compute the features
-    bool success = _computer.computeSomeFeatures(_dataset.getImageIndex(image), 0,
-                                                 pImage, coordinates, heuristic,
-                                                 nbFeatures, indexes, values);
+    if (!success)
+    {
+        success = _computer.computeSomeFeatures(imageIndex, 0, pImage, coordinates,
+                                                heuristic, nbFeatures, indexes, values);
+
+        if (success && bUseStore)
+            _pFeaturesStore->store(heuristic, coordinates, nbFeatures, indexes, values);
+    }
 
     // Notify the instruments
     if (_pListener && success)
     {
         _pListener->onFeaturesComputed(isDoingDetection(),
                                        _dataset.getMode() == DataSet::MODE_TRAINING,
-                                       image, _dataset.getImageIndex(image),
+                                       image, imageIndex,
                                        coordinates, roiExtent, heuristic,
                                        nbFeatures, indexes, values);
     }
@@ -44,8 +44,9 @@
 
 namespace Mash
 {
-    // Forward declaration
+    // Forward declarations
     class Client;
+    class FeaturesStoreClient;
 
 
     //--------------------------------------------------------------------------
@@ -149,6 +150,16 @@ namespace Mash
             _pListener = pListener;
         }
 
+        //----------------------------------------------------------------------
+        /// @brief  Set the store in which the features are looked up before
+        ///         being computed, and to which the computed ones are added
+        ///         (the object isn't owned by the Input Set)
+        //----------------------------------------------------------------------
+        inline void setFeaturesStore(FeaturesStoreClient* pFeaturesStore)
+        {
+            _pFeaturesStore = pFeaturesStore;
+        }
+
         //----------------------------------------------------------------------
         /// @brief  Must be called when the data in the set has changed
         //----------------------------------------------------------------------
@@ -404,6 +415,9 @@ namespace Mash
         std::string                     _strLastError;
         bool                            _bReadOnly;
         std::vector<unsigned int>       _heuristicsInModel;
+        FeaturesStoreClient*            _pFeaturesStore;
+        std::map<unsigned int, std::string> _imageKeys;    ///< Keys of the images in the features
+                                                            ///  store, by 'true index'
     };
 }
 
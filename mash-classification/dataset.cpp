@@ -41,10 +41,18 @@ using namespace std;
 using namespace Mash;
 
 
+/********************************** STATICS ***********************************/
+
+const unsigned int DataSet::MIN_ENTRIES_PER_CHECKPOINT;
+
+
 /************************* CONSTRUCTION / DESTRUCTION *************************/
 
 DataSet::DataSet(unsigned int maxNbImagesInCache)
-: _mode(MODE_NORMAL), _pDatabase(0), _roi_extent(0), _cache(maxNbImagesInCache)
+: _mode(MODE_NORMAL), _pDatabase(0), _roi_extent(0), _stepper(0),
+  _bUseStandardSets(false), _trainingRatio(0.0f), _cache(maxNbImagesInCache),
+  _nbEntries(0), _nbObjectsEntries(0), _entriesPerCheckpoint(MIN_ENTRIES_PER_CHECKPOINT),
+  _checkpoint(0), _nbImages(0), _nbTrainingImages(0), _nbTestImages(0)
 {
 }
 
@@ -71,191 +79,61 @@ void DataSet::setup(ImageDatabase* pDatabase, unsigned int roi_extent,
     _pDatabase = pDatabase;
     _roi_extent = roi_extent;
     _stepper = stepper;
+    _bUseStandardSets = bUseStandardSets;
+    _trainingRatio = trainingRatio;
     _cache.setListener(pCacheListener);
-    _generator.setSeed(seed);
 
-    // Determines the number of objects used during training for each label
-    vector<unsigned int> trainingCounters;
-    vector<unsigned int> unassignedObjectsCounters;
-    for (unsigned int i = 0; i < pDatabase->nbLabels(); ++i)
-    {
-        unsigned int nbObjects = pDatabase->nbObjects(i);
-        unassignedObjectsCounters.push_back(nbObjects);
-        trainingCounters.push_back(min(nbObjects - 1, (unsigned) max(int(nbObjects * trainingRatio), 1)));
-    }
+    _checkpoints.clear();
+    _entries.clear();
+    _scales.clear();
+
+    _nbEntries = pDatabase->nbImages();
+    _nbObjectsEntries = 0;
+    _entriesPerCheckpoint = max(MIN_ENTRIES_PER_CHECKPOINT, 8 * pDatabase->nbLabels());
 
-    // Populate the list used to generate the images
-    unsigned int roi_size = roi_extent * 2 + 1;
     for (unsigned int image = 0; image < pDatabase->nbImages(); ++image)
     {
-        dim_t image_size = pDatabase->imageSize(image);
-
-        Stepper::tScalesList scales;
-        _stepper->getScales(image_size, &scales);
-        assert(scales.size() > 0);
-
-        ImageDatabase::tObjectsList* pObjects = pDatabase->objectsOfImage(image);
-
-        tGeneratedImagesList generatedImages;
-
-        if (!pObjects->empty())
-        {
-            ImageDatabase::tObjectsIterator iter, iterEnd;
-            tGeneratedImagesIterator iter2, iterEnd2;
-            Stepper::tScalesIterator iter3, iterEnd3;
-
-            // Determine in which set should go the generated images (training or test)
-            vector<unsigned int> labelCounters(pDatabase->nbLabels(), 0);
-
-            ImageDatabase::tImageSet set = (bUseStandardSets ? pDatabase->imageSet(image) : ImageDatabase::SET_NONE);
-
-            if (set == ImageDatabase::SET_NONE)
-            {
-                bool training = false;
-                bool test = false;
-
-                for (iter = pObjects->begin(), iterEnd = pObjects->end(); iter != iterEnd; ++iter)
-                {
-                    unsigned int label = iter->label;
-
-                    if (trainingCounters[label] == 0)
-                        test = true;
-                    else if (unassignedObjectsCounters[label] <= trainingCounters[label])
-                        training = true;
-
-                    ++labelCounters[label];
-                    --unassignedObjectsCounters[label];
-                }
-
-                if (training)
-                    set = ImageDatabase::SET_TRAINING;
-                else if (test)
-                    set = ImageDatabase::SET_TEST;
-                else
-                    set = (_generator.randomize(1.0f) < trainingRatio) ? ImageDatabase::SET_TRAINING : ImageDatabase::SET_TEST;
-            }
-
-            if (set == ImageDatabase::SET_TRAINING)
-            {
-                for (unsigned int label = 0; label < labelCounters.size(); ++label)
-                    trainingCounters[label] -= labelCounters[label];
-            }
-
-            for (iter = pObjects->begin(), iterEnd = pObjects->end(); iter != iterEnd; ++iter)
-            {
-                // Compute the scale of the generated image
-                unsigned int width = iter->bottom_right.x - iter->top_left.x + 1;
-                unsigned int height = iter->bottom_right.y - iter->top_left.y + 1;
-                unsigned int size = max(width, height);
-                float scale = 1.0f;
-
-                // Look for the scale where the size of the object is the closest
-                // to the ROI size
-                int smallest_diff;
-
-                for (iter3 = scales.begin(), iterEnd3 = scales.end(); iter3 != iterEnd3; ++iter3)
-                {
-                    int diff = abs(int(size * (*iter3)) - int(roi_size));
-
-                    if (iter3 == scales.begin() || diff <= smallest_diff)
-                    {
-                        smallest_diff = diff;
-                        scale = *iter3;
-                    }
-                }
-
-                iter->scale = scale;
-
-                // Search if there is already a generated image with that scale
-                if (set == ImageDatabase::SET_TRAINING || !_stepper->isDoingDetection())
-                {
-                    bool found = false;
-                    for (iter2 = generatedImages.begin(), iterEnd2 = generatedImages.end(); iter2 != iterEnd2; ++iter2)
-                    {
-                        if ((iter2->scale >= scale - 1e-6f) && (iter2->scale <= scale + 1e-6f))
-                        {
-                            found = true;
-                            break;
-                        }
-                    }
-
-                    // Create the generated image if necessary
-                    if (!found)
-                    {
-                        tGeneratedImage generatedImage;
-                        generatedImage.original_image = image;
-                        generatedImage.scale = scale;
-                        generatedImages.push_back(generatedImage);
-                    }
-                }
-            }
+        if (!pDatabase->objectsOfImage(image)->empty())
+            ++_nbObjectsEntries;
+    }
 
+    // Initial state of the generation
+    tGenerationState state;
+    state.generator.setSeed(seed);
+    state.entry             = 0;
+    state.image             = 0;
+    state.nbImages          = 0;
+    state.nbTrainingImages  = 0;
+    state.nbTestImages      = 0;
+    state.backgroundCounter = (_nbEntries - _nbObjectsEntries) * trainingRatio;
 
-            if (_stepper->isDoingDetection() && set == ImageDatabase::SET_TEST)
-            {
-                for (iter3 = scales.begin(), iterEnd3 = scales.end(); iter3 != iterEnd3; ++iter3)
-                {
-                    tGeneratedImage generatedImage;
-                    generatedImage.original_image = image;
-                    generatedImage.scale = *iter3;
-                    generatedImages.push_back(generatedImage);
-                }
-            }
+    // Determines the number of objects used during training for each label
+    for (unsigned int i = 0; i < pDatabase->nbLabels(); ++i)
+    {
+        unsigned int nbObjects = pDatabase->nbObjects(i);
+        state.unassignedObjectsCounters.push_back(nbObjects);
+        state.trainingCounters.push_back(min(nbObjects - 1, (unsigned) max(int(nbObjects * trainingRatio), 1)));
+    }
 
+    // Generate all the entries once, to count the images and save the
+    // checkpoints
+    tEntry entry;
+    vector<float> scales;
 
-            for (iter2 = generatedImages.begin(), iterEnd2 = generatedImages.end(); iter2 != iterEnd2; ++iter2)
-            {
-                _images.push_back(*iter2);
+    while (state.entry < _nbEntries)
+    {
+        if (state.entry % _entriesPerCheckpoint == 0)
+            _checkpoints.push_back(state);
 
-                if (set == ImageDatabase::SET_TRAINING)
-                    _trainingImages.push_back(_images.size() - 1);
-                else
-                    _testImages.push_back(_images.size() - 1);
-            }
-        }
-        else
-        {
-            _backgroundImages.push_back(image);
-        }
+        generateEntry(&state, &entry, &scales);
+        scales.clear();
     }
 
-    // Assign the background images to one of the two sets (training or test)
-    unsigned int counter = _backgroundImages.size() * trainingRatio;
-    for (unsigned int i = 0; i < _backgroundImages.size(); ++i)
-    {
-        ImageDatabase::tImageSet set = (bUseStandardSets ? pDatabase->imageSet(_backgroundImages[i]) : ImageDatabase::SET_NONE);
+    _checkpoint = _checkpoints.size();
 
-        if (set == ImageDatabase::SET_NONE)
-        {
-            if (counter == 0)
-            {
-                _testImages.push_back(_images.size() + i);
-            }
-            else if (counter >= _backgroundImages.size() - i)
-            {
-                _trainingImages.push_back(_images.size() + i);
-                --counter;
-            }
-            else if (_generator.randomize(100) > 50)
-            {
-                _trainingImages.push_back(_images.size() + i);
-                --counter;
-            }
-            else
-            {
-                _testImages.push_back(_images.size() + i);
-            }
-        }
-        else if (set == ImageDatabase::SET_TRAINING)
-        {
-            _trainingImages.push_back(_images.size() + i);
-            --counter;
-        }
-        else
-        {
-            _testImages.push_back(_images.size() + i);
-        }
-    }
+    _nbImages = state.nbImages;
+    _nbTrainingImages = state.nbTrainingImages;
+    _nbTestImages = state.nbTestImages;
 }
 
 
@@ -269,20 +147,21 @@ void DataSet::objectsOfImage(unsigned int image, tObjectsList* objects)
     objects->clear();
 
     unsigned int image_index = getImageIndex(image);
+    tEntry entry = findEntry(image_index);
 
     // Background image?
-    if (image_index >= _images.size())
+    if (entry.background)
         return;
 
     // Retrieve the objects of the original image
-    ImageDatabase::tObjectsList* pOrigObjects = _pDatabase->objectsOfImage(_images[image_index].original_image);
+    ImageDatabase::tObjectsList* pOrigObjects = _pDatabase->objectsOfImage(entry.original_image);
 
     // Retrieve the size of the image
     dim_t image_size = imageSize(image);
-    dim_t original_size = _pDatabase->imageSize(_images[image_index].original_image);
+    dim_t original_size = _pDatabase->imageSize(entry.original_image);
 
     // Populates the result list
-    float scale = _images[image_index].scale;
+    float scale = scaleOf(entry, image_index - entry.first_image);
     unsigned int roiSize = _roi_extent * 2 + 1;
     ImageDatabase::tObjectsIterator iter, iterEnd;
     for (iter = pOrigObjects->begin(), iterEnd = pOrigObjects->end(); iter != iterEnd; ++iter)
@@ -348,15 +227,19 @@ Image* DataSet::getImage(unsigned int index)
     if (pImage)
         return pImage;
 
+    tEntry entry = findEntry(image_index);
+
     // Retrieves the original image from the database
-    if (image_index < _images.size())
+    if (!entry.background)
     {
-        Image* pOriginalImage = _pDatabase->getImage(_images[image_index].original_image);
+        Image* pOriginalImage = _pDatabase->getImage(entry.original_image);
         if (!pOriginalImage)
             return 0;
 
-        unsigned int dstWidth = pOriginalImage->width() * _images[image_index].scale;
-        unsigned int dstHeight = pOriginalImage->height() * _images[image_index].scale;
+        float scale = scaleOf(entry, image_index - entry.first_image);
+
+        unsigned int dstWidth = pOriginalImage->width() * scale;
+        unsigned int dstHeight = pOriginalImage->height() * scale;
 
         unsigned int roiSize = _roi_extent * 2 + 1;
 
@@ -372,7 +255,7 @@ Image* DataSet::getImage(unsigned int index)
     }
     else
     {
-        Image* pOriginalImage = _pDatabase->getImage(_backgroundImages[image_index - _images.size()]);
+        Image* pOriginalImage = _pDatabase->getImage(entry.original_image);
         if (!pOriginalImage)
             return 0;
 
@@ -398,12 +281,13 @@ dim_t DataSet::imageSize(unsigned int image)
     }
 
     unsigned int image_index = getImageIndex(image);
+    tEntry entry = findEntry(image_index);
     unsigned int roiSize = _roi_extent * 2 + 1;
 
-    if (image_index < _images.size())
+    if (!entry.background)
     {
-        dim_t size = _pDatabase->imageSize(_images[image_index].original_image);
-        float scale = _images[image_index].scale;
+        dim_t size = _pDatabase->imageSize(entry.original_image);
+        float scale = scaleOf(entry, image_index - entry.first_image);
 
         size.width *= scale;
         size.height *= scale;
@@ -418,7 +302,7 @@ dim_t DataSet::imageSize(unsigned int image)
     }
     else
     {
-        return _pDatabase->imageSize(_backgroundImages[image_index - _images.size()]);
+        return _pDatabase->imageSize(entry.original_image);
     }
 }
 
@@ -430,10 +314,10 @@ unsigned int DataSet::getImageIndex(unsigned int image)
 
     if (_mode == MODE_NORMAL)
         return image;
-    else if (_mode == MODE_TRAINING)
-        return _trainingImages[image];
-    else
-        return _testImages[image];
+
+    tEntry entry = findEntryInSet(_mode == MODE_TRAINING, image);
+
+    return entry.first_image + (image - entry.first_in_set);
 }
 
 
@@ -443,7 +327,7 @@ void DataSet::getImageInfos(unsigned int image, std::string* strName, dim_t* siz
     // Assertions
     assert(_pDatabase);
 
-    if (image >= _images.size() + _backgroundImages.size())
+    if (image >= _nbImages)
     {
         *strName   = "";
         *scale     = 0.0f;
@@ -452,60 +336,345 @@ void DataSet::getImageInfos(unsigned int image, std::string* strName, dim_t* siz
         return;
     }
 
-    if (image < _images.size())
-    {
-        tGeneratedImage* pImage = &_images[image];
+    tEntry entry = findEntry(image);
 
-        *strName = _pDatabase->getImageName(pImage->original_image);
-        *size = _pDatabase->imageSize(pImage->original_image);
-        *scale = pImage->scale;
-    }
+    *strName = _pDatabase->getImageName(entry.original_image);
+    *size = _pDatabase->imageSize(entry.original_image);
+
+    if (!entry.background)
+        *scale = scaleOf(entry, image - entry.first_image);
     else
-    {
-        *strName = _pDatabase->getImageName(_backgroundImages[image - _images.size()]);
-        *size = _pDatabase->imageSize(_backgroundImages[image - _images.size()]);
         *scale = 1.0f;
-    }
 
-    *training = false;
+    *training = entry.training;
+    *set_index = entry.first_in_set + (image - entry.first_image);
+}
+
 
-    for (unsigned int i = 0; i < _trainingImages.size(); ++i)
+bool DataSet::isImageInTestSet(unsigned int image)
+{
+    // Assertions
+    assert(_pDatabase);
+
+    if (image >= _nbImages)
+        return false;
+
+    return !findEntry(image).training;
+}
+
+
+/****************************** INTERNAL METHODS ******************************/
+
+void DataSet::generateEntry(tGenerationState* state, tEntry* entry,
+                            std::vector<float>* scales)
+{
+    // Assertions
+    assert(state);
+    assert(entry);
+    assert(scales);
+    assert(state->entry < _nbEntries);
+
+    entry->first_image  = state->nbImages;
+    entry->first_scale  = scales->size();
+    entry->all_scales   = false;
+    entry->background   = (state->entry >= _nbObjectsEntries);
+
+    if (!entry->background)
     {
-        if (_trainingImages[i] == image)
+        // Look for the next image with objects
+        while (_pDatabase->objectsOfImage(state->image)->empty())
+            ++state->image;
+
+        unsigned int image = state->image;
+        unsigned int roi_size = _roi_extent * 2 + 1;
+
+        dim_t image_size = _pDatabase->imageSize(image);
+
+        // The scales are shared by all the images of the same dimensions
+        const Stepper::tScalesList& stepperScales = _stepper->scales(image_size);
+        assert(stepperScales.size() > 0);
+
+        ImageDatabase::tObjectsList* pObjects = _pDatabase->objectsOfImage(image);
+        ImageDatabase::tObjectsIterator iter, iterEnd;
+        Stepper::tScalesConstIterator iter3, iterEnd3;
+
+        entry->original_image = image;
+        entry->nb_images      = 0;
+
+        // Determine in which set should go the generated images (training or test)
+        vector<unsigned int> labelCounters(_pDatabase->nbLabels(), 0);
+
+        ImageDatabase::tImageSet set = (_bUseStandardSets ? _pDatabase->imageSet(image) : ImageDatabase::SET_NONE);
+
+        if (set == ImageDatabase::SET_NONE)
         {
-            *training = true;
-            *set_index = i;
-            break;
+            bool training = false;
+            bool test = false;
+
+            for (iter = pObjects->begin(), iterEnd = pObjects->end(); iter != iterEnd; ++iter)
+            {
+                unsigned int label = iter->label;
+
+                if (state->trainingCounters[label] == 0)
+                    test = true;
+                else if (state->unassignedObjectsCounters[label] <= state->trainingCounters[label])
+                    training = true;
+
+                ++labelCounters[label];
+                --state->unassignedObjectsCounters[label];
+            }
+
+            if (training)
+                set = ImageDatabase::SET_TRAINING;
+            else if (test)
+                set = ImageDatabase::SET_TEST;
+            else
+                set = (state->generator.randomize(1.0f) < _trainingRatio) ? ImageDatabase::SET_TRAINING : ImageDatabase::SET_TEST;
+        }
+
+        if (set == ImageDatabase::SET_TRAINING)
+        {
+            for (unsigned int label = 0; label < labelCounters.size(); ++label)
+                state->trainingCounters[label] -= labelCounters[label];
+        }
+
+        for (iter = pObjects->begin(), iterEnd = pObjects->end(); iter != iterEnd; ++iter)
+        {
+            // Compute the scale of the generated image
+            unsigned int width = iter->bottom_right.x - iter->top_left.x + 1;
+            unsigned int height = iter->bottom_right.y - iter->top_left.y + 1;
+            unsigned int size = max(width, height);
+            float scale = 1.0f;
+
+            // Look for the scale where the size of the object is the closest
+            // to the ROI size
+            int smallest_diff;
+
+            for (iter3 = stepperScales.begin(), iterEnd3 = stepperScales.end(); iter3 != iterEnd3; ++iter3)
+            {
+                int diff = abs(int(size * (*iter3)) - int(roi_size));
+
+                if (iter3 == stepperScales.begin() || diff <= smallest_diff)
+                {
+                    smallest_diff = diff;
+                    scale = *iter3;
+                }
+            }
+
+            iter->scale = scale;
+
+            // Search if there is already a generated image with that scale
+            if (set == ImageDatabase::SET_TRAINING || !_stepper->isDoingDetection())
+            {
+                bool found = false;
+                for (unsigned int i = entry->first_scale; i < scales->size(); ++i)
+                {
+                    if (((*scales)[i] >= scale - 1e-6f) && ((*scales)[i] <= scale + 1e-6f))
+                    {
+                        found = true;
+                        break;
+                    }
+                }
+
+                // Create the generated image if necessary
+                if (!found)
+                {
+                    scales->push_back(scale);
+                    ++entry->nb_images;
+                }
+            }
         }
-    }
 
-    if (!*training)
+        // In detection, the test images are generated at all the scales
+        // of the stepper (retrieved when needed)
+        if (_stepper->isDoingDetection() && set == ImageDatabase::SET_TEST)
+        {
+            entry->all_scales = true;
+            entry->nb_images  = stepperScales.size();
+        }
+
+        entry->training = (set == ImageDatabase::SET_TRAINING);
+    }
+    else
     {
-        for (unsigned int i = 0; i < _testImages.size(); ++i)
+        // Look for the next background image
+        while (!_pDatabase->objectsOfImage(state->image)->empty())
+            ++state->image;
+
+        unsigned int nbBackgroundImages = _nbEntries - _nbObjectsEntries;
+        unsigned int index = state->entry - _nbObjectsEntries;
+
+        entry->original_image = state->image;
+        entry->nb_images      = 1;
+
+        // Assign the background image to one of the two sets (training or test)
+        ImageDatabase::tImageSet set = (_bUseStandardSets ? _pDatabase->imageSet(state->image) : ImageDatabase::SET_NONE);
+
+        if (set == ImageDatabase::SET_NONE)
         {
-            if (_testImages[i] == image)
+            if (state->backgroundCounter == 0)
+            {
+                entry->training = false;
+            }
+            else if (state->backgroundCounter >= nbBackgroundImages - index)
+            {
+                entry->training = true;
+                --state->backgroundCounter;
+            }
+            else if (state->generator.randomize(100) > 50)
+            {
+                entry->training = true;
+                --state->backgroundCounter;
+            }
+            else
             {
-                *set_index = i;
-                break;
+                entry->training = false;
             }
         }
+        else if (set == ImageDatabase::SET_TRAINING)
+        {
+            entry->training = true;
+            --state->backgroundCounter;
+        }
+        else
+        {
+            entry->training = false;
+        }
+    }
+
+    if (entry->training)
+    {
+        entry->first_in_set = state->nbTrainingImages;
+        state->nbTrainingImages += entry->nb_images;
+    }
+    else
+    {
+        entry->first_in_set = state->nbTestImages;
+        state->nbTestImages += entry->nb_images;
+    }
+
+    state->nbImages += entry->nb_images;
+    ++state->image;
+    ++state->entry;
+
+    // The background images are looked for from the start of the database,
+    // and don't need the counters of the labels
+    if (state->entry == _nbObjectsEntries)
+    {
+        state->image = 0;
+        state->trainingCounters.clear();
+        state->unassignedObjectsCounters.clear();
     }
 }
 
 
-bool DataSet::isImageInTestSet(unsigned int image)
+void DataSet::generateEntries(unsigned int checkpoint)
 {
     // Assertions
-    assert(_pDatabase);
+    assert(checkpoint < _checkpoints.size());
 
-    if (image >= _images.size() + _backgroundImages.size())
-        return false;
+    if (checkpoint == _checkpoint)
+        return;
+
+    tGenerationState state = _checkpoints[checkpoint];
+
+    _entries.clear();
+    _scales.clear();
 
-    for (unsigned int i = 0; i < _trainingImages.size(); ++i)
+    for (unsigned int i = 0; (i < _entriesPerCheckpoint) && (state.entry < _nbEntries); ++i)
     {
-        if (_trainingImages[i] == image)
-            return false;
+        tEntry entry;
+        generateEntry(&state, &entry, &_scales);
+        _entries.push_back(entry);
     }
 
-    return true;
+    _checkpoint = checkpoint;
+}
+
+
+DataSet::tEntry DataSet::findEntry(unsigned int image)
+{
+    // Assertions
+    assert(image < _nbImages);
+
+    // Binary search of the last checkpoint before the image
+    unsigned int first = 0;
+    unsigned int last = _checkpoints.size();
+
+    while (last - first > 1)
+    {
+        unsigned int middle = (first + last) >> 1;
+
+        if (_checkpoints[middle].nbImages <= image)
+            first = middle;
+        else
+            last = middle;
+    }
+
+    generateEntries(first);
+
+    // Binary search of the last entry starting at or before the image
+    first = 0;
+    last = _entries.size();
+
+    while (last - first > 1)
+    {
+        unsigned int middle = (first + last) >> 1;
+
+        if (_entries[middle].first_image <= image)
+            first = middle;
+        else
+            last = middle;
+    }
+
+    return _entries[first];
+}
+
+
+DataSet::tEntry DataSet::findEntryInSet(bool training, unsigned int image)
+{
+    // Assertions
+    assert(image < (training ? _nbTrainingImages : _nbTestImages));
+
+    // Binary search of the last checkpoint before the image
+    unsigned int first = 0;
+    unsigned int last = _checkpoints.size();
+
+    while (last - first > 1)
+    {
+        unsigned int middle = (first + last) >> 1;
+
+        if ((training ? _checkpoints[middle].nbTrainingImages : _checkpoints[middle].nbTestImages) <= image)
+            first = middle;
+        else
+            last = middle;
+    }
+
+    generateEntries(first);
+
+    // Look for the entry of the set containing the image (the entries of
+    // both sets are interleaved)
+    tEntriesList::const_iterator iter, iterEnd;
+    for (iter = _entries.begin(), iterEnd = _entries.end(); iter != iterEnd; ++iter)
+    {
+        if ((iter->training == training) && (image < iter->first_in_set + iter->nb_images))
+            break;
+    }
+
+    assert(iter != iterEnd);
+
+    return *iter;
+}
+
+
+float DataSet::scaleOf(const tEntry& entry, unsigned int index) const
+{
+    // Assertions
+    assert(index < entry.nb_images);
+    assert(!entry.background);
+
+    if (entry.all_scales)
+        return _stepper->scales(_pDatabase->imageSize(entry.original_image))[index];
+
+    return _scales[entry.first_scale + index];
 }
@@ -51,6 +51,14 @@ namespace Mash
     /// an image database, by rescaling it appropriately. Thus, the classifier
     /// can have access to much more images than what is effectively stored in
     /// the database.
+    ///
+    /// Each image of the database is described by an entry, from which the
+    /// generated images (one per scale) are enumerated on demand. The entries
+    /// aren't kept: only the state of their generation (random number
+    /// generator and counters) is saved every few entries, in a 'checkpoint'.
+    /// The block of entries following a checkpoint is generated again (with
+    /// the same random numbers) when one of its images is accessed, so the
+    /// memory used is a fraction of the number of images of the database.
     //--------------------------------------------------------------------------
     class MASH_SYMBOL DataSet
     {
@@ -66,6 +74,11 @@ namespace Mash
             MODE_TEST,      ///< Restricted access: test set only
         };
 
+        /// Minimum number of entries between two checkpoints (more when there
+        /// are a lot of labels, since the counters of all the labels are saved
+        /// in each checkpoint)
+        static const unsigned int MIN_ENTRIES_PER_CHECKPOINT = 64;
+
 
         //_____ Construction / Destruction __________
     public:
@@ -125,11 +138,11 @@ namespace Mash
         inline unsigned int nbImages() const
         {
             if (_mode == MODE_NORMAL)
-                return _images.size() + _backgroundImages.size();
+                return _nbImages;
             else if (_mode == MODE_TRAINING)
-                return _trainingImages.size();
+                return _nbTrainingImages;
             else
-                return _testImages.size();
+                return _nbTestImages;
         }
 
         //----------------------------------------------------------------------
@@ -201,20 +214,113 @@ namespace Mash
         //_____ Internal types __________
     private:
         //----------------------------------------------------------------------
-        /// @brief  Contains some informations about a generated image
+        /// @brief  Contains some informations about an image of the database,
+        ///         and the images generated from it
+        ///
+        /// The generated images of an entry have consecutive 'true indices',
+        /// and are all in the same set (training or test).
         //----------------------------------------------------------------------
-        struct tGeneratedImage
+        struct tEntry
         {
             unsigned int    original_image; ///< Index of the original image (in the database)
-            float           scale;          ///< Scale of the generated image
+            unsigned int    first_image;    ///< 'True index' of the first generated image
+            unsigned int    first_in_set;   ///< Index of the first generated image in its set
+            unsigned int    nb_images;      ///< Number of generated images
+            unsigned int    first_scale;    ///< Index of the scale of the first generated
+                                            ///  image in '_scales'
+            bool            all_scales;     ///< Indicates if an image is generated at each
+                                            ///  scale of the stepper (in this case,
+                                            ///  'first_scale' isn't used)
+            bool            background;     ///< Indicates if the image is a background one
+            bool            training;       ///< Indicates if the generated images are part
+                                            ///  of the training set
         };
 
-        typedef std::vector<tGeneratedImage>    tGeneratedImagesList;
-        typedef tGeneratedImagesList::iterator  tGeneratedImagesIterator;
+        typedef std::vector<tEntry>         tEntriesList;
 
         typedef std::vector<unsigned int>   tIndicesList;
         typedef tIndicesList::iterator      tIndicesIterator;
 
+        //----------------------------------------------------------------------
+        /// @brief  State of the generation of the entries
+        ///
+        /// The entries of the images with objects are generated first, then
+        /// the ones of the background images.
+        //----------------------------------------------------------------------
+        struct tGenerationState
+        {
+            RandomNumberGenerator   generator;
+            unsigned int            entry;              ///< Index of the next entry
+            unsigned int            image;              ///< Index of the next image of
+                                                        ///  the database to look at
+            unsigned int            nbImages;           ///< Number of images generated
+                                                        ///  by the previous entries
+            unsigned int            nbTrainingImages;   ///< Idem, in the training set
+            unsigned int            nbTestImages;       ///< Idem, in the test set
+            unsigned int            backgroundCounter;  ///< Number of background images
+                                                        ///  still to put in the
+                                                        ///  training set
+            tIndicesList            trainingCounters;   ///< Per label, number of objects
+                                                        ///  still to put in the training
+                                                        ///  set (emptied once all the
+                                                        ///  images with objects are done)
+            tIndicesList            unassignedObjectsCounters;  ///< Per label, number of
+                                                                ///  objects not yet
+                                                                ///  assigned to a set
+        };
+
+        typedef std::vector<tGenerationState>   tGenerationStatesList;
+
+
+        //_____ Internal methods __________
+    private:
+        //----------------------------------------------------------------------
+        /// @brief  Generates the next entry
+        ///
+        /// @param  state   State of the generation, updated
+        /// @retval entry   The entry
+        /// @retval scales  List to which the scales of the generated images
+        ///                 of the entry are appended (unless they are all the
+        ///                 scales of the stepper)
+        //----------------------------------------------------------------------
+        void generateEntry(tGenerationState* state, tEntry* entry,
+                           std::vector<float>* scales);
+
+        //----------------------------------------------------------------------
+        /// @brief  Generates (if necessary) the entries following a checkpoint
+        ///         into '_entries'
+        ///
+        /// @param  checkpoint  Index of the checkpoint
+        //----------------------------------------------------------------------
+        void generateEntries(unsigned int checkpoint);
+
+        //----------------------------------------------------------------------
+        /// @brief  Returns the entry containing an image
+        ///
+        /// @param  image   'True index' of the image
+        //----------------------------------------------------------------------
+        tEntry findEntry(unsigned int image);
+
+        //----------------------------------------------------------------------
+        /// @brief  Returns the entry containing an image of a set
+        ///
+        /// @param  training    Indicates if the set is the training one
+        /// @param  image       Index of the image in the set
+        //----------------------------------------------------------------------
+        tEntry findEntryInSet(bool training, unsigned int image);
+
+        //----------------------------------------------------------------------
+        /// @brief  Returns the scale of an image generated from an entry
+        ///
+        /// @param  entry   The entry
+        /// @param  index   Index of the generated image in the entry
+        ///
+        /// @remark When the images are generated at all the scales of the
+        ///         stepper, the scale is taken from Stepper::scales(), which
+        ///         computes the list again if it was evicted from its cache
+        //----------------------------------------------------------------------
+        float scaleOf(const tEntry& entry, unsigned int index) const;
+
 
         //_____ Attributes __________
     private:
@@ -222,12 +328,25 @@ namespace Mash
         ImageDatabase*          _pDatabase;
         unsigned int            _roi_extent;
         Stepper*                _stepper;
-        RandomNumberGenerator   _generator;
-        tGeneratedImagesList    _images;
-        tIndicesList            _backgroundImages;
+        bool                    _bUseStandardSets;
+        float                   _trainingRatio;
         ImagesCache             _cache;
-        tIndicesList            _trainingImages;
-        tIndicesList            _testImages;
+        unsigned int            _nbEntries;             ///< One per image of the database
+        unsigned int            _nbObjectsEntries;      ///< Entries of the images with objects
+                                                        ///  (the first ones)
+        unsigned int            _entriesPerCheckpoint;
+        tGenerationStatesList   _checkpoints;           ///< State of the generation before
+                                                        ///  every '_entriesPerCheckpoint'
+                                                        ///  entries
+        unsigned int            _checkpoint;            ///< Checkpoint from which '_entries'
+                                                        ///  were generated
+        tEntriesList            _entries;               ///< Entries following '_checkpoint'
+        std::vector<float>      _scales;                ///< Scales of the generated images of
+                                                        ///  '_entries' not using all the
+                                                        ///  scales of the stepper
+        unsigned int            _nbImages;
+        unsigned int            _nbTrainingImages;
+        unsigned int            _nbTestImages;
     };
 }
 
@@ -0,0 +1,492 @@
+/*******************************************************************************
+* The MASH Framework contains the source code of all the servers in the
+* "computation farm" of the MASH project (http://www.mash-project.eu),
+* developed at the Idiap Research Institute (http://www.idiap.ch).
+*
+* Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+* Written by Philip Abbet (philip.abbet@idiap.ch)
+*
+* This file is part of the MASH Framework.
+*
+* The MASH Framework is free software: you can redistribute it and/or modify
+* it under the terms of either the GNU General Public License version 2 or
+* the GNU General Public License version 3 as published by the Free
+* Software Foundation, whichever suits the most your needs.
+*
+* The MASH Framework is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public Licenses
+* along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+/** @file   features_store_client.cpp
+    @author Philip Abbet (philip.abbet@idiap.ch)
+
+    Implementation of the 'FeaturesStoreClient' class
+*/
+
+#include "features_store_client.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+
+using namespace std;
+using namespace Mash;
+
+
+/********************************** CONSTANTS *********************************/
+
+// Number of images whose blocks are kept in memory
+const unsigned int MAX_IMAGES = 16;
+
+// Size of a record in a block: x, y, feature index and value
+const unsigned int RECORD_SIZE = 3 * sizeof(uint32_t) + sizeof(float);
+
+
+/****************************** UTILITY FUNCTIONS *****************************/
+
+namespace
+{
+    const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+    const uint64_t FNV_PRIME        = 1099511628211ULL;
+
+
+    // 64-bit FNV-1a
+    uint64_t hashData(uint64_t hash, const void* data, size_t size)
+    {
+        const unsigned char* bytes = (const unsigned char*) data;
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= FNV_PRIME;
+        }
+
+        return hash;
+    }
+
+
+    uint64_t hashValue(uint64_t hash, uint32_t value)
+    {
+        return hashData(hash, &value, sizeof(uint32_t));
+    }
+
+
+    std::string toHex(uint64_t hash)
+    {
+        char buffer[17];
+        sprintf(buffer, "%016llx", (unsigned long long) hash);
+
+        return buffer;
+    }
+}
+
+
+/************************* CONSTRUCTION / DESTRUCTION *************************/
+
+FeaturesStoreClient::FeaturesStoreClient()
+: _bConnected(false)
+{
+}
+
+
+FeaturesStoreClient::~FeaturesStoreClient()
+{
+    if (_bConnected)
+    {
+        flush();
+
+        if (_bConnected)
+        {
+            _client.sendCommand("DONE", ArgumentsList());
+            _client.close();
+        }
+    }
+}
+
+
+/********************************* METHODS ************************************/
+
+tError FeaturesStoreClient::connect(const std::string& strAddress, unsigned int port)
+{
+    // Declarations
+    string strResponse;
+    ArgumentsList args;
+
+    if (_bConnected)
+        disconnect();
+
+    if (!_client.connect(strAddress, port))
+        return ERROR_NETWORK_REQUEST_FAILURE;
+
+    // Check that we are really connected to a features server
+    if (!_client.sendCommand("INFO", args))
+        return ERROR_NETWORK_REQUEST_FAILURE;
+
+    if (!_client.waitResponse(&strResponse, &args))
+        return ERROR_NETWORK_RESPONSE_FAILURE;
+
+    if ((strResponse != "TYPE") || (args.size() != 1) || (args.getString(0) != "FeaturesServer"))
+    {
+        _client.close();
+        return ERROR_SERVER_INCORRECT_TYPE;
+    }
+
+    if (!_client.waitResponse(&strResponse, &args))
+        return ERROR_NETWORK_RESPONSE_FAILURE;
+
+    if ((strResponse != "PROTOCOL") || (args.size() != 1) || (args.getString(0) != "1.0"))
+    {
+        _client.close();
+        return ERROR_SERVER_INCORRECT_TYPE;
+    }
+
+    _bConnected = true;
+
+    return ERROR_NONE;
+}
+
+
+void FeaturesStoreClient::setHeuristic(unsigned int heuristic, const std::string& strHash,
+                                       unsigned int seed)
+{
+    string strKey;
+    if (!strHash.empty())
+    {
+        char buffer[9];
+        sprintf(buffer, "%08x", seed);
+        strKey = strHash + buffer;
+    }
+
+    if (heuristic >= _heuristics.size())
+        _heuristics.resize(heuristic + 1);
+
+    // The blocks in memory are only valid for the previous heuristics
+    if (_heuristics[heuristic] != strKey)
+    {
+        flush();
+        _images.clear();
+
+        _heuristics[heuristic] = strKey;
+    }
+}
+
+
+bool FeaturesStoreClient::selectImage(const std::string& strImageKey)
+{
+    if (!_bConnected)
+        return false;
+
+    if (!_images.empty() && (_images.front().strKey == strImageKey))
+        return true;
+
+    // Search the image in memory
+    tImagesIterator iter, iterEnd;
+    for (iter = _images.begin(), iterEnd = _images.end(); iter != iterEnd; ++iter)
+    {
+        if (iter->strKey == strImageKey)
+        {
+            _images.splice(_images.begin(), _images, iter);
+            return true;
+        }
+    }
+
+    // Retrieve its blocks from the server
+    _images.push_front(tImage());
+
+    tImage& image = _images.front();
+    image.strKey = strImageKey;
+    image.blocks.resize(_heuristics.size());
+
+    if (!fetch(&image))
+        return false;
+
+    // Remove the least recently used image from memory
+    if (_images.size() > MAX_IMAGES)
+    {
+        bool bResult = publish(&_images.back());
+        _images.pop_back();
+
+        if (!bResult)
+            return false;
+    }
+
+    return true;
+}
+
+
+bool FeaturesStoreClient::lookup(unsigned int heuristic, const coordinates_t& coordinates,
+                                 unsigned int nbFeatures, const unsigned int* indexes,
+                                 scalar_t* values)
+{
+    // Assertions
+    assert(indexes);
+    assert(values);
+
+    if (!_bConnected || _images.empty() || (heuristic >= _heuristics.size()) ||
+        _heuristics[heuristic].empty())
+    {
+        return false;
+    }
+
+    tFeaturesList& features = _images.front().blocks[heuristic].features;
+    if (features.empty())
+        return false;
+
+    tFeatureKey key;
+    key.x = coordinates.x;
+    key.y = coordinates.y;
+
+    for (unsigned int i = 0; i < nbFeatures; ++i)
+    {
+        key.index = indexes[i];
+
+        tFeaturesIterator iter = features.find(key);
+        if (iter == features.end())
+            return false;
+
+        values[i] = iter->second;
+    }
+
+    return true;
+}
+
+
+void FeaturesStoreClient::store(unsigned int heuristic, const coordinates_t& coordinates,
+                                unsigned int nbFeatures, const unsigned int* indexes,
+                                const scalar_t* values)
+{
+    // Assertions
+    assert(indexes);
+    assert(values);
+
+    if (!_bConnected || _images.empty() || (heuristic >= _heuristics.size()) ||
+        _heuristics[heuristic].empty())
+    {
+        return;
+    }
+
+    tBlock& block = _images.front().blocks[heuristic];
+
+    tFeatureKey key;
+    key.x = coordinates.x;
+    key.y = coordinates.y;
+
+    for (unsigned int i = 0; i < nbFeatures; ++i)
+    {
+        key.index = indexes[i];
+        block.features[key] = values[i];
+    }
+
+    block.bModified = true;
+}
+
+
+bool FeaturesStoreClient::flush()
+{
+    tImagesIterator iter, iterEnd;
+    for (iter = _images.begin(), iterEnd = _images.end(); iter != iterEnd; ++iter)
+    {
+        if (!publish(&(*iter)))
+            return false;
+    }
+
+    return true;
+}
+
+
+/****************************** STATIC METHODS ********************************/
+
+std::string FeaturesStoreClient::hashFile(const std::string& strFileName)
+{
+    FILE* pFile = fopen(strFileName.c_str(), "rb");
+    if (!pFile)
+        return "";
+
+    uint64_t hash = FNV_OFFSET_BASIS;
+    unsigned char buffer[4096];
+    size_t size;
+
+    while ((size = fread(buffer, 1, sizeof(buffer), pFile)) > 0)
+        hash = hashData(hash, buffer, size);
+
+    bool bError = (ferror(pFile) != 0);
+    fclose(pFile);
+
+    return (bError ? "" : toHex(hash));
+}
+
+
+std::string FeaturesStoreClient::hashImage(Image* pImage, unsigned int roiExtent)
+{
+    // Assertions
+    assert(pImage);
+
+    uint64_t hash = FNV_OFFSET_BASIS;
+
+    hash = hashValue(hash, pImage->width());
+    hash = hashValue(hash, pImage->height());
+    hash = hashValue(hash, roiExtent);
+
+    unsigned int nbPixels = pImage->width() * pImage->height();
+
+    if (pImage->hasPixelFormat(Image::PIXELFORMAT_RGB))
+    {
+        hash = hashValue(hash, Image::PIXELFORMAT_RGB);
+        hash = hashData(hash, pImage->rgbBuffer(), nbPixels * sizeof(RGBPixel_t));
+    }
+    else
+    {
+        hash = hashValue(hash, Image::PIXELFORMAT_GRAY);
+        hash = hashData(hash, pImage->grayBuffer(), nbPixels * sizeof(byte_t));
+    }
+
+    return toHex(hash);
+}
+
+
+/***************************** PRIVATE METHODS ********************************/
+
+bool FeaturesStoreClient::fetch(tImage* pImage)
+{
+    // Assertions
+    assert(pImage);
+
+    // Declarations
+    string strResponse;
+    ArgumentsList args;
+    vector<unsigned char> data;
+
+    for (unsigned int i = 0; i < _heuristics.size(); ++i)
+    {
+        if (!_heuristics[i].empty())
+            args.add(_heuristics[i] + pImage->strKey);
+    }
+
+    if (args.size() == 0)
+        return true;
+
+    if (!_client.sendCommand("GET_BLOCKS", args))
+    {
+        disconnect();
+        return false;
+    }
+
+    for (unsigned int i = 0; i < _heuristics.size(); ++i)
+    {
+        if (_heuristics[i].empty())
+            continue;
+
+        if (!_client.waitResponse(&strResponse, &args) || (strResponse != "BLOCK") ||
+            (args.size() != 1) || (args.getInt(0) < 0))
+        {
+            disconnect();
+            return false;
+        }
+
+        int size = args.getInt(0);
+        if (size == 0)
+            continue;
+
+        data.resize(size);
+        if (!_client.waitData(&data[0], size))
+        {
+            disconnect();
+            return false;
+        }
+
+        // Decode the records
+        tFeaturesList& features = pImage->blocks[i].features;
+        unsigned int nbRecords = size / RECORD_SIZE;
+
+        for (unsigned int j = 0; j < nbRecords; ++j)
+        {
+            const unsigned char* pRecord = &data[j * RECORD_SIZE];
+
+            uint32_t fields[3];
+            float value;
+
+            memcpy(fields, pRecord, sizeof(fields));
+            memcpy(&value, pRecord + sizeof(fields), sizeof(float));
+
+            tFeatureKey key;
+            key.x     = fields[0];
+            key.y     = fields[1];
+            key.index = fields[2];
+
+            features[key] = value;
+        }
+    }
+
+    return true;
+}
+
+
+bool FeaturesStoreClient::publish(tImage* pImage)
+{
+    // Assertions
+    assert(pImage);
+
+    // Declarations
+    string strResponse;
+    ArgumentsList args;
+    vector<unsigned char> data;
+
+    if (!_bConnected)
+        return false;
+
+    for (unsigned int i = 0; i < pImage->blocks.size(); ++i)
+    {
+        tBlock& block = pImage->blocks[i];
+
+        if (!block.bModified || _heuristics[i].empty())
+            continue;
+
+        // Encode the records
+        data.resize(block.features.size() * RECORD_SIZE);
+
+        unsigned char* pRecord = (data.empty() ? 0 : &data[0]);
+
+        tFeaturesIterator iter, iterEnd;
+        for (iter = block.features.begin(), iterEnd = block.features.end();
+             iter != iterEnd; ++iter, pRecord += RECORD_SIZE)
+        {
+            uint32_t fields[3] = { iter->first.x, iter->first.y, iter->first.index };
+            float value = iter->second;
+
+            memcpy(pRecord, fields, sizeof(fields));
+            memcpy(pRecord + sizeof(fields), &value, sizeof(float));
+        }
+
+        args.clear();
+        args.add(_heuristics[i] + pImage->strKey);
+        args.add((int) data.size());
+
+        if (!_client.sendCommand("PUT_BLOCK", args) ||
+            (!data.empty() && !_client.sendData(&data[0], data.size())) ||
+            !_client.waitResponse(&strResponse, &args))
+        {
+            disconnect();
+            return false;
+        }
+
+        // The server refusing a block isn't fatal
+        block.bModified = false;
+    }
+
+    return true;
+}
+
+
+void FeaturesStoreClient::disconnect()
+{
+    _client.close();
+    _bConnected = false;
+    _images.clear();
+}
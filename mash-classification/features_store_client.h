@@ -0,0 +1,256 @@
+/*******************************************************************************
+* The MASH Framework contains the source code of all the servers in the
+* "computation farm" of the MASH project (http://www.mash-project.eu),
+* developed at the Idiap Research Institute (http://www.idiap.ch).
+*
+* Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+* Written by Philip Abbet (philip.abbet@idiap.ch)
+*
+* This file is part of the MASH Framework.
+*
+* The MASH Framework is free software: you can redistribute it and/or modify
+* it under the terms of either the GNU General Public License version 2 or
+* the GNU General Public License version 3 as published by the Free
+* Software Foundation, whichever suits the most your needs.
+*
+* The MASH Framework is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public Licenses
+* along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+/** @file   features_store_client.h
+    @author Philip Abbet (philip.abbet@idiap.ch)
+
+    Declaration of the 'FeaturesStoreClient' class
+*/
+
+#ifndef _MASH_FEATURESSTORECLIENT_H_
+#define _MASH_FEATURESSTORECLIENT_H_
+
+#include "declarations.h"
+#include <mash/image.h>
+#include <mash-network/client.h>
+#include <list>
+#include <map>
+#include <vector>
+
+
+namespace Mash
+{
+    //--------------------------------------------------------------------------
+    /// @brief  Client of a Features Server, which stores the features computed
+    ///         by the experiment servers so they can be reused by the other
+    ///         ones (or by the next experiments)
+    ///
+    /// The features are stored in blocks, one per heuristic and image. The key
+    /// of a block is made of:
+    ///   - the hash of the heuristic (of its source code)
+    ///   - the seed of the heuristic
+    ///   - the hash of the image (of its pixels) and the extent of the
+    ///     region of interest
+    ///
+    /// All the blocks of an image are retrieved in one request when the image
+    /// is first accessed. The blocks of the last accessed images are kept in
+    /// memory, and the features computed for them are sent to the server
+    /// (the complete blocks) when they are removed from memory or when
+    /// flush() is called. When two clients update the same block at the same
+    /// time, the last one wins: since the features are deterministic, only
+    /// some of them are missing from the store.
+    ///
+    /// The blocks are made of records (x, y, feature index, value) stored in
+    /// the byte order of the machine.
+    //--------------------------------------------------------------------------
+    class MASH_SYMBOL FeaturesStoreClient
+    {
+        //_____ Construction / Destruction __________
+    public:
+        //----------------------------------------------------------------------
+        /// @brief  Constructor
+        //----------------------------------------------------------------------
+        FeaturesStoreClient();
+
+        //----------------------------------------------------------------------
+        /// @brief  Destructor
+        ///
+        /// The computed features not sent yet are sent to the server
+        //----------------------------------------------------------------------
+        ~FeaturesStoreClient();
+
+
+        //_____ Methods __________
+    public:
+        //----------------------------------------------------------------------
+        /// @brief  Connect to the Features Server
+        ///
+        /// @param  strAddress  Address of the server
+        /// @param  port        Port of the server
+        /// @return             Error code
+        //----------------------------------------------------------------------
+        tError connect(const std::string& strAddress, unsigned int port);
+
+        //----------------------------------------------------------------------
+        /// @brief  Indicates if the client is connected to the server
+        //----------------------------------------------------------------------
+        inline bool isConnected() const
+        {
+            return _bConnected;
+        }
+
+        //----------------------------------------------------------------------
+        /// @brief  Set the informations identifying the features of a
+        ///         heuristic
+        ///
+        /// @param  heuristic   Index of the heuristic
+        /// @param  strHash     Hash of the heuristic (see hashFile()). If
+        ///                     empty, the features of the heuristic aren't
+        ///                     stored.
+        /// @param  seed        Seed of the heuristic
+        //----------------------------------------------------------------------
+        void setHeuristic(unsigned int heuristic, const std::string& strHash,
+                          unsigned int seed);
+
+        //----------------------------------------------------------------------
+        /// @brief  Select the image whose features are looked up/stored by the
+        ///         next calls to lookup() and store()
+        ///
+        /// Retrieves the blocks of the image from the server if they aren't
+        /// in memory.
+        ///
+        /// @param  strImageKey     Key of the image (see hashImage())
+        /// @return                 'false' if the communication with the
+        ///                         server failed
+        //----------------------------------------------------------------------
+        bool selectImage(const std::string& strImageKey);
+
+        //----------------------------------------------------------------------
+        /// @brief  Look up some features of the current image in the store
+        ///
+        /// @param  heuristic       Index of the heuristic
+        /// @param  coordinates     Coordinates of the region of interest
+        /// @param  nbFeatures      Number of features
+        /// @param  indexes         Indexes of the features
+        /// @retval values          Values of the features
+        /// @return                 'false' if at least one of the features
+        ///                         isn't in the store
+        //----------------------------------------------------------------------
+        bool lookup(unsigned int heuristic, const coordinates_t& coordinates,
+                    unsigned int nbFeatures, const unsigned int* indexes,
+                    scalar_t* values);
+
+        //----------------------------------------------------------------------
+        /// @brief  Add some computed features of the current image to the
+        ///         store
+        ///
+        /// @param  heuristic       Index of the heuristic
+        /// @param  coordinates     Coordinates of the region of interest
+        /// @param  nbFeatures      Number of features
+        /// @param  indexes         Indexes of the features
+        /// @param  values          Values of the features
+        //----------------------------------------------------------------------
+        void store(unsigned int heuristic, const coordinates_t& coordinates,
+                   unsigned int nbFeatures, const unsigned int* indexes,
+                   const scalar_t* values);
+
+        //----------------------------------------------------------------------
+        /// @brief  Send the features computed since the last call to the
+        ///         server
+        ///
+        /// @return 'false' if the communication with the server failed
+        //----------------------------------------------------------------------
+        bool flush();
+
+        //----------------------------------------------------------------------
+        /// @brief  Returns the hash of the content of a file (an empty string
+        ///         if the file can't be read)
+        //----------------------------------------------------------------------
+        static std::string hashFile(const std::string& strFileName);
+
+        //----------------------------------------------------------------------
+        /// @brief  Returns the key identifying an image in the store
+        ///
+        /// @param  pImage      The image
+        /// @param  roiExtent   Extent of the regions of interest
+        //----------------------------------------------------------------------
+        static std::string hashImage(Image* pImage, unsigned int roiExtent);
+
+
+        //_____ Internal types __________
+    private:
+        struct tFeatureKey
+        {
+            unsigned int x;
+            unsigned int y;
+            unsigned int index;
+
+            inline bool operator<(const tFeatureKey& other) const
+            {
+                if (x != other.x)
+                    return (x < other.x);
+
+                if (y != other.y)
+                    return (y < other.y);
+
+                return (index < other.index);
+            }
+        };
+
+        typedef std::map<tFeatureKey, scalar_t>     tFeaturesList;
+        typedef tFeaturesList::iterator             tFeaturesIterator;
+
+        struct tBlock
+        {
+            tBlock()
+            : bModified(false)
+            {
+            }
+
+            tFeaturesList   features;
+            bool            bModified;
+        };
+
+        struct tImage
+        {
+            std::string         strKey;
+            std::vector<tBlock> blocks;     ///< One per heuristic
+        };
+
+        typedef std::list<tImage>           tImagesList;
+        typedef tImagesList::iterator       tImagesIterator;
+
+
+        //_____ Methods __________
+    private:
+        //----------------------------------------------------------------------
+        /// @brief  Retrieve the blocks of an image from the server
+        //----------------------------------------------------------------------
+        bool fetch(tImage* pImage);
+
+        //----------------------------------------------------------------------
+        /// @brief  Send the modified blocks of an image to the server
+        //----------------------------------------------------------------------
+        bool publish(tImage* pImage);
+
+        //----------------------------------------------------------------------
+        /// @brief  Close the connection after a communication failure (the
+        ///         features are then always computed)
+        //----------------------------------------------------------------------
+        void disconnect();
+
+
+        //_____ Attributes __________
+    private:
+        Client                      _client;
+        bool                        _bConnected;
+        std::vector<std::string>    _heuristics;    ///< Key of the heuristics (empty:
+                                                    ///  not stored)
+        tImagesList                 _images;        ///< Most recently used first
+    };
+}
+
+#endif
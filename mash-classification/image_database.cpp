@@ -37,10 +37,17 @@ using namespace std;
 using namespace Mash;
 
 
+/********************************** CONSTANTS *********************************/
+
+// Number of image names requested at once (see getImageName())
+const unsigned int IMAGE_NAMES_PREFETCH = 64;
+
+
 /************************* CONSTRUCTION / DESTRUCTION *************************/
 
 ImageDatabase::ImageDatabase(unsigned int maxNbImagesInCache)
-: _pClient(0), _preferredRoiSize(0), _nbObjects(0), _cache(maxNbImagesInCache)
+: _pClient(0), _bSupportListImages(false), _preferredRoiSize(0), _nbObjects(0),
+  _cache(maxNbImagesInCache)
 {
     _preferredImageSize.width = 0;
     _preferredImageSize.height = 0;
@@ -88,9 +95,12 @@ tError ImageDatabase::setClient(Client* pClient)
     if (!_pClient->waitResponse(&strResponse, &args))
         return ERROR_NETWORK_RESPONSE_FAILURE;
     
-    if ((strResponse != "PROTOCOL") || (args.size() != 1) || (args.getString(0) != "1.2"))
+    if ((strResponse != "PROTOCOL") || (args.size() != 1) ||
+        ((args.getString(0) != "1.3") && (args.getString(0) != "1.2")))
         return ERROR_APPSERVER_UNSUPPORTED_PROTOCOL;
 
+    _bSupportListImages = (args.getString(0) == "1.3");
+
     // Sends an STATUS request to the application server
     if (!_pClient->sendCommand("STATUS", args))
         return ERROR_NETWORK_REQUEST_FAILURE;
@@ -120,42 +130,73 @@ tError ImageDatabase::setDatabase(const std::string& strName,
     int nbLabels;
     tError ret;
     
+    // The connection might have been kept from a previous experiment, without
+    // resetting the application server (see Client::tag()). The database isn't
+    // selected again if it doesn't change, but the enabled labels and the
+    // background images are always set again below.
+    bool bConfigured = !_pClient->tag().empty();
+    bool bAlreadySelected = (_pClient->tag() == strName);
+    _pClient->setTag("");
+
     // Sends a SELECT_DATABASE request to the application server
-    args.add(strName);
-    if (!_pClient->sendCommand("SELECT_DATABASE", args))
-        return ERROR_NETWORK_REQUEST_FAILURE;
+    if (!bAlreadySelected)
+    {
+        args.add(strName);
+        if (!_pClient->sendCommand("SELECT_DATABASE", args))
+            return ERROR_NETWORK_REQUEST_FAILURE;
 
-    // Retrieve the infos from the database
-    ret = receiveInfos(&nbImages, &nbLabels);
-    if (ret != ERROR_NONE)
-        return ret;
+        // Retrieve the infos from the database
+        ret = receiveInfos(&nbImages, &nbLabels);
+        if (ret != ERROR_NONE)
+            return ret;
+    }
+
+    // The following requests don't depend on the responses of the previous
+    // ones: they are pipelined, and the responses are read in the same order
 
     // Sends a ENABLE_BACKGROUND_IMAGES or DISABLE_BACKGROUND_IMAGES request to
     // the application server
-    if (!_pClient->sendCommand((bBackgroundImagesEnabled ? "ENABLE_BACKGROUND_IMAGES" : "DISABLE_BACKGROUND_IMAGES"), ArgumentsList()))
+    if (!_pClient->queueCommand((bBackgroundImagesEnabled ? "ENABLE_BACKGROUND_IMAGES" : "DISABLE_BACKGROUND_IMAGES"), ArgumentsList()))
+        return ERROR_NETWORK_REQUEST_FAILURE;
+
+    // Sends a ENABLE_LABELS request to the application server (or a
+    // RESET_ENABLED_LABELS one, to forget the labels enabled by the previous
+    // experiment)
+    if ((enabledLabels.size() > 0) && !_pClient->queueCommand("ENABLE_LABELS", enabledLabels))
         return ERROR_NETWORK_REQUEST_FAILURE;
 
+    if ((enabledLabels.size() == 0) && bConfigured &&
+        !_pClient->queueCommand("RESET_ENABLED_LABELS", ArgumentsList()))
+    {
+        return ERROR_NETWORK_REQUEST_FAILURE;
+    }
+
+    // Retrieves the list of label names, the preferred size of the images and
+    // the preferred size of the ROI
+    if (!_pClient->queueCommand("LIST_LABEL_NAMES", ArgumentsList()) ||
+        !_pClient->queueCommand("REPORT_PREFERRED_IMAGE_SIZE", ArgumentsList()) ||
+        !_pClient->queueCommand("REPORT_PREFERRED_ROI_SIZE", ArgumentsList()))
+    {
+        return ERROR_NETWORK_REQUEST_FAILURE;
+    }
+
     // Retrieve the infos from the database
     ret = receiveInfos(&nbImages, &nbLabels);
     if (ret != ERROR_NONE)
         return ret;
 
-    // Sends a ENABLE_LABELS request to the application server
-    if (enabledLabels.size() > 0)
+    if ((enabledLabels.size() > 0) || bConfigured)
     {
-        if (!_pClient->sendCommand("ENABLE_LABELS", enabledLabels))
-            return ERROR_NETWORK_REQUEST_FAILURE;
-
         // Retrieve the infos from the database
         ret = receiveInfos(&nbImages, &nbLabels);
         if (ret != ERROR_NONE)
             return ret;
     }
+
+    // Remember the state in which the application server is
+    _pClient->setTag(strName);
     
     // Retrieves the list of label names
-    if (!_pClient->sendCommand("LIST_LABEL_NAMES", ArgumentsList()))
-        return ERROR_NETWORK_REQUEST_FAILURE;
-    
     while (true)
     {
         if (!_pClient->waitResponse(&strResponse, &args))
@@ -178,9 +219,6 @@ tError ImageDatabase::setDatabase(const std::string& strName,
     }
 
     // Retrieves the preferred size of the images
-    if (!_pClient->sendCommand("REPORT_PREFERRED_IMAGE_SIZE", ArgumentsList()))
-        return ERROR_NETWORK_REQUEST_FAILURE;
-    
     if (!_pClient->waitResponse(&strResponse, &args))
         return ERROR_NETWORK_RESPONSE_FAILURE;
 
@@ -191,29 +229,46 @@ tError ImageDatabase::setDatabase(const std::string& strName,
     }
 
     // Retrieves the preferred size of the ROI
-    if (!_pClient->sendCommand("REPORT_PREFERRED_ROI_SIZE", ArgumentsList()))
-        return ERROR_NETWORK_REQUEST_FAILURE;
-    
     if (!_pClient->waitResponse(&strResponse, &args))
         return ERROR_NETWORK_RESPONSE_FAILURE;
 
     if ((strResponse == "PREFERRED_ROI_SIZE") && (args.size() == 1))
         _preferredRoiSize = args.getInt(0);
 
-    // Use the preprocessed images if possible
-    if (_preferredImageSize.width > 0)
+    // Use the preprocessed images if possible, retrieves the URL prefix for
+    // the images and the list of objects (pipelined). When the server supports
+    // it, the names of the images are retrieved at the same time than the
+    // objects, with the LIST_IMAGES command.
+    if ((_preferredImageSize.width > 0) &&
+        !_pClient->queueCommand("ENABLE_PREPROCESSED_IMAGES", ArgumentsList()))
     {
-        if (!_pClient->sendCommand("ENABLE_PREPROCESSED_IMAGES", ArgumentsList()))
+        return ERROR_NETWORK_REQUEST_FAILURE;
+    }
+
+    if (!_pClient->queueCommand("REPORT_URL_PREFIX", ArgumentsList()))
+        return ERROR_NETWORK_REQUEST_FAILURE;
+
+    if (_bSupportListImages)
+    {
+        args.clear();
+        args.add(0);
+        args.add(nbImages);
+
+        if (!_pClient->queueCommand("LIST_IMAGES", args))
             return ERROR_NETWORK_REQUEST_FAILURE;
+    }
+    else if (!_pClient->queueCommand("LIST_OBJECTS", ArgumentsList()))
+    {
+        return ERROR_NETWORK_REQUEST_FAILURE;
+    }
 
+    if (_preferredImageSize.width > 0)
+    {
         if (!_pClient->waitResponse(&strResponse, &args))
             return ERROR_NETWORK_RESPONSE_FAILURE;
     }
 
     // Retrieves the URL prefix for the images
-    if (!_pClient->sendCommand("REPORT_URL_PREFIX", ArgumentsList()))
-        return ERROR_NETWORK_REQUEST_FAILURE;
-    
     if (!_pClient->waitResponse(&strResponse, &args))
         return ERROR_NETWORK_RESPONSE_FAILURE;
 
@@ -227,10 +282,11 @@ tError ImageDatabase::setDatabase(const std::string& strName,
     if (_strImagesUrlPrefix.at(_strImagesUrlPrefix.length() - 1) != '/')
         _strImagesUrlPrefix += "/";
 
+    // Retrieves the list of images
+    if (_bSupportListImages)
+        return receiveImages();
+
     // Retrieves the list of objects
-    if (!_pClient->sendCommand("LIST_OBJECTS", ArgumentsList()))
-        return ERROR_NETWORK_REQUEST_FAILURE;
-    
     while (true)
     {
         if (!_pClient->waitResponse(&strResponse, &args))
@@ -369,26 +425,122 @@ std::string ImageDatabase::getImageUrl(unsigned int index)
 std::string ImageDatabase::getImageName(unsigned int index)
 {
     // Assertions
-    assert(_pClient);
     assert(index < nbImages());
 
     // Declarations
     string strResponse;
     ArgumentsList args;
+    vector<unsigned int> requested;
 
-    // Sends an IMAGE request to the application server
-    args.add((int) index);
-    if (!_pClient->sendCommand("IMAGE", args))
-        return "";
+    // Use the known name if possible
+    if (!_images[index].strName.empty())
+        return _images[index].strName;
 
-    // Retrieve the URL of the image
-    if (!_pClient->waitResponse(&strResponse, &args))
-        return "";
-    
-    if ((strResponse != "IMAGE_NAME") || (args.size() != 1))
-        return "";
+    assert(_pClient);
 
-    return args.getString(0);
+    // Sends IMAGE requests to the application server, for this image and the
+    // following ones (pipelined: the images are often used in order)
+    unsigned int end = index + IMAGE_NAMES_PREFETCH;
+    if (end > nbImages())
+        end = nbImages();
+
+    for (unsigned int i = index; i < end; ++i)
+    {
+        if (!_images[i].strName.empty())
+            continue;
+
+        if (!_pClient->queueCommand("IMAGE", ArgumentsList((int) i)))
+            return "";
+
+        requested.push_back(i);
+    }
+
+    // Retrieve the names of the images (one response per request, in the same
+    // order)
+    for (unsigned int i = 0; i < requested.size(); ++i)
+    {
+        if (!_pClient->waitResponse(&strResponse, &args))
+            return "";
+
+        if ((strResponse == "IMAGE_NAME") && (args.size() == 1))
+            _images[requested[i]].strName = args.getString(0);
+    }
+
+    return _images[index].strName;
+}
+
+
+tError ImageDatabase::receiveImages()
+{
+    // Assertions
+    assert(_pClient);
+
+    // Declarations
+    string strResponse;
+    ArgumentsList args;
+
+    while (true)
+    {
+        if (!_pClient->waitResponse(&strResponse, &args))
+            return ERROR_NETWORK_RESPONSE_FAILURE;
+
+        if (strResponse == "END_LIST_IMAGES")
+            break;
+
+        // IMAGE_INFOS <index> <name> <width> <height> <set> <nb_objects>
+        //             [<label> <left> <top> <right> <bottom>]*
+        if ((strResponse != "IMAGE_INFOS") || (args.size() < 6))
+        {
+            _strLastError = strResponse + " (expected: IMAGE_INFOS)";
+            return ERROR_APPSERVER_UNEXPECTED_RESPONSE;
+        }
+
+        int nbObjectsInImage = args.getInt(5);
+        if ((nbObjectsInImage < 0) || (args.size() != 6 + 5 * nbObjectsInImage) ||
+            (args.getInt(0) != (int) _images.size()))
+        {
+            _strLastError = "IMAGE_INFOS (invalid arguments)";
+            return ERROR_APPSERVER_UNEXPECTED_RESPONSE;
+        }
+
+        tImage image;
+        image.strName = args.getString(1);
+        image.size.width = args.getInt(2);
+        image.size.height = args.getInt(3);
+
+        if (args.getString(4) == "TRAINING")
+            image.set = SET_TRAINING;
+        else if (args.getString(4) == "TEST")
+            image.set = SET_TEST;
+        else
+            image.set = SET_NONE;
+
+        image.objects.resize(nbObjectsInImage);
+
+        for (int i = 0; i < nbObjectsInImage; ++i)
+        {
+            tObject& object = image.objects[i];
+            unsigned int offset = 6 + 5 * i;
+
+            object.label = args.getInt(offset);
+            object.top_left.x = args.getInt(offset + 1);
+            object.top_left.y = args.getInt(offset + 2);
+            object.bottom_right.x = args.getInt(offset + 3);
+            object.bottom_right.y = args.getInt(offset + 4);
+
+            if (object.label >= _labels.size())
+            {
+                _strLastError = "IMAGE_INFOS (unknown label)";
+                return ERROR_APPSERVER_UNEXPECTED_RESPONSE;
+            }
+
+            _labels[object.label].nbObjects++;
+        }
+
+        _images.push_back(image);
+    }
+
+    return ERROR_NONE;
 }
 
 
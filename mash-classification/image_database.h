@@ -81,6 +81,8 @@ namespace Mash
             dim_t           size;           ///< Dimensions of the image
             tObjectsList    objects;        ///< List of objects in the image
             tImageSet       set;            ///< Set of the image
+            std::string     strName;        ///< Name of the image (retrieved on demand
+                                        ///  from older servers)
         };
 
         typedef std::vector<tImage>         tImagesList;
@@ -148,6 +150,10 @@ namespace Mash
         /// @param  bBackgroundImagesEnabled    Indicates if the background
         ///                                     images are enabled
         /// @return                             Error code
+        ///
+        /// The name of the database is used as the tag of the client (see
+        /// Client::tag()). The database isn't selected again if the tag
+        /// already matches.
         //----------------------------------------------------------------------
         tError setDatabase(const std::string& strName,
                            const ArgumentsList& enabledLabels,
@@ -274,6 +280,11 @@ namespace Mash
         //----------------------------------------------------------------------
         /// @brief  Returns the name of the specified image
         ///
+        /// With application servers that don't support the LIST_IMAGES
+        /// command (protocol 1.2), the names of the following images are
+        /// retrieved at the same time (in one round-trip with the application
+        /// server), and all of them are kept for subsequent calls.
+        ///
         /// @param  index   Index of the image (from 0 to nbImages()-1)
         //----------------------------------------------------------------------
         std::string getImageName(unsigned int index);
@@ -292,10 +303,18 @@ namespace Mash
     private:
         tError receiveInfos(int* nbImages, int* nbLabels);
 
+        //----------------------------------------------------------------------
+        /// @brief  Retrieves the informations about all the images (names,
+        ///         sizes, sets and objects) from the responses to a
+        ///         LIST_IMAGES command
+        //----------------------------------------------------------------------
+        tError receiveImages();
+
 
         //_____ Attributes __________
-    private:
+    protected:
         Client*         _pClient;
+        bool            _bSupportListImages;
         dim_t           _preferredImageSize;
         unsigned int    _preferredRoiSize;
         std::string     _strImagesUrlPrefix;
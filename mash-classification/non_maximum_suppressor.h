@@ -0,0 +1,214 @@
+/*******************************************************************************
+* The MASH Framework contains the source code of all the servers in the
+* "computation farm" of the MASH project (http://www.mash-project.eu),
+* developed at the Idiap Research Institute (http://www.idiap.ch).
+*
+* Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+* Written by Charles Dubout (charles.dubout@idiap.ch)
+*
+* This file is part of the MASH Framework.
+*
+* The MASH Framework is free software: you can redistribute it and/or modify
+* it under the terms of either the GNU General Public License version 2 or
+* the GNU General Public License version 3 as published by the Free
+* Software Foundation, whichever suits the most your needs.
+*
+* The MASH Framework is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public Licenses
+* along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+/** @file   non_maximum_suppressor.h
+    @author Philip Abbet (philip.abbet@idiap.ch)
+
+    Declaration of the 'NonMaximumSuppressor' class
+*/
+
+#ifndef _MASH_NONMAXIMUMSUPPRESSOR_H_
+#define _MASH_NONMAXIMUMSUPPRESSOR_H_
+
+#include "object_intersecter.h"
+#include <vector>
+#include <map>
+#include <assert.h>
+
+
+namespace Mash
+{
+    //--------------------------------------------------------------------------
+    /// @brief  Clusters the detections made in an image, by only keeping the
+    ///         ones that don't intersect with a detection of higher score
+    ///
+    /// The detections are processed in the order they are added: a detection
+    /// is discarded if it intersects with a kept one of higher (or equal)
+    /// score, otherwise it replaces all the kept detections intersecting with
+    /// it.
+    ///
+    /// The kept detections are stored in a uniform grid, whose cells are as
+    /// large as the biggest ROI: two ROIs can only intersect if they are in
+    /// neighbouring cells, so each detection is only compared with a few
+    /// others (instead of all the kept ones).
+    ///
+    /// The type of the detections must derive from tObject, and have a
+    /// 'score' attribute.
+    ///
+    /// Header-only, so it can be used by the predictors.
+    //--------------------------------------------------------------------------
+    template <typename T>
+    class NonMaximumSuppressor
+    {
+        //_____ Construction / Destruction __________
+    public:
+        //----------------------------------------------------------------------
+        /// @brief  Constructor
+        ///
+        /// @param  max_roi_extent  The biggest extent of the ROI of the
+        ///                         detections
+        /// @param  rho             The constant above which two detections
+        ///                         intersect (see tObjectIntersecter)
+        //----------------------------------------------------------------------
+        NonMaximumSuppressor(unsigned int max_roi_extent, scalar_t rho = 0.25f)
+        : _cellSize(max_roi_extent * 2 + 1), _maxRoiExtent(max_roi_extent),
+          _rho(rho), _nbDetections(0)
+        {
+        }
+
+
+        //_____ Methods __________
+    public:
+        //----------------------------------------------------------------------
+        /// @brief  Add a detection
+        ///
+        /// @return 'true' if the detection was kept (for the moment)
+        //----------------------------------------------------------------------
+        bool add(const T& detection)
+        {
+            // Assertions
+            assert(detection.roi_extent <= _maxRoiExtent);
+
+            tObjectIntersecter intersecter(detection, _rho);
+
+            const unsigned int cx = detection.roi_position.x / _cellSize;
+            const unsigned int cy = detection.roi_position.y / _cellSize;
+
+            // Look if there is already a detection with a higher score
+            // intersecting with this one
+            for (unsigned int y = (cy > 0 ? cy - 1 : 0); y <= cy + 1; ++y)
+            {
+                for (unsigned int x = (cx > 0 ? cx - 1 : 0); x <= cx + 1; ++x)
+                {
+                    typename tGrid::const_iterator iter = _grid.find(tCell(x, y));
+                    if (iter == _grid.end())
+                        continue;
+
+                    const tIndicesList& indices = iter->second;
+                    for (unsigned int i = 0; i < indices.size(); ++i)
+                    {
+                        const T& other = _detections[indices[i]];
+                        if ((other.score >= detection.score) && intersecter(other))
+                            return false;
+                    }
+                }
+            }
+
+            // Remove all the detections intersecting with this one before
+            // adding it
+            for (unsigned int y = (cy > 0 ? cy - 1 : 0); y <= cy + 1; ++y)
+            {
+                for (unsigned int x = (cx > 0 ? cx - 1 : 0); x <= cx + 1; ++x)
+                {
+                    typename tGrid::iterator iter = _grid.find(tCell(x, y));
+                    if (iter == _grid.end())
+                        continue;
+
+                    tIndicesList& indices = iter->second;
+                    for (unsigned int i = 0; i < indices.size(); )
+                    {
+                        if (intersecter(_detections[indices[i]]))
+                        {
+                            _alive[indices[i]] = false;
+                            --_nbDetections;
+
+                            indices[i] = indices.back();
+                            indices.pop_back();
+                        }
+                        else
+                        {
+                            ++i;
+                        }
+                    }
+                }
+            }
+
+            _grid[tCell(cx, cy)].push_back(_detections.size());
+            _detections.push_back(detection);
+            _alive.push_back(true);
+            ++_nbDetections;
+
+            return true;
+        }
+
+        //----------------------------------------------------------------------
+        /// @brief  Returns the number of kept detections
+        //----------------------------------------------------------------------
+        inline unsigned int size() const
+        {
+            return _nbDetections;
+        }
+
+        //----------------------------------------------------------------------
+        /// @brief  Retrieve the kept detections, in the order they were added
+        //----------------------------------------------------------------------
+        void getDetections(std::vector<T>* detections) const
+        {
+            // Assertions
+            assert(detections);
+
+            detections->clear();
+            detections->reserve(_nbDetections);
+
+            for (unsigned int i = 0; i < _detections.size(); ++i)
+            {
+                if (_alive[i])
+                    detections->push_back(_detections[i]);
+            }
+        }
+
+        //----------------------------------------------------------------------
+        /// @brief  Remove all the detections
+        //----------------------------------------------------------------------
+        void clear()
+        {
+            _grid.clear();
+            std::vector<T>().swap(_detections);
+            std::vector<bool>().swap(_alive);
+            _nbDetections = 0;
+        }
+
+
+        //_____ Internal types __________
+    private:
+        typedef std::pair<unsigned int, unsigned int>   tCell;
+        typedef std::vector<unsigned int>               tIndicesList;
+        typedef std::map<tCell, tIndicesList>           tGrid;
+
+
+        //_____ Attributes __________
+    private:
+        unsigned int        _cellSize;
+        unsigned int        _maxRoiExtent;
+        scalar_t            _rho;
+        tGrid               _grid;
+        std::vector<T>      _detections;    // All the detections added (in order)
+        std::vector<bool>   _alive;         // Indicates which ones are kept
+        unsigned int        _nbDetections;
+    };
+}
+
+#endif
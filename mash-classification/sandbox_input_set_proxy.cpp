@@ -51,8 +51,9 @@ SandboxInputSetProxy::tCommandHandlersList SandboxInputSetProxy::handlers;
 
 /************************* CONSTRUCTION / DESTRUCTION *************************/
 
-SandboxInputSetProxy::SandboxInputSetProxy(IClassifierInputSet* pInputSet, const CommunicationChannel& channel)
-: _channel(channel), _pInputSet(pInputSet)
+SandboxInputSetProxy::SandboxInputSetProxy(IClassifierInputSet* pInputSet, const CommunicationChannel& channel,
+                                           SharedFeaturesBuffer* pSharedFeatures)
+: _channel(channel), _pInputSet(pInputSet), _pSharedFeatures(pSharedFeatures)
 {
     assert(pInputSet);
     
@@ -70,6 +71,7 @@ SandboxInputSetProxy::SandboxInputSetProxy(IClassifierInputSet* pInputSet, const
         handlers[SANDBOX_COMMAND_INPUT_SET_IMAGE_SIZE]               = &SandboxInputSetProxy::handleInputSetImageSizeCommand;
         handlers[SANDBOX_COMMAND_INPUT_SET_IMAGE_IN_TEST_SET]        = &SandboxInputSetProxy::handleInputSetImageInTestSetCommand;
         handlers[SANDBOX_COMMAND_INPUT_SET_ROI_EXTENT]               = &SandboxInputSetProxy::handleInputSetRoiExtentCommand;
+        handlers[SANDBOX_COMMAND_INPUT_SET_COMPUTE_SOME_FEATURES_SHARED] = &SandboxInputSetProxy::handleInputSetComputeSomeFeaturesSharedCommand;
     }
 }
 
@@ -259,22 +261,12 @@ tCommandProcessingResult SandboxInputSetProxy::handleInputSetComputeSomeFeatures
         delete[] indexes;
         delete[] values;
 
-        if (dynamic_cast<ClassifierInputSet*>(_pInputSet))
-        {
-            tError error = dynamic_cast<ClassifierInputSet*>(_pInputSet)->getLastHeuristicsError();
-
-            if (error == ERROR_HEURISTIC_TIMEOUT)
-                return DEST_PLUGIN_TIMEOUT;
-            else if (error == ERROR_NONE)
-                return INVALID_ARGUMENTS;
-        }
-
-        return DEST_PLUGIN_CRASHED;
+        return featuresComputationFailure();
     }
 
     // Send the response
     _channel.startPacket(SANDBOX_MESSAGE_RESPONSE);
-    _channel.add((char*) values, nbFeatures * sizeof(scalar_t));
+    _channel.addReference((const char*) values, nbFeatures * sizeof(scalar_t));
     _channel.sendPacket();
 
     delete[] indexes;
@@ -284,6 +276,53 @@ tCommandProcessingResult SandboxInputSetProxy::handleInputSetComputeSomeFeatures
 }
 
 
+tCommandProcessingResult SandboxInputSetProxy::handleInputSetComputeSomeFeaturesSharedCommand()
+{
+    // Assertions
+    assert(_pInputSet);
+
+    // Declarations
+    unsigned int    image;
+    coordinates_t   coordinates;
+    unsigned int    heuristic;
+    unsigned int    nbFeatures;
+
+    // Retrieve all the parameters
+    _channel.read(&image);
+    _channel.read(&coordinates.x);
+    _channel.read(&coordinates.y);
+    _channel.read(&heuristic);
+    _channel.read(&nbFeatures);
+
+    if (!_channel.good())
+        return SOURCE_PLUGIN_CRASHED;
+
+    if (!_pSharedFeatures || (nbFeatures == 0) || (nbFeatures > _pSharedFeatures->capacity()))
+        return INVALID_ARGUMENTS;
+
+    // The indexes are copied in the shared buffer by us: the classifier only
+    // has a read-only mapping of it, so the indexes and the values can't be
+    // modified once checked and forwarded to the instruments
+    _channel.read((char*) _pSharedFeatures->indexes(), nbFeatures * sizeof(unsigned int));
+
+    if (!_channel.good())
+        return SOURCE_PLUGIN_CRASHED;
+
+    // Compute the features, directly in the shared buffer
+    if (!_pInputSet->computeSomeFeatures(image, coordinates, heuristic, nbFeatures,
+                                         _pSharedFeatures->indexes(), _pSharedFeatures->values()))
+    {
+        return featuresComputationFailure();
+    }
+
+    // Send the response
+    _channel.startPacket(SANDBOX_MESSAGE_RESPONSE);
+    _channel.sendPacket();
+
+    return (_channel.good() ? COMMAND_PROCESSED : SOURCE_PLUGIN_CRASHED);
+}
+
+
 tCommandProcessingResult SandboxInputSetProxy::handleInputSetObjectsInImageCommand()
 {
     // Assertions
@@ -399,3 +438,21 @@ tCommandProcessingResult SandboxInputSetProxy::handleInputSetRoiExtentCommand()
     
     return (_channel.good() ? COMMAND_PROCESSED : SOURCE_PLUGIN_CRASHED);
 }
+
+
+/*********************************** METHODS **********************************/
+
+tCommandProcessingResult SandboxInputSetProxy::featuresComputationFailure()
+{
+    if (dynamic_cast<ClassifierInputSet*>(_pInputSet))
+    {
+        tError error = dynamic_cast<ClassifierInputSet*>(_pInputSet)->getLastHeuristicsError();
+
+        if (error == ERROR_HEURISTIC_TIMEOUT)
+            return DEST_PLUGIN_TIMEOUT;
+        else if (error == ERROR_NONE)
+            return INVALID_ARGUMENTS;
+    }
+
+    return DEST_PLUGIN_CRASHED;
+}
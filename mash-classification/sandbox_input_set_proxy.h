@@ -36,6 +36,7 @@
 #include "classifier_input_set_interface.h"
 #include <mash-sandboxing/communication_channel.h>
 #include <mash-sandboxing/sandbox_controller.h>
+#include <mash/shared_features_buffer.h>
 
 
 namespace Mash
@@ -50,8 +51,14 @@ namespace Mash
     public:
         //----------------------------------------------------------------------
         /// @brief  Constructor
+        ///
+        /// @param  pInputSet           The Input Set
+        /// @param  channel             The channel to the sandboxed plugin
+        /// @param  pSharedFeatures     Buffer shared with the sandboxed plugin
+        ///                             to transfer the features (optional)
         //----------------------------------------------------------------------
-        SandboxInputSetProxy(IClassifierInputSet* pInputSet, const CommunicationChannel& channel);
+        SandboxInputSetProxy(IClassifierInputSet* pInputSet, const CommunicationChannel& channel,
+                             SharedFeaturesBuffer* pSharedFeatures = 0);
 
         //----------------------------------------------------------------------
         /// @brief  Destructor
@@ -77,11 +84,14 @@ namespace Mash
         SandboxControllerDeclarations::tCommandProcessingResult handleInputSetNbImagesCommand();
         SandboxControllerDeclarations::tCommandProcessingResult handleInputSetNbLabelsCommand();
         SandboxControllerDeclarations::tCommandProcessingResult handleInputSetComputeSomeFeaturesCommand();
+        SandboxControllerDeclarations::tCommandProcessingResult handleInputSetComputeSomeFeaturesSharedCommand();
         SandboxControllerDeclarations::tCommandProcessingResult handleInputSetObjectsInImageCommand();
         SandboxControllerDeclarations::tCommandProcessingResult handleInputSetNegativesInImageCommand();
         SandboxControllerDeclarations::tCommandProcessingResult handleInputSetImageSizeCommand();
         SandboxControllerDeclarations::tCommandProcessingResult handleInputSetImageInTestSetCommand();
         SandboxControllerDeclarations::tCommandProcessingResult handleInputSetRoiExtentCommand();
+
+        SandboxControllerDeclarations::tCommandProcessingResult featuresComputationFailure();
         
 
         //_____ Internal types __________
@@ -98,6 +108,7 @@ namespace Mash
 
         CommunicationChannel    _channel;
         IClassifierInputSet*    _pInputSet;
+        SharedFeaturesBuffer*   _pSharedFeatures;
     };
 }
 
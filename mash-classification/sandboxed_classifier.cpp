@@ -47,7 +47,7 @@ using namespace Mash::SandboxControllerDeclarations;
 /************************* CONSTRUCTION / DESTRUCTION *************************/
 
 SandboxedClassifier::SandboxedClassifier()
-: _pInputSetProxy(0), _pNotifierProxy(0)
+: _pInputSetProxy(0), _pNotifierProxy(0), _pSharedFeatures(0)
 {
 }
 
@@ -95,42 +95,36 @@ bool SandboxedClassifier::loadClassifierPlugin(const std::string& strName,
                                                const std::string& strInternalDataFile)
 {
     // Save the context (in case of crash)
-    std::ostringstream str;
-    str << "Method: loading" << endl;
-    _strContext = str.str();
+    _context.record("loading");
 
     if (_sandbox.loadPlugin(strName) != 0)
         return false;
 
     // Save the context (in case of crash)
-    str.str("");
-    str << "Method: constructor" << endl
-        << "Parameters:" << endl;
+    _context.record("constructor");
 
     if (!strModelFile.empty())
     {
-        str << "    - Model" << endl;
+        _context.addParameter("Model");
 
         if (!strInternalDataFile.empty())
         {
-            str << "    - Internal data" << endl;
+            _context.addParameter("Internal data");
             _outStream << "< USE_MODEL " << strModelFile << " " << strInternalDataFile << endl;
         }
         else
         {
-            str << "    - No internal data" << endl;
+            _context.addParameter("No internal data");
             _outStream << "< USE_MODEL " << strModelFile << " -" << endl;
         }
     }
     else
     {
-        str << "    - No model" << endl
-            << "    - No internal data" << endl;
+        _context.addParameter("No model");
+        _context.addParameter("No internal data");
         _outStream << "< USE_MODEL -" << endl;
     }
 
-    _strContext = str.str();
-
     // Send the infos about the model to the child
     CommunicationChannel* pChannel = _sandbox.channel();
 
@@ -166,7 +160,7 @@ bool SandboxedClassifier::setSeed(unsigned int seed)
     if (getLastError() != ERROR_NONE)
         return false;
 
-    _strContext = "";
+    _context.record("setSeed");
 
     _outStream << "< SET_SEED " << seed << endl;
 
@@ -193,14 +187,9 @@ bool SandboxedClassifier::setup(const tExperimentParametersList& parameters)
     _outStream << "< SETUP " << parameters.size() << " ..." << endl;
 
     // Save the context (in case of crash)
-    std::ostringstream str;
-
-    str << "Method: setup" << endl;
+    _context.record("setup");
 
-    if (parameters.empty())
-        str << "No parameters" << endl;
-    else
-        str << "Parameters:" << endl;
+    std::ostringstream str;
 
     tExperimentParametersIterator iter, iterEnd;
     for (iter = parameters.begin(), iterEnd = parameters.end();
@@ -216,7 +205,7 @@ bool SandboxedClassifier::setup(const tExperimentParametersList& parameters)
         str << endl;
     }
 
-    _strContext = str.str();
+    _context.addDetails(str.str());
 
     // Send the command to the child
     CommunicationChannel* pChannel = _sandbox.channel();
@@ -258,13 +247,11 @@ bool SandboxedClassifier::loadModel(IClassifierInputSet* input_set)
     _outStream << "< LOAD_MODEL" << endl;
 
     // Save the context (in case of crash)
-    std::ostringstream str;
-    str << "Method: loadModel" << endl;
-    _strContext = str.str();
+    _context.record("loadModel");
 
     CommunicationChannel* pChannel = _sandbox.channel();
 
-    _pInputSetProxy = new SandboxInputSetProxy(input_set, *pChannel);
+    _pInputSetProxy = new SandboxInputSetProxy(input_set, *pChannel, _pSharedFeatures);
 
     // Send the command to the child
     pChannel->startPacket(SANDBOX_COMMAND_LOAD_MODEL);
@@ -294,20 +281,15 @@ bool SandboxedClassifier::train(IClassifierInputSet* input_set, scalar_t &train_
 
     CommunicationChannel* pChannel = _sandbox.channel();
 
-    _pInputSetProxy = new SandboxInputSetProxy(input_set, *pChannel);
+    _pInputSetProxy = new SandboxInputSetProxy(input_set, *pChannel, _pSharedFeatures);
 
     // Save the context (in case of crash)
-    std::ostringstream str;
-
-    str << "Method: train" << endl
-        << "Parameters:" << endl
-        << "    - Number of images:     " << input_set->nbImages() << endl
-        << "    - Number of labels:     " << input_set->nbLabels() << endl
-        << "    - Number of heuristics: " << input_set->nbHeuristics() << endl
-        << "    - Number of features:   " << input_set->nbFeaturesTotal() << endl
-        << "    - ROI extent:           " << input_set->roiExtent() << " pixels" << endl;
-
-    _strContext = str.str();
+    _context.record("train");
+    _context.addParameter("Number of images", "%d", input_set->nbImages());
+    _context.addParameter("Number of labels", "%d", input_set->nbLabels());
+    _context.addParameter("Number of heuristics", "%d", input_set->nbHeuristics());
+    _context.addParameter("Number of features", "%d", input_set->nbFeaturesTotal());
+    _context.addParameter("ROI extent", "%d pixels", input_set->roiExtent());
 
     // Send the command to the child
     pChannel->startPacket(SANDBOX_COMMAND_CLASSIFIER_TRAIN);
@@ -350,23 +332,19 @@ bool SandboxedClassifier::classify(IClassifierInputSet* input_set,
 
     CommunicationChannel* pChannel = _sandbox.channel();
 
-    _pInputSetProxy = new SandboxInputSetProxy(input_set, *pChannel);
+    _pInputSetProxy = new SandboxInputSetProxy(input_set, *pChannel, _pSharedFeatures);
 
     // Save the context (in case of crash)
-    std::ostringstream str;
-
     dim_t image_size = input_set->imageSize(image);
 
-    str << "Method: classify" << endl
-        << "Parameters:" << endl
-        << "    - Image:                #" << image << " (" << image_size.width << "x" << image_size.height << " pixels)" << endl
-        << "    - ROI extent:           " << input_set->roiExtent() << " pixels" << endl
-        << "    - ROI position:         (" << position.x << ", " << position.y << ")" << endl
-        << "    - Number of labels:     " << input_set->nbLabels() << endl
-        << "    - Number of heuristics: " << input_set->nbHeuristics() << endl
-        << "    - Number of features:   " << input_set->nbFeaturesTotal() << endl;
-
-    _strContext = str.str();
+    _context.record("classify");
+    _context.addParameter("Image", "#%d", image);
+    _context.addParameter("Image size", "%dx%d pixels", image_size.width, image_size.height);
+    _context.addParameter("ROI extent", "%d pixels", input_set->roiExtent());
+    _context.addParameter("ROI position", "(%d, %d)", position.x, position.y);
+    _context.addParameter("Number of labels", "%d", input_set->nbLabels());
+    _context.addParameter("Number of heuristics", "%d", input_set->nbHeuristics());
+    _context.addParameter("Number of features", "%d", input_set->nbFeaturesTotal());
 
     // Send the command to the child
     pChannel->startPacket(SANDBOX_COMMAND_CLASSIFIER_CLASSIFY);
@@ -405,6 +383,80 @@ bool SandboxedClassifier::classify(IClassifierInputSet* input_set,
 }
 
 
+bool SandboxedClassifier::classifyBatch(IClassifierInputSet* input_set,
+                                        unsigned int image,
+                                        const tCoordinatesList& positions,
+                                        Classifier::tClassificationResultsList &results)
+{
+    // Assertions
+    assert(input_set);
+
+    if (getLastError() != ERROR_NONE)
+        return false;
+
+    _outStream << "< CLASSIFY_BATCH " << " " << input_set->id() << " "
+               << input_set->isDoingDetection() << " " << image << " "
+               << positions.size() << endl;
+
+    results.clear();
+    results.resize(positions.size());
+
+    if (positions.empty())
+        return true;
+
+    CommunicationChannel* pChannel = _sandbox.channel();
+
+    _pInputSetProxy = new SandboxInputSetProxy(input_set, *pChannel, _pSharedFeatures);
+
+    // Save the context (in case of crash)
+    dim_t image_size = input_set->imageSize(image);
+
+    _context.record("classifyBatch");
+    _context.addParameter("Image", "#%d", image);
+    _context.addParameter("Image size", "%dx%d pixels", image_size.width, image_size.height);
+    _context.addParameter("ROI extent", "%d pixels", input_set->roiExtent());
+    _context.addParameter("Number of positions", "%d", positions.size());
+    _context.addParameter("Number of labels", "%d", input_set->nbLabels());
+    _context.addParameter("Number of heuristics", "%d", input_set->nbHeuristics());
+    _context.addParameter("Number of features", "%d", input_set->nbFeaturesTotal());
+
+    // Send the command to the child (all the positions of the image at once)
+    pChannel->startPacket(SANDBOX_COMMAND_CLASSIFIER_CLASSIFY_BATCH);
+    pChannel->add(input_set->id());
+    pChannel->add(input_set->isDoingDetection());
+    pChannel->add(image);
+    pChannel->add((unsigned int) positions.size());
+    pChannel->addReference((const char*) &positions[0], positions.size() * sizeof(coordinates_t));
+    pChannel->sendPacket();
+
+    // Wait the response
+    bool result = pChannel->good();
+    if (result)
+        result = _sandbox.waitResponse();
+
+    // Retrieve the results
+    for (unsigned int i = 0; result && pChannel->good() && (i < positions.size()); ++i)
+    {
+        unsigned int nbScores = 0;
+        pChannel->read(&nbScores);
+
+        for (unsigned int j = 0; pChannel->good() && (j < nbScores); ++j)
+        {
+            int label;
+            scalar_t score;
+
+            if (pChannel->read(&label) && pChannel->read(&score))
+                results[i][label] = score;
+        }
+    }
+
+    delete _pInputSetProxy;
+    _pInputSetProxy = 0;
+
+    return result && pChannel->good();
+}
+
+
 bool SandboxedClassifier::reportFeaturesUsed(IClassifierInputSet* input_set,
                                              tFeatureList &list)
 {
@@ -414,16 +466,12 @@ bool SandboxedClassifier::reportFeaturesUsed(IClassifierInputSet* input_set,
     _outStream << "< REPORT_FEATURES_USED" << endl;
 
     // Save the context (in case of crash)
-    std::ostringstream str;
-
-    str << "Method: reportFeaturesUsed" << endl;
-
-    _strContext = str.str();
+    _context.record("reportFeaturesUsed");
 
     // Send the command to the child
     CommunicationChannel* pChannel = _sandbox.channel();
 
-    _pInputSetProxy = new SandboxInputSetProxy(input_set, *pChannel);
+    _pInputSetProxy = new SandboxInputSetProxy(input_set, *pChannel, _pSharedFeatures);
 
     pChannel->startPacket(SANDBOX_COMMAND_CLASSIFIER_REPORT_FEATURES_USED);
     pChannel->sendPacket();
@@ -464,9 +512,7 @@ bool SandboxedClassifier::saveModel()
     _outStream << "< SAVE_MODEL" << endl;
 
     // Save the context (in case of crash)
-    std::ostringstream str;
-    str << "Method: saveModel" << endl;
-    _strContext = str.str();
+    _context.record("saveModel");
 
     // Send the command to the child
     CommunicationChannel* pChannel = _sandbox.channel();
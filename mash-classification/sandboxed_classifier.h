@@ -37,6 +37,7 @@
 #include "sandbox_input_set_proxy.h"
 #include <mash/sandbox_notifier_proxy.h>
 #include <mash-sandboxing/sandbox_controller.h>
+#include <mash-sandboxing/context_recorder.h>
 
 
 namespace Mash
@@ -72,6 +73,19 @@ namespace Mash
         //----------------------------------------------------------------------
         bool createSandbox(const tSandboxConfiguration& configuration);
 
+        //----------------------------------------------------------------------
+        /// @brief  Sets the buffer shared with the sandbox, used by the
+        ///         classifier to retrieve the features without copying them
+        ///         through the communication channel
+        ///
+        /// The file descriptor of the buffer must have been given to the
+        /// sandbox through its configuration
+        //----------------------------------------------------------------------
+        inline void setSharedFeaturesBuffer(SharedFeaturesBuffer* pBuffer)
+        {
+            _pSharedFeatures = pBuffer;
+        }
+
         //----------------------------------------------------------------------
         /// @brief  Returns the Sandbox Controller used
         //----------------------------------------------------------------------
@@ -85,7 +99,7 @@ namespace Mash
         //----------------------------------------------------------------------
         inline std::string getContext() const
         {
-            return _strContext;
+            return _context.toString();
         }
 
         //----------------------------------------------------------------------
@@ -181,6 +195,21 @@ namespace Mash
                               const coordinates_t& position,
                               Classifier::tClassificationResults &results);
 
+        //----------------------------------------------------------------------
+        /// @brief  Classify the content of an image at several positions
+        ///
+        /// @param  input_set   The Classifier Input Set to use
+        /// @param  image       Index of the image (in the Input Set)
+        /// @param  positions   Centers of the regions-of-interest (in the
+        ///                     image)
+        /// @retval results     Classification results, one per position
+        /// @return             'true' if successful
+        //----------------------------------------------------------------------
+        virtual bool classifyBatch(IClassifierInputSet* input_set,
+                                   unsigned int image,
+                                   const tCoordinatesList& positions,
+                                   Classifier::tClassificationResultsList &results);
+
         //----------------------------------------------------------------------
         /// @brief  Populates the provided list with the features used by the
         ///         classifier
@@ -235,7 +264,8 @@ namespace Mash
         OutStream               _outStream;         ///< Output stream to use for logging
         SandboxInputSetProxy*   _pInputSetProxy;    ///< Proxy around the Input Set currently in use
         SandboxNotifierProxy*   _pNotifierProxy;    ///< Proxy around the Notifier currently in use
-        std::string             _strContext;        ///< Context of the sandboxed object (used to report
+        SharedFeaturesBuffer*   _pSharedFeatures;   ///< Buffer shared with the sandbox (optional)
+        ContextRecorder         _context;           ///< Context of the sandboxed object (used to report
                                                     ///  debugging informations after a crash)
     };
 }
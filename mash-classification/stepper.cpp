@@ -36,6 +36,10 @@
 using namespace std;
 using namespace Mash;
 
+/********************************** STATICS ***********************************/
+
+const unsigned int Stepper::MAX_CACHED_SIZES;
+
 /************************* CONSTRUCTION / DESTRUCTION *************************/
 
 Stepper::Stepper(bool detection) : _detection(detection) {}
@@ -49,87 +53,71 @@ void Stepper::setParameters(unsigned int roi_extent, unsigned int step_x,
     _step_x = step_x;
     _step_y = step_y;
     _step_z = step_z;
+
+    _scalesCache.clear();
+    _positionsCache.clear();
 }
 
 void Stepper::getScales(dim_t image_size, tScalesList* list) const
 {
-    unsigned int roi_size = _roi_extent * 2 + 1;
-
     assert(list != 0);
 
-    list->clear();
+    *list = scales(image_size);
+}
 
-    if(!_detection)
+const Stepper::tScalesList& Stepper::scales(dim_t image_size) const
+{
+    tSize key(image_size.width, image_size.height);
+
+    // Note: moving the elements of a list doesn't invalidate the references
+    // to them
+    tScalesCache::iterator iter, iterEnd;
+    for(iter = _scalesCache.begin(), iterEnd = _scalesCache.end(); iter != iterEnd; ++iter)
     {
-        list->resize(1);
-        list->front() = (float) roi_size / max(image_size.width, image_size.height);
-        return;
+        if(iter->first == key)
+        {
+            _scalesCache.splice(_scalesCache.begin(), _scalesCache, iter);
+            return iter->second;
+        }
     }
 
-    float scale = 1.0f;
+    if(_scalesCache.size() >= MAX_CACHED_SIZES)
+        _scalesCache.pop_back();
 
-    do
-    {
-        list->push_back(scale);
-        scale *= _step_z;
-    }
-    while(image_size.width * scale >= roi_size || image_size.height * scale >= roi_size);
+    _scalesCache.push_front(make_pair(key, tScalesList()));
+    computeScales(image_size, &_scalesCache.front().second);
+
+    return _scalesCache.front().second;
 }
 
 void Stepper::getPositions(dim_t image_size, tCoordinatesList* list) const
 {
     assert(list != 0);
 
-    list->clear();
-
-    if(!_detection)
-    {
-        assert(image_size.width == _roi_extent * 2 + 1);
-        assert(image_size.height == _roi_extent * 2 + 1);
-        list->resize(1);
-        list->front().x = _roi_extent;
-        list->front().y = _roi_extent;
-        return;
-    }
-
-    // Find the first pair of coordinates (top-left corner)
-    coordinates_t coords;
-
-    // Start from the middle (so that the coordinates are symetric)
-    coords.x = (image_size.width  - 1) >> 1;
-    coords.y = (image_size.height - 1) >> 1;
-
-    // Determine the number of steps to do to go from the middle to the top-left corner
-    unsigned int nb_steps_x = (coords.x - _roi_extent) / _step_x;
-    unsigned int nb_steps_y = (coords.y - _roi_extent) / _step_y;
+    *list = positions(image_size);
+}
 
-    // Go to the top-left corner
-    coords.x -= nb_steps_x * _step_x;
-    coords.y -= nb_steps_y * _step_y;
+const tCoordinatesList& Stepper::positions(dim_t image_size) const
+{
+    tSize key(image_size.width, image_size.height);
 
-    // Iterates the coordinates on the grid, alternating between left to right
-    // and right to left
-    for(unsigned int y = 0; y <= nb_steps_y << 1; ++y)
+    tPositionsCache::iterator iter, iterEnd;
+    for(iter = _positionsCache.begin(), iterEnd = _positionsCache.end(); iter != iterEnd; ++iter)
     {
-        if(y & 1)
-        {
-            for(unsigned int x = 0; x <= nb_steps_x << 1; ++x)
-            {
-                coords.x -= _step_x;
-                list->push_back(coords);
-            }
-        }
-        else
+        if(iter->first == key)
         {
-            for(unsigned int x = 0; x <= nb_steps_x << 1; ++x)
-            {
-                list->push_back(coords);
-                coords.x += _step_x;
-            }
+            _positionsCache.splice(_positionsCache.begin(), _positionsCache, iter);
+            return iter->second;
         }
-
-        coords.y += _step_y;
     }
+
+    if(_positionsCache.size() >= MAX_CACHED_SIZES)
+        _positionsCache.pop_back();
+
+    _positionsCache.push_front(make_pair(key, tCoordinatesList()));
+    computePositions(image_size, &_positionsCache.front().second);
+
+    return _positionsCache.front().second;
 }
 
 coordinates_t Stepper::getClosestPosition(dim_t image_size, coordinates_t position) const
@@ -188,3 +176,86 @@ coordinates_t Stepper::getClosestPosition(dim_t image_size, coordinates_t positi
 
     return closest;
 }
+
+/****************************** INTERNAL METHODS ******************************/
+
+void Stepper::computeScales(dim_t image_size, tScalesList* list) const
+{
+    unsigned int roi_size = _roi_extent * 2 + 1;
+
+    assert(list != 0);
+
+    list->clear();
+
+    if(!_detection)
+    {
+        list->resize(1);
+        list->front() = (float) roi_size / max(image_size.width, image_size.height);
+        return;
+    }
+
+    float scale = 1.0f;
+
+    do
+    {
+        list->push_back(scale);
+        scale *= _step_z;
+    }
+    while(image_size.width * scale >= roi_size || image_size.height * scale >= roi_size);
+}
+
+void Stepper::computePositions(dim_t image_size, tCoordinatesList* list) const
+{
+    assert(list != 0);
+
+    list->clear();
+
+    if(!_detection)
+    {
+        assert(image_size.width == _roi_extent * 2 + 1);
+        assert(image_size.height == _roi_extent * 2 + 1);
+        list->resize(1);
+        list->front().x = _roi_extent;
+        list->front().y = _roi_extent;
+        return;
+    }
+
+    // Find the first pair of coordinates (top-left corner)
+    coordinates_t coords;
+
+    // Start from the middle (so that the coordinates are symetric)
+    coords.x = (image_size.width  - 1) >> 1;
+    coords.y = (image_size.height - 1) >> 1;
+
+    // Determine the number of steps to do to go from the middle to the top-left corner
+    unsigned int nb_steps_x = (coords.x - _roi_extent) / _step_x;
+    unsigned int nb_steps_y = (coords.y - _roi_extent) / _step_y;
+
+    // Go to the top-left corner
+    coords.x -= nb_steps_x * _step_x;
+    coords.y -= nb_steps_y * _step_y;
+
+    // Iterates the coordinates on the grid, alternating between left to right
+    // and right to left
+    for(unsigned int y = 0; y <= nb_steps_y << 1; ++y)
+    {
+        if(y & 1)
+        {
+            for(unsigned int x = 0; x <= nb_steps_x << 1; ++x)
+            {
+                coords.x -= _step_x;
+                list->push_back(coords);
+            }
+        }
+        else
+        {
+            for(unsigned int x = 0; x <= nb_steps_x << 1; ++x)
+            {
+                list->push_back(coords);
+                coords.x += _step_x;
+            }
+        }
+
+        coords.y += _step_y;
+    }
+}
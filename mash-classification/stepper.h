@@ -35,6 +35,7 @@
 #include "declarations.h"
 #include <mash/heuristic.h>
 #include <vector>
+#include <list>
 
 namespace Mash
 {
@@ -48,8 +49,13 @@ namespace Mash
         //----------------------------------------------------------------------
         /// @brief  Contains the list of the possible scales of an image
         //----------------------------------------------------------------------
-        typedef std::vector<float>      tScalesList;
-        typedef tScalesList::iterator   tScalesIterator;
+        typedef std::vector<float>              tScalesList;
+        typedef tScalesList::iterator           tScalesIterator;
+        typedef tScalesList::const_iterator     tScalesConstIterator;
+
+        /// Maximum number of image dimensions for which the lists of scales
+        /// and positions are kept
+        static const unsigned int MAX_CACHED_SIZES = 32;
 
         //_____ Construction / Destruction __________
     public:
@@ -66,6 +72,9 @@ namespace Mash
         //----------------------------------------------------------------------
         /// @brief  Sets the parameters of the stepper: roi extent and step
         ///            sizes
+        ///
+        /// @remark The lists previously returned by scales() and positions()
+        ///         are invalidated
         //----------------------------------------------------------------------
         void setParameters(unsigned int roi_extent,
                            unsigned int step_x = 0,
@@ -122,6 +131,20 @@ namespace Mash
         void getScales(dim_t image_size,
                        tScalesList* list) const;
 
+        //----------------------------------------------------------------------
+        /// @brief  Returns all the possible scales of the image
+        ///
+        /// @param  image_size  The dimensions of the image
+        /// @return             The list of scales, shared by all the images of
+        ///                     the same dimensions
+        ///
+        /// The list is only computed the first time images of those dimensions
+        /// are encountered, and stays valid until the parameters of the stepper
+        /// are changed or the scales of MAX_CACHED_SIZES other dimensions are
+        /// requested.
+        //----------------------------------------------------------------------
+        const tScalesList& scales(dim_t image_size) const;
+
         //----------------------------------------------------------------------
         /// @brief  Populates the provided list with the coordinates computed by
         ///         the stepper
@@ -132,6 +155,20 @@ namespace Mash
         void getPositions(dim_t image_size,
                           tCoordinatesList* list) const;
 
+        //----------------------------------------------------------------------
+        /// @brief  Returns the coordinates computed by the stepper
+        ///
+        /// @param  image_size  The dimensions of the image
+        /// @return             The list of coordinates, shared by all the
+        ///                     images of the same dimensions
+        ///
+        /// The list is only computed the first time images of those dimensions
+        /// are encountered, and stays valid until the parameters of the stepper
+        /// are changed or the positions of MAX_CACHED_SIZES other dimensions
+        /// are requested.
+        //----------------------------------------------------------------------
+        const tCoordinatesList& positions(dim_t image_size) const;
+
         //----------------------------------------------------------------------
         /// @brief  Returns the closest scanning position of the given
         ///         coordinates
@@ -143,6 +180,37 @@ namespace Mash
         coordinates_t getClosestPosition(dim_t image_size,
                                          coordinates_t position) const;
 
+        //----------------------------------------------------------------------
+        /// @brief  Returns the number of image dimensions for which the
+        ///         positions are currently cached
+        //----------------------------------------------------------------------
+        inline unsigned int nbCachedPositions() const
+        {
+            return _positionsCache.size();
+        }
+
+        //----------------------------------------------------------------------
+        /// @brief  Returns the number of image dimensions for which the scales
+        ///         are currently cached
+        //----------------------------------------------------------------------
+        inline unsigned int nbCachedScales() const
+        {
+            return _scalesCache.size();
+        }
+
+        //_____ Internal methods __________
+    private:
+        void computeScales(dim_t image_size, tScalesList* list) const;
+        void computePositions(dim_t image_size, tCoordinatesList* list) const;
+
+
+        //_____ Internal types __________
+    private:
+        typedef std::pair<unsigned int, unsigned int>               tSize;
+        typedef std::list<std::pair<tSize, tScalesList> >           tScalesCache;
+        typedef std::list<std::pair<tSize, tCoordinatesList> >      tPositionsCache;
+
+
         //_____ Attributes __________
     private:
         bool         _detection;
@@ -150,6 +218,12 @@ namespace Mash
         unsigned int _step_x;
         unsigned int _step_y;
         float        _step_z;
+
+        // The lists computed for the last image dimensions, most recently used
+        // first (most databases only contain a few distinct ones, but the
+        // memory must stay bounded for the others)
+        mutable tScalesCache    _scalesCache;
+        mutable tPositionsCache _positionsCache;
     };
 }
 
@@ -322,6 +322,38 @@ bool TrustedClassifier::classify(IClassifierInputSet* input_set,
 }
 
 
+bool TrustedClassifier::classifyBatch(IClassifierInputSet* input_set,
+                                      unsigned int image,
+                                      const tCoordinatesList& positions,
+                                      Classifier::tClassificationResultsList &results)
+{
+    // Assertions
+    assert(input_set);
+    assert(_pManager);
+    assert(_pClassifier);
+
+    if (getLastError() != ERROR_NONE)
+        return false;
+
+    _outStream << "> CLASSIFY_BATCH " << " " << input_set->id() << " "
+               << input_set->isDoingDetection() << " " << image << " "
+               << positions.size() << endl;
+
+    results.clear();
+    results.resize(positions.size());
+
+    // Tell the classifier to classify the image
+    if (!_pClassifier->classifyBatch(input_set, image, positions, results))
+    {
+        _lastError = ERROR_CLASSIFIER_CLASSIFICATION_FAILED;
+        _outStream << getErrorDescription(_lastError) << endl;
+        return false;
+    }
+
+    return true;
+}
+
+
 bool TrustedClassifier::reportFeaturesUsed(IClassifierInputSet* input_set,
                                            tFeatureList &list)
 {
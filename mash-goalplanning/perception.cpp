@@ -254,23 +254,57 @@ Image* Perception::_getView(unsigned int view)
         if (!pImage)
             return 0;
 
-        // Rescale it if necessary
-        dim_t size = viewSize(view);
-        
-        if ((size.width != pImage->width()) || (size.height != pImage->height()))
-        {
-            Image* pOriginalImage = pImage;
-        
-            RGBPixel_t paddingColor = { 0 };
-            pImage = ImageUtils::scale(pOriginalImage, size.width, size.height, paddingColor);
-        
-            pImage->setView(pOriginalImage->view());
-        
-            delete pOriginalImage;
-        }
-
-        _views[view] = pImage;
+        _setView(view, pImage);
     }
 
     return _views[view];
 }
+
+
+void Perception::_loadViews()
+{
+    // Initialize the array of views if necessary
+    if (!_views)
+        _onStateUpdated();
+
+    // Retrieve all the missing views at once
+    std::vector<unsigned int> indices;
+    for (unsigned int view = 0; view < nbViews(); ++view)
+    {
+        if (!_views[view])
+            indices.push_back(view);
+    }
+
+    if (indices.size() <= 1)
+        return;
+
+    std::vector<Image*> images;
+    _controller.getViews(indices, &images);
+
+    for (unsigned int i = 0; i < indices.size(); ++i)
+    {
+        if (images[i])
+            _setView(indices[i], images[i]);
+    }
+}
+
+
+void Perception::_setView(unsigned int view, Image* pImage)
+{
+    // Rescale it if necessary
+    dim_t size = viewSize(view);
+    
+    if ((size.width != pImage->width()) || (size.height != pImage->height()))
+    {
+        Image* pOriginalImage = pImage;
+    
+        RGBPixel_t paddingColor = { 0 };
+        pImage = ImageUtils::scale(pOriginalImage, size.width, size.height, paddingColor);
+    
+        pImage->setView(pOriginalImage->view());
+    
+        delete pOriginalImage;
+    }
+
+    _views[view] = pImage;
+}
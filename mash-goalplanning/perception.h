@@ -247,6 +247,11 @@ namespace Mash
         void _onStateUpdated();
         void _onStateReset();
         Image* _getView(unsigned int view);
+        void _loadViews();
+
+
+    private:
+        void _setView(unsigned int view, Image* pImage);
 
 
          //_____ Attributes __________
@@ -416,7 +416,7 @@ tCommandProcessingResult SandboxTaskProxy::handlePerceptionComputeSomeFeaturesCo
 
     // Send the response
     _channel.startPacket(SANDBOX_MESSAGE_RESPONSE);
-    _channel.add((char*) values, nbFeatures * sizeof(scalar_t));
+    _channel.addReference((const char*) values, nbFeatures * sizeof(scalar_t));
     _channel.sendPacket();
 
     delete[] indexes;
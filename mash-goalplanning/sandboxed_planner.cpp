@@ -94,31 +94,25 @@ bool SandboxedPlanner::loadPlannerPlugin(const std::string& strName,
                                          const std::string& strModelFile)
 {
     // Save the context (in case of crash)
-    std::ostringstream str;
-    str << "Method: loading" << endl;
-	_strContext = str.str();
+    _context.record("loading");
 
     if (_sandbox.loadPlugin(strName) != 0)
         return false;
         
     // Save the context (in case of crash)
-    str.str("");
-    str << "Method: constructor" << endl
-        << "Parameters:" << endl;
+    _context.record("constructor");
 
     if (!strModelFile.empty())
     {
-        str << "    - Model" << endl;
+        _context.addParameter("Model");
         _outStream << "< USE_MODEL " << strModelFile << " -" << endl;
     }
     else
     {
-        str << "    - No model" << endl;
+        _context.addParameter("No model");
         _outStream << "< USE_MODEL -" << endl;
     }
 
-	_strContext = str.str();
-
     // Send the infos about the model to the child
     CommunicationChannel* pChannel = _sandbox.channel();
 
@@ -154,7 +148,7 @@ bool SandboxedPlanner::setSeed(unsigned int seed)
     if (getLastError() != ERROR_NONE)
         return false;
 
-	_strContext = "";
+	_context.record("setSeed");
 
     _outStream << "< SET_SEED " << " " << seed << endl;
 
@@ -181,14 +175,9 @@ bool SandboxedPlanner::setup(const tExperimentParametersList& parameters)
     _outStream << "< SETUP " << " " << parameters.size() << " ..." << endl;
 
     // Save the context (in case of crash)
-    std::ostringstream str;
-	
-    str << "Method: setup" << endl;
+    _context.record("setup");
 
-    if (parameters.empty())
-        str << "No parameters" << endl;
-    else
-        str << "Parameters:" << endl;
+    std::ostringstream str;
 
     tExperimentParametersIterator iter, iterEnd;
     for (iter = parameters.begin(), iterEnd = parameters.end();
@@ -204,7 +193,7 @@ bool SandboxedPlanner::setup(const tExperimentParametersList& parameters)
         str << endl;
     }
 
-	_strContext = str.str();
+    _context.addDetails(str.str());
 
     // Send the command to the child
     CommunicationChannel* pChannel = _sandbox.channel();
@@ -248,9 +237,7 @@ bool SandboxedPlanner::loadModel(IPerception* perception)
     _outStream << "< LOAD_MODEL" << endl;
 
     // Save the context (in case of crash)
-    std::ostringstream str;
-    str << "Method: loadModel" << endl;
-    _strContext = str.str();
+    _context.record("loadModel");
 
     CommunicationChannel* pChannel = _sandbox.channel();
 
@@ -287,16 +274,11 @@ bool SandboxedPlanner::learn(ITask* task)
     _pTaskProxy = new SandboxTaskProxy(task, *pChannel);
 
     // Save the context (in case of crash)
-    std::ostringstream str;
-
-    str << "Method: learn" << endl
-        << "Parameters:" << endl
-        << "    - Number of actions:    " << task->nbActions() << endl
-        << "    - Number of views:      " << task->perception()->nbViews() << endl
-        << "    - Number of heuristics: " << task->perception()->nbHeuristics() << endl
-        << "    - Number of features:   " << task->perception()->nbFeaturesTotal() << endl;
-
-    _strContext = str.str();
+    _context.record("learn");
+    _context.addParameter("Number of actions", "%d", task->nbActions());
+    _context.addParameter("Number of views", "%d", task->perception()->nbViews());
+    _context.addParameter("Number of heuristics", "%d", task->perception()->nbHeuristics());
+    _context.addParameter("Number of features", "%d", task->perception()->nbFeaturesTotal());
 
     // Send the command to the child
     pChannel->startPacket(SANDBOX_COMMAND_PLANNER_LEARN);
@@ -333,15 +315,10 @@ bool SandboxedPlanner::chooseAction(IPerception* perception, unsigned int* actio
     _pTaskProxy = new SandboxTaskProxy(perception, *pChannel);
 
     // Save the context (in case of crash)
-    std::ostringstream str;
- 
-    str << "Method: chooseAction" << endl
-        << "Parameters:" << endl
-        << "    - Number of views:      " << perception->nbViews() << endl
-        << "    - Number of heuristics: " << perception->nbHeuristics() << endl
-        << "    - Number of features:   " << perception->nbFeaturesTotal() << endl;
-
-    _strContext = str.str();
+    _context.record("chooseAction");
+    _context.addParameter("Number of views", "%d", perception->nbViews());
+    _context.addParameter("Number of heuristics", "%d", perception->nbHeuristics());
+    _context.addParameter("Number of features", "%d", perception->nbFeaturesTotal());
 
     // Send the command to the child
     pChannel->startPacket(SANDBOX_COMMAND_PLANNER_CHOOSE_ACTION);
@@ -378,11 +355,7 @@ bool SandboxedPlanner::reportFeaturesUsed(IPerception* perception, tFeatureList
     _outStream << "< REPORT_FEATURES_USED" << endl;
 
     // Save the context (in case of crash)
-    std::ostringstream str;
-	
-    str << "Method: reportFeaturesUsed" << endl;
-
-	_strContext = str.str();
+    _context.record("reportFeaturesUsed");
 
     // Send the command to the child
     CommunicationChannel* pChannel = _sandbox.channel();
@@ -430,9 +403,7 @@ bool SandboxedPlanner::saveModel()
     _outStream << "< SAVE_MODEL" << endl;
 
     // Save the context (in case of crash)
-    std::ostringstream str;
-    str << "Method: saveModel" << endl;
-    _strContext = str.str();
+    _context.record("saveModel");
 
     // Send the command to the child
     CommunicationChannel* pChannel = _sandbox.channel();
@@ -37,6 +37,7 @@
 #include "sandbox_task_proxy.h"
 #include <mash/sandbox_notifier_proxy.h>
 #include <mash-sandboxing/sandbox_controller.h>
+#include <mash-sandboxing/context_recorder.h>
 
 
 namespace Mash
@@ -85,7 +86,7 @@ namespace Mash
         //----------------------------------------------------------------------
         inline std::string getContext() const
         {
-            return _strContext;
+            return _context.toString();
         }
 
         //----------------------------------------------------------------------
@@ -230,7 +231,7 @@ namespace Mash
         OutStream               _outStream;         ///< Output stream to use for logging
         SandboxTaskProxy*       _pTaskProxy;        ///< Proxy around the Task or Perception currently in use
         SandboxNotifierProxy*   _pNotifierProxy;    ///< Proxy around the Notifier currently in use
-        std::string             _strContext;        ///< Context of the sandboxed object (used to report
+        ContextRecorder         _context;           ///< Context of the sandboxed object (used to report
                                                     ///  debugging informations after a crash)
         tError                  _lastError;         ///< Last error that occured
     };
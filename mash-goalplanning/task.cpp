@@ -91,6 +91,8 @@ bool Task::performAction(unsigned int action, scalar_t* reward)
     
     if (!_strCaptureFolder.empty())
     {
+        _perception._loadViews();
+
         for (unsigned int view = 0; view < _perception.nbViews(); ++view)
         {
             Image* pImage = _perception._getView(view);
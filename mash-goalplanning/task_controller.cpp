@@ -32,16 +32,24 @@
 #include "task_controller.h"
 #include <mash/imageutils.h>
 #include <mash-utils/stringutils.h>
+#include <mash-utils/compression.h>
 
 
 using namespace std;
 using namespace Mash;
 
 
+/********************************** CONSTANTS *********************************/
+
+// Maximum number of GET_TRAJECTORY_LENGTH requests pipelined at once
+const unsigned int MAX_PIPELINED_REQUESTS = 256;
+
+
 /************************* CONSTRUCTION / DESTRUCTION *************************/
 
 TaskController::TaskController()
-: _pClient(0), _bSupportRecordedSequences(false), _result(RESULT_NONE),
+: _pClient(0), _bSupportRecordedSequences(false),
+  _bSupportViewEncodings(false), _result(RESULT_NONE),
   _mode(GPMODE_STANDARD), _nbTrajectories(0), _suggestedAction(0)
 {
 }
@@ -89,10 +97,26 @@ tError TaskController::setClient(Client* pClient)
         return ERROR_NETWORK_RESPONSE_FAILURE;
     
     if ((strResponse != "PROTOCOL") || (args.size() != 1) ||
-        ((args.getString(0) != "1.4") && (args.getString(0) != "1.3") && (args.getString(0) != "1.2")))
+        ((args.getString(0) != "1.5") && (args.getString(0) != "1.4") &&
+         (args.getString(0) != "1.3") && (args.getString(0) != "1.2")))
         return ERROR_APPSERVER_UNSUPPORTED_PROTOCOL;
 
-    _bSupportRecordedSequences = (args.getString(0) == "1.4");
+    _bSupportRecordedSequences = (args.getString(0) == "1.5") || (args.getString(0) == "1.4");
+    _bSupportViewEncodings = (args.getString(0) == "1.5");
+
+    // Ask for compressed views (sent as differences with the previous ones),
+    // we don't have to decode PNG files anymore
+    if (_bSupportViewEncodings)
+    {
+        if (!_pClient->sendCommand("USE_VIEW_ENCODING", ArgumentsList("DELTA")))
+            return ERROR_NETWORK_REQUEST_FAILURE;
+
+        if (!_pClient->waitResponse(&strResponse, &args))
+            return ERROR_NETWORK_RESPONSE_FAILURE;
+
+        // Not fatal: the server will use the default encoding
+        _bSupportViewEncodings = (strResponse == "OK");
+    }
 
     // Sends an STATUS request to the application server
     if (!_pClient->sendCommand("STATUS", args))
@@ -126,6 +150,7 @@ tError TaskController::selectTask(const std::string& strGoal, const std::string&
     _result = RESULT_NONE;
     _mode = GPMODE_STANDARD;
     _nbTrajectories = 0;
+    _trajectoryLengths.clear();
     
     // Sends a INITIALIZE_TASK request to the application server
     args.add(strGoal);
@@ -205,25 +230,20 @@ tError TaskController::selectTask(const std::string& strGoal, const std::string&
             _mode = GPMODE_STANDARD;
     }
 
-    // Sends the parameters to the application server
-    if (!_pClient->sendCommand("BEGIN_TASK_SETUP", ArgumentsList()))
+    // Sends the parameters to the application server (pipelined: each of
+    // them is acknowledged with an 'OK', in the same order)
+    if (!_pClient->queueCommand("BEGIN_TASK_SETUP", ArgumentsList()))
         return ERROR_NETWORK_REQUEST_FAILURE;
 
-    if (!_pClient->waitResponse(&strResponse, &args))
-        return ERROR_NETWORK_RESPONSE_FAILURE;
-    
-    if (strResponse != "OK")
-    {
-        _strLastError = strResponse + " (expected: OK)";
-        return ERROR_APPSERVER_UNEXPECTED_RESPONSE;
-    }
-
     tExperimentParametersIterator iter, iterEnd;
     for (iter = parameters.begin(), iterEnd = parameters.end(); iter != iterEnd; ++iter)
     {
-        if (!_pClient->sendCommand(iter->first, iter->second))
+        if (!_pClient->queueCommand(iter->first, iter->second))
             return ERROR_NETWORK_REQUEST_FAILURE;
+    }
 
+    for (unsigned int i = 0; i < parameters.size() + 1; ++i)
+    {
         if (!_pClient->waitResponse(&strResponse, &args))
             return ERROR_NETWORK_RESPONSE_FAILURE;
 
@@ -368,18 +388,41 @@ unsigned int TaskController::trajectoryLength(unsigned int trajectory)
     if (trajectory >= _nbTrajectories)
         return 0;
 
-    // Sends an GET_TRAJECTORY_LENGTH request to the application server
-    if (!_pClient->sendCommand("GET_TRAJECTORY_LENGTH", ArgumentsList((int) trajectory)))
-        return 0;
+    // Use the cached value if available
+    if (!_trajectoryLengths.empty())
+        return _trajectoryLengths[trajectory];
 
-    // Retrieve the length of the trajectory
-    if (!_pClient->waitResponse(&strResponse, &args))
-        return 0;
-    
-    if ((strResponse != "TRAJECTORY_LENGTH") || (args.size() != 1))
-        return 0;
-    
-    return (unsigned) args.getInt(0);
+    // Retrieve the lengths of all the trajectories, by groups of pipelined
+    // GET_TRAJECTORY_LENGTH requests
+    tLengthsList lengths(_nbTrajectories, 0);
+
+    for (unsigned int first = 0; first < _nbTrajectories; first += MAX_PIPELINED_REQUESTS)
+    {
+        unsigned int end = first + MAX_PIPELINED_REQUESTS;
+        if (end > _nbTrajectories)
+            end = _nbTrajectories;
+
+        for (unsigned int i = first; i < end; ++i)
+        {
+            if (!_pClient->queueCommand("GET_TRAJECTORY_LENGTH", ArgumentsList((int) i)))
+                return 0;
+        }
+
+        for (unsigned int i = first; i < end; ++i)
+        {
+            if (!_pClient->waitResponse(&strResponse, &args))
+                return 0;
+
+            if ((strResponse != "TRAJECTORY_LENGTH") || (args.size() != 1))
+                return 0;
+
+            lengths[i] = (unsigned) args.getInt(0);
+        }
+    }
+
+    _trajectoryLengths = lengths;
+
+    return _trajectoryLengths[trajectory];
 }
 
 
@@ -389,55 +432,34 @@ Image* TaskController::getView(unsigned int index)
     assert(_pClient);
     assert(index < nbViews());
 
-    // Declarations
-    string strResponse;
-    ArgumentsList args;
-    string strName;
-    string strMimeType;
-    int size;
-    Image* pImage;
-
     // Sends an GET_VIEW request to the application server
-    args.add(_views[index].strName);
-    if (!_pClient->sendCommand("GET_VIEW", args))
-        return 0;
-
-    // Retrieve the infos about the image
-    if (!_pClient->waitResponse(&strResponse, &args))
-        return 0;
-    
-    if ((strResponse != "VIEW") || (args.size() != 3))
+    if (!_pClient->sendCommand("GET_VIEW", ArgumentsList(_views[index].strName)))
         return 0;
 
-    strName = args.getString(0);
-    strMimeType = args.getString(1);
-    size = args.getInt(2);
-
-    if ((strName != _views[index].strName) || (size <= 0))
-        return 0;
-    
-    // Retrieve the bytes
-    unsigned char* pBuffer = new unsigned char[size];
-    if (!_pClient->waitData(pBuffer, size))
-    {
-        delete[] pBuffer;
-        return 0;
-    }
-    
-    // Create the image from the buffer
-    pImage = ImageUtils::createImage(strMimeType, pBuffer, size);
+    return receiveView(index);
+}
 
-    delete[] pBuffer;
 
-    if (!pImage)
-        return 0;
+void TaskController::getViews(const std::vector<unsigned int>& indices,
+                              std::vector<Image*>* images)
+{
+    // Assertions
+    assert(_pClient);
+    assert(images);
 
-    // Add the missing pixel formats to the image
-    ImageUtils::convertImageToPixelFormats(pImage, Image::PIXELFORMAT_ALL);
+    images->clear();
 
-    pImage->setView(index);
+    // Sends all the GET_VIEW requests to the application server
+    bool bSent = true;
+    for (unsigned int i = 0; bSent && (i < indices.size()); ++i)
+    {
+        assert(indices[i] < nbViews());
+        bSent = _pClient->queueCommand("GET_VIEW", ArgumentsList(_views[indices[i]].strName));
+    }
 
-    return pImage;
+    // Retrieve the views, in the same order
+    for (unsigned int i = 0; i < indices.size(); ++i)
+        images->push_back(bSent ? receiveView(indices[i]) : 0);
 }
 
 
@@ -537,3 +559,85 @@ tError TaskController::performAction(unsigned int action, scalar_t* reward)
         }
     }
 }
+
+
+/***************************** INTERNAL METHODS *******************************/
+
+Image* TaskController::receiveView(unsigned int index)
+{
+    // Declarations
+    string strResponse;
+    ArgumentsList args;
+    string strName;
+    string strMimeType;
+    int size;
+    Image* pImage;
+
+    // Retrieve the infos about the image
+    if (!_pClient->waitResponse(&strResponse, &args))
+        return 0;
+    
+    if ((strResponse != "VIEW") || (args.size() != 3))
+        return 0;
+
+    strName = args.getString(0);
+    strMimeType = args.getString(1);
+    size = args.getInt(2);
+
+    if ((strName != _views[index].strName) || (size <= 0))
+        return 0;
+    
+    // Retrieve the bytes
+    unsigned char* pBuffer = new unsigned char[size];
+    if (!_pClient->waitData(pBuffer, size))
+    {
+        delete[] pBuffer;
+        return 0;
+    }
+    
+    // Decompress the buffer if necessary
+    if (_bSupportViewEncodings &&
+        ((strMimeType == "image/mif+lz4") || (strMimeType == "image/mif+lz4-delta")))
+    {
+        tView& view = _views[index];
+        
+        std::vector<unsigned char> mif(8 + 3 * view.width * view.height);
+
+        bool bValid = Compression::decompress(pBuffer, size, &mif[0], mif.size());
+
+        delete[] pBuffer;
+
+        if (!bValid)
+            return 0;
+
+        if (strMimeType == "image/mif+lz4-delta")
+        {
+            if (view.previous.size() != mif.size())
+                return 0;
+
+            Compression::xorBuffers(&mif[0], &view.previous[0], mif.size());
+        }
+
+        view.previous.swap(mif);
+
+        pImage = ImageUtils::createImage("image/mif", &view.previous[0],
+                                         view.previous.size());
+    }
+    else
+    {
+        // Create the image from the buffer
+        pImage = ImageUtils::createImage(strMimeType, pBuffer, size);
+
+        delete[] pBuffer;
+    }
+
+    if (!pImage)
+        return 0;
+
+    // Add the missing pixel formats to the image
+    ImageUtils::convertImageToPixelFormats(pImage, Image::PIXELFORMAT_ALL);
+
+    pImage->setView(index);
+
+    return pImage;
+}
@@ -55,11 +55,16 @@ namespace Mash
             std::string     strName;
             unsigned int    width;
             unsigned int    height;
+            std::vector<unsigned char> previous;    ///< Last MIF buffer received
+                                                    ///  (used by the delta
+                                                    ///  encoding)
         };
 
         typedef std::vector<tView>          tViewsList;
         typedef tViewsList::iterator        tViewsIterator;
 
+        typedef std::vector<unsigned int>   tLengthsList;
+
 
         //_____ Construction / Destruction __________
     public:
@@ -150,6 +155,9 @@ namespace Mash
         ///
         /// @param trajectory   Index of the trajectory
         ///
+        /// The lengths of all the trajectories are retrieved (with pipelined
+        /// requests) at the first call.
+        ///
         /// Only available in GPMODE_RECORDED_TEACHER and
         /// GPMODE_RECORDED_TRAJECTORIES modes
         //----------------------------------------------------------------------
@@ -184,6 +192,19 @@ namespace Mash
         //----------------------------------------------------------------------
         Image* getView(unsigned int index);
 
+        //----------------------------------------------------------------------
+        /// @brief  Returns several views at once
+        ///
+        /// The requests are pipelined: all the views are retrieved in one
+        /// round-trip with the application server.
+        ///
+        /// @param      indices Indices of the views
+        /// @param[out] images  The views (0 for the ones that couldn't be
+        ///                     retrieved), in the same order than the indices
+        //----------------------------------------------------------------------
+        void getViews(const std::vector<unsigned int>& indices,
+                      std::vector<Image*>* images);
+
         //----------------------------------------------------------------------
         /// @brief  Returns the dimensions of the specified view
         ///
@@ -239,14 +260,21 @@ namespace Mash
         }
 
 
+        //_____ Internal methods __________
+    private:
+        Image* receiveView(unsigned int index);
+
+
         //_____ Attributes __________
     private:
         Client*             _pClient;
         bool                _bSupportRecordedSequences;
+        bool                _bSupportViewEncodings;
         tStringList         _actions;
         tViewsList          _views;
         tGoalPlanningMode   _mode;
         unsigned int        _nbTrajectories;
+        tLengthsList        _trajectoryLengths;
         tResult             _result;
         unsigned int        _suggestedAction;
         std::string         _strLastError;
@@ -66,13 +66,44 @@ namespace Mash
             CLASSIFICATION_ERROR_WRONG_CLASSIFICATION,  ///< Classified an object with an incorrect label
         };
 
+        //----------------------------------------------------------------------
+        /// @brief  Enumerates the events an instrument can consume
+        ///
+        /// Used to declare the events the instrument is interested in (see
+        /// Instrument::events): the other ones aren't sent to it at all.
+        //----------------------------------------------------------------------
+        enum tEvent
+        {
+            EVENT_EXPERIMENT_DONE                   = 0x0001,
+            EVENT_CLASSIFICATION_EXPERIMENT_STARTED = 0x0002,
+            EVENT_CLASSIFIER_TRAINING_STARTED       = 0x0004,
+            EVENT_CLASSIFIER_TRAINING_DONE          = 0x0008,
+            EVENT_CLASSIFIER_TEST_STARTED           = 0x0010,
+            EVENT_CLASSIFIER_TEST_DONE              = 0x0020,
+            EVENT_CLASSIFIER_CLASSIFICATION_DONE    = 0x0040,
+            EVENT_FEATURES_COMPUTED_BY_CLASSIFIER   = 0x0080,
+            EVENT_GOALPLANNING_EXPERIMENT_STARTED   = 0x0100,
+            EVENT_PLANNER_LEARNING_STARTED          = 0x0200,
+            EVENT_PLANNER_LEARNING_DONE             = 0x0400,
+            EVENT_PLANNER_TEST_STARTED              = 0x0800,
+            EVENT_PLANNER_TEST_DONE                 = 0x1000,
+            EVENT_PLANNER_ACTION_CHOOSEN            = 0x2000,
+            EVENT_FEATURES_COMPUTED_BY_PLANNER      = 0x4000,
+            EVENT_FEATURE_LIST_REPORTED             = 0x8000,
+
+            EVENT_ALL                               = 0xFFFF,
+        };
+
 
         //_____ Construction / Destruction __________
     public:
         //----------------------------------------------------------------------
         /// @brief  Constructor
         //----------------------------------------------------------------------
-        Instrument() {}
+        Instrument()
+        : events(0), unhandled(0)
+        {
+        }
 
         //----------------------------------------------------------------------
         /// @brief  Destructor
@@ -98,7 +129,7 @@ namespace Mash
         //----------------------------------------------------------------------
         /// @brief  Called at the end of an experiment
         //----------------------------------------------------------------------
-        virtual void onExperimentDone() {}
+        virtual void onExperimentDone() { unhandled |= EVENT_EXPERIMENT_DONE; }
 
 
         //_____ Classifier-related events __________
@@ -112,7 +143,7 @@ namespace Mash
         /// @remark Only available for classification and object detection
         ///         experiments
         //----------------------------------------------------------------------
-        virtual void onExperimentStarted(IClassifierInputSet* input_set) {}
+        virtual void onExperimentStarted(IClassifierInputSet* input_set) { unhandled |= EVENT_CLASSIFICATION_EXPERIMENT_STARTED; }
 
         //----------------------------------------------------------------------
         /// @brief  Called when the training of the classifier has started (just
@@ -123,7 +154,7 @@ namespace Mash
         /// @remark Only available for classification and object detection
         ///         experiments
         //----------------------------------------------------------------------
-        virtual void onClassifierTrainingStarted(IClassifierInputSet* input_set) {}
+        virtual void onClassifierTrainingStarted(IClassifierInputSet* input_set) { unhandled |= EVENT_CLASSIFIER_TRAINING_STARTED; }
 
         //----------------------------------------------------------------------
         /// @brief  Called when the training of the classifier is done (after
@@ -137,7 +168,7 @@ namespace Mash
         ///         experiments
         //----------------------------------------------------------------------
         virtual void onClassifierTrainingDone(IClassifierInputSet* input_set,
-                                              scalar_t train_error) {}
+                                              scalar_t train_error) { unhandled |= EVENT_CLASSIFIER_TRAINING_DONE; }
 
         //----------------------------------------------------------------------
         /// @brief  Called when the test of the classifier has started
@@ -147,7 +178,7 @@ namespace Mash
         /// @remark Only available for classification and object detection
         ///         experiments
         //----------------------------------------------------------------------
-        virtual void onClassifierTestStarted(IClassifierInputSet* input_set) {}
+        virtual void onClassifierTestStarted(IClassifierInputSet* input_set) { unhandled |= EVENT_CLASSIFIER_TEST_STARTED; }
 
         //----------------------------------------------------------------------
         /// @brief  Called when the test of the classifier is done
@@ -159,7 +190,7 @@ namespace Mash
         ///         experiments
         //----------------------------------------------------------------------
         virtual void onClassifierTestDone(IClassifierInputSet* input_set,
-                                          scalar_t test_error) {}
+                                          scalar_t test_error) { unhandled |= EVENT_CLASSIFIER_TEST_DONE; }
 
         //----------------------------------------------------------------------
         /// @brief  Called when the classifier finished to classify an object
@@ -182,7 +213,7 @@ namespace Mash
                                                     unsigned int original_image,
                                                     const coordinates_t& position,
                                                     const Classifier::tClassificationResults& results,
-                                                    tClassificationError error) {}
+                                                    tClassificationError error) { unhandled |= EVENT_CLASSIFIER_CLASSIFICATION_DONE; }
 
         //----------------------------------------------------------------------
         /// @brief  Called when some features have been computed by a classifier
@@ -210,7 +241,7 @@ namespace Mash
                                                     unsigned int heuristic,
                                                     unsigned int nbFeatures,
                                                     unsigned int* indexes,
-                                                    scalar_t* values) {}
+                                                    scalar_t* values) { unhandled |= EVENT_FEATURES_COMPUTED_BY_CLASSIFIER; }
 
 
         //_____ Goalplanner-related events __________
@@ -223,7 +254,7 @@ namespace Mash
         ///
         /// @remark Only available for goal-planning experiments
         //----------------------------------------------------------------------
-        virtual bool onExperimentStarted(ITask* task) {}
+        virtual bool onExperimentStarted(ITask* task) { unhandled |= EVENT_GOALPLANNING_EXPERIMENT_STARTED; return true; }
 
         //----------------------------------------------------------------------
         /// @brief  Called when the learning phase of the goal-planner has
@@ -233,7 +264,7 @@ namespace Mash
         ///
         /// @remark Only available for goal-planning experiments
         //----------------------------------------------------------------------
-        virtual void onPlannerLearningStarted(ITask* task) {}
+        virtual void onPlannerLearningStarted(ITask* task) { unhandled |= EVENT_PLANNER_LEARNING_STARTED; }
 
         //----------------------------------------------------------------------
         /// @brief  Called when the learning phase of the goal-planner (after
@@ -244,7 +275,7 @@ namespace Mash
         ///
         /// @remark Only available for goal-planning experiments
         //----------------------------------------------------------------------
-        virtual void onPlannerLearningDone(ITask* task, tResult result) {}
+        virtual void onPlannerLearningDone(ITask* task, tResult result) { unhandled |= EVENT_PLANNER_LEARNING_DONE; }
 
         //----------------------------------------------------------------------
         /// @brief  Called when the test of the goal-planner has started
@@ -253,7 +284,7 @@ namespace Mash
         ///
         /// @remark Only available for goal-planning experiments
         //----------------------------------------------------------------------
-        virtual void onPlannerTestStarted(ITask* task) {}
+        virtual void onPlannerTestStarted(ITask* task) { unhandled |= EVENT_PLANNER_TEST_STARTED; }
 
         //----------------------------------------------------------------------
         /// @brief  Called when the test of the goal-planner is done
@@ -264,7 +295,7 @@ namespace Mash
         ///
         /// @remark Only available for goal-planning experiments
         //----------------------------------------------------------------------
-        virtual void onPlannerTestDone(ITask* task, scalar_t score, tResult result) {}
+        virtual void onPlannerTestDone(ITask* task, scalar_t score, tResult result) { unhandled |= EVENT_PLANNER_TEST_DONE; }
 
         //----------------------------------------------------------------------
         /// @brief  Called when the goal-planner has choosed the next action to
@@ -278,7 +309,7 @@ namespace Mash
         /// @remark Only available for goal-planning experiments
         //----------------------------------------------------------------------
         virtual void onPlannerActionChoosen(ITask* task, unsigned int action,
-                                            scalar_t reward, tResult result) {}
+                                            scalar_t reward, tResult result) { unhandled |= EVENT_PLANNER_ACTION_CHOOSEN; }
 
         //----------------------------------------------------------------------
         /// @brief  Called when some features have been computed by a
@@ -302,7 +333,7 @@ namespace Mash
                                                  unsigned int heuristic,
                                                  unsigned int nbFeatures,
                                                  unsigned int* indexes,
-                                                 scalar_t* values) {}
+                                                 scalar_t* values) { unhandled |= EVENT_FEATURES_COMPUTED_BY_PLANNER; }
 
 
         //_____ Predictor-related events __________
@@ -313,12 +344,22 @@ namespace Mash
         ///
         /// @param  features    The list of features
         //----------------------------------------------------------------------
-        virtual void onFeatureListReported(const tFeatureList& features) {}
+        virtual void onFeatureListReported(const tFeatureList& features) { unhandled |= EVENT_FEATURE_LIST_REPORTED; }
 
 
         //_____ Attributes __________
     public:
-        DataWriter writer;  ///< The object to use to save data
+        DataWriter      writer;     ///< The object to use to save data
+
+        /// Events consumed by the instrument (combination of 'tEvent' values),
+        /// to be set in the constructor. If left to 0, all the events are sent
+        /// to the instrument, until it doesn't handle them (see 'unhandled').
+        unsigned int    events;
+
+        /// Events received by the instrument but not handled by it (set by the
+        /// default implementations of the event methods, the first time they
+        /// are called). They aren't sent to the instrument anymore.
+        unsigned int    unhandled;
     };
 
 
@@ -83,6 +83,18 @@ Instrument* InstrumentsManager::create(const std::string& strName)
 }
 
 
+unsigned int InstrumentsManager::getSubscribedEvents(const Instrument* pInstrument)
+{
+    // Assertions
+    assert(pInstrument);
+
+    unsigned int events = (pInstrument->events != 0 ? pInstrument->events
+                                                     : Instrument::EVENT_ALL);
+
+    return (events & ~pInstrument->unhandled);
+}
+
+
 tInstrumentConstructor* InstrumentsManager::getInstrumentConstructor(const std::string& strInstrument)
 {
     // Assertions
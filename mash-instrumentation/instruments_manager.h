@@ -79,6 +79,19 @@ namespace Mash
         //----------------------------------------------------------------------
         Instrument* create(const std::string& strName);
 
+        //----------------------------------------------------------------------
+        /// @brief  Returns the events consumed by an instrument
+        ///
+        /// @param  pInstrument The instrument
+        /// @return             A combination of Instrument::tEvent values
+        ///
+        /// The events declared by the instrument (see Instrument::events) are
+        /// used if any, all the events otherwise. The events that the
+        /// instrument received but didn't handle (see Instrument::unhandled)
+        /// are removed.
+        //----------------------------------------------------------------------
+        static unsigned int getSubscribedEvents(const Instrument* pInstrument);
+
 
     private:
         tInstrumentConstructor* getInstrumentConstructor(const std::string& strInstrument);
@@ -118,6 +118,20 @@ namespace Mash
         //----------------------------------------------------------------------
         virtual std::string instrumentName(int index) const = 0;
 
+        //----------------------------------------------------------------------
+        /// @brief  Returns the events consumed by an instrument
+        ///
+        /// @param  index   Index of the instrument
+        /// @return         A combination of Instrument::tEvent values
+        //----------------------------------------------------------------------
+        virtual unsigned int instrumentEvents(int index) const = 0;
+
+        //----------------------------------------------------------------------
+        /// @brief  Returns the events consumed by at least one of the
+        ///         instruments (the other ones are ignored by the set)
+        //----------------------------------------------------------------------
+        virtual unsigned int subscribedEvents() const = 0;
+
 
         //_____ General events __________
     public:
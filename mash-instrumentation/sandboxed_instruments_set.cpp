@@ -44,17 +44,45 @@ using namespace Mash;
 using namespace Mash::SandboxControllerDeclarations;
 
 
+/********************************** CONSTANTS *********************************/
+
+// Maximum number of 'features computed by classifier' events waiting to be
+// delivered (the classifier is blocked when the queue is full)
+const unsigned int MAX_PENDING_EVENTS = 1024;
+
+// Maximum size of the features of those events (in bytes)
+const size_t MAX_PENDING_SIZE = 16 * 1024 * 1024;
+
+
 /************************* CONSTRUCTION / DESTRUCTION *************************/
 
 SandboxedInstrumentsSet::SandboxedInstrumentsSet()
 : _pInputSetProxy(0), _pTaskProxy(0), _currentInstrument(-1),
-  _lastError(ERROR_NONE)
+  _lastError(ERROR_NONE), _events(0), _checkedEvents(0), _pendingSize(0),
+  _bDelivering(false), _bStopDelivery(false), _bThreadStarted(false)
 {
+    pthread_mutex_init(&_mutex, 0);
+    pthread_cond_init(&_condition, 0);
 }
 
 
 SandboxedInstrumentsSet::~SandboxedInstrumentsSet()
 {
+    // Stop the delivery thread (the events still in the queue are delivered
+    // first)
+    if (_bThreadStarted)
+    {
+        pthread_mutex_lock(&_mutex);
+        _bStopDelivery = true;
+        pthread_cond_broadcast(&_condition);
+        pthread_mutex_unlock(&_mutex);
+
+        pthread_join(_thread, 0);
+    }
+
+    pthread_cond_destroy(&_condition);
+    pthread_mutex_destroy(&_mutex);
+
     _outStream.deleteFile();
 }
 
@@ -172,7 +200,11 @@ bool SandboxedInstrumentsSet::createInstruments()
     str << "Method: constructor" << endl;
 	_strContext = str.str();
         
-    return _sandbox.createPlugins();
+    if (!_sandbox.createPlugins())
+        return false;
+
+    // Retrieve the events consumed by the instruments
+    return retrieveEvents();
 }
 
 
@@ -194,11 +226,29 @@ std::string SandboxedInstrumentsSet::instrumentName(int index) const
 }
 
 
+unsigned int SandboxedInstrumentsSet::instrumentEvents(int index) const
+{
+    // Assertions
+    assert(index >= 0);
+
+    if (index >= _instrumentsEvents.size())
+        return 0;
+
+    return _instrumentsEvents[index];
+}
+
+
+unsigned int SandboxedInstrumentsSet::subscribedEvents() const
+{
+    return _events;
+}
+
+
 /******************************** GENERAL EVENTS ******************************/
 
 bool SandboxedInstrumentsSet::onExperimentDone()
 {
-    if (_sandbox.nbPlugins() == 0)
+    if ((_events & Instrument::EVENT_EXPERIMENT_DONE) == 0)
         return true;
 
     if (getLastError() != ERROR_NONE)
@@ -227,6 +277,9 @@ bool SandboxedInstrumentsSet::onExperimentDone()
     if (_lastError == ERROR_NONE)
         _lastError = (pChannel->getLastError() == ERROR_CHANNEL_SLAVE_CRASHED) ? ERROR_INSTRUMENT_CRASHED : ERROR_NONE;
 
+    if (result)
+        updateEvents(Instrument::EVENT_EXPERIMENT_DONE);
+
     return result;
 }
 
@@ -238,7 +291,7 @@ bool SandboxedInstrumentsSet::onExperimentStarted(IClassifierInputSet* input_set
     // Assertions
     assert(input_set);
 
-    if (_sandbox.nbPlugins() == 0)
+    if ((_events & Instrument::EVENT_CLASSIFICATION_EXPERIMENT_STARTED) == 0)
         return true;
 
     if (getLastError() != ERROR_NONE)
@@ -280,6 +333,9 @@ bool SandboxedInstrumentsSet::onExperimentStarted(IClassifierInputSet* input_set
     if (_lastError == ERROR_NONE)
         _lastError = (pChannel->getLastError() == ERROR_CHANNEL_SLAVE_CRASHED) ? ERROR_INSTRUMENT_CRASHED : ERROR_NONE;
 
+    if (result)
+        updateEvents(Instrument::EVENT_CLASSIFICATION_EXPERIMENT_STARTED);
+
     return result;
 }
 
@@ -289,7 +345,7 @@ bool SandboxedInstrumentsSet::onClassifierTrainingStarted(IClassifierInputSet* i
     // Assertions
     assert(input_set);
 
-    if (_sandbox.nbPlugins() == 0)
+    if ((_events & Instrument::EVENT_CLASSIFIER_TRAINING_STARTED) == 0)
         return true;
 
     if (getLastError() != ERROR_NONE)
@@ -331,6 +387,9 @@ bool SandboxedInstrumentsSet::onClassifierTrainingStarted(IClassifierInputSet* i
     if (_lastError == ERROR_NONE)
         _lastError = (pChannel->getLastError() == ERROR_CHANNEL_SLAVE_CRASHED) ? ERROR_INSTRUMENT_CRASHED : ERROR_NONE;
 
+    if (result)
+        updateEvents(Instrument::EVENT_CLASSIFIER_TRAINING_STARTED);
+
     return result;
 }
 
@@ -341,7 +400,7 @@ bool SandboxedInstrumentsSet::onClassifierTrainingDone(IClassifierInputSet* inpu
     // Assertions
     assert(input_set);
 
-    if (_sandbox.nbPlugins() == 0)
+    if ((_events & Instrument::EVENT_CLASSIFIER_TRAINING_DONE) == 0)
         return true;
 
     if (getLastError() != ERROR_NONE)
@@ -383,6 +442,9 @@ bool SandboxedInstrumentsSet::onClassifierTrainingDone(IClassifierInputSet* inpu
     if (_lastError == ERROR_NONE)
         _lastError = (pChannel->getLastError() == ERROR_CHANNEL_SLAVE_CRASHED) ? ERROR_INSTRUMENT_CRASHED : ERROR_NONE;
 
+    if (result)
+        updateEvents(Instrument::EVENT_CLASSIFIER_TRAINING_DONE);
+
     return result;
 }
 
@@ -392,7 +454,7 @@ bool SandboxedInstrumentsSet::onClassifierTestStarted(IClassifierInputSet* input
     // Assertions
     assert(input_set);
 
-    if (_sandbox.nbPlugins() == 0)
+    if ((_events & Instrument::EVENT_CLASSIFIER_TEST_STARTED) == 0)
         return true;
 
     if (getLastError() != ERROR_NONE)
@@ -434,6 +496,9 @@ bool SandboxedInstrumentsSet::onClassifierTestStarted(IClassifierInputSet* input
     if (_lastError == ERROR_NONE)
         _lastError = (pChannel->getLastError() == ERROR_CHANNEL_SLAVE_CRASHED) ? ERROR_INSTRUMENT_CRASHED : ERROR_NONE;
 
+    if (result)
+        updateEvents(Instrument::EVENT_CLASSIFIER_TEST_STARTED);
+
     return result;
 }
 
@@ -444,7 +509,7 @@ bool SandboxedInstrumentsSet::onClassifierTestDone(IClassifierInputSet* input_se
     // Assertions
     assert(input_set);
 
-    if (_sandbox.nbPlugins() == 0)
+    if ((_events & Instrument::EVENT_CLASSIFIER_TEST_DONE) == 0)
         return true;
 
     if (getLastError() != ERROR_NONE)
@@ -486,6 +551,9 @@ bool SandboxedInstrumentsSet::onClassifierTestDone(IClassifierInputSet* input_se
     if (_lastError == ERROR_NONE)
         _lastError = (pChannel->getLastError() == ERROR_CHANNEL_SLAVE_CRASHED) ? ERROR_INSTRUMENT_CRASHED : ERROR_NONE;
 
+    if (result)
+        updateEvents(Instrument::EVENT_CLASSIFIER_TEST_DONE);
+
     return result;
 }
 
@@ -500,7 +568,7 @@ bool SandboxedInstrumentsSet::onClassifierClassificationDone(IClassifierInputSet
     // Assertions
     assert(input_set);
 
-    if (_sandbox.nbPlugins() == 0)
+    if ((_events & Instrument::EVENT_CLASSIFIER_CLASSIFICATION_DONE) == 0)
         return true;
 
     if (getLastError() != ERROR_NONE)
@@ -572,6 +640,9 @@ bool SandboxedInstrumentsSet::onClassifierClassificationDone(IClassifierInputSet
     if (_lastError == ERROR_NONE)
         _lastError = (pChannel->getLastError() == ERROR_CHANNEL_SLAVE_CRASHED) ? ERROR_INSTRUMENT_CRASHED : ERROR_NONE;
 
+    if (result)
+        updateEvents(Instrument::EVENT_CLASSIFIER_CLASSIFICATION_DONE);
+
     return result;
 }
 
@@ -591,59 +662,86 @@ bool SandboxedInstrumentsSet::onFeaturesComputedByClassifier(bool detection,
     assert(indexes);
     assert(values);
 
-    if (_sandbox.nbPlugins() == 0)
+    if ((_events & Instrument::EVENT_FEATURES_COMPUTED_BY_CLASSIFIER) == 0)
         return true;
 
-    if (getLastError() != ERROR_NONE)
+    pthread_mutex_lock(&_mutex);
+
+    // The sandbox can only be checked when the delivery thread isn't using it
+    tError error = ((_bDelivering || !_pendingEvents.empty()) ? _lastError : currentError());
+    if (error != ERROR_NONE)
+    {
+        pthread_mutex_unlock(&_mutex);
         return false;
+    }
 
-    _outStream << "< EVENT_FEATURES_COMPUTED_BY_CLASSIFIER " << detection << " "
-               << training << " " << image << " " << original_image << " "
-               << coords.x << " " << coords.y << " " << heuristic << " "
-               << nbFeatures << " ..." << endl;
+    if (!_bThreadStarted)
+        _bThreadStarted = (pthread_create(&_thread, 0, deliveryThread, this) == 0);
 
-    // Save the context (in case of crash)
-    std::ostringstream str;
+    // Without delivery thread, or until the instruments reported if they handle
+    // the event, the event is sent synchronously
+    if (!_bThreadStarted || ((_checkedEvents & Instrument::EVENT_FEATURES_COMPUTED_BY_CLASSIFIER) == 0))
+    {
+        pthread_mutex_unlock(&_mutex);
 
-	str << "Method: onFeaturesComputedByClassifier" << endl
-        << "Parameters:" << endl
-        << "    - Detection:          " << detection << endl
-        << "    - Training:           " << training << endl
-        << "    - Image:              #" << image << endl
-        << "    - Original image:     #" << original_image << endl
-        << "    - ROI position:       (" << coords.x << ", " << coords.y << ")" << endl
-        << "    - ROI extent:         " << roiExtent << endl
-        << "    - Heuristic:          #" << heuristic << endl
-        << "    - Number of features: " << nbFeatures << endl;
+        tFeaturesEventsList events(1);
+        tFeaturesEvent& event = events.back();
 
-	_strContext = str.str();
+        event.detection         = detection;
+        event.training          = training;
+        event.image             = image;
+        event.original_image    = original_image;
+        event.coords            = coords;
+        event.roiExtent         = roiExtent;
+        event.heuristic         = heuristic;
+        event.indexes.assign(indexes, indexes + nbFeatures);
+        event.values.assign(values, values + nbFeatures);
 
-    // Send the command to the child
-    CommunicationChannel* pChannel = _sandbox.channel();
+        error = sendFeaturesEvents(events);
+        if ((error != ERROR_NONE) && (_lastError == ERROR_NONE))
+            _lastError = error;
 
-    pChannel->startPacket(SANDBOX_EVENT_INSTRUMENTS_FEATURES_COMPUTED_BY_CLASSIFIER);
-    pChannel->add(detection);
-    pChannel->add(training);
-    pChannel->add(image);
-    pChannel->add(original_image);
-    pChannel->add(coords.x);
-    pChannel->add(coords.y);
-    pChannel->add(roiExtent);
-    pChannel->add(heuristic);
-    pChannel->add(nbFeatures);
-    pChannel->add((char*) indexes, nbFeatures * sizeof(unsigned int));
-    pChannel->add((char*) values, nbFeatures * sizeof(scalar_t));
-    pChannel->sendPacket();
+        if (error == ERROR_NONE)
+            updateEvents(Instrument::EVENT_FEATURES_COMPUTED_BY_CLASSIFIER);
 
-    // Wait the response
-    bool result = pChannel->good();
-    if (result)
-        result = _sandbox.waitResponse();
-    
-    if (_lastError == ERROR_NONE)
-        _lastError = (pChannel->getLastError() == ERROR_CHANNEL_SLAVE_CRASHED) ? ERROR_INSTRUMENT_CRASHED : ERROR_NONE;
+        return (error == ERROR_NONE);
+    }
 
-    return result;
+    // Wait until there is some room in the queue
+    size_t size = nbFeatures * (sizeof(unsigned int) + sizeof(scalar_t));
+
+    while (!_pendingEvents.empty() && (_lastError == ERROR_NONE) &&
+           ((_pendingEvents.size() >= MAX_PENDING_EVENTS) || (_pendingSize + size > MAX_PENDING_SIZE)))
+    {
+        pthread_cond_wait(&_condition, &_mutex);
+    }
+
+    if (_lastError != ERROR_NONE)
+    {
+        pthread_mutex_unlock(&_mutex);
+        return false;
+    }
+
+    // Queue the event (the arrays belong to the caller, so they are copied)
+    _pendingEvents.push_back(tFeaturesEvent());
+    tFeaturesEvent& event = _pendingEvents.back();
+
+    event.detection         = detection;
+    event.training          = training;
+    event.image             = image;
+    event.original_image    = original_image;
+    event.coords            = coords;
+    event.roiExtent         = roiExtent;
+    event.heuristic         = heuristic;
+    event.indexes.assign(indexes, indexes + nbFeatures);
+    event.values.assign(values, values + nbFeatures);
+
+    _pendingSize += size;
+
+    pthread_cond_broadcast(&_condition);
+    pthread_mutex_unlock(&_mutex);
+
+    return true;
 }
 
 
@@ -654,7 +752,7 @@ bool SandboxedInstrumentsSet::onExperimentStarted(ITask* task)
     // Assertions
     assert(task);
 
-    if (_sandbox.nbPlugins() == 0)
+    if ((_events & Instrument::EVENT_GOALPLANNING_EXPERIMENT_STARTED) == 0)
         return true;
 
     if (getLastError() != ERROR_NONE)
@@ -693,6 +791,9 @@ bool SandboxedInstrumentsSet::onExperimentStarted(ITask* task)
     if (_lastError == ERROR_NONE)
         _lastError = (pChannel->getLastError() == ERROR_CHANNEL_SLAVE_CRASHED) ? ERROR_INSTRUMENT_CRASHED : ERROR_NONE;
 
+    if (result)
+        updateEvents(Instrument::EVENT_GOALPLANNING_EXPERIMENT_STARTED);
+
     return result;
 }
 
@@ -702,7 +803,7 @@ bool SandboxedInstrumentsSet::onPlannerLearningStarted(ITask* task)
     // Assertions
     assert(task);
 
-    if (_sandbox.nbPlugins() == 0)
+    if ((_events & Instrument::EVENT_PLANNER_LEARNING_STARTED) == 0)
         return true;
 
     if (getLastError() != ERROR_NONE)
@@ -741,6 +842,9 @@ bool SandboxedInstrumentsSet::onPlannerLearningStarted(ITask* task)
     if (_lastError == ERROR_NONE)
         _lastError = (pChannel->getLastError() == ERROR_CHANNEL_SLAVE_CRASHED) ? ERROR_INSTRUMENT_CRASHED : ERROR_NONE;
 
+    if (result)
+        updateEvents(Instrument::EVENT_PLANNER_LEARNING_STARTED);
+
     return result;
 }
 
@@ -750,7 +854,7 @@ bool SandboxedInstrumentsSet::onPlannerLearningDone(ITask* task, tResult result)
     // Assertions
     assert(task);
 
-    if (_sandbox.nbPlugins() == 0)
+    if ((_events & Instrument::EVENT_PLANNER_LEARNING_DONE) == 0)
         return true;
 
     if (getLastError() != ERROR_NONE)
@@ -800,6 +904,9 @@ bool SandboxedInstrumentsSet::onPlannerLearningDone(ITask* task, tResult result)
     if (_lastError == ERROR_NONE)
         _lastError = (pChannel->getLastError() == ERROR_CHANNEL_SLAVE_CRASHED) ? ERROR_INSTRUMENT_CRASHED : ERROR_NONE;
 
+    if (res)
+        updateEvents(Instrument::EVENT_PLANNER_LEARNING_DONE);
+
     return res;
 }
 
@@ -809,7 +916,7 @@ bool SandboxedInstrumentsSet::onPlannerTestStarted(ITask* task)
     // Assertions
     assert(task);
 
-    if (_sandbox.nbPlugins() == 0)
+    if ((_events & Instrument::EVENT_PLANNER_TEST_STARTED) == 0)
         return true;
 
     if (getLastError() != ERROR_NONE)
@@ -848,6 +955,9 @@ bool SandboxedInstrumentsSet::onPlannerTestStarted(ITask* task)
     if (_lastError == ERROR_NONE)
         _lastError = (pChannel->getLastError() == ERROR_CHANNEL_SLAVE_CRASHED) ? ERROR_INSTRUMENT_CRASHED : ERROR_NONE;
 
+    if (result)
+        updateEvents(Instrument::EVENT_PLANNER_TEST_STARTED);
+
     return result;
 }
 
@@ -857,7 +967,7 @@ bool SandboxedInstrumentsSet::onPlannerTestDone(ITask* task, scalar_t score, tRe
     // Assertions
     assert(task);
 
-    if (_sandbox.nbPlugins() == 0)
+    if ((_events & Instrument::EVENT_PLANNER_TEST_DONE) == 0)
         return true;
 
     if (getLastError() != ERROR_NONE)
@@ -909,6 +1019,9 @@ bool SandboxedInstrumentsSet::onPlannerTestDone(ITask* task, scalar_t score, tRe
     if (_lastError == ERROR_NONE)
         _lastError = (pChannel->getLastError() == ERROR_CHANNEL_SLAVE_CRASHED) ? ERROR_INSTRUMENT_CRASHED : ERROR_NONE;
 
+    if (res)
+        updateEvents(Instrument::EVENT_PLANNER_TEST_DONE);
+
     return res;
 }
 
@@ -919,7 +1032,7 @@ bool SandboxedInstrumentsSet::onPlannerActionChoosen(ITask* task, unsigned int a
     // Assertions
     assert(task);
 
-    if (_sandbox.nbPlugins() == 0)
+    if ((_events & Instrument::EVENT_PLANNER_ACTION_CHOOSEN) == 0)
         return true;
 
     if (getLastError() != ERROR_NONE)
@@ -974,6 +1087,9 @@ bool SandboxedInstrumentsSet::onPlannerActionChoosen(ITask* task, unsigned int a
     if (_lastError == ERROR_NONE)
         _lastError = (pChannel->getLastError() == ERROR_CHANNEL_SLAVE_CRASHED) ? ERROR_INSTRUMENT_CRASHED : ERROR_NONE;
 
+    if (res)
+        updateEvents(Instrument::EVENT_PLANNER_ACTION_CHOOSEN);
+
     return res;
 }
 
@@ -992,7 +1108,7 @@ bool SandboxedInstrumentsSet::onFeaturesComputedByPlanner(unsigned int sequence,
     assert(indexes);
     assert(values);
 
-    if (_sandbox.nbPlugins() == 0)
+    if ((_events & Instrument::EVENT_FEATURES_COMPUTED_BY_PLANNER) == 0)
         return true;
 
     if (getLastError() != ERROR_NONE)
@@ -1029,8 +1145,8 @@ bool SandboxedInstrumentsSet::onFeaturesComputedByPlanner(unsigned int sequence,
     pChannel->add(roiExtent);
     pChannel->add(heuristic);
     pChannel->add(nbFeatures);
-    pChannel->add((char*) indexes, nbFeatures * sizeof(unsigned int));
-    pChannel->add((char*) values, nbFeatures * sizeof(scalar_t));
+    pChannel->addReference((const char*) indexes, nbFeatures * sizeof(unsigned int));
+    pChannel->addReference((const char*) values, nbFeatures * sizeof(scalar_t));
     pChannel->sendPacket();
 
     // Wait the response
@@ -1041,6 +1157,9 @@ bool SandboxedInstrumentsSet::onFeaturesComputedByPlanner(unsigned int sequence,
     if (_lastError == ERROR_NONE)
         _lastError = (pChannel->getLastError() == ERROR_CHANNEL_SLAVE_CRASHED) ? ERROR_INSTRUMENT_CRASHED : ERROR_NONE;
 
+    if (result)
+        updateEvents(Instrument::EVENT_FEATURES_COMPUTED_BY_PLANNER);
+
     return result;
 }
 
@@ -1049,7 +1168,7 @@ bool SandboxedInstrumentsSet::onFeaturesComputedByPlanner(unsigned int sequence,
 
 bool SandboxedInstrumentsSet::onFeatureListReported(const tFeatureList& features)
 {
-    if (_sandbox.nbPlugins() == 0)
+    if ((_events & Instrument::EVENT_FEATURE_LIST_REPORTED) == 0)
         return true;
 
     if (getLastError() != ERROR_NONE)
@@ -1092,6 +1211,9 @@ bool SandboxedInstrumentsSet::onFeatureListReported(const tFeatureList& features
     if (_lastError == ERROR_NONE)
         _lastError = (pChannel->getLastError() == ERROR_CHANNEL_SLAVE_CRASHED) ? ERROR_INSTRUMENT_CRASHED : ERROR_NONE;
 
+    if (result)
+        updateEvents(Instrument::EVENT_FEATURE_LIST_REPORTED);
+
     return result;
 }
 
@@ -1100,10 +1222,24 @@ bool SandboxedInstrumentsSet::onFeatureListReported(const tFeatureList& features
 
 tError SandboxedInstrumentsSet::getLastError()
 {
-    return (_lastError != ERROR_NONE ?
-                _lastError :
-                (_sandbox.getLastError() == ERROR_CHANNEL_SLAVE_CRASHED ?
-                        ERROR_INSTRUMENT_CRASHED : _sandbox.getLastError()));
+    flushEvents();
+
+    return currentError();
+}
+
+
+bool SandboxedInstrumentsSet::flushEvents()
+{
+    pthread_mutex_lock(&_mutex);
+
+    while (!_pendingEvents.empty() || _bDelivering)
+        pthread_cond_wait(&_condition, &_mutex);
+
+    bool result = (_lastError == ERROR_NONE);
+
+    pthread_mutex_unlock(&_mutex);
+
+    return result;
 }
 
 
@@ -1129,3 +1265,195 @@ tCommandProcessingResult SandboxedInstrumentsSet::processResponse(tSandboxMessag
     
     return result;
 }
+
+
+/****************************** INTERNAL METHODS ******************************/
+
+bool SandboxedInstrumentsSet::retrieveEvents()
+{
+    _outStream << "< INSTRUMENT_EVENTS" << endl;
+
+    CommunicationChannel* pChannel = _sandbox.channel();
+
+    pChannel->startPacket(SANDBOX_COMMAND_INSTRUMENT_EVENTS);
+    pChannel->sendPacket();
+
+    bool result = pChannel->good();
+    if (result)
+        result = _sandbox.waitResponse();
+
+    unsigned int nbInstruments = 0;
+    if (result)
+        result = pChannel->read(&nbInstruments);
+
+    _instrumentsEvents.resize(nbInstruments, 0);
+
+    unsigned int events = 0;
+
+    for (unsigned int i = 0; result && (i < nbInstruments); ++i)
+    {
+        result = pChannel->read(&_instrumentsEvents[i]);
+        events |= _instrumentsEvents[i];
+
+        _outStream << "    " << _sandbox.getPluginName(i) << ": " << _instrumentsEvents[i] << endl;
+    }
+
+    if (result)
+        _events = events;
+
+    if (_lastError == ERROR_NONE)
+        _lastError = (pChannel->getLastError() == ERROR_CHANNEL_SLAVE_CRASHED) ? ERROR_INSTRUMENT_CRASHED : ERROR_NONE;
+
+    return result;
+}
+
+
+void SandboxedInstrumentsSet::updateEvents(unsigned int event)
+{
+    // The instruments report the events they don't handle the first time they
+    // receive them, so the events are retrieved again after the first delivery
+    // of each kind of event
+    if ((_checkedEvents & event) != 0)
+        return;
+
+    _checkedEvents |= event;
+
+    retrieveEvents();
+}
+
+
+tError SandboxedInstrumentsSet::currentError()
+{
+    return (_lastError != ERROR_NONE ?
+                _lastError :
+                (_sandbox.getLastError() == ERROR_CHANNEL_SLAVE_CRASHED ?
+                        ERROR_INSTRUMENT_CRASHED : _sandbox.getLastError()));
+}
+
+
+tError SandboxedInstrumentsSet::sendFeaturesEvents(const tFeaturesEventsList& events)
+{
+    // Assertions
+    assert(!events.empty());
+
+    const tFeaturesEvent& last = events.back();
+
+    _outStream << "< EVENT_FEATURES_COMPUTED_BY_CLASSIFIER_BATCH " << events.size() << endl;
+
+    tFeaturesEventsList::const_iterator iter, iterEnd;
+    for (iter = events.begin(), iterEnd = events.end(); iter != iterEnd; ++iter)
+    {
+        _outStream << "< EVENT_FEATURES_COMPUTED_BY_CLASSIFIER " << iter->detection << " "
+                   << iter->training << " " << iter->image << " " << iter->original_image << " "
+                   << iter->coords.x << " " << iter->coords.y << " " << iter->heuristic << " "
+                   << iter->indexes.size() << " ..." << endl;
+    }
+
+    // Save the context (in case of crash)
+    std::ostringstream str;
+
+	str << "Method: onFeaturesComputedByClassifier" << endl
+        << "Number of events in the batch: " << events.size() << endl
+        << "Parameters of the last event:" << endl
+        << "    - Detection:          " << last.detection << endl
+        << "    - Training:           " << last.training << endl
+        << "    - Image:              #" << last.image << endl
+        << "    - Original image:     #" << last.original_image << endl
+        << "    - ROI position:       (" << last.coords.x << ", " << last.coords.y << ")" << endl
+        << "    - ROI extent:         " << last.roiExtent << endl
+        << "    - Heuristic:          #" << last.heuristic << endl
+        << "    - Number of features: " << last.indexes.size() << endl;
+
+	_strContext = str.str();
+
+    // Send all the events in one packet
+    CommunicationChannel* pChannel = _sandbox.channel();
+
+    pChannel->startPacket(SANDBOX_EVENT_INSTRUMENTS_FEATURES_COMPUTED_BY_CLASSIFIER_BATCH);
+    pChannel->add((unsigned int) events.size());
+
+    for (iter = events.begin(), iterEnd = events.end(); iter != iterEnd; ++iter)
+    {
+        unsigned int nbFeatures = iter->indexes.size();
+
+        pChannel->add(iter->detection);
+        pChannel->add(iter->training);
+        pChannel->add(iter->image);
+        pChannel->add(iter->original_image);
+        pChannel->add(iter->coords.x);
+        pChannel->add(iter->coords.y);
+        pChannel->add(iter->roiExtent);
+        pChannel->add(iter->heuristic);
+        pChannel->add(nbFeatures);
+
+        if (nbFeatures > 0)
+        {
+            pChannel->addReference((const char*) &iter->indexes[0], nbFeatures * sizeof(unsigned int));
+            pChannel->addReference((const char*) &iter->values[0], nbFeatures * sizeof(scalar_t));
+        }
+    }
+
+    pChannel->sendPacket();
+
+    // Wait the response (only one for the whole batch)
+    if (pChannel->good() && _sandbox.waitResponse())
+        return ERROR_NONE;
+
+    if (pChannel->getLastError() == ERROR_CHANNEL_SLAVE_CRASHED)
+        return ERROR_INSTRUMENT_CRASHED;
+
+    if (_sandbox.getLastError() != ERROR_NONE)
+        return _sandbox.getLastError();
+
+    return (pChannel->getLastError() != ERROR_NONE ? pChannel->getLastError() : ERROR_INSTRUMENT_CRASHED);
+}
+
+
+void* SandboxedInstrumentsSet::deliveryThread(void* pInstrumentsSet)
+{
+    ((SandboxedInstrumentsSet*) pInstrumentsSet)->deliverEvents();
+
+    return 0;
+}
+
+
+void SandboxedInstrumentsSet::deliverEvents()
+{
+    tFeaturesEventsList events;
+
+    pthread_mutex_lock(&_mutex);
+
+    while (true)
+    {
+        while (_pendingEvents.empty() && !_bStopDelivery)
+            pthread_cond_wait(&_condition, &_mutex);
+
+        if (_pendingEvents.empty())
+            break;
+
+        // Take all the queued events at once: the classifier can continue to
+        // fill the queue while they are sent
+        events.swap(_pendingEvents);
+        _pendingSize = 0;
+        _bDelivering = true;
+
+        bool bSend = (_lastError == ERROR_NONE);
+
+        pthread_cond_broadcast(&_condition);
+        pthread_mutex_unlock(&_mutex);
+
+        // After an error, the remaining events are dropped
+        tError error = (bSend ? sendFeaturesEvents(events) : ERROR_NONE);
+        events.clear();
+
+        pthread_mutex_lock(&_mutex);
+
+        if ((error != ERROR_NONE) && (_lastError == ERROR_NONE))
+            _lastError = error;
+
+        _bDelivering = false;
+        pthread_cond_broadcast(&_condition);
+    }
+
+    pthread_mutex_unlock(&_mutex);
+}
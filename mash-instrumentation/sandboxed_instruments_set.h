@@ -39,6 +39,9 @@
 #include <mash-goalplanning/sandbox_task_proxy.h>
 #include "instruments_set_interface.h"
 #include "instrument.h"
+#include <deque>
+#include <vector>
+#include <pthread.h>
 
 
 namespace Mash
@@ -159,6 +162,20 @@ namespace Mash
         //----------------------------------------------------------------------
         virtual std::string instrumentName(int index) const;
 
+        //----------------------------------------------------------------------
+        /// @brief  Returns the events consumed by an instrument
+        ///
+        /// @param  index   Index of the instrument
+        /// @return         A combination of Instrument::tEvent values
+        //----------------------------------------------------------------------
+        virtual unsigned int instrumentEvents(int index) const;
+
+        //----------------------------------------------------------------------
+        /// @brief  Returns the events consumed by at least one of the
+        ///         instruments (the other ones are ignored by the set)
+        //----------------------------------------------------------------------
+        virtual unsigned int subscribedEvents() const;
+
         //----------------------------------------------------------------------
         /// @brief  Returns the index of the current instrument
         //----------------------------------------------------------------------
@@ -395,9 +412,25 @@ namespace Mash
     public:
         //----------------------------------------------------------------------
         /// @brief  Returns the last error that occured
+        ///
+        /// The queued events are delivered first, so an error caused by one
+        /// of them is reported too
         //----------------------------------------------------------------------
         virtual tError getLastError();
 
+        //----------------------------------------------------------------------
+        /// @brief  Wait until all the queued events have been delivered to the
+        ///         instruments
+        ///
+        /// The 'features computed by classifier' events are queued and sent
+        /// in batches by a separate thread. All the other events are
+        /// synchronous, and flush the queue before being sent (through
+        /// getLastError()), so the instruments receive them in order.
+        ///
+        /// @return 'false' if the delivery of one of the events failed
+        //----------------------------------------------------------------------
+        bool flushEvents();
+
 
         //_____ Implementation of ISandboxControllerListener __________
     public:
@@ -415,6 +448,68 @@ namespace Mash
                     processResponse(tSandboxMessage message);
 
 
+        //_____ Internal types __________
+    protected:
+        // A 'features computed by classifier' event waiting to be delivered
+        struct tFeaturesEvent
+        {
+            bool                        detection;
+            bool                        training;
+            unsigned int                image;
+            unsigned int                original_image;
+            coordinates_t               coords;
+            unsigned int                roiExtent;
+            unsigned int                heuristic;
+            std::vector<unsigned int>   indexes;
+            std::vector<scalar_t>       values;
+        };
+
+        typedef std::deque<tFeaturesEvent>  tFeaturesEventsList;
+
+
+        //_____ Internal methods __________
+    protected:
+        //----------------------------------------------------------------------
+        /// @brief  Returns the last error that occured, without waiting for
+        ///         the queued events
+        //----------------------------------------------------------------------
+        tError currentError();
+
+        //----------------------------------------------------------------------
+        /// @brief  Retrieve the events consumed by the instruments from the
+        ///         sandbox
+        ///
+        /// @return 'true' if successful
+        //----------------------------------------------------------------------
+        bool retrieveEvents();
+
+        //----------------------------------------------------------------------
+        /// @brief  Retrieve the events consumed by the instruments again after
+        ///         the first delivery of an event (see Instrument::unhandled)
+        ///
+        /// @param  event   The event delivered (one of Instrument::tEvent)
+        //----------------------------------------------------------------------
+        void updateEvents(unsigned int event);
+
+        //----------------------------------------------------------------------
+        /// @brief  Send a batch of events to the sandbox and wait for the
+        ///         response
+        ///
+        /// @return Error code
+        //----------------------------------------------------------------------
+        tError sendFeaturesEvents(const tFeaturesEventsList& events);
+
+        //----------------------------------------------------------------------
+        /// @brief  Entry point of the thread delivering the queued events
+        //----------------------------------------------------------------------
+        static void* deliveryThread(void* pInstrumentsSet);
+
+        //----------------------------------------------------------------------
+        /// @brief  Main loop of the thread delivering the queued events
+        //----------------------------------------------------------------------
+        void deliverEvents();
+
+
         //_____ Attributes __________
     protected:
         SandboxController       _sandbox;           ///< The sandbox used
@@ -425,6 +520,22 @@ namespace Mash
         std::string             _strContext;        ///< Context of the sandboxed object (used to report
                                                     ///  debugging informations after a crash)
         tError                  _lastError;         ///< Last error that occured
+
+        // Events consumed by the instruments (the other ones aren't sent to
+        // the sandbox)
+        std::vector<unsigned int>   _instrumentsEvents; ///< Events consumed by each instrument
+        unsigned int                _events;            ///< Events consumed by at least one instrument
+        unsigned int                _checkedEvents;     ///< Events delivered at least once
+
+        // Asynchronous delivery of the 'features computed by classifier' events
+        tFeaturesEventsList     _pendingEvents;     ///< Events not delivered yet
+        size_t                  _pendingSize;       ///< Size of the features of those events (in bytes)
+        bool                    _bDelivering;       ///< Indicates if a batch is being sent
+        bool                    _bStopDelivery;     ///< Indicates if the thread must exit
+        bool                    _bThreadStarted;
+        pthread_t               _thread;
+        pthread_mutex_t         _mutex;
+        pthread_cond_t          _condition;
     };
 }
 
@@ -46,7 +46,7 @@ using namespace Mash;
 /************************* CONSTRUCTION / DESTRUCTION *************************/
 
 TrustedInstrumentsSet::TrustedInstrumentsSet()
-: _pManager(0), _lastError(ERROR_NONE)
+: _pManager(0), _lastError(ERROR_NONE), _events(0)
 {
     _outStream.setVerbosityLevel(3);
 }
@@ -127,6 +127,7 @@ int TrustedInstrumentsSet::loadInstrumentPlugin(const std::string& strName)
     tInstrumentInfos infos;
     infos.strName = strName;
     infos.pInstrument = 0;
+    infos.events = 0;
     
     _instruments.push_back(infos);
     
@@ -175,6 +176,11 @@ bool TrustedInstrumentsSet::createInstruments()
             return false;
         }
 
+        iter->events = InstrumentsManager::getSubscribedEvents(iter->pInstrument);
+        _events |= iter->events;
+
+        _outStream << "Subscribed events: " << iter->events << endl;
+
         iter->pInstrument->writer.open(_strReportFolder + iter->strName + ".data");
 
         iter->pInstrument->setup(iter->parameters);
@@ -222,6 +228,24 @@ std::string TrustedInstrumentsSet::instrumentName(int index) const
 }
 
 
+unsigned int TrustedInstrumentsSet::instrumentEvents(int index) const
+{
+    // Assertions
+    assert(index >= 0);
+
+    if (index >= _instruments.size())
+        return 0;
+
+    return _instruments[index].events;
+}
+
+
+unsigned int TrustedInstrumentsSet::subscribedEvents() const
+{
+    return _events;
+}
+
+
 /******************************** GENERAL EVENTS ******************************/
 
 bool TrustedInstrumentsSet::onExperimentDone()
@@ -229,7 +253,7 @@ bool TrustedInstrumentsSet::onExperimentDone()
     // Assertions
     assert(_pManager);
 
-    if (_instruments.empty())
+    if ((_events & Instrument::EVENT_EXPERIMENT_DONE) == 0)
         return true;
 
     if (getLastError() != ERROR_NONE)
@@ -240,7 +264,12 @@ bool TrustedInstrumentsSet::onExperimentDone()
     // Forward the event to all the instruments
     tInstrumentsIterator iter, iterEnd;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter)
-        iter->pInstrument->onExperimentDone();
+    {
+        if (iter->events & Instrument::EVENT_EXPERIMENT_DONE)
+            iter->pInstrument->onExperimentDone();
+    }
+
+    updateEvents();
 
     return true;
 }
@@ -254,7 +283,7 @@ bool TrustedInstrumentsSet::onExperimentStarted(IClassifierInputSet* input_set)
     assert(input_set);
     assert(_pManager);
 
-    if (_instruments.empty())
+    if ((_events & Instrument::EVENT_CLASSIFICATION_EXPERIMENT_STARTED) == 0)
         return true;
  
     if (getLastError() != ERROR_NONE)
@@ -271,7 +300,12 @@ bool TrustedInstrumentsSet::onExperimentStarted(IClassifierInputSet* input_set)
     // Forward the event to all the instruments
     tInstrumentsIterator iter, iterEnd;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter)
-        iter->pInstrument->onExperimentStarted(input_set);
+    {
+        if (iter->events & Instrument::EVENT_CLASSIFICATION_EXPERIMENT_STARTED)
+            iter->pInstrument->onExperimentStarted(input_set);
+    }
+
+    updateEvents();
 
     if (pSet)
         pSet->setReadOnly(false);
@@ -286,7 +320,7 @@ bool TrustedInstrumentsSet::onClassifierTrainingStarted(IClassifierInputSet* inp
     assert(input_set);
     assert(_pManager);
 
-    if (_instruments.empty())
+    if ((_events & Instrument::EVENT_CLASSIFIER_TRAINING_STARTED) == 0)
         return true;
  
     if (getLastError() != ERROR_NONE)
@@ -303,7 +337,12 @@ bool TrustedInstrumentsSet::onClassifierTrainingStarted(IClassifierInputSet* inp
     // Forward the event to all the instruments
     tInstrumentsIterator iter, iterEnd;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter)
-        iter->pInstrument->onClassifierTrainingStarted(input_set);
+    {
+        if (iter->events & Instrument::EVENT_CLASSIFIER_TRAINING_STARTED)
+            iter->pInstrument->onClassifierTrainingStarted(input_set);
+    }
+
+    updateEvents();
 
     if (pSet)
         pSet->setReadOnly(false);
@@ -319,7 +358,7 @@ bool TrustedInstrumentsSet::onClassifierTrainingDone(IClassifierInputSet* input_
     assert(input_set);
     assert(_pManager);
 
-    if (_instruments.empty())
+    if ((_events & Instrument::EVENT_CLASSIFIER_TRAINING_DONE) == 0)
         return true;
  
     if (getLastError() != ERROR_NONE)
@@ -335,7 +374,12 @@ bool TrustedInstrumentsSet::onClassifierTrainingDone(IClassifierInputSet* input_
     // Forward the event to all the instruments
     tInstrumentsIterator iter, iterEnd;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter)
-        iter->pInstrument->onClassifierTrainingDone(input_set, train_error);
+    {
+        if (iter->events & Instrument::EVENT_CLASSIFIER_TRAINING_DONE)
+            iter->pInstrument->onClassifierTrainingDone(input_set, train_error);
+    }
+
+    updateEvents();
 
     if (pSet)
         pSet->setReadOnly(false);
@@ -350,7 +394,7 @@ bool TrustedInstrumentsSet::onClassifierTestStarted(IClassifierInputSet* input_s
     assert(input_set);
     assert(_pManager);
 
-    if (_instruments.empty())
+    if ((_events & Instrument::EVENT_CLASSIFIER_TEST_STARTED) == 0)
         return true;
  
     if (getLastError() != ERROR_NONE)
@@ -367,7 +411,12 @@ bool TrustedInstrumentsSet::onClassifierTestStarted(IClassifierInputSet* input_s
     // Forward the event to all the instruments
     tInstrumentsIterator iter, iterEnd;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter)
-        iter->pInstrument->onClassifierTestStarted(input_set);
+    {
+        if (iter->events & Instrument::EVENT_CLASSIFIER_TEST_STARTED)
+            iter->pInstrument->onClassifierTestStarted(input_set);
+    }
+
+    updateEvents();
 
     if (pSet)
         pSet->setReadOnly(false);
@@ -383,7 +432,7 @@ bool TrustedInstrumentsSet::onClassifierTestDone(IClassifierInputSet* input_set,
     assert(input_set);
     assert(_pManager);
 
-    if (_instruments.empty())
+    if ((_events & Instrument::EVENT_CLASSIFIER_TEST_DONE) == 0)
         return true;
  
     if (getLastError() != ERROR_NONE)
@@ -399,7 +448,12 @@ bool TrustedInstrumentsSet::onClassifierTestDone(IClassifierInputSet* input_set,
     // Forward the event to all the instruments
     tInstrumentsIterator iter, iterEnd;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter)
-        iter->pInstrument->onClassifierTestDone(input_set, test_error);
+    {
+        if (iter->events & Instrument::EVENT_CLASSIFIER_TEST_DONE)
+            iter->pInstrument->onClassifierTestDone(input_set, test_error);
+    }
+
+    updateEvents();
 
     if (pSet)
         pSet->setReadOnly(false);
@@ -419,7 +473,7 @@ bool TrustedInstrumentsSet::onClassifierClassificationDone(IClassifierInputSet*
     assert(input_set);
     assert(_pManager);
 
-    if (_instruments.empty())
+    if ((_events & Instrument::EVENT_CLASSIFIER_CLASSIFICATION_DONE) == 0)
         return true;
  
     if (getLastError() != ERROR_NONE)
@@ -438,10 +492,15 @@ bool TrustedInstrumentsSet::onClassifierClassificationDone(IClassifierInputSet*
     tInstrumentsIterator iter, iterEnd;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter)
     {
-        iter->pInstrument->onClassifierClassificationDone(input_set, image, original_image,
-                                                          position, results, error);
+        if (iter->events & Instrument::EVENT_CLASSIFIER_CLASSIFICATION_DONE)
+        {
+            iter->pInstrument->onClassifierClassificationDone(input_set, image, original_image,
+                                                              position, results, error);
+        }
     }
 
+    updateEvents();
+
     if (pSet)
         pSet->setReadOnly(false);
 
@@ -465,7 +524,7 @@ bool TrustedInstrumentsSet::onFeaturesComputedByClassifier(bool detection,
     assert(values);
     assert(_pManager);
 
-    if (_instruments.empty())
+    if ((_events & Instrument::EVENT_FEATURES_COMPUTED_BY_CLASSIFIER) == 0)
         return true;
  
     if (getLastError() != ERROR_NONE)
@@ -481,12 +540,17 @@ bool TrustedInstrumentsSet::onFeaturesComputedByClassifier(bool detection,
     tInstrumentsIterator iter, iterEnd;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter)
     {
-        iter->pInstrument->onFeaturesComputedByClassifier(detection, training,
-                                                          image, original_image,
-                                                          coords, roiExtent, heuristic,
-                                                          nbFeatures, indexes, values);
+        if (iter->events & Instrument::EVENT_FEATURES_COMPUTED_BY_CLASSIFIER)
+        {
+            iter->pInstrument->onFeaturesComputedByClassifier(detection, training,
+                                                              image, original_image,
+                                                              coords, roiExtent, heuristic,
+                                                              nbFeatures, indexes, values);
+        }
     }
 
+    updateEvents();
+
     return true;
 }
 
@@ -499,7 +563,7 @@ bool TrustedInstrumentsSet::onExperimentStarted(ITask* task)
     assert(task);
     assert(_pManager);
 
-    if (_instruments.empty())
+    if ((_events & Instrument::EVENT_GOALPLANNING_EXPERIMENT_STARTED) == 0)
         return true;
 
     if (getLastError() != ERROR_NONE)
@@ -515,7 +579,12 @@ bool TrustedInstrumentsSet::onExperimentStarted(ITask* task)
     // Forward the event to all the instruments
     tInstrumentsIterator iter, iterEnd;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter)
-        iter->pInstrument->onExperimentStarted(task);
+    {
+        if (iter->events & Instrument::EVENT_GOALPLANNING_EXPERIMENT_STARTED)
+            iter->pInstrument->onExperimentStarted(task);
+    }
+
+    updateEvents();
 
     if (pTask)
         pTask->setReadOnly(false);
@@ -530,7 +599,7 @@ bool TrustedInstrumentsSet::onPlannerLearningStarted(ITask* task)
     assert(task);
     assert(_pManager);
 
-    if (_instruments.empty())
+    if ((_events & Instrument::EVENT_PLANNER_LEARNING_STARTED) == 0)
         return true;
 
     if (getLastError() != ERROR_NONE)
@@ -546,7 +615,12 @@ bool TrustedInstrumentsSet::onPlannerLearningStarted(ITask* task)
     // Forward the event to all the instruments
     tInstrumentsIterator iter, iterEnd;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter)
-        iter->pInstrument->onPlannerLearningStarted(task);
+    {
+        if (iter->events & Instrument::EVENT_PLANNER_LEARNING_STARTED)
+            iter->pInstrument->onPlannerLearningStarted(task);
+    }
+
+    updateEvents();
 
     if (pTask)
         pTask->setReadOnly(false);
@@ -561,7 +635,7 @@ bool TrustedInstrumentsSet::onPlannerLearningDone(ITask* task, tResult result)
     assert(task);
     assert(_pManager);
 
-    if (_instruments.empty())
+    if ((_events & Instrument::EVENT_PLANNER_LEARNING_DONE) == 0)
         return true;
 
     if (getLastError() != ERROR_NONE)
@@ -577,7 +651,12 @@ bool TrustedInstrumentsSet::onPlannerLearningDone(ITask* task, tResult result)
     // Forward the event to all the instruments
     tInstrumentsIterator iter, iterEnd;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter)
-        iter->pInstrument->onPlannerLearningDone(task, result);
+    {
+        if (iter->events & Instrument::EVENT_PLANNER_LEARNING_DONE)
+            iter->pInstrument->onPlannerLearningDone(task, result);
+    }
+
+    updateEvents();
 
     if (pTask)
         pTask->setReadOnly(false);
@@ -592,7 +671,7 @@ bool TrustedInstrumentsSet::onPlannerTestStarted(ITask* task)
     assert(task);
     assert(_pManager);
 
-    if (_instruments.empty())
+    if ((_events & Instrument::EVENT_PLANNER_TEST_STARTED) == 0)
         return true;
 
     if (getLastError() != ERROR_NONE)
@@ -608,7 +687,12 @@ bool TrustedInstrumentsSet::onPlannerTestStarted(ITask* task)
     // Forward the event to all the instruments
     tInstrumentsIterator iter, iterEnd;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter)
-        iter->pInstrument->onPlannerTestStarted(task);
+    {
+        if (iter->events & Instrument::EVENT_PLANNER_TEST_STARTED)
+            iter->pInstrument->onPlannerTestStarted(task);
+    }
+
+    updateEvents();
 
     if (pTask)
         pTask->setReadOnly(false);
@@ -623,7 +707,7 @@ bool TrustedInstrumentsSet::onPlannerTestDone(ITask* task, scalar_t score, tResu
     assert(task);
     assert(_pManager);
 
-    if (_instruments.empty())
+    if ((_events & Instrument::EVENT_PLANNER_TEST_DONE) == 0)
         return true;
 
     if (getLastError() != ERROR_NONE)
@@ -639,7 +723,12 @@ bool TrustedInstrumentsSet::onPlannerTestDone(ITask* task, scalar_t score, tResu
     // Forward the event to all the instruments
     tInstrumentsIterator iter, iterEnd;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter)
-        iter->pInstrument->onPlannerTestDone(task, score, result);
+    {
+        if (iter->events & Instrument::EVENT_PLANNER_TEST_DONE)
+            iter->pInstrument->onPlannerTestDone(task, score, result);
+    }
+
+    updateEvents();
 
     if (pTask)
         pTask->setReadOnly(false);
@@ -655,7 +744,7 @@ bool TrustedInstrumentsSet::onPlannerActionChoosen(ITask* task, unsigned int act
     assert(task);
     assert(_pManager);
 
-    if (_instruments.empty())
+    if ((_events & Instrument::EVENT_PLANNER_ACTION_CHOOSEN) == 0)
         return true;
 
     if (getLastError() != ERROR_NONE)
@@ -672,7 +761,12 @@ bool TrustedInstrumentsSet::onPlannerActionChoosen(ITask* task, unsigned int act
     // Forward the event to all the instruments
     tInstrumentsIterator iter, iterEnd;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter)
-        iter->pInstrument->onPlannerActionChoosen(task, action, reward, result);
+    {
+        if (iter->events & Instrument::EVENT_PLANNER_ACTION_CHOOSEN)
+            iter->pInstrument->onPlannerActionChoosen(task, action, reward, result);
+    }
+
+    updateEvents();
 
     if (pTask)
         pTask->setReadOnly(false);
@@ -696,7 +790,7 @@ bool TrustedInstrumentsSet::onFeaturesComputedByPlanner(unsigned int sequence,
     assert(values);
     assert(_pManager);
 
-    if (_instruments.empty())
+    if ((_events & Instrument::EVENT_FEATURES_COMPUTED_BY_PLANNER) == 0)
         return true;
 
     if (getLastError() != ERROR_NONE)
@@ -710,11 +804,16 @@ bool TrustedInstrumentsSet::onFeaturesComputedByPlanner(unsigned int sequence,
     tInstrumentsIterator iter, iterEnd;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter)
     {
-        iter->pInstrument->onFeaturesComputedByPlanner(sequence, view, image,
-                                                       coords, roiExtent, heuristic,
-                                                       nbFeatures, indexes, values);
+        if (iter->events & Instrument::EVENT_FEATURES_COMPUTED_BY_PLANNER)
+        {
+            iter->pInstrument->onFeaturesComputedByPlanner(sequence, view, image,
+                                                           coords, roiExtent, heuristic,
+                                                           nbFeatures, indexes, values);
+        }
     }
 
+    updateEvents();
+
     return true;
 }
 
@@ -726,7 +825,7 @@ bool TrustedInstrumentsSet::onFeatureListReported(const tFeatureList& features)
     // Assertions
     assert(_pManager);
 
-    if (_instruments.empty())
+    if ((_events & Instrument::EVENT_FEATURE_LIST_REPORTED) == 0)
         return true;
 
     if (getLastError() != ERROR_NONE)
@@ -737,7 +836,12 @@ bool TrustedInstrumentsSet::onFeatureListReported(const tFeatureList& features)
     // Forward the event to all the instruments
     tInstrumentsIterator iter, iterEnd;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter)
-        iter->pInstrument->onFeatureListReported(features);
+    {
+        if (iter->events & Instrument::EVENT_FEATURE_LIST_REPORTED)
+            iter->pInstrument->onFeatureListReported(features);
+    }
+
+    updateEvents();
 
     return true;
 }
@@ -745,6 +849,21 @@ bool TrustedInstrumentsSet::onFeatureListReported(const tFeatureList& features)
 
 /*********************************** METHODS **********************************/
 
+void TrustedInstrumentsSet::updateEvents()
+{
+    // The instruments report the events they don't handle the first time they
+    // receive them
+    _events = 0;
+
+    tInstrumentsIterator iter, iterEnd;
+    for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter)
+    {
+        iter->events = InstrumentsManager::getSubscribedEvents(iter->pInstrument);
+        _events |= iter->events;
+    }
+}
+
+
 tError TrustedInstrumentsSet::getLastError()
 {
     return (((_lastError != ERROR_NONE) || !_pManager) ? _lastError : _pManager->getLastError());
@@ -132,6 +132,20 @@ namespace Mash
         //----------------------------------------------------------------------
         virtual std::string instrumentName(int index) const;
 
+        //----------------------------------------------------------------------
+        /// @brief  Returns the events consumed by an instrument
+        ///
+        /// @param  index   Index of the instrument
+        /// @return         A combination of Instrument::tEvent values
+        //----------------------------------------------------------------------
+        virtual unsigned int instrumentEvents(int index) const;
+
+        //----------------------------------------------------------------------
+        /// @brief  Returns the events consumed by at least one of the
+        ///         instruments (the other ones are ignored by the set)
+        //----------------------------------------------------------------------
+        virtual unsigned int subscribedEvents() const;
+
 
         //_____ General events __________
     public:
@@ -363,6 +377,13 @@ namespace Mash
         //----------------------------------------------------------------------
         virtual tError getLastError();
 
+    protected:
+        //----------------------------------------------------------------------
+        /// @brief  Updates the events consumed by the instruments, once they
+        ///         received an event (see Instrument::unhandled)
+        //----------------------------------------------------------------------
+        void updateEvents();
+
 
         //_____ Internal types __________
     protected:
@@ -371,6 +392,7 @@ namespace Mash
             Mash::Instrument*           pInstrument;
             std::string                 strName;
             tExperimentParametersList   parameters;
+            unsigned int                events;     ///< Events consumed by the instrument
         };
 
         typedef std::vector<tInstrumentInfos>       tInstrumentsList;
@@ -385,6 +407,7 @@ namespace Mash
         OutStream           _outStream;         ///< Output stream to use for logging
         tError              _lastError;         ///< Last error that occured
         std::string         _strReportFolder;
+        unsigned int        _events;            ///< Events consumed by at least one instrument
     };
 }
 
@@ -37,6 +37,7 @@
 #include <netinet/in.h>
 #include <netdb.h>
 #include <arpa/inet.h>
+#include <poll.h>
 #include <memory.h>
 #include <assert.h>
 
@@ -122,6 +123,7 @@ bool Client::connect(const std::string& strAddress, unsigned int port)
     freeaddrinfo(servinfo);
     
     _buffer.reset();
+    _queuedCommands.clear();
     
     return true;
 }
@@ -129,6 +131,13 @@ bool Client::connect(const std::string& strAddress, unsigned int port)
 
 bool Client::sendCommand(const std::string& strCommand,
                          const ArgumentsList& arguments)
+{
+    return queueCommand(strCommand, arguments) && flushCommands();
+}
+
+
+bool Client::queueCommand(const std::string& strCommand,
+                          const ArgumentsList& arguments)
 {
     _outStream << "> " << strCommand;
 
@@ -137,12 +146,35 @@ bool Client::sendCommand(const std::string& strCommand,
 
     _outStream << endl;
 
-    return NetworkUtils::sendMessage(_socket, strCommand, arguments);
+    NetworkUtils::encodeMessage(&_queuedCommands, strCommand, arguments);
+
+    // Don't let the queue grow without limit
+    if (_queuedCommands.size() >= NetworkUtils::RECEIVE_CHUNK_SIZE)
+        return flushCommands();
+
+    return true;
+}
+
+
+bool Client::flushCommands()
+{
+    if (_queuedCommands.empty())
+        return true;
+
+    bool bResult = NetworkUtils::sendData(_socket, (const unsigned char*) _queuedCommands.data(),
+                                          _queuedCommands.size());
+
+    _queuedCommands.clear();
+
+    return bResult;
 }
 
 
 bool Client::sendData(const unsigned char* data, int size)
 {
+    if (!flushCommands())
+        return false;
+
     _outStream << "> <" << size << " bytes of data>" << endl;
 
     return NetworkUtils::sendData(_socket, data, size);
@@ -151,6 +183,9 @@ bool Client::sendData(const unsigned char* data, int size)
 
 bool Client::waitResponse(std::string* strResponse, ArgumentsList* arguments)
 {
+    if (!flushCommands())
+        return false;
+
     bool bResult = NetworkUtils::waitMessage(_socket, &_buffer, strResponse, arguments);
 
     if (bResult)
@@ -169,6 +204,9 @@ bool Client::waitResponse(std::string* strResponse, ArgumentsList* arguments)
 
 bool Client::waitData(unsigned char* data, int size)
 {
+    if (!flushCommands())
+        return false;
+
     bool bResult = NetworkUtils::waitData(_socket, &_buffer, data, size);
 
     if (bResult)
@@ -178,8 +216,34 @@ bool Client::waitData(unsigned char* data, int size)
 }
 
 
+bool Client::isAlive()
+{
+    if ((_socket == -1) || !_queuedCommands.empty() || (_buffer.size() > 0))
+        return false;
+
+    struct pollfd pfd;
+    pfd.fd = _socket;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    return (poll(&pfd, 1, 0) == 0);
+}
+
+
+void Client::setOutStream(OutStream* pOutStream)
+{
+    if (pOutStream)
+        _outStream = *pOutStream;
+    else
+        _outStream.close();
+}
+
+
 void Client::close()
 {
+    _queuedCommands.clear();
+    _strTag = "";
+
     ::close(_socket);
     _socket = -1;
 }
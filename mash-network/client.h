@@ -84,6 +84,32 @@ namespace Mash
         bool sendCommand(const std::string& strCommand,
                          const ArgumentsList& arguments);
 
+        //----------------------------------------------------------------------
+        /// @brief  Queue a command, to be sent with the next ones
+        ///
+        /// Used to pipeline independent requests: the queued commands are sent
+        /// together (in one system call) when flushCommands() is called, or
+        /// automatically before waiting for a response. The server processes
+        /// the commands in order, so the responses are received in the same
+        /// order than the commands (FIFO).
+        ///
+        /// The responses must be read before their amount exceeds the buffers
+        /// of the sockets, or both ends block: pipeline a bounded number of
+        /// requests at once.
+        /// @param  strCommand  The command
+        /// @param  arguments   The arguments of the command
+        /// @return             'false' if failed
+        //----------------------------------------------------------------------
+        bool queueCommand(const std::string& strCommand,
+                          const ArgumentsList& arguments);
+
+        //----------------------------------------------------------------------
+        /// @brief  Send all the queued commands to the server
+        ///
+        /// @return 'false' if failed
+        //----------------------------------------------------------------------
+        bool flushCommands();
+
         //----------------------------------------------------------------------
         /// @brief  Send some binary data to the server
         ///
@@ -116,6 +142,44 @@ namespace Mash
         //----------------------------------------------------------------------
         bool waitData(unsigned char* data, int size);
 
+        //----------------------------------------------------------------------
+        /// @brief  Indicates if the connection is still usable, without
+        ///         communicating with the server
+        ///
+        /// The connection must be established, without any pending command,
+        /// and nothing must be available to read from it (which would be
+        /// either an unexpected response or the connection being closed by the
+        /// server).
+        //----------------------------------------------------------------------
+        bool isAlive();
+
+        //----------------------------------------------------------------------
+        /// @brief  Changes the output stream used by the client
+        /// @param  pOutStream  The output stream to use (if 0, nothing is
+        ///                     reported)
+        //----------------------------------------------------------------------
+        void setOutStream(OutStream* pOutStream);
+
+        //----------------------------------------------------------------------
+        /// @brief  Sets the tag describing the state in which the user of the
+        ///         connection left the server (see ClientPool)
+        ///
+        /// The tag is cleared when the connection is closed.
+        //----------------------------------------------------------------------
+        inline void setTag(const std::string& strTag)
+        {
+            _strTag = strTag;
+        }
+
+        //----------------------------------------------------------------------
+        /// @brief  Returns the tag describing the state in which the user of
+        ///         the connection left the server
+        //----------------------------------------------------------------------
+        inline const std::string& tag() const
+        {
+            return _strTag;
+        }
+
         //----------------------------------------------------------------------
         /// @brief  Close the connection to the server
         //----------------------------------------------------------------------
@@ -126,7 +190,9 @@ namespace Mash
     private:
         int             _socket;
         NetworkBuffer   _buffer;
+        std::string     _queuedCommands;
         OutStream       _outStream;
+        std::string     _strTag;
     };
 }
 
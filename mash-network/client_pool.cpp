@@ -0,0 +1,261 @@
+/*******************************************************************************
+* The MASH Framework contains the source code of all the servers in the
+* "computation farm" of the MASH project (http://www.mash-project.eu),
+* developed at the Idiap Research Institute (http://www.idiap.ch).
+*
+* Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+* Written by Philip Abbet (philip.abbet@idiap.ch)
+*
+* This file is part of the MASH Framework.
+*
+* The MASH Framework is free software: you can redistribute it and/or modify
+* it under the terms of either the GNU General Public License version 2 or
+* the GNU General Public License version 3 as published by the Free
+* Software Foundation, whichever suits the most your needs.
+*
+* The MASH Framework is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public Licenses
+* along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+/** @file   client_pool.cpp
+    @author Philip Abbet (philip.abbet@idiap.ch)
+
+    Implementation of the 'ClientPool' class
+*/
+
+#include "client_pool.h"
+#include <assert.h>
+
+using namespace std;
+using namespace Mash;
+
+
+/************************* CONSTRUCTION / DESTRUCTION *************************/
+
+ClientPool::ClientPool(unsigned int maxIdleClients, unsigned int maxIdleTime,
+                       const std::string& strHealthCheckCommand,
+                       const std::string& strHealthyResponse)
+: _maxIdleClients(maxIdleClients), _maxIdleTime(maxIdleTime),
+  _strHealthCheckCommand(strHealthCheckCommand),
+  _strHealthyResponse(strHealthyResponse)
+{
+    pthread_mutex_init(&_mutex, 0);
+}
+
+
+ClientPool::~ClientPool()
+{
+    clear();
+
+    pthread_mutex_destroy(&_mutex);
+}
+
+
+/*********************************** METHODS **********************************/
+
+Client* ClientPool::acquire(const std::string& strAddress, unsigned int port,
+                            const std::string& strTag, OutStream* pOutStream,
+                            bool* bReused)
+{
+    // Assertions
+    assert(!strAddress.empty());
+
+    // Declarations
+    tKey key;
+    Client* pClient = 0;
+
+    key.strAddress  = strAddress;
+    key.port        = port;
+    key.strTag      = strTag;
+
+    if (bReused)
+        *bReused = false;
+
+    // Look for an idle connection in the same state, discarding the ones that
+    // can't be used anymore
+    while (true)
+    {
+        pthread_mutex_lock(&_mutex);
+
+        removeExpiredClients(time(0));
+
+        tIdleClientsIterator iter, iterEnd;
+        for (iter = _idleClients.begin(), iterEnd = _idleClients.end(); iter != iterEnd; ++iter)
+        {
+            if (iter->key == key)
+            {
+                pClient = iter->pClient;
+                _idleClients.erase(iter);
+                break;
+            }
+        }
+
+        pthread_mutex_unlock(&_mutex);
+
+        if (!pClient)
+            break;
+
+        pClient->setOutStream(pOutStream);
+
+        if (isHealthy(pClient))
+        {
+            pClient->setTag(strTag);
+
+            if (bReused)
+                *bReused = true;
+
+            break;
+        }
+
+        delete pClient;
+        pClient = 0;
+    }
+
+    // Establish a new connection if necessary
+    if (!pClient)
+    {
+        pClient = new Client(pOutStream);
+
+        if (!pClient->connect(strAddress, port))
+        {
+            delete pClient;
+            return 0;
+        }
+    }
+
+    pthread_mutex_lock(&_mutex);
+    _usedClients[pClient] = key;
+    pthread_mutex_unlock(&_mutex);
+
+    return pClient;
+}
+
+
+void ClientPool::release(Client* pClient, const std::string& strTag)
+{
+    // Assertions
+    assert(pClient);
+
+    // Declarations
+    Client* pOldestClient = 0;
+
+    // Don't keep the output stream of the user
+    pClient->setOutStream(0);
+
+    pthread_mutex_lock(&_mutex);
+
+    tClientsKeysIterator iter = _usedClients.find(pClient);
+    assert(iter != _usedClients.end());
+
+    pClient->setTag(strTag);
+
+    tIdleClient idleClient;
+    idleClient.pClient      = pClient;
+    idleClient.key          = iter->second;
+    idleClient.key.strTag   = strTag;
+    idleClient.releaseTime  = time(0);
+
+    _usedClients.erase(iter);
+
+    if (pClient->isAlive() && (_maxIdleClients > 0))
+    {
+        _idleClients.push_front(idleClient);
+
+        if (_idleClients.size() > _maxIdleClients)
+        {
+            pOldestClient = _idleClients.back().pClient;
+            _idleClients.pop_back();
+        }
+    }
+    else
+    {
+        pOldestClient = pClient;
+    }
+
+    pthread_mutex_unlock(&_mutex);
+
+    delete pOldestClient;
+}
+
+
+void ClientPool::discard(Client* pClient)
+{
+    // Assertions
+    assert(pClient);
+
+    pthread_mutex_lock(&_mutex);
+    _usedClients.erase(pClient);
+    pthread_mutex_unlock(&_mutex);
+
+    delete pClient;
+}
+
+
+void ClientPool::clear()
+{
+    pthread_mutex_lock(&_mutex);
+
+    tIdleClientsList idleClients;
+    idleClients.swap(_idleClients);
+
+    pthread_mutex_unlock(&_mutex);
+
+    tIdleClientsIterator iter, iterEnd;
+    for (iter = idleClients.begin(), iterEnd = idleClients.end(); iter != iterEnd; ++iter)
+        delete iter->pClient;
+}
+
+
+unsigned int ClientPool::nbIdleClients()
+{
+    pthread_mutex_lock(&_mutex);
+    unsigned int nb = _idleClients.size();
+    pthread_mutex_unlock(&_mutex);
+
+    return nb;
+}
+
+
+bool ClientPool::isHealthy(Client* pClient)
+{
+    // Assertions
+    assert(pClient);
+
+    // Declarations
+    string strResponse;
+    ArgumentsList args;
+
+    // Check that the connection wasn't closed by the server
+    if (!pClient->isAlive())
+        return false;
+
+    // Check that the server is still responding
+    if (_strHealthCheckCommand.empty())
+        return true;
+
+    if (!pClient->sendCommand(_strHealthCheckCommand, ArgumentsList()) ||
+        !pClient->waitResponse(&strResponse, &args))
+    {
+        return false;
+    }
+
+    return (strResponse == _strHealthyResponse);
+}
+
+
+void ClientPool::removeExpiredClients(time_t now)
+{
+    while (!_idleClients.empty() &&
+           (now - _idleClients.back().releaseTime >= (time_t) _maxIdleTime))
+    {
+        delete _idleClients.back().pClient;
+        _idleClients.pop_back();
+    }
+}
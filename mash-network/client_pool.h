@@ -0,0 +1,202 @@
+/*******************************************************************************
+* The MASH Framework contains the source code of all the servers in the
+* "computation farm" of the MASH project (http://www.mash-project.eu),
+* developed at the Idiap Research Institute (http://www.idiap.ch).
+*
+* Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+* Written by Philip Abbet (philip.abbet@idiap.ch)
+*
+* This file is part of the MASH Framework.
+*
+* The MASH Framework is free software: you can redistribute it and/or modify
+* it under the terms of either the GNU General Public License version 2 or
+* the GNU General Public License version 3 as published by the Free
+* Software Foundation, whichever suits the most your needs.
+*
+* The MASH Framework is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public Licenses
+* along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+/** @file   client_pool.h
+    @author Philip Abbet (philip.abbet@idiap.ch)
+
+    Declaration of the 'ClientPool' class
+*/
+
+#ifndef _MASH_CLIENTPOOL_H_
+#define _MASH_CLIENTPOOL_H_
+
+#include "client.h"
+#include <pthread.h>
+#include <time.h>
+#include <string>
+#include <list>
+#include <map>
+
+
+namespace Mash
+{
+    //--------------------------------------------------------------------------
+    /// @brief  Keeps the connections to some servers alive, so they can be
+    ///         reused instead of going through the whole connection (and
+    ///         handshake) again
+    ///
+    /// The connections are identified by the address and port of the server,
+    /// and by a 'tag' chosen by the user, describing the state in which the
+    /// connection was left when it was released (for instance, the database
+    /// selected on an application server). A connection is only returned by
+    /// acquire() when all of them match, and keeps its tag (see Client::tag()),
+    /// so the user can skip the requests that would put the server in the
+    /// same state again.
+    ///
+    /// Before being reused, a connection is checked: it must not have been
+    /// closed by the server (nor contain unexpected data), and the server must
+    /// give the expected response to a health check command ('STATUS' ->
+    /// 'READY' by default, as understood by all the servers of the framework).
+    ///
+    /// The idle connections are closed when they weren't used for some time,
+    /// or when there are too many of them (the oldest ones first).
+    ///
+    /// Thread-safe.
+    //--------------------------------------------------------------------------
+    class MASH_SYMBOL ClientPool
+    {
+        //_____ Internal types __________
+    private:
+        struct tKey
+        {
+            std::string     strAddress;
+            unsigned int    port;
+            std::string     strTag;
+
+            bool operator==(const tKey& key) const
+            {
+                return (port == key.port) && (strAddress == key.strAddress) &&
+                       (strTag == key.strTag);
+            }
+        };
+
+        struct tIdleClient
+        {
+            Client*         pClient;
+            tKey            key;
+            time_t          releaseTime;
+        };
+
+        typedef std::list<tIdleClient>      tIdleClientsList;
+        typedef tIdleClientsList::iterator  tIdleClientsIterator;
+
+        typedef std::map<Client*, tKey>     tClientsKeysList;
+        typedef tClientsKeysList::iterator  tClientsKeysIterator;
+
+
+        //_____ Construction / Destruction __________
+    public:
+        //----------------------------------------------------------------------
+        /// @brief  Constructor
+        ///
+        /// @param  maxIdleClients          Maximum number of idle connections
+        ///                                 kept alive
+        /// @param  maxIdleTime             Number of seconds after which an
+        ///                                 idle connection is closed
+        /// @param  strHealthCheckCommand   Command sent to the server before
+        ///                                 reusing a connection
+        /// @param  strHealthyResponse      Expected response to the health
+        ///                                 check command
+        //----------------------------------------------------------------------
+        ClientPool(unsigned int maxIdleClients = 4, unsigned int maxIdleTime = 300,
+                   const std::string& strHealthCheckCommand = "STATUS",
+                   const std::string& strHealthyResponse = "READY");
+
+        //----------------------------------------------------------------------
+        /// @brief  Destructor
+        ///
+        /// Closes the idle connections. The ones still in use are left alone.
+        //----------------------------------------------------------------------
+        ~ClientPool();
+
+
+        //_____ Methods __________
+    public:
+        //----------------------------------------------------------------------
+        /// @brief  Returns a connection to a server, reusing an idle one if
+        ///         possible
+        ///
+        /// @param      strAddress  The address of the server
+        /// @param      port        The port of the server
+        /// @param      strTag      The state in which the connection must be
+        ///                         (see release())
+        /// @param      pOutStream  The output stream the client must use (if 0,
+        ///                         nothing is reported)
+        /// @param[out] bReused     (Optional) Indicates if an existing
+        ///                         connection was reused
+        /// @return                 The client, 0 if the connection failed. Its
+        ///                         tag is 'strTag' if it was reused, empty
+        ///                         otherwise
+        //----------------------------------------------------------------------
+        Client* acquire(const std::string& strAddress, unsigned int port,
+                        const std::string& strTag = "", OutStream* pOutStream = 0,
+                        bool* bReused = 0);
+
+        //----------------------------------------------------------------------
+        /// @brief  Gives a connection back to the pool
+        ///
+        /// @param  pClient     The client, returned by acquire()
+        /// @param  strTag      The state in which the connection is left
+        ///
+        /// @remark All the responses of the server must have been read
+        //----------------------------------------------------------------------
+        void release(Client* pClient, const std::string& strTag = "");
+
+        //----------------------------------------------------------------------
+        /// @brief  Closes a connection that can't be reused (for instance,
+        ///         after a communication error)
+        ///
+        /// @param  pClient     The client, returned by acquire()
+        //----------------------------------------------------------------------
+        void discard(Client* pClient);
+
+        //----------------------------------------------------------------------
+        /// @brief  Closes all the idle connections
+        //----------------------------------------------------------------------
+        void clear();
+
+        //----------------------------------------------------------------------
+        /// @brief  Returns the number of idle connections
+        //----------------------------------------------------------------------
+        unsigned int nbIdleClients();
+
+    private:
+        //----------------------------------------------------------------------
+        /// @brief  Check that an idle connection can be reused
+        //----------------------------------------------------------------------
+        bool isHealthy(Client* pClient);
+
+        //----------------------------------------------------------------------
+        /// @brief  Closes the idle connections that weren't used for too long
+        ///
+        /// @remark The mutex must be locked
+        //----------------------------------------------------------------------
+        void removeExpiredClients(time_t now);
+
+
+        //_____ Attributes __________
+    private:
+        unsigned int        _maxIdleClients;
+        unsigned int        _maxIdleTime;
+        std::string         _strHealthCheckCommand;
+        std::string         _strHealthyResponse;
+        tIdleClientsList    _idleClients;       ///< Most recently released first
+        tClientsKeysList    _usedClients;
+        pthread_mutex_t     _mutex;
+    };
+}
+
+#endif
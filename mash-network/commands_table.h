@@ -0,0 +1,197 @@
+/*******************************************************************************
+* The MASH Framework contains the source code of all the servers in the
+* "computation farm" of the MASH project (http://www.mash-project.eu),
+* developed at the Idiap Research Institute (http://www.idiap.ch).
+*
+* Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+* Written by Philip Abbet (philip.abbet@idiap.ch)
+*
+* This file is part of the MASH Framework.
+*
+* The MASH Framework is free software: you can redistribute it and/or modify
+* it under the terms of either the GNU General Public License version 2 or
+* the GNU General Public License version 3 as published by the Free
+* Software Foundation, whichever suits the most your needs.
+*
+* The MASH Framework is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public Licenses
+* along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+/** @file   commands_table.h
+    @author Philip Abbet (philip.abbet@idiap.ch)
+
+    Declaration of the 'CommandsTable' class
+*/
+
+#ifndef _MASH_COMMANDSTABLE_H_
+#define _MASH_COMMANDSTABLE_H_
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+
+namespace Mash
+{
+    //--------------------------------------------------------------------------
+    /// @brief  Associates the commands of a protocol to their handlers
+    ///
+    /// Replaces a std::map for the dispatch of the commands received by a
+    /// listener. The set of commands is known in advance, so the table looks
+    /// for a hash function (by changing its seed and its size) that gives a
+    /// different slot to each command: a lookup then costs one hash and one
+    /// string comparison.
+    ///
+    /// The table is rebuilt each time a command is added, it is meant to be
+    /// filled once at initialisation.
+    //--------------------------------------------------------------------------
+    template<typename HANDLER>
+    class CommandsTable
+    {
+        //_____ Internal types __________
+    private:
+        struct tEntry
+        {
+            std::string strCommand;
+            HANDLER     handler;
+        };
+
+        typedef std::vector<tEntry> tEntriesList;
+        typedef std::vector<int>    tSlotsList;
+
+
+        //_____ Construction / Destruction __________
+    public:
+        CommandsTable()
+        : _seed(0), _mask(0)
+        {
+        }
+
+
+        //_____ Methods __________
+    public:
+        //----------------------------------------------------------------------
+        /// @brief  Returns the handler of a command, adding the command to the
+        ///         table if necessary
+        //----------------------------------------------------------------------
+        HANDLER& operator[](const std::string& strCommand)
+        {
+            tEntry* pEntry = lookup(strCommand);
+            if (pEntry)
+                return pEntry->handler;
+
+            tEntry entry;
+            entry.strCommand = strCommand;
+            entry.handler = HANDLER();
+
+            _entries.push_back(entry);
+            rebuild();
+
+            return lookup(strCommand)->handler;
+        }
+
+        //----------------------------------------------------------------------
+        /// @brief  Returns the handler of a command, 0 if the command is
+        ///         unknown
+        //----------------------------------------------------------------------
+        inline const HANDLER* find(const std::string& strCommand) const
+        {
+            const tEntry* pEntry = const_cast<CommandsTable*>(this)->lookup(strCommand);
+            return (pEntry ? &pEntry->handler : 0);
+        }
+
+        inline unsigned int size() const
+        {
+            return _entries.size();
+        }
+
+        inline bool empty() const
+        {
+            return _entries.empty();
+        }
+
+
+        //_____ Internal methods __________
+    private:
+        static inline uint32_t hash(const std::string& strCommand, uint32_t seed)
+        {
+            // FNV-1a
+            uint32_t h = 2166136261u ^ seed;
+            for (size_t i = 0; i < strCommand.size(); ++i)
+            {
+                h ^= (unsigned char) strCommand[i];
+                h *= 16777619u;
+            }
+
+            return h ^ (h >> 15);
+        }
+
+        inline tEntry* lookup(const std::string& strCommand)
+        {
+            if (_slots.empty())
+                return 0;
+
+            int index = _slots[hash(strCommand, _seed) & _mask];
+            if ((index >= 0) && (_entries[index].strCommand == strCommand))
+                return &_entries[index];
+
+            return 0;
+        }
+
+        void rebuild()
+        {
+            // Start with a table twice as large as the number of commands,
+            // and grow it until a seed without collision is found
+            uint32_t size = 1;
+            while (size < 2 * _entries.size())
+                size <<= 1;
+
+            while (true)
+            {
+                for (uint32_t seed = 0; seed < 64; ++seed)
+                {
+                    if (fill(size, seed))
+                        return;
+                }
+
+                size <<= 1;
+            }
+        }
+
+        bool fill(uint32_t size, uint32_t seed)
+        {
+            _slots.assign(size, -1);
+            _seed = seed;
+            _mask = size - 1;
+
+            for (unsigned int i = 0; i < _entries.size(); ++i)
+            {
+                int& slot = _slots[hash(_entries[i].strCommand, seed) & _mask];
+                if (slot >= 0)
+                    return false;
+
+                slot = i;
+            }
+
+            return true;
+        }
+
+
+        //_____ Attributes __________
+    private:
+        tEntriesList    _entries;   ///< The commands, in insertion order
+        tSlotsList      _slots;     ///< The hash table (indices of the
+                                    ///  commands, -1 for the empty slots)
+        uint32_t        _seed;
+        uint32_t        _mask;
+    };
+}
+
+#endif
@@ -0,0 +1,589 @@
+/*******************************************************************************
+* The MASH Framework contains the source code of all the servers in the
+* "computation farm" of the MASH project (http://www.mash-project.eu),
+* developed at the Idiap Research Institute (http://www.idiap.ch).
+*
+* Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+* Written by Philip Abbet (philip.abbet@idiap.ch)
+*
+* This file is part of the MASH Framework.
+*
+* The MASH Framework is free software: you can redistribute it and/or modify
+* it under the terms of either the GNU General Public License version 2 or
+* the GNU General Public License version 3 as published by the Free
+* Software Foundation, whichever suits the most your needs.
+*
+* The MASH Framework is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public Licenses
+* along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+/** @file   events_engine.cpp
+    @author Philip Abbet (philip.abbet@idiap.ch)
+
+    Implementation of the 'EventsEngine' class
+*/
+
+#include "events_engine.h"
+#include "server.h"
+#include "busy_listener.h"
+#include "networkutils.h"
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#include <assert.h>
+
+using namespace std;
+using namespace Mash;
+
+
+/********************************** CONSTANTS *********************************/
+
+const int MAX_EVENTS = 64;
+
+
+/********************************** FUNCTIONS *********************************/
+
+static bool setFlags(int fd, int statusFlags, int descriptorFlags)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+    if ((flags == -1) || (fcntl(fd, F_SETFL, flags | statusFlags) == -1))
+        return false;
+
+    flags = fcntl(fd, F_GETFD, 0);
+    return (flags != -1) && (fcntl(fd, F_SETFD, flags | descriptorFlags) != -1);
+}
+
+
+static bool armSocket(int epoll, int socket, void* ptr, bool bEnabled)
+{
+    struct epoll_event event;
+
+    memset(&event, 0, sizeof(event));
+    event.events    = EPOLLONESHOT | (bEnabled ? EPOLLIN | EPOLLRDHUP : 0);
+    event.data.ptr  = ptr;
+
+    return (epoll_ctl(epoll, EPOLL_CTL_MOD, socket, &event) == 0);
+}
+
+
+/************************* CONSTRUCTION / DESTRUCTION *************************/
+
+EventsEngine::EventsEngine(Server* pServer, unsigned int nbWorkers)
+: _pServer(pServer), _listenerConstructor(0), _epoll(-1), _clientsCounter(0),
+  _bStopping(false)
+{
+    // Assertions
+    assert(pServer);
+
+    _wakeupPipe[0] = -1;
+    _wakeupPipe[1] = -1;
+
+    _workers.resize(nbWorkers > 0 ? nbWorkers : 1);
+
+    pthread_mutex_init(&_mutex, 0);
+    pthread_cond_init(&_jobsCondition, 0);
+}
+
+
+EventsEngine::~EventsEngine()
+{
+    // Stop the worker threads
+    pthread_mutex_lock(&_mutex);
+    _bStopping = true;
+    pthread_cond_broadcast(&_jobsCondition);
+    pthread_mutex_unlock(&_mutex);
+
+    for (unsigned int i = 0; i < _workers.size(); ++i)
+    {
+        if (_workers[i] != 0)
+            pthread_join(_workers[i], 0);
+    }
+
+    // Close the remaining connections
+    tConnectionsIterator iter, iterEnd;
+    for (iter = _connections.begin(), iterEnd = _connections.end(); iter != iterEnd; ++iter)
+    {
+        delete (*iter)->pListener;
+        close((*iter)->socket);
+        delete *iter;
+    }
+
+    _connections.clear();
+
+    if (_epoll != -1)
+        close(_epoll);
+
+    if (_wakeupPipe[0] != -1)
+    {
+        close(_wakeupPipe[0]);
+        close(_wakeupPipe[1]);
+    }
+
+    pthread_cond_destroy(&_jobsCondition);
+    pthread_mutex_destroy(&_mutex);
+}
+
+
+/*********************************** METHODS **********************************/
+
+bool EventsEngine::run(int listen_socket, const std::string& host, unsigned int port,
+                       tServerListenerConstructor* listenerConstructor)
+{
+    // Assertions
+    assert(listen_socket >= 0);
+    assert(listenerConstructor);
+
+    // Declarations
+    OutStream& outStream = _pServer->_outStream;
+    struct epoll_event events[MAX_EVENTS];
+    struct epoll_event event;
+    struct sigaction sa;
+
+    _listenerConstructor = listenerConstructor;
+
+    // A client closing its connection must not kill the whole server
+    sa.sa_handler = SIG_IGN;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = 0;
+    if (sigaction(SIGPIPE, &sa, NULL) == -1)
+    {
+        outStream << "ERROR - Failed to ignore the SIGPIPE signal" << endl;
+        return false;
+    }
+
+    // Setup the file descriptors monitored by the event loop
+    _epoll = epoll_create(MAX_EVENTS);
+    if ((_epoll == -1) || !setFlags(_epoll, 0, FD_CLOEXEC))
+    {
+        outStream << "ERROR - Failed to create the epoll instance" << endl;
+        return false;
+    }
+
+    if ((pipe(_wakeupPipe) == -1) || !setFlags(_wakeupPipe[0], O_NONBLOCK, FD_CLOEXEC) ||
+        !setFlags(_wakeupPipe[1], O_NONBLOCK, FD_CLOEXEC))
+    {
+        outStream << "ERROR - Failed to create the wake-up pipe of the event loop" << endl;
+        return false;
+    }
+
+    if (!setFlags(listen_socket, O_NONBLOCK, FD_CLOEXEC))
+    {
+        outStream << "ERROR - Failed to make the socket of the server non-blocking" << endl;
+        return false;
+    }
+
+    memset(&event, 0, sizeof(event));
+    event.events    = EPOLLIN;
+    event.data.ptr  = 0;
+
+    if (epoll_ctl(_epoll, EPOLL_CTL_ADD, listen_socket, &event) == -1)
+    {
+        outStream << "ERROR - Failed to monitor the socket of the server" << endl;
+        return false;
+    }
+
+    event.data.ptr = this;
+
+    if (epoll_ctl(_epoll, EPOLL_CTL_ADD, _wakeupPipe[0], &event) == -1)
+    {
+        outStream << "ERROR - Failed to monitor the wake-up pipe of the event loop" << endl;
+        return false;
+    }
+
+    // Start the worker threads
+    for (unsigned int i = 0; i < _workers.size(); ++i)
+    {
+        if (pthread_create(&_workers[i], 0, &EventsEngine::workerThread, this) != 0)
+        {
+            _workers[i] = 0;
+            outStream << "ERROR - Failed to create the worker thread #" << i << endl;
+            return false;
+        }
+    }
+
+    outStream << "--------------------------------------------------------------------------------" << endl
+              << "Waiting..." << endl;
+
+    while (true)
+    {
+        // Delete the log file and starts a new one when the limit is reached
+        if ((_clientsCounter >= _pServer->_logLimit) && _connections.empty())
+        {
+            _pServer->resetLogFile(host, port);
+            _clientsCounter = 0;
+        }
+
+        int timeout = processTimeouts();
+
+        int nb = epoll_wait(_epoll, events, MAX_EVENTS, timeout);
+        if (nb == -1)
+        {
+            if (errno == EINTR)
+                continue;
+
+            outStream << "ERROR - Failed to wait for events: " << strerror(errno) << endl;
+            return false;
+        }
+
+        bool bConnectionsFinished = false;
+
+        for (int i = 0; i < nb; ++i)
+        {
+            if (events[i].data.ptr == 0)
+            {
+                acceptConnections(listen_socket);
+            }
+            else if (events[i].data.ptr == this)
+            {
+                bConnectionsFinished = true;
+            }
+            else
+            {
+                tConnection* pConnection = (tConnection*) events[i].data.ptr;
+
+                // The socket is armed in one-shot mode: if a worker is already
+                // using the listener, it will re-arm it when done
+                pthread_mutex_lock(&_mutex);
+
+                if (!pConnection->bBusy)
+                {
+                    pConnection->bBusy = true;
+                    pushJob(pConnection, JOB_DATA);
+                }
+
+                pthread_mutex_unlock(&_mutex);
+            }
+        }
+
+        // Done last, since some events of this batch might concern the
+        // finished connections
+        if (bConnectionsFinished)
+            processFinishedConnections(host, port);
+    }
+
+    return true;
+}
+
+
+void EventsEngine::acceptConnections(int listen_socket)
+{
+    // Declarations
+    OutStream& outStream = _pServer->_outStream;
+    struct sockaddr_storage their_addr; // connector's address information
+    socklen_t sin_size;
+    char s[INET6_ADDRSTRLEN];
+    struct epoll_event event;
+
+    // Accept all the pending connections at once (they come in bursts)
+    while (true)
+    {
+        sin_size = sizeof(their_addr);
+        int child_socket = accept(listen_socket, (struct sockaddr*) &their_addr, &sin_size);
+        if (child_socket == -1)
+        {
+            if (errno == EINTR)
+                continue;
+
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+                outStream << "ERROR - Failed to accept an incoming connection" << endl;
+
+            return;
+        }
+
+        ++_clientsCounter;
+
+        setFlags(child_socket, 0, FD_CLOEXEC);
+
+        inet_ntop(their_addr.ss_family, NetworkUtils::getNetworkAddress((struct sockaddr*) &their_addr),
+                  s, sizeof(s));
+
+        if (their_addr.ss_family == AF_INET)
+            outStream << "Incoming connection from " << s << ":" << ((struct sockaddr_in*) &their_addr)->sin_port << endl;
+        else
+            outStream << "Incoming connection from " << s << ":" << ((struct sockaddr_in6*) &their_addr)->sin6_port << endl;
+
+        // Determine if we can handle this client
+        bool bBusy = false;
+        unsigned int nb = (unsigned int) _connections.size();
+
+        if (_pServer->_state == Server::STATE_SLEEPING)
+        {
+            bBusy = true;
+            outStream << "The server is sleeping, there is currently " << nb + 1 << " clients connected" << endl;
+        }
+        else if (_pServer->_state == Server::STATE_GOING_TO_SLEEP)
+        {
+            bBusy = true;
+            outStream << "The server is going to sleep, there is still " << nb + 1 << " clients connected" << endl;
+        }
+        else if (_pServer->_nbMaxClients > 0)
+        {
+            bBusy = (nb >= _pServer->_nbMaxClients);
+
+            if (bBusy)
+                outStream << "The server is busy (" << nb << "/" << _pServer->_nbMaxClients << " client(s) connected)" << endl;
+            else
+                outStream << "The server is available (" << nb << "/" << _pServer->_nbMaxClients << " client(s) connected)" << endl;
+        }
+        else
+        {
+            outStream << "There is currently " << nb + 1 << " clients connected" << endl;
+        }
+
+        tConnection* pConnection = new tConnection();
+        pConnection->socket         = child_socket;
+        pConnection->pListener      = 0;
+        pConnection->bBusyListener  = bBusy;
+        pConnection->bBusy          = true;
+        gettimeofday(&pConnection->lastActivity, 0);
+
+        // Registered disarmed: the worker creating the listener will arm it
+        memset(&event, 0, sizeof(event));
+        event.events    = EPOLLONESHOT;
+        event.data.ptr  = pConnection;
+
+        if (epoll_ctl(_epoll, EPOLL_CTL_ADD, child_socket, &event) == -1)
+        {
+            outStream << "ERROR - Failed to monitor the incoming connection" << endl;
+            close(child_socket);
+            delete pConnection;
+            continue;
+        }
+
+        _connections.push_back(pConnection);
+
+        pthread_mutex_lock(&_mutex);
+        pushJob(pConnection, JOB_CREATE);
+        pthread_mutex_unlock(&_mutex);
+    }
+}
+
+
+void EventsEngine::processFinishedConnections(const std::string& host, unsigned int port)
+{
+    // Declarations
+    OutStream& outStream = _pServer->_outStream;
+    std::vector<tFinishedConnection> finished;
+    char buffer[64];
+
+    while (read(_wakeupPipe[0], buffer, sizeof(buffer)) > 0);
+
+    pthread_mutex_lock(&_mutex);
+    finished.swap(_finishedConnections);
+    pthread_mutex_unlock(&_mutex);
+
+    if (finished.empty())
+        return;
+
+    std::vector<tFinishedConnection>::iterator iter, iterEnd;
+    for (iter = finished.begin(), iterEnd = finished.end(); iter != iterEnd; ++iter)
+    {
+        if (iter->action == ServerListener::ACTION_SLEEP)
+        {
+            outStream << "Going to sleep..." << endl;
+            _pServer->_state = Server::STATE_GOING_TO_SLEEP;
+        }
+
+        _connections.remove(iter->pConnection);
+        delete iter->pConnection;
+    }
+
+    if (finished.size() > 1)
+        outStream << finished.size() << " client(s) are done" << endl;
+    else
+        outStream << "One client is done" << endl;
+
+    if ((_pServer->_state == Server::STATE_GOING_TO_SLEEP) && _connections.empty())
+    {
+        outStream << "Sleeping..." << endl;
+        _pServer->_state = Server::STATE_SLEEPING;
+    }
+}
+
+
+int EventsEngine::processTimeouts()
+{
+    // Declarations
+    struct timeval now;
+    int next = -1;
+
+    gettimeofday(&now, 0);
+
+    pthread_mutex_lock(&_mutex);
+
+    tConnectionsIterator iter, iterEnd;
+    for (iter = _connections.begin(), iterEnd = _connections.end(); iter != iterEnd; ++iter)
+    {
+        tConnection* pConnection = *iter;
+
+        if (pConnection->bBusy)
+            continue;
+
+        const struct timeval& timeout = pConnection->pListener->getTimeout();
+        if ((timeout.tv_sec == 0) && (timeout.tv_usec == 0))
+            continue;
+
+        int elapsed = (now.tv_sec - pConnection->lastActivity.tv_sec) * 1000 +
+                      (now.tv_usec - pConnection->lastActivity.tv_usec) / 1000;
+
+        int remaining = timeout.tv_sec * 1000 + timeout.tv_usec / 1000 - elapsed;
+
+        if (remaining <= 0)
+        {
+            armSocket(_epoll, pConnection->socket, pConnection, false);
+            pConnection->bBusy = true;
+            pushJob(pConnection, JOB_TIMEOUT);
+        }
+        else if ((next == -1) || (remaining < next))
+        {
+            next = remaining;
+        }
+    }
+
+    pthread_mutex_unlock(&_mutex);
+
+    return next;
+}
+
+
+void EventsEngine::pushJob(tConnection* pConnection, tJobType type)
+{
+    // Assertions
+    assert(pConnection);
+
+    // Note: the mutex must be locked by the caller
+    tJob job;
+    job.pConnection = pConnection;
+    job.type        = type;
+
+    _jobs.push_back(job);
+
+    pthread_cond_signal(&_jobsCondition);
+}
+
+
+void EventsEngine::processJob(const tJob& job)
+{
+    // Assertions
+    assert(job.pConnection);
+
+    // Declarations
+    tConnection* pConnection = job.pConnection;
+    ServerListener::tAction action = ServerListener::ACTION_NONE;
+    bool bConnected = true;
+
+    if (job.type == JOB_CREATE)
+    {
+        if (pConnection->bBusyListener)
+            pConnection->pListener = new BusyListener(pConnection->socket, _listenerConstructor);
+        else
+            pConnection->pListener = _listenerConstructor(pConnection->socket);
+    }
+
+    if (job.type == JOB_TIMEOUT)
+    {
+        pConnection->pListener->onTimeout();
+    }
+    else
+    {
+        // Process the commands already received even if the client closed the
+        // connection afterwards
+        bConnected = pConnection->pListener->receiveAvailableData();
+        action = pConnection->pListener->processReceivedCommands();
+    }
+
+    if (!bConnected || (action != ServerListener::ACTION_NONE))
+        finishConnection(pConnection, action);
+    else
+        releaseConnection(pConnection);
+}
+
+
+void EventsEngine::releaseConnection(tConnection* pConnection)
+{
+    // Assertions
+    assert(pConnection);
+
+    pthread_mutex_lock(&_mutex);
+    pConnection->bBusy = false;
+    gettimeofday(&pConnection->lastActivity, 0);
+    pthread_mutex_unlock(&_mutex);
+
+    armSocket(_epoll, pConnection->socket, pConnection, true);
+}
+
+
+void EventsEngine::finishConnection(tConnection* pConnection, ServerListener::tAction action)
+{
+    // Assertions
+    assert(pConnection);
+
+    // Remove the socket from epoll before closing it, since its number might be
+    // reused by the next incoming connection
+    epoll_ctl(_epoll, EPOLL_CTL_DEL, pConnection->socket, 0);
+
+    delete pConnection->pListener;
+    pConnection->pListener = 0;
+
+    close(pConnection->socket);
+
+    tFinishedConnection finished;
+    finished.pConnection    = pConnection;
+    finished.action         = action;
+
+    pthread_mutex_lock(&_mutex);
+    _finishedConnections.push_back(finished);
+    pthread_mutex_unlock(&_mutex);
+
+    // Notify the event loop
+    write(_wakeupPipe[1], "!", 1);
+}
+
+
+/******************************* WORKER THREADS *******************************/
+
+void* EventsEngine::workerThread(void* pEngine)
+{
+    // Assertions
+    assert(pEngine);
+
+    // Declarations
+    EventsEngine* pThis = (EventsEngine*) pEngine;
+    tJob job;
+
+    pthread_mutex_lock(&pThis->_mutex);
+
+    while (true)
+    {
+        while (pThis->_jobs.empty() && !pThis->_bStopping)
+            pthread_cond_wait(&pThis->_jobsCondition, &pThis->_mutex);
+
+        if (pThis->_bStopping)
+            break;
+
+        job = pThis->_jobs.front();
+        pThis->_jobs.pop_front();
+
+        pthread_mutex_unlock(&pThis->_mutex);
+
+        pThis->processJob(job);
+
+        pthread_mutex_lock(&pThis->_mutex);
+    }
+
+    pthread_mutex_unlock(&pThis->_mutex);
+
+    return 0;
+}
@@ -0,0 +1,168 @@
+/*******************************************************************************
+* The MASH Framework contains the source code of all the servers in the
+* "computation farm" of the MASH project (http://www.mash-project.eu),
+* developed at the Idiap Research Institute (http://www.idiap.ch).
+*
+* Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+* Written by Philip Abbet (philip.abbet@idiap.ch)
+*
+* This file is part of the MASH Framework.
+*
+* The MASH Framework is free software: you can redistribute it and/or modify
+* it under the terms of either the GNU General Public License version 2 or
+* the GNU General Public License version 3 as published by the Free
+* Software Foundation, whichever suits the most your needs.
+*
+* The MASH Framework is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public Licenses
+* along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+/** @file   events_engine.h
+    @author Philip Abbet (philip.abbet@idiap.ch)
+
+    Declaration of the 'EventsEngine' class
+*/
+
+#ifndef _MASH_EVENTSENGINE_H_
+#define _MASH_EVENTSENGINE_H_
+
+#include "server_listener.h"
+#include <sys/time.h>
+#include <pthread.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <list>
+
+
+namespace Mash
+{
+    class Server;
+
+
+    //--------------------------------------------------------------------------
+    /// @brief  Engine of a server that monitors its connections with epoll and
+    ///         processes the commands of the clients with a fixed pool of
+    ///         threads (see Server::ENGINE_EVENTS)
+    ///
+    /// Each connection is a small state machine: it is either 'idle' (its
+    /// socket is monitored by epoll) or 'busy' (a worker thread is using its
+    /// listener). The socket is armed in one-shot mode, so a listener is never
+    /// used by two threads at the same time, and can block while sending a
+    /// response or waiting for binary data.
+    ///
+    /// Only the thread running the event loop modifies the state of the server
+    /// and writes in its log.
+    //--------------------------------------------------------------------------
+    class EventsEngine
+    {
+        //_____ Internal types __________
+    private:
+        enum tJobType
+        {
+            JOB_CREATE,         ///< Create the listener, then process the data
+            JOB_DATA,           ///< Data is available on the socket
+            JOB_TIMEOUT,        ///< No command received before the timeout
+        };
+
+        struct tConnection
+        {
+            int                 socket;
+            ServerListener*     pListener;
+            bool                bBusyListener;  ///< Use a BusyListener
+            bool                bBusy;          ///< Used by a worker thread
+            struct timeval      lastActivity;
+        };
+
+        struct tJob
+        {
+            tConnection*    pConnection;
+            tJobType        type;
+        };
+
+        struct tFinishedConnection
+        {
+            tConnection*                pConnection;
+            ServerListener::tAction     action;
+        };
+
+        typedef std::list<tConnection*>         tConnectionsList;
+        typedef tConnectionsList::iterator      tConnectionsIterator;
+
+
+        //_____ Construction / Destruction __________
+    public:
+        //----------------------------------------------------------------------
+        /// @brief  Constructor
+        ///
+        /// @param  pServer     The server using the engine
+        /// @param  nbWorkers   Number of worker threads
+        //----------------------------------------------------------------------
+        EventsEngine(Server* pServer, unsigned int nbWorkers);
+
+        //----------------------------------------------------------------------
+        /// @brief  Destructor
+        //----------------------------------------------------------------------
+        ~EventsEngine();
+
+
+        //_____ Methods __________
+    public:
+        //----------------------------------------------------------------------
+        /// @brief  Run the event loop
+        ///
+        /// @param  listen_socket           The socket listening for incoming
+        ///                                 connections
+        /// @param  host                    The host the server listens to (for
+        ///                                 the logs)
+        /// @param  port                    The port the server listens to (for
+        ///                                 the logs)
+        /// @param  listenerConstructor     Pointer to the function to use to
+        ///                                 create the listeners
+        /// @return                         'false' if failed
+        ///
+        /// @remark Blocking call
+        //----------------------------------------------------------------------
+        bool run(int listen_socket, const std::string& host, unsigned int port,
+                 tServerListenerConstructor* listenerConstructor);
+
+
+    private:
+        void acceptConnections(int listen_socket);
+        void processFinishedConnections(const std::string& host, unsigned int port);
+        int processTimeouts();
+
+        void pushJob(tConnection* pConnection, tJobType type);
+        void processJob(const tJob& job);
+        void releaseConnection(tConnection* pConnection);
+        void finishConnection(tConnection* pConnection, ServerListener::tAction action);
+
+        static void* workerThread(void* pEngine);
+
+
+        //_____ Attributes __________
+    private:
+        Server*                             _pServer;
+        tServerListenerConstructor*         _listenerConstructor;
+        int                                 _epoll;
+        int                                 _wakeupPipe[2];
+        unsigned int                        _clientsCounter;
+        bool                                _bStopping;
+
+        tConnectionsList                    _connections;
+        std::vector<pthread_t>              _workers;
+
+        pthread_mutex_t                     _mutex;
+        pthread_cond_t                      _jobsCondition;
+        std::deque<tJob>                    _jobs;
+        std::vector<tFinishedConnection>    _finishedConnections;
+    };
+}
+
+#endif
@@ -38,12 +38,13 @@ using namespace Mash;
 
 
 const unsigned int BUFFER_INCREMENT = 1024;
+const unsigned int BUFFER_MAX_IDLE_SIZE = 1024 * 1024;
 
 
 /****************************** CONSTRUCTION / DESTRUCTION ******************************/
 
 NetworkBuffer::NetworkBuffer()
-: _data(0), _size(0), _allocated(BUFFER_INCREMENT)
+: _data(0), _start(0), _size(0), _searched(0), _allocated(BUFFER_INCREMENT)
 {
     _data = new unsigned char[_allocated];
 }
@@ -51,7 +52,8 @@ NetworkBuffer::NetworkBuffer()
 //-----------------------------------------------------------------------
 
 NetworkBuffer::NetworkBuffer(const std::string& str)
-: _data(0), _size(str.size()), _allocated(((str.size() / BUFFER_INCREMENT) + 1) * BUFFER_INCREMENT)
+: _data(0), _start(0), _size(str.size()), _searched(0),
+  _allocated(((str.size() / BUFFER_INCREMENT) + 1) * BUFFER_INCREMENT)
 {
     _data = new unsigned char[_allocated];
     memcpy(_data, str.c_str(), _size);
@@ -60,7 +62,8 @@ NetworkBuffer::NetworkBuffer(const std::string& str)
 //-----------------------------------------------------------------------
 
 NetworkBuffer::NetworkBuffer(const unsigned char* pData, unsigned int dataSize)
-: _data(0), _size(dataSize), _allocated(((dataSize / BUFFER_INCREMENT) + 1) * BUFFER_INCREMENT)
+: _data(0), _start(0), _size(dataSize), _searched(0),
+  _allocated(((dataSize / BUFFER_INCREMENT) + 1) * BUFFER_INCREMENT)
 {
     assert(pData);
     assert(dataSize > 0);
@@ -81,12 +84,11 @@ NetworkBuffer::~NetworkBuffer()
 
 void NetworkBuffer::add(const std::string& str)
 {
-    if (_size + str.size() > _allocated)
-        reallocate(str.size());
-    
-    memcpy(_data + _size, str.c_str(), str.size());
-    
-    _size += str.size();
+    if (str.empty())
+        return;
+
+    memcpy(reserve(str.size()), str.c_str(), str.size());
+    commit(str.size());
 }
 
 
@@ -95,12 +97,8 @@ void NetworkBuffer::add(const unsigned char* pData, unsigned int dataSize)
     assert(pData);
     assert(dataSize > 0);
 
-    if (_size + dataSize > _allocated)
-        reallocate(dataSize);
-    
-    memcpy(_data + _size, pData, dataSize);
-    
-    _size += dataSize;
+    memcpy(reserve(dataSize), pData, dataSize);
+    commit(dataSize);
 }
 
 
@@ -109,62 +107,126 @@ void NetworkBuffer::extract(unsigned char* pDest, unsigned int nbBytes)
     assert(pDest);
     assert(nbBytes <= _size);
     
-    memcpy(pDest, _data, nbBytes);
-    
-    unsigned char* previous = _data;
-
-    _size -= nbBytes;
+    memcpy(pDest, _data + _start, nbBytes);
 
-    _data = new unsigned char[_allocated];
-    memcpy(_data, previous + nbBytes, _size);
-    
-    delete[] previous;
+    skip(nbBytes);
 }
 
 
 bool NetworkBuffer::extractLine(std::string &strLine)
 {
-    for (unsigned int i = 0; i < _size; ++i)
+    unsigned int length;
+    if (!findLine(&length))
+        return false;
+
+    strLine.assign((const char*) _data + _start, length);
+
+    skip(length + 1);
+
+    return true;
+}
+
+
+bool NetworkBuffer::findLine(unsigned int* pLength)
+{
+    // Assertions
+    assert(pLength);
+
+    // Only search in the bytes that weren't already searched by a previous call
+    const unsigned char* pEnd = (const unsigned char*) memchr(_data + _start + _searched,
+                                                              '\n', _size - _searched);
+    if (!pEnd)
     {
-        if (_data[i] == '\n')
-        {
-            _data[i] = 0;
-            strLine = (char*) _data;
-            
-            unsigned char* previous = _data;
+        _searched = _size;
+        return false;
+    }
+
+    *pLength = pEnd - (_data + _start);
 
-            _size -= i + 1;
+    return true;
+}
 
-            _data = new unsigned char[_allocated];
-            memcpy(_data, previous + i + 1, _size);
 
-            delete[] previous;
+void NetworkBuffer::skip(unsigned int nbBytes)
+{
+    assert(nbBytes <= _size);
+
+    _size -= nbBytes;
 
-            return true;
-        }
+    if (_size == 0)
+    {
+        _start = 0;
+        _searched = 0;
     }
-    
-    return false;
+    else
+    {
+        _start += nbBytes;
+        _searched = (_searched > nbBytes ? _searched - nbBytes : 0);
+    }
+}
+
+
+unsigned char* NetworkBuffer::reserve(unsigned int nbBytes)
+{
+    if (_start + _size + nbBytes > _allocated)
+        reallocate(nbBytes);
+
+    return _data + _start + _size;
+}
+
+
+void NetworkBuffer::commit(unsigned int nbBytes)
+{
+    assert(_start + _size + nbBytes <= _allocated);
+
+    _size += nbBytes;
 }
 
 
 void NetworkBuffer::reset()
 {
+    _start = 0;
     _size = 0;
+    _searched = 0;
+
+    // Don't keep a huge block of memory around after a large transfer
+    if (_allocated > BUFFER_MAX_IDLE_SIZE)
+    {
+        delete[] _data;
+
+        _allocated = BUFFER_INCREMENT;
+        _data = new unsigned char[_allocated];
+    }
 }
 
 
 void NetworkBuffer::reallocate(unsigned int nbBytesToAdd)
 {
-    if (nbBytesToAdd <= _allocated - _size)
+    if (_start + _size + nbBytesToAdd <= _allocated)
         return;
 
-    _allocated = (((_size + nbBytesToAdd) / BUFFER_INCREMENT) + 1) * BUFFER_INCREMENT;
-    
+    // Move the data back to the beginning of the buffer if that frees enough
+    // space (at least half of the buffer, so the cost of the move is amortized)
+    if (_size + nbBytesToAdd <= _allocated / 2)
+    {
+        memmove(_data, _data + _start, _size);
+        _start = 0;
+        return;
+    }
+
+    // Otherwise, at least double the size of the buffer
+    unsigned int required = _size + nbBytesToAdd;
+    unsigned int allocated = 2 * _allocated;
+    if (allocated < required)
+        allocated = ((required / BUFFER_INCREMENT) + 1) * BUFFER_INCREMENT;
+
     unsigned char* previous = _data;
 
-    _data = new unsigned char[_allocated];
-    memcpy(_data, previous, _size);
-    
+    _data = new unsigned char[allocated];
+    memcpy(_data, previous + _start, _size);
+
     delete[] previous;
+
+    _start = 0;
+    _allocated = allocated;
 }
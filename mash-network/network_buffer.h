@@ -38,7 +38,17 @@
 namespace Mash
 {
 	//--------------------------------------------------------------------------
-	/// @brief	Network-related utility class
+	/// @brief	Buffer used to store the data received from a socket until it is
+	///         processed
+	///
+	/// The data is stored in a contiguous block of memory. The extraction
+	/// methods only advance the start of the valid data: the rest of the
+	/// buffer is never copied, and the memory is only moved back to its
+	/// beginning when space is needed at its end. This makes the parsing of
+	/// a response made of many lines linear in its size.
+	///
+	/// The data can be received directly into the buffer (see reserve() and
+	/// commit()), avoiding an intermediate copy.
 	//--------------------------------------------------------------------------
 	class NetworkBuffer
 	{
@@ -59,13 +69,48 @@ namespace Mash
     
         void extract(unsigned char* pDest, unsigned int nbBytes);
         bool extractLine(std::string &strLine);
-    
+
+        //----------------------------------------------------------------------
+        /// @brief  Look for the end of the first line of the buffer, without
+        ///         extracting it
+        ///
+        /// The line starts at data(). Use skip() with 'length + 1' to remove
+        /// it (and its end-of-line character) from the buffer.
+        ///
+        /// @param[out] pLength Length of the line, without the end-of-line
+        ///                     character
+        /// @return             'false' if the buffer doesn't contain a
+        ///                     complete line
+        //----------------------------------------------------------------------
+        bool findLine(unsigned int* pLength);
+        void skip(unsigned int nbBytes);
+
+        //----------------------------------------------------------------------
+        /// @brief  Returns a pointer to (at least) 'nbBytes' bytes of free
+        ///         memory at the end of the buffer
+        ///
+        /// The data written there becomes part of the buffer once commit()
+        /// is called. The pointer is invalidated by any other method call.
+        //----------------------------------------------------------------------
+        unsigned char* reserve(unsigned int nbBytes);
+
+        //----------------------------------------------------------------------
+        /// @brief  Add the 'nbBytes' first bytes of the memory returned by
+        ///         reserve() to the buffer
+        //----------------------------------------------------------------------
+        void commit(unsigned int nbBytes);
+
         void reset();
     
         inline unsigned int size() const
         {
             return _size;
         }
+
+        inline const unsigned char* data() const
+        {
+            return _data + _start;
+        }
     
     private:
         void reallocate(unsigned int nbBytesToAdd);
@@ -74,7 +119,10 @@ namespace Mash
         //_____ Attributes __________
     private:
         unsigned char*  _data;
-        unsigned int    _size;
+        unsigned int    _start;         ///< Offset of the first valid byte
+        unsigned int    _size;          ///< Number of valid bytes
+        unsigned int    _searched;      ///< Number of valid bytes already known to
+                                        ///  contain no end-of-line character
         unsigned int    _allocated;
 	};
 }
@@ -32,16 +32,54 @@
 #include "networkutils.h"
 #include <mash-utils/stringutils.h>
 #include <netinet/in.h>
+#include <stdint.h>
 #include <memory.h>
 #include <assert.h>
 #include <iostream>
 #include <errno.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <sys/sendfile.h>
 
 
 using namespace Mash;
 using namespace std;
 
 
+/*********************************** HELPERS **********************************/
+
+//------------------------------------------------------------------------------
+/// @brief  Find the next token (delimited by spaces) of a line, without
+///         copying it
+///
+/// @return 'false' if there is no more token in the line
+//------------------------------------------------------------------------------
+static inline bool nextToken(const char** pCurrent, const char* pEnd,
+                             const char** pToken, unsigned int* length)
+{
+    const char* p = *pCurrent;
+
+    while ((p < pEnd) && (*p == ' '))
+        ++p;
+
+    if (p == pEnd)
+    {
+        *pCurrent = p;
+        return false;
+    }
+
+    *pToken = p;
+
+    while ((p < pEnd) && (*p != ' '))
+        ++p;
+
+    *length = p - *pToken;
+    *pCurrent = p;
+
+    return true;
+}
+
+
 
 void* NetworkUtils::getNetworkAddress(struct sockaddr* sa)
 {
@@ -57,15 +95,23 @@ bool NetworkUtils::sendMessage(int socket, const std::string& strMessage,
 {
     // Assertions
     assert(socket >= 0);
-    assert(!strMessage.empty());
 
-    // Declarations
-    int total;
-    int bytesleft;
-    const char* pSrc;
+    string data;
+    encodeMessage(&data, strMessage, arguments);
+
+    return sendBuffer(socket, (const unsigned char*) data.c_str(), data.length());
+}
+
+
+void NetworkUtils::encodeMessage(std::string* pData, const std::string& strMessage,
+                                 const ArgumentsList& arguments)
+{
+    // Assertions
+    assert(pData);
+    assert(!strMessage.empty());
 
     // Build the line that will be sent
-    string data = strMessage;
+    pData->append(strMessage);
     for (int i = 0; i < arguments.size(); ++i)
     {
         string arg = arguments.getString(i);
@@ -81,18 +127,30 @@ bool NetworkUtils::sendMessage(int socket, const std::string& strMessage,
         if (bMustQuote || (arg.find(' ') != string::npos))
             arg = "'" + arg + "'";
 
-        data += " " + arg;
+        pData->append(" " + arg);
     }
-    data += "\n";
-    pSrc = data.c_str();
+    pData->append("\n");
+}
+
+
+bool NetworkUtils::sendData(int socket, const unsigned char* data, int size)
+{
+    // Assertions
+    assert(socket >= 0);
+    assert(data);
+    assert(size > 0);
+
+    // Declarations
+    int total;
+    int bytesleft;
 
     // Send the response to the client
     total = 0;
-    bytesleft = data.length();
-    while (total < data.length())
+    bytesleft = size;
+    while (total < size)
     {
         errno = 0;
-        int n = send(socket, pSrc + total, bytesleft, 0);
+        int n = send(socket, data + total, bytesleft, 0);
         if (n == -1)
         {
             if (errno == EINTR)
@@ -109,33 +167,94 @@ bool NetworkUtils::sendMessage(int socket, const std::string& strMessage,
 }
 
 
-bool NetworkUtils::sendData(int socket, const unsigned char* data, int size)
+bool NetworkUtils::sendMessage(int socket, const std::string& strMessage,
+                               const ArgumentsList& arguments,
+                               const unsigned char* data, unsigned int size)
 {
     // Assertions
     assert(socket >= 0);
-    assert(data);
-    assert(size > 0);
+    assert(data || (size == 0));
 
-    // Declarations
-    int total;
-    int bytesleft;
+    string header;
+    encodeMessage(&header, strMessage, arguments);
 
-    // Send the response to the client
-    total = 0;
-    bytesleft = size;
-    while (total < size)
+    struct iovec vectors[2];
+    vectors[0].iov_base = (void*) header.data();
+    vectors[0].iov_len  = header.size();
+    vectors[1].iov_base = (void*) data;
+    vectors[1].iov_len  = size;
+
+    return sendVectors(socket, vectors, (size > 0) ? 2 : 1);
+}
+
+
+bool NetworkUtils::sendFile(int socket, const std::string& strHeader, int fd,
+                            int64_t offset, int64_t size)
+{
+    // Assertions
+    assert(socket >= 0);
+    assert(fd >= 0);
+    assert(offset >= 0);
+    assert(size >= 0);
+
+    // Send the header, telling the kernel that more data will follow (so it
+    // doesn't send a small packet first)
+    if (!strHeader.empty() &&
+        !sendBuffer(socket, (const unsigned char*) strHeader.data(), strHeader.size(),
+                    (size > 0) ? MSG_MORE : 0))
+    {
+        return false;
+    }
+
+    off_t position = offset;
+    int64_t bytesleft = size;
+
+    while (bytesleft > 0)
     {
         errno = 0;
-        int n = send(socket, data + total, bytesleft, 0);
+        ssize_t n = sendfile(socket, fd, &position, bytesleft);
         if (n == -1)
         {
             if (errno == EINTR)
                 continue;
 
+            // The file doesn't support 'sendfile()': send it the usual way
+            if ((errno == EINVAL) || (errno == ENOSYS))
+                break;
+
             return false;
         }
-        
-        total += n;
+        else if (n == 0)
+        {
+            // The file is shorter than expected
+            return false;
+        }
+
+        bytesleft -= n;
+    }
+
+    unsigned char buffer[RECEIVE_CHUNK_SIZE];
+
+    while (bytesleft > 0)
+    {
+        errno = 0;
+        ssize_t n = pread(fd, buffer, min((int64_t) RECEIVE_CHUNK_SIZE, bytesleft), position);
+        if (n == -1)
+        {
+            if (errno == EINTR)
+                continue;
+
+            return false;
+        }
+        else if (n == 0)
+        {
+            return false;
+        }
+
+        if (!sendBuffer(socket, buffer, n))
+            return false;
+
+        position += n;
         bytesleft -= n;
     }
 
@@ -153,55 +272,25 @@ bool NetworkUtils::waitMessage(int socket, NetworkBuffer* pBuffer,
     assert(strMessage);
     assert(arguments);
 
-    const int MAXDATASIZE = 256;
-    
-    // Declarations
-    char buf[MAXDATASIZE];
-    fd_set readfds;
-    int nbBytes;
-    
-    FD_ZERO(&readfds);
-
     arguments->clear();
 
-    if (processBuffer(pBuffer, strMessage, arguments))
-        return true;
-
     while (true)
     {
-        FD_SET(socket, &readfds);
-        errno = 0;
+        if (processBuffer(pBuffer, strMessage, arguments))
+            return true;
 
-        int ret = select(socket + 1, &readfds, NULL, NULL, pTimeout);
+        int result = receive(socket, pBuffer, pTimeout);
 
         // Timeout?
-        if (ret == 0)
+        if (result == 0)
         {
             *strMessage = "";
             return true;
         }
 
-        if (FD_ISSET(socket, &readfds))
-        {
-            nbBytes = recv(socket, buf, MAXDATASIZE - 1, 0);
-            if (nbBytes > 0)
-            {
-                buf[nbBytes] = 0;
-                pBuffer->add((const unsigned char*) buf, nbBytes);
-
-                if (processBuffer(pBuffer, strMessage, arguments))
-                    return true;
-            }
-            else if (errno == EINTR)
-            {
-                continue;
-            }
-            else
-            {
-                // Connection closed or error
-                return false;
-            }
-        }
+        // Connection closed or error
+        if (result < 0)
+            return false;
     }
 }
 
@@ -276,51 +365,67 @@ bool NetworkUtils::processBuffer(NetworkBuffer* pBuffer, std::string* strMessage
     assert(arguments);
 
     // Declarations
-    size_t offset;
-    tStringList parts;
-    tStringIterator iter, iterEnd;
-    string strLine;
-
-    while (pBuffer->extractLine(strLine))
+    unsigned int length;
+    const char* pToken;
+    unsigned int tokenLength;
+    string decoded;
+
+    // The line is parsed directly in the buffer: only the arguments are copied
+    // (once), and decoded only if they contain escaped characters
+    while (pBuffer->findLine(&length))
     {
-        if (strLine.empty())
+        const char* pCurrent = (const char*) pBuffer->data();
+        const char* pEnd = pCurrent + length;
+
+        if (!nextToken(&pCurrent, pEnd, &pToken, &tokenLength))
+        {
+            pBuffer->skip(length + 1);
             continue;
-            
-        parts = StringUtils::split(strLine, " ");
+        }
+
+        strMessage->assign(pToken, tokenLength);
 
         bool bQuotedString = false;
-        string quotedString = "";
-        for (iter = ++(parts.begin()), iterEnd = parts.end(); iter != iterEnd; ++iter)
+        while (nextToken(&pCurrent, pEnd, &pToken, &tokenLength))
         {
             if (!bQuotedString)
             {
-                if (iter->at(0) == '\'')
+                if (pToken[0] == '\'')
                 {
-                    quotedString = iter->substr(1);
+                    decoded.clear();
+                    decodeArgument(&decoded, pToken + 1, tokenLength - 1);
                     bQuotedString = true;
                 }
+                else if (!memchr(pToken, '\\', tokenLength))
+                {
+                    arguments->add(pToken, tokenLength);
+                }
                 else
                 {
-                    arguments->add(decodeArgument(*iter));
+                    decoded.clear();
+                    decodeArgument(&decoded, pToken, tokenLength);
+                    arguments->add(decoded);
                 }
             }
             else
             {
-                if ((iter->at(iter->size() - 1) == '\'') and ((iter->size() == 1) || (iter->at(iter->size() - 2) != '\\')))
+                decoded += " ";
+
+                if ((pToken[tokenLength - 1] == '\'') &&
+                    ((tokenLength == 1) || (pToken[tokenLength - 2] != '\\')))
                 {
-                    quotedString += " " + iter->substr(0, iter->size() - 1);
-                    arguments->add(decodeArgument(quotedString));
+                    decodeArgument(&decoded, pToken, tokenLength - 1);
+                    arguments->add(decoded);
                     bQuotedString = false;
-                    quotedString = "";
                 }
                 else
                 {
-                    quotedString += " " + *iter;
+                    decodeArgument(&decoded, pToken, tokenLength);
                 }
             }
         }
-        
-        (*strMessage) = parts[0];
+
+        pBuffer->skip(length + 1);
 
         return true;
     }
@@ -338,10 +443,139 @@ std::string NetworkUtils::encodeArgument(const std::string& strArgument)
 }
 
 
-std::string NetworkUtils::decodeArgument(const std::string& strArgument)
+void NetworkUtils::decodeArgument(std::string* pDest, const char* pSource,
+                                  unsigned int length)
 {
-    string strResult = StringUtils::replaceAll(strArgument, "\\'", "'");
-    strResult = StringUtils::replaceAll(strResult, "\\n", "\n");
+    const char* pEnd = pSource + length;
 
-    return strResult;
+    while (pSource < pEnd)
+    {
+        const char* pEscape = (const char*) memchr(pSource, '\\', pEnd - pSource);
+        if (!pEscape)
+        {
+            pDest->append(pSource, pEnd - pSource);
+            return;
+        }
+
+        pDest->append(pSource, pEscape - pSource);
+
+        if ((pEscape + 1 < pEnd) && (pEscape[1] == '\''))
+        {
+            *pDest += '\'';
+            pSource = pEscape + 2;
+        }
+        else if ((pEscape + 1 < pEnd) && (pEscape[1] == 'n'))
+        {
+            *pDest += '\n';
+            pSource = pEscape + 2;
+        }
+        else
+        {
+            *pDest += '\\';
+            pSource = pEscape + 1;
+        }
+    }
+}
+
+
+bool NetworkUtils::sendBuffer(int socket, const unsigned char* data, unsigned int size,
+                              int flags)
+{
+    // Declarations
+    unsigned int total = 0;
+    unsigned int bytesleft = size;
+
+    while (total < size)
+    {
+        errno = 0;
+        int n = send(socket, data + total, bytesleft, flags);
+        if (n == -1)
+        {
+            if (errno == EINTR)
+                continue;
+
+            return false;
+        }
+
+        total += n;
+        bytesleft -= n;
+    }
+
+    return true;
+}
+
+
+bool NetworkUtils::sendVectors(int socket, struct iovec* vectors, int nbVectors)
+{
+    while (nbVectors > 0)
+    {
+        errno = 0;
+        ssize_t n = writev(socket, vectors, nbVectors);
+        if (n == -1)
+        {
+            if (errno == EINTR)
+                continue;
+
+            return false;
+        }
+
+        // Skip the vectors that were completely sent, and adjust the first
+        // one that was only partially sent
+        while ((nbVectors > 0) && (n >= (ssize_t) vectors->iov_len))
+        {
+            n -= vectors->iov_len;
+            ++vectors;
+            --nbVectors;
+        }
+
+        if (nbVectors > 0)
+        {
+            vectors->iov_base = (char*) vectors->iov_base + n;
+            vectors->iov_len -= n;
+        }
+    }
+
+    return true;
+}
+
+
+int NetworkUtils::receive(int socket, NetworkBuffer* pBuffer, struct timeval* pTimeout)
+{
+    // Declarations
+    fd_set readfds;
+    int nbBytes;
+
+    FD_ZERO(&readfds);
+
+    while (true)
+    {
+        FD_SET(socket, &readfds);
+        errno = 0;
+
+        int ret = select(socket + 1, &readfds, NULL, NULL, pTimeout);
+
+        // Timeout?
+        if (ret == 0)
+            return 0;
+
+        if (FD_ISSET(socket, &readfds))
+        {
+            // Receive directly into the buffer, in large chunks
+            nbBytes = recv(socket, pBuffer->reserve(RECEIVE_CHUNK_SIZE), RECEIVE_CHUNK_SIZE, 0);
+            if (nbBytes > 0)
+            {
+                pBuffer->commit(nbBytes);
+                return 1;
+            }
+            else if (errno == EINTR)
+            {
+                continue;
+            }
+            else
+            {
+                // Connection closed or error
+                return -1;
+            }
+        }
+    }
 }
@@ -36,6 +36,7 @@
 #include "network_buffer.h"
 #include <string>
 #include <sys/socket.h>
+#include <stdint.h>
 
 
 namespace Mash
@@ -46,13 +47,50 @@ namespace Mash
 	class NetworkUtils
 	{
 	public:
+        /// Maximum number of bytes received at once from a socket
+        static const unsigned int RECEIVE_CHUNK_SIZE = 64 * 1024;
+
         static void* getNetworkAddress(struct sockaddr* sa);
         
         static bool sendMessage(int socket, const std::string& strMessage,
                                 const ArgumentsList& arguments);
 
+        //----------------------------------------------------------------------
+        /// @brief  Append the encoded form of a message to a string, to send
+        ///         it later (possibly with other ones)
+        //----------------------------------------------------------------------
+        static void encodeMessage(std::string* pData, const std::string& strMessage,
+                                  const ArgumentsList& arguments);
+
         static bool sendData(int socket, const unsigned char* data, int size);
 
+        //----------------------------------------------------------------------
+        /// @brief  Send a message followed by some binary data
+        ///
+        /// The message and the data are sent together (with 'writev()'),
+        /// without copying the data.
+        //----------------------------------------------------------------------
+        static bool sendMessage(int socket, const std::string& strMessage,
+                                const ArgumentsList& arguments,
+                                const unsigned char* data, unsigned int size);
+
+        //----------------------------------------------------------------------
+        /// @brief  Send some bytes followed by a part of a file
+        ///
+        /// The content of the file is sent by the kernel (with 'sendfile()')
+        /// when possible, without being read in memory first.
+        ///
+        /// @param  socket      The socket
+        /// @param  strHeader   The bytes to send before the file (for instance,
+        ///                     an encoded message), can be empty
+        /// @param  fd          File descriptor of the file
+        /// @param  offset      Offset of the first byte of the file to send
+        /// @param  size        Number of bytes of the file to send
+        /// @return             'false' if failed
+        //----------------------------------------------------------------------
+        static bool sendFile(int socket, const std::string& strHeader, int fd,
+                             int64_t offset, int64_t size);
+
         static bool waitMessage(int socket, NetworkBuffer* pBuffer,
                                 std::string* strMessage, ArgumentsList* arguments,
                                 struct timeval* pTimeout = 0);
@@ -64,7 +102,15 @@ namespace Mash
 
     private:
         static std::string encodeArgument(const std::string& strArgument);
-        static std::string decodeArgument(const std::string& strArgument);
+        static void decodeArgument(std::string* pDest, const char* pSource,
+                                   unsigned int length);
+
+        static bool sendBuffer(int socket, const unsigned char* data, unsigned int size,
+                               int flags = 0);
+
+        static bool sendVectors(int socket, struct iovec* vectors, int nbVectors);
+
+        static int receive(int socket, NetworkBuffer* pBuffer, struct timeval* pTimeout);
 	};
 }
 
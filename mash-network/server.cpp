@@ -32,6 +32,7 @@
 #include "server.h"
 #include "networkutils.h"
 #include "busy_listener.h"
+#include "events_engine.h"
 #include <mash-utils/stringutils.h>
 #include <sys/socket.h>
 #include <sys/wait.h>
@@ -63,8 +64,10 @@ string Server::strLogFolder = "logs/";
 /************************* CONSTRUCTION / DESTRUCTION *************************/
 
 Server::Server(unsigned int nbMaxClients, unsigned int logLimit,
-               const std::string& strName)
-: _state(STATE_NORMAL), _nbMaxClients(nbMaxClients), _logLimit(logLimit)
+               const std::string& strName, tEngine engine,
+               unsigned int nbWorkers)
+: _state(STATE_NORMAL), _engine(engine), _nbMaxClients(nbMaxClients),
+  _nbWorkers(nbWorkers), _logLimit(logLimit)
 {
     _outStream.open(strName, strLogFolder + strName + "-$TIMESTAMP.log", 200 * 1024);
 }
@@ -83,17 +86,6 @@ bool Server::listen(const std::string& host, unsigned int port,
     // Assertions
     assert(listenerConstructor);
 
-    // Declarations
-    int listen_socket;
-    struct addrinfo hints, *servinfo, *p;
-    struct sockaddr_storage their_addr; // connector's address information
-    socklen_t sin_size;
-    struct sigaction sa;
-    int yes = 1;
-    char s[INET6_ADDRSTRLEN];
-    int rv;
-    unsigned int clients_counter = 0;
-
     if (!host.empty())
         _outStream << "Start to listen for incoming connections on '" << host << ":" << port << "'" << endl;
     else
@@ -104,6 +96,34 @@ bool Server::listen(const std::string& host, unsigned int port,
     else
         _outStream << "This server supports an unlimited amount of clients" << endl;
 
+    int listen_socket = createListenSocket(host, port);
+    if (listen_socket == -1)
+        return false;
+
+    if (_engine == ENGINE_EVENTS)
+    {
+        _outStream << "The connections are handled by " << _nbWorkers << " thread(s)" << endl;
+
+        EventsEngine engine(this, _nbWorkers);
+        bool bResult = engine.run(listen_socket, host, port, listenerConstructor);
+
+        close(listen_socket);
+
+        return bResult;
+    }
+
+    return listenWithForks(listen_socket, host, port, listenerConstructor);
+}
+
+
+int Server::createListenSocket(const std::string& host, unsigned int port)
+{
+    // Declarations
+    int listen_socket;
+    struct addrinfo hints, *servinfo, *p;
+    int yes = 1;
+    int rv;
+
     // Retrieve a list of our addresses
     memset(&hints, 0, sizeof hints);
     hints.ai_family     = AF_UNSPEC;
@@ -113,7 +133,7 @@ bool Server::listen(const std::string& host, unsigned int port,
     if ((rv = getaddrinfo((host.empty() ? NULL : host.c_str()), StringUtils::toString(port).c_str(), &hints, &servinfo)) != 0)
     {
         _outStream << "ERROR - Failed to retrieve a list of our addresses: " << gai_strerror(rv) << endl;
-        return false;
+        return -1;
     }
 
     // Loop through all the results and bind to the first we can
@@ -128,7 +148,7 @@ bool Server::listen(const std::string& host, unsigned int port,
         if (setsockopt(listen_socket, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(int)) == -1)
         {
             _outStream << "ERROR - Failed to set the socket options" << endl;
-            return false;
+            return -1;
         }
 
         if (bind(listen_socket, p->ai_addr, p->ai_addrlen) == -1)
@@ -144,19 +164,68 @@ bool Server::listen(const std::string& host, unsigned int port,
     if (p == NULL)
     {
         _outStream << "ERROR - Failed to create the socket of the server" << endl;
-        return false;
+        return -1;
     }
 
     freeaddrinfo(servinfo);
 
 
-    // Start listening
-    if (::listen(listen_socket, 10) == -1)
+    // Start listening (the events engine must handle bursts of connections)
+    if (::listen(listen_socket, (_engine == ENGINE_EVENTS ? SOMAXCONN : 10)) == -1)
     {
         _outStream << "ERROR - Failed to listen for incoming connections" << endl;
-        return false;
+        close(listen_socket);
+        return -1;
     }
 
+    return listen_socket;
+}
+
+
+void Server::resetLogFile(const std::string& host, unsigned int port)
+{
+    _outStream << "--------------------------------------------------------------------------------" << endl;
+
+    string strLogName = _outStream.getName();
+    string strLogFileName = _outStream.getFileName();
+
+    _outStream.deleteFile();
+    _outStream.open(strLogName, strLogFileName);
+
+    time_t t;
+    struct tm* timeinfo;
+    char buffer[20];
+
+    time(&t);
+    timeinfo = localtime(&t);
+
+    strftime(buffer, 20, "%d/%m/%Y %H:%M:%S", timeinfo);
+
+    _outStream << "Reset of the log file: " << buffer << endl;
+
+    if (!host.empty())
+        _outStream << "Listen for incoming connections on '" << host << ":" << port << "'" << endl;
+    else
+        _outStream << "Listen for incoming connections on port " << port << endl;
+
+    if (_nbMaxClients > 0)
+        _outStream << "This server only supports " << _nbMaxClients << " client(s) at the same time" << endl;
+    else
+        _outStream << "This server supports an unlimited amount of clients" << endl;
+}
+
+
+bool Server::listenWithForks(int listen_socket, const std::string& host,
+                             unsigned int port,
+                             tServerListenerConstructor* listenerConstructor)
+{
+    // Declarations
+    struct sockaddr_storage their_addr; // connector's address information
+    socklen_t sin_size;
+    struct sigaction sa;
+    char s[INET6_ADDRSTRLEN];
+    unsigned int clients_counter = 0;
+
     // Reap all dead processes
     sa.sa_handler = sigchld_handler;
     sigemptyset(&sa.sa_mask);
@@ -172,35 +241,7 @@ bool Server::listen(const std::string& host, unsigned int port,
         // Delete the log file and starts a new one when the limit is reached
         if ((clients_counter >= _logLimit) && _pipesList.empty())
         {
-            _outStream << "--------------------------------------------------------------------------------" << endl;
-
-            string strLogName = _outStream.getName();
-            string strLogFileName = _outStream.getFileName();
-
-            _outStream.deleteFile();
-            _outStream.open(strLogName, strLogFileName);
-
-            time_t t;
-            struct tm* timeinfo;
-            char buffer[20];
-
-            time(&t);
-            timeinfo = localtime(&t);
-
-            strftime(buffer, 20, "%d/%m/%Y %H:%M:%S", timeinfo);
-
-            _outStream << "Reset of the log file: " << buffer << endl;
-
-            if (!host.empty())
-                _outStream << "Listen for incoming connections on '" << host << ":" << port << "'" << endl;
-            else
-                _outStream << "Listen for incoming connections on port " << port << endl;
-
-            if (_nbMaxClients > 0)
-                _outStream << "This server only supports " << _nbMaxClients << " client(s) at the same time" << endl;
-            else
-                _outStream << "This server supports an unlimited amount of clients" << endl;
-            
+            resetLogFile(host, port);
             clients_counter = 0;
         }
         
@@ -40,14 +40,41 @@
 
 namespace Mash
 {
+    class EventsEngine;
+
+
     //--------------------------------------------------------------------------
     /// @brief  Manages the server side of a TCP/IP communication
     ///
     /// A 'listener' is created to handle each incoming connection (see
     /// ServerListener).
+    ///
+    /// Two engines are available:
+    ///   - ENGINE_FORK: a new process is forked for each incoming connection,
+    ///     and its listener processes the commands in a blocking loop
+    ///   - ENGINE_EVENTS: the connections are monitored with epoll by the
+    ///     process of the server, and their commands are processed by a fixed
+    ///     pool of worker threads. The listeners of a server can share some
+    ///     in-memory state (like caches), but must be thread-safe. A given
+    ///     listener is never used by two threads at the same time.
     //--------------------------------------------------------------------------
     class MASH_SYMBOL Server
     {
+        friend class EventsEngine;
+
+
+        //_____ Internal types __________
+    public:
+        //----------------------------------------------------------------------
+        /// @brief  The engines that can be used to handle the connections
+        //----------------------------------------------------------------------
+        enum tEngine
+        {
+            ENGINE_FORK,        ///< One process per connection
+            ENGINE_EVENTS,      ///< epoll-based event loop and pool of threads
+        };
+
+
         //_____ Construction / Destruction __________
     public:
         //----------------------------------------------------------------------
@@ -60,9 +87,13 @@ namespace Mash
         ///                         one is created when that limit is reached.
         ///                         0 means 'no limit'
         /// @param  strName         Name of the server (used for the logs)
+        /// @param  engine          The engine to use to handle the connections
+        /// @param  nbWorkers       (ENGINE_EVENTS only) Number of threads
+        ///                         processing the commands of the clients
         //----------------------------------------------------------------------
         Server(unsigned int nbMaxClients = 0, unsigned int logLimit = 100,
-               const std::string& strName = "Server");
+               const std::string& strName = "Server",
+               tEngine engine = ENGINE_FORK, unsigned int nbWorkers = 4);
 
         //----------------------------------------------------------------------
         /// @brief  Destructor
@@ -92,6 +123,26 @@ namespace Mash
                     
 
     private:
+        //----------------------------------------------------------------------
+        /// @brief  Create the socket listening for incoming connections
+        ///
+        /// @return The socket, -1 if failed
+        //----------------------------------------------------------------------
+        int createListenSocket(const std::string& host, unsigned int port);
+
+        //----------------------------------------------------------------------
+        /// @brief  Delete the log file and starts a new one
+        //----------------------------------------------------------------------
+        void resetLogFile(const std::string& host, unsigned int port);
+
+        //----------------------------------------------------------------------
+        /// @brief  Handle the incoming connections by forking a new process
+        ///         for each one of them
+        //----------------------------------------------------------------------
+        bool listenWithForks(int listen_socket, const std::string& host,
+                             unsigned int port,
+                             tServerListenerConstructor* listenerConstructor);
+
         //----------------------------------------------------------------------
         /// @brief  Add a client to the list
         ///
@@ -127,7 +178,9 @@ namespace Mash
         //_____ Attributes __________
     private:
         tState              _state;
+        tEngine             _engine;
         unsigned int        _nbMaxClients;
+        unsigned int        _nbWorkers;
         unsigned int        _logLimit;
         std::vector<int>    _pipesList;
         OutStream           _outStream;
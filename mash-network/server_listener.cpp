@@ -31,6 +31,11 @@
 
 #include "server.h"
 #include "networkutils.h"
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
 #include <assert.h>
 
 using namespace std;
@@ -114,6 +119,64 @@ bool ServerListener::sendData(const unsigned char* data, int size)
 }
 
 
+bool ServerListener::sendResponse(const std::string& strResponse,
+                                  const ArgumentsList& arguments,
+                                  const unsigned char* data, int size)
+{
+    _outStream << "> " << strResponse;
+
+    for (unsigned int i = 0; i < arguments.size(); ++i)
+        _outStream << " " << arguments.getString(i);
+
+    _outStream << endl;
+    _outStream << "> <" << size << " bytes of data>" << endl;
+
+    return NetworkUtils::sendMessage(_socket, strResponse, arguments, data, size);
+}
+
+
+bool ServerListener::sendFile(const std::string& strResponse,
+                              const ArgumentsList& arguments,
+                              const std::string& strFileName,
+                              int64_t offset, int64_t size,
+                              const std::string& strPrefix)
+{
+    int fd = open(strFileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    if (size < 0)
+    {
+        struct stat infos;
+        if (fstat(fd, &infos) != 0)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        size = infos.st_size - offset;
+    }
+
+    _outStream << "> " << strResponse;
+
+    for (unsigned int i = 0; i < arguments.size(); ++i)
+        _outStream << " " << arguments.getString(i);
+
+    _outStream << endl;
+    _outStream << "> <" << (int64_t) strPrefix.size() + size << " bytes of data>" << endl;
+
+    string header;
+    NetworkUtils::encodeMessage(&header, strResponse, arguments);
+    header += strPrefix;
+
+    bool bResult = NetworkUtils::sendFile(_socket, header, fd, offset, size);
+
+    ::close(fd);
+
+    return bResult;
+}
+
+
 bool ServerListener::waitData(unsigned char* data, int size)
 {
     bool bResult = NetworkUtils::waitData(_socket, &_buffer, data, size);
@@ -123,3 +186,66 @@ bool ServerListener::waitData(unsigned char* data, int size)
 
     return bResult;
 }
+
+
+/*********************** EVENT-DRIVEN PROCESSING METHODS **********************/
+
+bool ServerListener::receiveAvailableData()
+{
+    // Commands are small: don't make each connection reserve a large buffer
+    const unsigned int MAXDATASIZE = 4096;
+
+    while (true)
+    {
+        errno = 0;
+
+        ssize_t nbBytes = recv(_socket, _buffer.reserve(MAXDATASIZE), MAXDATASIZE, MSG_DONTWAIT);
+        if (nbBytes > 0)
+        {
+            _buffer.commit(nbBytes);
+
+            if (nbBytes < MAXDATASIZE)
+                return true;
+        }
+        else if (nbBytes == 0)
+        {
+            // Connection closed
+            return false;
+        }
+        else if (errno == EINTR)
+        {
+            continue;
+        }
+        else
+        {
+            return (errno == EAGAIN) || (errno == EWOULDBLOCK);
+        }
+    }
+}
+
+
+ServerListener::tAction ServerListener::processReceivedCommands()
+{
+    // Declarations
+    std::string strCommand;
+    ArgumentsList arguments;
+
+    while (NetworkUtils::processBuffer(&_buffer, &strCommand, &arguments))
+    {
+        _outStream << "< " << strCommand;
+
+        for (unsigned int i = 0; i < arguments.size(); ++i)
+            _outStream << " " << arguments.getString(i);
+
+        _outStream << endl;
+
+        tAction action = handleCommand(strCommand, arguments);
+
+        if (action != ACTION_NONE)
+            return action;
+
+        arguments.clear();
+    }
+
+    return ACTION_NONE;
+}
@@ -37,6 +37,7 @@
 #include "network_buffer.h"
 #include <string>
 #include <sys/time.h>
+#include <stdint.h>
 
 
 namespace Mash
@@ -107,6 +108,44 @@ namespace Mash
         //----------------------------------------------------------------------
         bool sendData(const unsigned char* data, int size);
 
+        //----------------------------------------------------------------------
+        /// @brief  Send a response to the client, followed by some binary data
+        ///
+        /// Equivalent to sendResponse() followed by sendData(), but both are
+        /// sent at once.
+        /// @param  strResponse The response
+        /// @param  arguments   The arguments of the response
+        /// @param  data        The data
+        /// @param  size        Size of the data, in bytes
+        /// @return             'false' if failed
+        //----------------------------------------------------------------------
+        bool sendResponse(const std::string& strResponse,
+                          const ArgumentsList& arguments,
+                          const unsigned char* data, int size);
+
+        //----------------------------------------------------------------------
+        /// @brief  Send a response to the client, followed by (a part of) the
+        ///         content of a file
+        ///
+        /// The content of the file isn't loaded in memory.
+        /// @param  strResponse The response
+        /// @param  arguments   The arguments of the response
+        /// @param  strFileName Path to the file
+        /// @param  offset      Offset of the first byte of the file to send
+        /// @param  size        Number of bytes to send (-1: until the end of
+        ///                     the file)
+        /// @param  strPrefix   Bytes to send before the content of the file
+        /// @return             'false' if failed
+        ///
+        /// @remark The size of the data (including the prefix) must be part
+        ///         of the arguments, so it must be known beforehand
+        //----------------------------------------------------------------------
+        bool sendFile(const std::string& strResponse,
+                      const ArgumentsList& arguments,
+                      const std::string& strFileName,
+                      int64_t offset = 0, int64_t size = -1,
+                      const std::string& strPrefix = "");
+
         //----------------------------------------------------------------------
         /// @brief  Wait for some binary data from the client
         ///
@@ -119,6 +158,34 @@ namespace Mash
         bool waitData(unsigned char* data, int size);
 
 
+        //_____ Event-driven processing (see Server::ENGINE_EVENTS) __________
+    public:
+        //----------------------------------------------------------------------
+        /// @brief  Read all the data currently available on the socket, without
+        ///         blocking
+        ///
+        /// @return 'false' if the connection was closed by the client
+        //----------------------------------------------------------------------
+        bool receiveAvailableData();
+
+        //----------------------------------------------------------------------
+        /// @brief  Process the commands already received, without waiting for
+        ///         new ones
+        ///
+        /// @return The action that must be performed by the server
+        //----------------------------------------------------------------------
+        tAction processReceivedCommands();
+
+        //----------------------------------------------------------------------
+        /// @brief  Returns the timeout used while waiting for a command (zero
+        ///         if none)
+        //----------------------------------------------------------------------
+        inline const struct timeval& getTimeout() const
+        {
+            return _timeout;
+        }
+
+
         //_____ Methods to implement __________
     public:
         //----------------------------------------------------------------------
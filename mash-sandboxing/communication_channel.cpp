@@ -46,6 +46,16 @@ using namespace Mash;
 
 const unsigned int DEFAULT_BUFFER_SIZE = 1024;
 
+// Referenced buffers smaller than this are copied into the packet
+const size_t MIN_REFERENCE_SIZE = 4096;
+
+// Maximum number of referenced buffers in a packet (the next ones are copied)
+const unsigned int MAX_REFERENCES = 32;
+
+// Packets bigger than this aren't entirely buffered on reception, their data
+// is read directly into the destination buffers
+const size_t LARGE_PACKET_SIZE = 64 * 1024;
+
 
 /************************* CONSTRUCTION / DESTRUCTION *************************/
 
@@ -163,6 +173,8 @@ void CommunicationChannel::open(tEndPoint endPoint, int writefd, int readfd)
     _pBuffers->write.packet_size    = 0;
     _pBuffers->write.content_size   = 0;
     _pBuffers->write.buffer_size    = DEFAULT_BUFFER_SIZE;
+    _pBuffers->write.pending        = 0;
+    _pBuffers->write.skipped        = 0;
                                     
     _pBuffers->read.data            = new char[DEFAULT_BUFFER_SIZE];
     _pBuffers->read.packet_start    = _pBuffers->read.data;
@@ -170,6 +182,12 @@ void CommunicationChannel::open(tEndPoint endPoint, int writefd, int readfd)
     _pBuffers->read.packet_size     = 0;
     _pBuffers->read.content_size    = 0;
     _pBuffers->read.buffer_size     = DEFAULT_BUFFER_SIZE;
+    _pBuffers->read.pending         = 0;
+    _pBuffers->read.skipped         = 0;
+
+    _pBuffers->timeout              = 0;
+    _pBuffers->statistics           = 0;
+    _pBuffers->bCommandPending      = false;
     
     _outStream << "[PID " << getpid() << "] Communication channel opened as "
                << (endPoint == ENDPOINT_MASTER ? "MASTER" : "SLAVE") << ", using file descriptors "
@@ -198,6 +216,7 @@ void CommunicationChannel::close()
         {
             delete[] _pBuffers->write.data;
             delete[] _pBuffers->read.data;
+            delete _pBuffers->statistics;
             delete _pBuffers;
 
             _outStream << "[PID " << getpid() << "] Communication channel "
@@ -278,6 +297,69 @@ void CommunicationChannel::reallocateBuffer(tBuffer* pBuffer, size_t size)
 }
 
 
+void CommunicationChannel::enableStatistics()
+{
+    // Assertions
+    assert(_pBuffers);
+
+    if (!_pBuffers->statistics)
+        _pBuffers->statistics = new tChannelStatistics();
+}
+
+
+void CommunicationChannel::recordSentPacket(tSandboxMessage message, size_t size)
+{
+    tMessageStatistics* pStatistics = &_pBuffers->statistics->messages[message];
+
+    ++pStatistics->nb_sent;
+    pStatistics->bytes_sent += size;
+
+    // The round trips are measured from the master, for its commands and events
+    if ((_endPoint == ENDPOINT_MASTER) && (message != SANDBOX_MESSAGE_RESPONSE) &&
+        (message != SANDBOX_MESSAGE_ERROR) && (message != SANDBOX_MESSAGE_KEEP_ALIVE))
+    {
+        _pBuffers->command = message;
+        _pBuffers->bCommandPending = true;
+        gettimeofday(&_pBuffers->commandTime, 0);
+    }
+}
+
+
+void CommunicationChannel::recordReceivedPacket(tSandboxMessage message, size_t size)
+{
+    tMessageStatistics* pStatistics = &_pBuffers->statistics->messages[message];
+
+    ++pStatistics->nb_received;
+    pStatistics->bytes_received += size;
+
+    if (!_pBuffers->bCommandPending ||
+        ((message != SANDBOX_MESSAGE_RESPONSE) && (message != SANDBOX_MESSAGE_PONG) &&
+         (message != SANDBOX_MESSAGE_ERROR) && (message != SANDBOX_MESSAGE_UNKNOWN_COMMAND)))
+    {
+        return;
+    }
+
+    struct timeval now, latency;
+    gettimeofday(&now, 0);
+    timersub(&now, &_pBuffers->commandTime, &latency);
+
+    pStatistics = &_pBuffers->statistics->messages[_pBuffers->command];
+
+    struct timeval current = pStatistics->total_latency;
+    timeradd(&current, &latency, &pStatistics->total_latency);
+    ++pStatistics->nb_round_trips;
+
+    unsigned long long microseconds = (unsigned long long) latency.tv_sec * 1000000 + latency.tv_usec;
+    unsigned int bucket = 0;
+    for (microseconds >>= 4; (microseconds > 0) && (bucket < tMessageStatistics::NB_LATENCY_BUCKETS - 1); microseconds >>= 1)
+        ++bucket;
+
+    ++pStatistics->latency_histogram[bucket];
+
+    _pBuffers->bCommandPending = false;
+}
+
+
 void CommunicationChannel::dumpData(char* pData, size_t size, unsigned int nbBytesToDump)
 {
     if (OutStream::verbosityLevel < 5)
@@ -337,15 +419,11 @@ tError CommunicationChannel::startPacket(tSandboxMessage message)
         return _lastError;
 
     // Reset the buffer
-    _pBuffers->write.packet_start   = _pBuffers->write.data;
-    _pBuffers->write.current        = _pBuffers->write.packet_start + sizeof(tPacketHeader);
-    _pBuffers->write.packet_size    = sizeof(tPacketHeader);
-    _pBuffers->write.content_size   = _pBuffers->write.packet_size;
+    resetWriteBuffer();
 
     // Setup the buffer header
     tPacketHeader* pHeader  = (tPacketHeader*) _pBuffers->write.packet_start;
     pHeader->message        = message;
-    pHeader->size           = _pBuffers->write.packet_size;
     
     return ERROR_NONE;
 }
@@ -371,8 +449,10 @@ void CommunicationChannel::add(char* pData, size_t size)
     if (_lastError != ERROR_NONE)
         return;
 
-    if (_pBuffers->write.buffer_size - _pBuffers->write.packet_size < size)
-        reallocateBuffer(&_pBuffers->write, _pBuffers->write.packet_size + size + DEFAULT_BUFFER_SIZE);
+    // Note: the referenced buffers aren't stored in the packet buffer, so only
+    // its content is taken into account here
+    if (_pBuffers->write.buffer_size - _pBuffers->write.content_size < size)
+        reallocateBuffer(&_pBuffers->write, _pBuffers->write.content_size + size + DEFAULT_BUFFER_SIZE);
 
     memcpy(_pBuffers->write.current, pData, size);
     _pBuffers->write.current += size;
@@ -381,6 +461,30 @@ void CommunicationChannel::add(char* pData, size_t size)
 }
 
 
+void CommunicationChannel::addReference(const char* pData, size_t size)
+{
+    // Assertions
+    assert(_pBuffers);
+    
+    if (_lastError != ERROR_NONE)
+        return;
+
+    if ((size < MIN_REFERENCE_SIZE) || (_pBuffers->references.size() >= MAX_REFERENCES))
+    {
+        add((char*) pData, size);
+        return;
+    }
+
+    tReference reference;
+    reference.offset    = _pBuffers->write.content_size;
+    reference.data      = pData;
+    reference.size      = size;
+
+    _pBuffers->references.push_back(reference);
+    _pBuffers->write.packet_size += size;
+}
+
+
 tError CommunicationChannel::sendPacket()
 {
     // Assertions
@@ -399,13 +503,60 @@ tError CommunicationChannel::sendPacket()
     if (pHeader->message != SANDBOX_MESSAGE_KEEP_ALIVE)
     {
         _outStream << "[Channel] Sending packet (" << pHeader->size << " bytes, message = "
-                   << pHeader->message << ")" << endl;
-         dumpData(_pBuffers->write.packet_start, _pBuffers->write.packet_size);
+                   << pHeader->message << ", " << _pBuffers->references.size()
+                   << " referenced buffers)" << endl;
+         dumpData(_pBuffers->write.packet_start, _pBuffers->write.content_size);
+    }
+
+    // Gather the segments of the packet: the parts of the packet buffer,
+    // interleaved with the referenced buffers
+    struct iovec segments[2 * MAX_REFERENCES + 1];
+    unsigned int nbSegments = 0;
+    size_t offset = 0;
+
+    tReferencesList::iterator iter, iterEnd;
+    for (iter = _pBuffers->references.begin(), iterEnd = _pBuffers->references.end();
+         iter != iterEnd; ++iter)
+    {
+        if (iter->offset > offset)
+        {
+            segments[nbSegments].iov_base = _pBuffers->write.packet_start + offset;
+            segments[nbSegments].iov_len  = iter->offset - offset;
+            ++nbSegments;
+            offset = iter->offset;
+        }
+
+        segments[nbSegments].iov_base = (void*) iter->data;
+        segments[nbSegments].iov_len  = iter->size;
+        ++nbSegments;
+    }
+
+    if (_pBuffers->write.content_size > offset)
+    {
+        segments[nbSegments].iov_base = _pBuffers->write.packet_start + offset;
+        segments[nbSegments].iov_len  = _pBuffers->write.content_size - offset;
+        ++nbSegments;
     }
 
     // Send the packet
-    size_t size = _pBuffers->write.packet_size;
-    char* pData = _pBuffers->write.packet_start;
+    if (!writeData(segments, nbSegments))
+        return _lastError;
+
+    if (_pBuffers->statistics && (pHeader->message < SANDBOX_NB_MESSAGES))
+        recordSentPacket(pHeader->message, pHeader->size);
+
+    // Reset the buffer
+    resetWriteBuffer();
+
+    return _lastError;
+}
+
+
+bool CommunicationChannel::writeData(struct iovec* pSegments, unsigned int nbSegments)
+{
+    // Assertions
+    assert(pSegments);
+
     if (_endPoint == ENDPOINT_MASTER)
     {
         fd_set writefds;
@@ -414,7 +565,7 @@ tError CommunicationChannel::sendPacket()
         tv.tv_sec = 1;
         tv.tv_usec = 0;
         
-        while (size > 0)
+        while (nbSegments > 0)
         {
             // Check that the slave is ready to receive more data
             FD_ZERO(&writefds);
@@ -424,57 +575,78 @@ tError CommunicationChannel::sendPacket()
             if (nb == 0)
             {
                 _lastError = ERROR_CHANNEL_SLAVE_TIMEOUT;
-                return _lastError;
+                return false;
             }
             
             if (FD_ISSET(_writefd, &writefds))
             {
                 // Write the data to the pipe. If any error occur, we consider that
                 // the slave died.
-                ssize_t count = write(_writefd, pData, size);
-                if (count > 0)
+                ssize_t count = writev(_writefd, pSegments, nbSegments);
+                if (count <= 0)
                 {
-                    pData += count;
-                    size -= count;
+                    _lastError = ERROR_CHANNEL_SLAVE_CRASHED;
+                    return false;
                 }
-                else
+
+                // Skip the segments that were entirely written
+                while ((nbSegments > 0) && (count >= (ssize_t) pSegments->iov_len))
                 {
-                    _lastError = ERROR_CHANNEL_SLAVE_CRASHED;
-                    return _lastError;
+                    count -= pSegments->iov_len;
+                    ++pSegments;
+                    --nbSegments;
+                }
+
+                if (nbSegments > 0)
+                {
+                    pSegments->iov_base = (char*) pSegments->iov_base + count;
+                    pSegments->iov_len -= count;
                 }
             }
         }
     }
     else
     {
-        while (size > 0)
+        while (nbSegments > 0)
         {
             // Write the data to the pipe. If any error occur, the slave commit
             // suicide.
-            ssize_t count = write(_writefd, pData, size);
-            if (count > 0)
+            ssize_t count = writev(_writefd, pSegments, nbSegments);
+            if (count <= 0)
+                _exit(0);
+
+            // Skip the segments that were entirely written
+            while ((nbSegments > 0) && (count >= (ssize_t) pSegments->iov_len))
             {
-                pData += count;
-                size -= count;
+                count -= pSegments->iov_len;
+                ++pSegments;
+                --nbSegments;
             }
-            else
+
+            if (nbSegments > 0)
             {
-                _exit(0);
+                pSegments->iov_base = (char*) pSegments->iov_base + count;
+                pSegments->iov_len -= count;
             }
         }
     }
 
-    // Reset the buffer
+    return true;
+}
+
+
+void CommunicationChannel::resetWriteBuffer()
+{
     _pBuffers->write.packet_start   = _pBuffers->write.data;
     _pBuffers->write.current        = _pBuffers->write.packet_start + sizeof(tPacketHeader);
     _pBuffers->write.packet_size    = sizeof(tPacketHeader);
     _pBuffers->write.content_size   = _pBuffers->write.packet_size;
 
-    // Setup the buffer header
-    pHeader         = (tPacketHeader*) _pBuffers->write.packet_start;
-    pHeader->size   = _pBuffers->write.packet_size;
+    _pBuffers->references.clear();
 
-    return _lastError;
+    // Setup the buffer header
+    tPacketHeader* pHeader  = (tPacketHeader*) _pBuffers->write.packet_start;
+    pHeader->size           = _pBuffers->write.packet_size;
 }
 
 
@@ -491,6 +663,17 @@ tError CommunicationChannel::receivePacket(tSandboxMessage* message, unsigned in
     if (_lastError != ERROR_NONE)
         return _lastError;
 
+    _pBuffers->timeout = timeout;
+
+    // Discard the end of the previous packet if it wasn't entirely read from
+    // the channel
+    if ((_pBuffers->read.pending > 0) || (_pBuffers->read.skipped > 0))
+    {
+        skipPendingData();
+        if (_lastError != ERROR_NONE)
+            return _lastError;
+    }
+
     // Test if the buffer already contain another packet
     if (_pBuffers->read.packet_start + _pBuffers->read.packet_size - _pBuffers->read.data < _pBuffers->read.content_size)
     {
@@ -514,8 +697,8 @@ tError CommunicationChannel::receivePacket(tSandboxMessage* message, unsigned in
             _pBuffers->read.packet_size = pHeader->size;
         
             // Test if the packet is totally contained in the buffer, otherwise we reallocate the buffer
-            // and retrieve the missing part
-            if (pHeader->size > _pBuffers->read.content_size)
+            // and retrieve the missing part (big packets are read on demand)
+            if ((pHeader->size > _pBuffers->read.content_size) && !deferEndOfPacket())
             {
                 reallocateBuffer(&_pBuffers->read, pHeader->size + DEFAULT_BUFFER_SIZE);
         
@@ -540,6 +723,12 @@ tError CommunicationChannel::receivePacket(tSandboxMessage* message, unsigned in
                 _pBuffers->read.current = _pBuffers->read.packet_start + sizeof(tPacketHeader);
             }
         
+            // Big packets are read on demand
+            else if (deferEndOfPacket())
+            {
+                pHeader = (tPacketHeader*) _pBuffers->read.packet_start;
+            }
+
             // Otherwise we reallocate the buffer, and retrieve the missing part
             else
             {
@@ -576,8 +765,8 @@ tError CommunicationChannel::receivePacket(tSandboxMessage* message, unsigned in
             return _lastError;
 
         // Test if the packet is totally contained in the buffer, otherwise we reallocate the buffer
-        // and retrieve the missing part
-        if (pHeader->size > _pBuffers->read.content_size)
+        // and retrieve the missing part (big packets are read on demand)
+        if ((pHeader->size > _pBuffers->read.content_size) && !deferEndOfPacket())
         {
             reallocateBuffer(&_pBuffers->read, pHeader->size + DEFAULT_BUFFER_SIZE);
 
@@ -600,11 +789,15 @@ tError CommunicationChannel::receivePacket(tSandboxMessage* message, unsigned in
     {
         _outStream << "[Channel] Received packet (" << pHeader->size << " bytes, message = "
                    << pHeader->message << ")" << endl;
-         dumpData(_pBuffers->read.packet_start, _pBuffers->read.packet_size);
+         dumpData(_pBuffers->read.packet_start,
+                  (_pBuffers->read.pending > 0 ? _pBuffers->read.content_size : _pBuffers->read.packet_size));
     }
 
     *message = pHeader->message;
 
+    if (_pBuffers->statistics && (*message < SANDBOX_NB_MESSAGES))
+        recordReceivedPacket(*message, pHeader->size);
+
     _pBuffers->read.current = _pBuffers->read.packet_start + sizeof(tPacketHeader);
 
     return ERROR_NONE;    
@@ -619,9 +812,7 @@ bool CommunicationChannel::endOfPacket() const
     if (_pBuffers->read.buffer_size == 0)
         return true;
 
-    tPacketHeader* pHeader = (tPacketHeader*) _pBuffers->read.packet_start;
-    
-    return (_pBuffers->read.current - _pBuffers->read.packet_start == _pBuffers->read.packet_size);
+    return (_pBuffers->read.skipped + (_pBuffers->read.current - _pBuffers->read.packet_start) == _pBuffers->read.packet_size);
 }
 
 
@@ -661,16 +852,104 @@ bool CommunicationChannel::read(char* pData, size_t size)
     assert(size > 0);
     assert(_pBuffers);
 
-    if ((_pBuffers->read.current - _pBuffers->read.packet_start) + size > _pBuffers->read.packet_size)
+    tBuffer* pBuffer = &_pBuffers->read;
+
+    size_t offset = pBuffer->skipped + (pBuffer->current - pBuffer->packet_start);
+    if (offset + size > pBuffer->packet_size)
         return false;
 
-    memcpy(pData, _pBuffers->read.current, size);
-    _pBuffers->read.current += size;
+    // Test if the data is already in the buffer
+    size_t available = pBuffer->content_size - (pBuffer->current - pBuffer->data);
+    if ((pBuffer->pending == 0) || (size <= available))
+    {
+        memcpy(pData, pBuffer->current, size);
+        pBuffer->current += size;
+        return true;
+    }
+
+    // Copy the part of the data already in the buffer
+    memcpy(pData, pBuffer->current, available);
+    pData += available;
+    size -= available;
+
+    pBuffer->skipped        = offset + available;
+    pBuffer->packet_start   = pBuffer->data;
+    pBuffer->current        = pBuffer->data;
+    pBuffer->content_size   = 0;
+
+    // Big chunks of data are read directly into the destination buffer
+    if (size >= DEFAULT_BUFFER_SIZE)
+    {
+        readData(pData, size, 0, _pBuffers->timeout);
+        if (_lastError != ERROR_NONE)
+            return false;
+
+        pBuffer->pending -= size;
+        pBuffer->skipped += size;
+        return true;
+    }
+
+    // Small ones are read through the buffer
+    size_t nbBytes = min(pBuffer->pending, pBuffer->buffer_size);
+
+    pBuffer->content_size = readData(pBuffer->data, nbBytes, 0, _pBuffers->timeout);
+    if (_lastError != ERROR_NONE)
+        return false;
+
+    pBuffer->pending -= nbBytes;
+
+    memcpy(pData, pBuffer->current, size);
+    pBuffer->current += size;
+
+    return true;
+}
+
+
+bool CommunicationChannel::deferEndOfPacket()
+{
+    tBuffer* pBuffer = &_pBuffers->read;
+    tPacketHeader* pHeader = (tPacketHeader*) pBuffer->packet_start;
+
+    if (pHeader->size <= LARGE_PACKET_SIZE)
+        return false;
+
+    // Move the beginning of the packet at the start of the buffer
+    if (pBuffer->packet_start != pBuffer->data)
+    {
+        pBuffer->content_size -= pBuffer->packet_start - pBuffer->data;
+        memmove(pBuffer->data, pBuffer->packet_start, pBuffer->content_size);
+        pBuffer->packet_start = pBuffer->data;
+    }
+
+    pBuffer->packet_size    = ((tPacketHeader*) pBuffer->packet_start)->size;
+    pBuffer->pending        = pBuffer->packet_size - pBuffer->content_size;
+    pBuffer->skipped        = 0;
 
     return true;
 }
 
 
+void CommunicationChannel::skipPendingData()
+{
+    tBuffer* pBuffer = &_pBuffers->read;
+
+    while ((pBuffer->pending > 0) && (_lastError == ERROR_NONE))
+    {
+        size_t nbBytes = min(pBuffer->pending, pBuffer->buffer_size);
+        readData(pBuffer->data, nbBytes, 0, _pBuffers->timeout);
+        pBuffer->pending -= nbBytes;
+    }
+
+    // The buffer doesn't contain any other packet
+    pBuffer->packet_start   = pBuffer->data;
+    pBuffer->current        = pBuffer->data;
+    pBuffer->packet_size    = 0;
+    pBuffer->content_size   = 0;
+    pBuffer->pending        = 0;
+    pBuffer->skipped        = 0;
+}
+
+
 unsigned int CommunicationChannel::readData(char* pData, size_t size, char* pPacketStart,
                                             unsigned int timeout)
 {
@@ -35,7 +35,10 @@
 #include <mash-utils/declarations.h>
 #include <mash-utils/outstream.h>
 #include "sandbox_messages.h"
+#include "declarations.h"
 #include <string>
+#include <vector>
+#include <sys/uio.h>
 
 
 namespace Mash
@@ -85,12 +88,29 @@ namespace Mash
             size_t          packet_size;
             size_t          content_size;
             size_t          buffer_size;
+            size_t          pending;        ///< (Read only) Bytes of the packet still in the pipe
+            size_t          skipped;        ///< (Read only) Bytes of the packet no longer in the buffer
         };
 
+        struct tReference
+        {
+            size_t          offset;         ///< Position in the buffer at which the data is inserted
+            const char*     data;
+            size_t          size;
+        };
+
+        typedef std::vector<tReference> tReferencesList;
+
         struct tBuffers
         {
             tBuffer         write;
             tBuffer         read;
+            tReferencesList references;     ///< Caller-owned buffers of the packet being written
+            unsigned int    timeout;        ///< Timeout of the packet being read
+            tChannelStatistics* statistics; ///< Statistics about the messages (0 if disabled)
+            tSandboxMessage command;        ///< Last command sent by the master, waiting for a response
+            struct timeval  commandTime;    ///< Time at which that command was sent
+            bool            bCommandPending;
             unsigned int    refCounter;
         };
 
@@ -193,9 +213,29 @@ namespace Mash
         {
             return _lastError;
         }
+
+        //----------------------------------------------------------------------
+        /// @brief  Enable the collection of statistics about the messages
+        ///         exchanged through the channel
+        ///
+        /// The statistics are shared by all the copies of the channel
+        //----------------------------------------------------------------------
+        void enableStatistics();
+
+        //----------------------------------------------------------------------
+        /// @brief  Returns the statistics about the messages exchanged through
+        ///         the channel (0 if not enabled)
+        //----------------------------------------------------------------------
+        inline const tChannelStatistics* statistics() const
+        {
+            return (_pBuffers ? _pBuffers->statistics : 0);
+        }
     
     private:
         void reallocateBuffer(tBuffer* pBuffer, size_t size);
+        void resetWriteBuffer();
+        void recordSentPacket(tSandboxMessage message, size_t size);
+        void recordReceivedPacket(tSandboxMessage message, size_t size);
         void dumpData(char* pData, size_t size, unsigned int nbBytesToDump=320);
 
 
@@ -308,12 +348,28 @@ namespace Mash
         //----------------------------------------------------------------------
         void add(char* pData, size_t size);
 
+        //----------------------------------------------------------------------
+        /// @brief  Add a reference to a buffer of data to the packet
+        ///
+        /// Unlike add(), the data isn't copied into the packet: the buffer
+        /// must remain valid (and unchanged) until sendPacket() returns. The
+        /// packet is then sent with one call to writev(). Small buffers are
+        /// copied anyway.
+        ///
+        /// @param  pData   The buffer
+        /// @param  size    Number of bytes in the buffer
+        //----------------------------------------------------------------------
+        void addReference(const char* pData, size_t size);
+
         //----------------------------------------------------------------------
         /// @brief  Send the packet
         /// @return An error code
         //----------------------------------------------------------------------
         tError sendPacket();
 
+    private:
+        bool writeData(struct iovec* pSegments, unsigned int nbSegments);
+
 
         //_____ Data reception __________
     public:
@@ -423,6 +479,10 @@ namespace Mash
         //----------------------------------------------------------------------
         /// @brief  Read a buffer of data from the packet
         ///
+        /// The big packets aren't entirely buffered by receivePacket(): when
+        /// the requested data isn't in the buffer, it is read from the channel
+        /// directly into the destination buffer.
+        ///
         /// @param  pData   The buffer
         /// @param  size    Number of bytes in the buffer
         //----------------------------------------------------------------------
@@ -431,6 +491,8 @@ namespace Mash
     private:
         unsigned int readData(char* pData, size_t size, char* pPacketStart,
                               unsigned int timeout);
+        bool deferEndOfPacket();
+        void skipPendingData();
 
 
         //_____ Attributes __________
@@ -0,0 +1,149 @@
+/*******************************************************************************
+* The MASH Framework contains the source code of all the servers in the
+* "computation farm" of the MASH project (http://www.mash-project.eu),
+* developed at the Idiap Research Institute (http://www.idiap.ch).
+*
+* Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+* Written by Philip Abbet (philip.abbet@idiap.ch)
+*
+* This file is part of the MASH Framework.
+*
+* The MASH Framework is free software: you can redistribute it and/or modify
+* it under the terms of either the GNU General Public License version 2 or
+* the GNU General Public License version 3 as published by the Free
+* Software Foundation, whichever suits the most your needs.
+*
+* The MASH Framework is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public Licenses
+* along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+/** @file   context_recorder.cpp
+    @author Philip Abbet (philip.abbet@idiap.ch)
+
+    Implementation of the 'ContextRecorder' class
+*/
+
+#include "context_recorder.h"
+#include <sstream>
+#include <stdio.h>
+#include <string.h>
+
+using namespace std;
+using namespace Mash;
+
+
+/************************* CONSTRUCTION / DESTRUCTION *************************/
+
+ContextRecorder::ContextRecorder()
+: _current(NB_ENTRIES - 1), _nbEntries(0)
+{
+    for (unsigned int i = 0; i < NB_ENTRIES; ++i)
+    {
+        _entries[i].strMethod = 0;
+        _entries[i].nbParameters = 0;
+    }
+}
+
+
+ContextRecorder::~ContextRecorder()
+{
+}
+
+
+/********************************** METHODS ***********************************/
+
+void ContextRecorder::addDetails(const std::string& strDetails)
+{
+    if (_nbEntries > 0)
+        _entries[_current].strDetails += strDetails;
+}
+
+
+void ContextRecorder::clear()
+{
+    _current = NB_ENTRIES - 1;
+    _nbEntries = 0;
+}
+
+
+std::string ContextRecorder::toString() const
+{
+    if (_nbEntries == 0)
+        return "";
+
+    ostringstream str;
+
+    // Full description of the last call
+    const tEntry& last = _entries[_current];
+
+    str << "Method: " << last.strMethod << endl;
+
+    if ((last.nbParameters > 0) || !last.strDetails.empty())
+        str << "Parameters:" << endl;
+
+    size_t labelsLength = 0;
+    for (unsigned int i = 0; i < last.nbParameters; ++i)
+    {
+        if (last.parameters[i].strFormat)
+            labelsLength = max(labelsLength, strlen(last.parameters[i].strLabel));
+    }
+
+    for (unsigned int i = 0; i < last.nbParameters; ++i)
+    {
+        const tParameter& parameter = last.parameters[i];
+
+        str << "    - " << parameter.strLabel;
+
+        if (parameter.strFormat)
+        {
+            str << ":" << string(labelsLength - strlen(parameter.strLabel) + 1, ' ')
+                << formatValue(parameter);
+        }
+
+        str << endl;
+    }
+
+    str << last.strDetails;
+
+    // Summary of the previous ones
+    if (_nbEntries > 1)
+        str << "Previous calls (most recent first):" << endl;
+
+    for (unsigned int n = 1; n < _nbEntries; ++n)
+    {
+        const tEntry& entry = _entries[(_current + NB_ENTRIES - n) % NB_ENTRIES];
+
+        str << "    - " << entry.strMethod;
+
+        for (unsigned int i = 0; i < entry.nbParameters; ++i)
+        {
+            const tParameter& parameter = entry.parameters[i];
+
+            str << (i == 0 ? " (" : ", ") << parameter.strLabel;
+
+            if (parameter.strFormat)
+                str << ": " << formatValue(parameter);
+        }
+
+        str << (entry.nbParameters > 0 ? ")" : "") << endl;
+    }
+
+    return str.str();
+}
+
+
+std::string ContextRecorder::formatValue(const tParameter& parameter) const
+{
+    char buffer[64];
+
+    snprintf(buffer, sizeof(buffer), parameter.strFormat, parameter.values[0], parameter.values[1]);
+
+    return buffer;
+}
@@ -0,0 +1,185 @@
+/*******************************************************************************
+* The MASH Framework contains the source code of all the servers in the
+* "computation farm" of the MASH project (http://www.mash-project.eu),
+* developed at the Idiap Research Institute (http://www.idiap.ch).
+*
+* Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+* Written by Philip Abbet (philip.abbet@idiap.ch)
+*
+* This file is part of the MASH Framework.
+*
+* The MASH Framework is free software: you can redistribute it and/or modify
+* it under the terms of either the GNU General Public License version 2 or
+* the GNU General Public License version 3 as published by the Free
+* Software Foundation, whichever suits the most your needs.
+*
+* The MASH Framework is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public Licenses
+* along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+/** @file   context_recorder.h
+    @author Philip Abbet (philip.abbet@idiap.ch)
+
+    Declaration of the 'ContextRecorder' class
+*/
+
+#ifndef _MASH_CONTEXTRECORDER_H_
+#define _MASH_CONTEXTRECORDER_H_
+
+#include <mash-utils/declarations.h>
+#include <string>
+
+
+namespace Mash
+{
+    //--------------------------------------------------------------------------
+    /// @brief  Records the last calls made to a sandboxed object, in order to
+    ///         report them if the sandbox crashes
+    ///
+    /// The calls are stored in a fixed-size ring, using only plain stores (the
+    /// labels and formats must be string literals). They are converted into a
+    /// human-readable text only when requested, by toString().
+    //--------------------------------------------------------------------------
+    class MASH_SYMBOL ContextRecorder
+    {
+        //_____ Internal types __________
+    public:
+        static const unsigned int NB_ENTRIES        = 8;
+        static const unsigned int MAX_PARAMETERS    = 10;
+
+    private:
+        struct tParameter
+        {
+            const char* strLabel;
+            const char* strFormat;  ///< printf-like format of the values (up to two
+                                    ///  integers), 0 if the parameter has no value
+            int         values[2];
+        };
+
+        struct tEntry
+        {
+            const char*     strMethod;
+            unsigned int    nbParameters;
+            tParameter      parameters[MAX_PARAMETERS];
+            std::string     strDetails;     ///< Additional lines (only used by rare calls)
+        };
+
+
+        //_____ Construction / Destruction __________
+    public:
+        //----------------------------------------------------------------------
+        /// @brief  Constructor
+        //----------------------------------------------------------------------
+        ContextRecorder();
+
+        //----------------------------------------------------------------------
+        /// @brief  Destructor
+        //----------------------------------------------------------------------
+        ~ContextRecorder();
+
+
+        //_____ Methods __________
+    public:
+        //----------------------------------------------------------------------
+        /// @brief  Record a new call (replaces the oldest one)
+        ///
+        /// @param  strMethod   Name of the method (string literal)
+        //----------------------------------------------------------------------
+        inline void record(const char* strMethod)
+        {
+            _current = (_current + 1) % NB_ENTRIES;
+
+            if (_nbEntries < NB_ENTRIES)
+                ++_nbEntries;
+
+            tEntry& entry = _entries[_current];
+            entry.strMethod = strMethod;
+            entry.nbParameters = 0;
+
+            if (!entry.strDetails.empty())
+                entry.strDetails.clear();
+        }
+
+        //----------------------------------------------------------------------
+        /// @brief  Add a parameter to the last recorded call
+        ///
+        /// @param  strLabel    Label of the parameter (string literal)
+        /// @param  strFormat   printf-like format of the values (string literal,
+        ///                     up to two integers), 0 if there is no value
+        /// @param  value1      First value
+        /// @param  value2      Second value
+        //----------------------------------------------------------------------
+        inline void addParameter(const char* strLabel, const char* strFormat = 0,
+                                 int value1 = 0, int value2 = 0)
+        {
+            tEntry& entry = _entries[_current];
+
+            if ((_nbEntries == 0) || (entry.nbParameters >= MAX_PARAMETERS))
+                return;
+
+            tParameter& parameter = entry.parameters[entry.nbParameters];
+            parameter.strLabel  = strLabel;
+            parameter.strFormat = strFormat;
+            parameter.values[0] = value1;
+            parameter.values[1] = value2;
+
+            ++entry.nbParameters;
+        }
+
+        //----------------------------------------------------------------------
+        /// @brief  Add some free-form lines to the last recorded call
+        ///
+        /// Intended for the calls that aren't done often (they need a copy of
+        /// the text)
+        //----------------------------------------------------------------------
+        void addDetails(const std::string& strDetails);
+
+        //----------------------------------------------------------------------
+        /// @brief  Forget all the recorded calls
+        //----------------------------------------------------------------------
+        void clear();
+
+        //----------------------------------------------------------------------
+        /// @brief  Indicates if no call was recorded
+        //----------------------------------------------------------------------
+        inline bool empty() const
+        {
+            return (_nbEntries == 0);
+        }
+
+        //----------------------------------------------------------------------
+        /// @brief  Returns the number of recorded calls
+        //----------------------------------------------------------------------
+        inline unsigned int nbEntries() const
+        {
+            return _nbEntries;
+        }
+
+        //----------------------------------------------------------------------
+        /// @brief  Returns a human-readable description of the recorded calls
+        ///
+        /// The last call is fully described, the previous ones are summarized
+        /// (most recent first)
+        //----------------------------------------------------------------------
+        std::string toString() const;
+
+    private:
+        std::string formatValue(const tParameter& parameter) const;
+
+
+        //_____ Attributes __________
+    private:
+        tEntry          _entries[NB_ENTRIES];
+        unsigned int    _current;       ///< Index of the last recorded call
+        unsigned int    _nbEntries;     ///< Number of recorded calls
+    };
+}
+
+#endif
@@ -32,7 +32,9 @@
 #ifndef _MASHSANDBOXING_DECLARATIONS_H_
 #define _MASHSANDBOXING_DECLARATIONS_H_
 
+#include "sandbox_messages.h"
 #include <sys/time.h>
+#include <memory.h>
 
 
 #ifndef MASH_CORE_DUMP_TEMPLATE
@@ -50,7 +52,7 @@ namespace Mash
         tSandboxConfiguration()
         : verbosity(0), strCoreDumpTemplate(MASH_CORE_DUMP_TEMPLATE), strUsername(""), strJailDir("jail/"),
           strLogDir("logs/"), strOutputDir("out/"), strScriptsDir("./"), strTempDir("./"),
-          strSourceDir(""), bDeleteAllLogFiles(true)
+          strSourceDir(""), bDeleteAllLogFiles(true), sharedFeaturesFd(-1), bSeccomp(false)
         {
         }
 
@@ -64,6 +66,11 @@ namespace Mash
         std::string     strTempDir;             ///< The temporary directory for the sandbox
         std::string     strSourceDir;           ///< Directory containing the source code of the untrusted plugins
         bool            bDeleteAllLogFiles;     ///< Indicates if all the log files must be deleted at shutdown
+        int             sharedFeaturesFd;       ///< File descriptor of the shared features buffer to give
+                                                ///  to the sandbox (-1 if none, read-only for the
+                                                ///  classifiers)
+        bool            bSeccomp;               ///< Indicates if the sandbox must be confined by a system
+                                                ///  call filter once the plugins are loaded (Linux only)
     };
 
 
@@ -162,6 +169,45 @@ namespace Mash
         tStatisticsEntry            features;
         struct timeval              total_duration;
     };
+
+
+    //--------------------------------------------------------------------------
+    /// @brief  Contains the statistics about one type of message exchanged
+    ///         through a communication channel
+    ///
+    /// The round trips are measured on the master side, from the sending of
+    /// a command (or event) to the reception of the corresponding response.
+    //--------------------------------------------------------------------------
+    struct tMessageStatistics
+    {
+        static const unsigned int NB_LATENCY_BUCKETS = 16;
+
+        tMessageStatistics()
+        : nb_sent(0), bytes_sent(0), nb_received(0), bytes_received(0), nb_round_trips(0)
+        {
+            timerclear(&total_latency);
+            memset(latency_histogram, 0, sizeof(latency_histogram));
+        }
+
+        unsigned int        nb_sent;
+        unsigned long long  bytes_sent;
+        unsigned int        nb_received;
+        unsigned long long  bytes_received;
+        unsigned int        nb_round_trips;
+        struct timeval      total_latency;
+        unsigned int        latency_histogram[NB_LATENCY_BUCKETS];  ///< Bucket i: latencies below 2^(i+4) microseconds
+                                                                    ///  (the last one also contains the longer ones)
+    };
+
+
+    //--------------------------------------------------------------------------
+    /// @brief  Contains the statistics about all the messages exchanged
+    ///         through a communication channel
+    //--------------------------------------------------------------------------
+    struct tChannelStatistics
+    {
+        tMessageStatistics messages[SANDBOX_NB_MESSAGES];
+    };
 }
 
 #endif
@@ -45,6 +45,7 @@
 #include <sys/wait.h>
 #include <vector>
 #include <fstream>
+#include <sstream>
 #include <errno.h>
 
 
@@ -147,7 +148,8 @@ bool SandboxController::createSandbox(tPluginType pluginType,
         // stdout, stderr and stdin!)
         for (int i = 3; i < getdtablesize(); ++i)
         {
-            if ((i != slave.writefd()) && (i != slave.readfd()))
+            if ((i != slave.writefd()) && (i != slave.readfd()) &&
+                (i != _configuration.sharedFeaturesFd))
                 close(i);
         }
 
@@ -171,6 +173,12 @@ bool SandboxController::createSandbox(tPluginType pluginType,
         if (!_configuration.strJailDir.empty())
             vargs.push_back("--jailfolder=" + _configuration.strJailDir);
 
+        if (_configuration.sharedFeaturesFd >= 0)
+            vargs.push_back("--featuresfd=" + StringUtils::toString(_configuration.sharedFeaturesFd));
+
+        if (_configuration.bSeccomp)
+            vargs.push_back("--seccomp");
+
         if (_configuration.verbosity == 1)
             vargs.push_back("-v");
         else if (_configuration.verbosity == 2)
@@ -242,6 +250,8 @@ bool SandboxController::createSandbox(tPluginType pluginType,
     _channel = master;
     master.close();
 
+    _channel.enableStatistics();
+
     // Don't assign an output stream to the channel if not specifically asked to do so
     if (_configuration.verbosity >= 4)
     {
@@ -396,6 +406,52 @@ bool SandboxController::ping()
 }
 
 
+std::string SandboxController::getStatisticsReport() const
+{
+    const tChannelStatistics* pStatistics = _channel.statistics();
+    if (!pStatistics)
+        return "";
+
+    ostringstream str;
+
+    for (unsigned int i = 0; i < SANDBOX_NB_MESSAGES; ++i)
+    {
+        const tMessageStatistics& message = pStatistics->messages[i];
+
+        if ((message.nb_sent == 0) && (message.nb_received == 0))
+            continue;
+
+        struct timeval mean_latency;
+        timerclear(&mean_latency);
+
+        if (message.nb_round_trips > 0)
+        {
+            unsigned long long microseconds = ((unsigned long long) message.total_latency.tv_sec * 1000000 +
+                                               message.total_latency.tv_usec) / message.nb_round_trips;
+            mean_latency.tv_sec = microseconds / 1000000;
+            mean_latency.tv_usec = microseconds % 1000000;
+        }
+
+        str << "MESSAGE " << i << endl
+            << "SENT_COUNT " << message.nb_sent << endl
+            << "SENT_BYTES " << message.bytes_sent << endl
+            << "RECEIVED_COUNT " << message.nb_received << endl
+            << "RECEIVED_BYTES " << message.bytes_received << endl
+            << "ROUND_TRIPS_COUNT " << message.nb_round_trips << endl
+            << "ROUND_TRIPS_TOTAL_DURATION " << StringUtils::toString(message.total_latency) << endl
+            << "ROUND_TRIPS_MEAN_DURATION " << StringUtils::toString(mean_latency) << endl
+            << "ROUND_TRIPS_HISTOGRAM";
+
+        for (unsigned int j = 0; j < tMessageStatistics::NB_LATENCY_BUCKETS; ++j)
+            str << " " << message.latency_histogram[j];
+
+        str << endl;
+    }
+
+    return str.str();
+}
+
+
 std::string SandboxController::getStackTrace()
 {
     // Check that the core dump file exists
@@ -219,6 +219,22 @@ namespace Mash
         //----------------------------------------------------------------------
         std::string getStackTrace();
 
+        //----------------------------------------------------------------------
+        /// @brief  Returns the statistics about the messages exchanged with the
+        ///         sandbox (0 if no sandbox was created)
+        //----------------------------------------------------------------------
+        inline const tChannelStatistics* getStatistics() const
+        {
+            return _channel.statistics();
+        }
+
+        //----------------------------------------------------------------------
+        /// @brief  Returns a report of the statistics about the messages
+        ///         exchanged with the sandbox (one entry per type of message
+        ///         used)
+        //----------------------------------------------------------------------
+        std::string getStatisticsReport() const;
+
         //----------------------------------------------------------------------
         /// @brief  Add infos about a log file
         //----------------------------------------------------------------------
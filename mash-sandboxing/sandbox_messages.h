@@ -142,6 +142,17 @@ namespace Mash
         SANDBOX_MESSAGE_CURRENT_INSTRUMENT,
 
         SANDBOX_NOTIFICATION_TRAINING_STEP_DONE,                        // 85
+
+        SANDBOX_COMMAND_HEURISTIC_COMPUTE_SOME_FEATURES_SHARED,
+        SANDBOX_COMMAND_INPUT_SET_COMPUTE_SOME_FEATURES_SHARED,
+
+        SANDBOX_COMMAND_CLASSIFIER_CLASSIFY_BATCH,
+
+        SANDBOX_EVENT_INSTRUMENTS_FEATURES_COMPUTED_BY_CLASSIFIER_BATCH,
+
+        SANDBOX_COMMAND_INSTRUMENT_EVENTS,                              // 90
+
+        SANDBOX_NB_MESSAGES                                             // Must be the last one
     };
 }
 
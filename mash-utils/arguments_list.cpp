@@ -93,6 +93,17 @@ void ArgumentsList::add(const std::string& value)
 }
 
 
+void ArgumentsList::add(const char* value, unsigned int length)
+{
+    // Assertions
+    assert(value);
+    assert(length > 0);
+
+    _arguments.push_back(std::string());
+    _arguments.back().assign(value, length);
+}
+
+
 void ArgumentsList::add(int value)
 {
     _arguments.push_back(StringUtils::toString(value));
@@ -111,7 +122,7 @@ void ArgumentsList::add(const struct timeval& value)
 }
 
 
-std::string ArgumentsList::getString(unsigned int index) const
+const std::string& ArgumentsList::getString(unsigned int index) const
 {
     // Assertions
     assert(index < _arguments.size());
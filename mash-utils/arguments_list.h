@@ -90,6 +90,12 @@ namespace Mash
         //----------------------------------------------------------------------
         void add(const std::string& value);
 
+        //----------------------------------------------------------------------
+        /// @brief  Add a string argument directly from a memory buffer (like
+        ///         the reception buffer of a socket)
+        //----------------------------------------------------------------------
+        void add(const char* value, unsigned int length);
+
         //----------------------------------------------------------------------
         /// @brief  Add an integer argument to the list
         //----------------------------------------------------------------------
@@ -108,7 +114,7 @@ namespace Mash
         //----------------------------------------------------------------------
         /// @brief  Returns one of the argument as a string
         //----------------------------------------------------------------------
-        std::string getString(unsigned int index) const;
+        const std::string& getString(unsigned int index) const;
 
         //----------------------------------------------------------------------
         /// @brief  Returns one of the argument as an integer
@@ -0,0 +1,303 @@
+/*******************************************************************************
+* The MASH Framework contains the source code of all the servers in the
+* "computation farm" of the MASH project (http://www.mash-project.eu),
+* developed at the Idiap Research Institute (http://www.idiap.ch).
+*
+* Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+* Written by Philip Abbet (philip.abbet@idiap.ch)
+*
+* This file is part of the MASH Framework.
+*
+* The MASH Framework is free software: you can redistribute it and/or modify
+* it under the terms of either the GNU General Public License version 2 or
+* the GNU General Public License version 3 as published by the Free
+* Software Foundation, whichever suits the most your needs.
+*
+* The MASH Framework is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public Licenses
+* along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+/** @file   compression.cpp
+    @author Philip Abbet (philip.abbet@idiap.ch)
+
+    Implementation of the class 'Compression'
+*/
+
+#include "compression.h"
+#include <vector>
+#include <string.h>
+
+using namespace std;
+using namespace Mash;
+
+
+/********************************** CONSTANTS *********************************/
+
+// Parameters of the LZ4 block format
+const unsigned int MIN_MATCH        = 4;     // Minimum length of a match
+const unsigned int LAST_LITERALS    = 5;     // The last bytes are always literals
+const unsigned int MF_LIMIT         = 12;    // No match can start in the last bytes
+const unsigned int MAX_OFFSET       = 65535;
+const unsigned int RUN_MASK         = 15;
+
+// Size of the hash table used to find the matches
+const unsigned int HASH_LOG         = 14;
+
+
+/****************************** UTILITY FUNCTIONS *****************************/
+
+static inline unsigned int read32(const unsigned char* p)
+{
+    unsigned int value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+
+static inline unsigned int hash32(unsigned int value)
+{
+    return (value * 2654435761U) >> (32 - HASH_LOG);
+}
+
+
+static inline unsigned char* writeLength(unsigned char* pDest, unsigned int length)
+{
+    while (length >= 255)
+    {
+        *pDest++ = 255;
+        length -= 255;
+    }
+
+    *pDest++ = (unsigned char) length;
+    return pDest;
+}
+
+
+static inline bool readLength(const unsigned char** pSource, const unsigned char* pEnd,
+                              unsigned int* length)
+{
+    unsigned char value;
+
+    do
+    {
+        if (*pSource >= pEnd)
+            return false;
+
+        value = *(*pSource)++;
+        *length += value;
+    }
+    while (value == 255);
+
+    return true;
+}
+
+
+/******************************* STATIC METHODS *******************************/
+
+unsigned int Compression::compressBound(unsigned int size)
+{
+    return size + size / 255 + 16;
+}
+
+
+unsigned int Compression::compress(const unsigned char* pSource, unsigned int size,
+                                   unsigned char* pDest, unsigned int capacity)
+{
+    // Declarations
+    const unsigned char* ip     = pSource;
+    const unsigned char* anchor = pSource;
+    const unsigned char* iend   = pSource + size;
+    unsigned char* op           = pDest;
+    unsigned char* oend         = pDest + capacity;
+
+    if (size >= MF_LIMIT + 1)
+    {
+        const unsigned char* mflimit    = iend - MF_LIMIT;
+        const unsigned char* matchlimit = iend - LAST_LITERALS;
+
+        vector<int> table(1 << HASH_LOG, -1);
+
+        while (ip < mflimit)
+        {
+            unsigned int sequence = read32(ip);
+            unsigned int h = hash32(sequence);
+            int ref = table[h];
+
+            table[h] = (int) (ip - pSource);
+
+            if ((ref < 0) || ((unsigned int) (ip - pSource - ref) > MAX_OFFSET) ||
+                (read32(pSource + ref) != sequence))
+            {
+                // Skip faster over the incompressible parts
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+            }
+
+            const unsigned char* match = pSource + ref;
+
+            // Extend the match
+            unsigned int matchLength = MIN_MATCH;
+            while ((ip + matchLength < matchlimit) && (match[matchLength] == ip[matchLength]))
+                ++matchLength;
+
+            // Write the sequence: token, literals, offset and match length
+            unsigned int literalsLength = (unsigned int) (ip - anchor);
+
+            if (op + 1 + literalsLength + literalsLength / 255 + 1 + 2 + matchLength / 255 + 1 > oend)
+                return 0;
+
+            unsigned char* token = op++;
+
+            if (literalsLength >= RUN_MASK)
+            {
+                *token = (unsigned char) (RUN_MASK << 4);
+                op = writeLength(op, literalsLength - RUN_MASK);
+            }
+            else
+            {
+                *token = (unsigned char) (literalsLength << 4);
+            }
+
+            memcpy(op, anchor, literalsLength);
+            op += literalsLength;
+
+            unsigned int offset = (unsigned int) (ip - match);
+            *op++ = (unsigned char) (offset & 0xFF);
+            *op++ = (unsigned char) (offset >> 8);
+
+            if (matchLength - MIN_MATCH >= RUN_MASK)
+            {
+                *token |= RUN_MASK;
+                op = writeLength(op, matchLength - MIN_MATCH - RUN_MASK);
+            }
+            else
+            {
+                *token |= (unsigned char) (matchLength - MIN_MATCH);
+            }
+
+            ip += matchLength;
+            anchor = ip;
+
+            // Help the next search
+            if (ip < mflimit)
+                table[hash32(read32(ip - 2))] = (int) (ip - 2 - pSource);
+        }
+    }
+
+    // Write the last literals
+    unsigned int literalsLength = (unsigned int) (iend - anchor);
+
+    if (op + 1 + literalsLength + literalsLength / 255 + 1 > oend)
+        return 0;
+
+    if (literalsLength >= RUN_MASK)
+    {
+        *op++ = (unsigned char) (RUN_MASK << 4);
+        op = writeLength(op, literalsLength - RUN_MASK);
+    }
+    else
+    {
+        *op++ = (unsigned char) (literalsLength << 4);
+    }
+
+    memcpy(op, anchor, literalsLength);
+    op += literalsLength;
+
+    return (unsigned int) (op - pDest);
+}
+
+
+bool Compression::decompress(const unsigned char* pSource, unsigned int size,
+                             unsigned char* pDest, unsigned int destSize)
+{
+    // Declarations
+    const unsigned char* ip     = pSource;
+    const unsigned char* iend   = pSource + size;
+    unsigned char* op           = pDest;
+    unsigned char* oend         = pDest + destSize;
+
+    while (ip < iend)
+    {
+        unsigned int token = *ip++;
+
+        // Literals
+        unsigned int literalsLength = token >> 4;
+        if ((literalsLength == RUN_MASK) && !readLength(&ip, iend, &literalsLength))
+            return false;
+
+        if ((literalsLength > (unsigned int) (iend - ip)) ||
+            (literalsLength > (unsigned int) (oend - op)))
+        {
+            return false;
+        }
+
+        memcpy(op, ip, literalsLength);
+        ip += literalsLength;
+        op += literalsLength;
+
+        // The last sequence only contains literals
+        if (ip == iend)
+            break;
+
+        // Match
+        if (iend - ip < 2)
+            return false;
+
+        unsigned int offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+
+        if ((offset == 0) || (offset > (unsigned int) (op - pDest)))
+            return false;
+
+        unsigned int matchLength = token & RUN_MASK;
+        if ((matchLength == RUN_MASK) && !readLength(&ip, iend, &matchLength))
+            return false;
+
+        matchLength += MIN_MATCH;
+
+        if (matchLength > (unsigned int) (oend - op))
+            return false;
+
+        const unsigned char* match = op - offset;
+
+        if (offset >= matchLength)
+        {
+            memcpy(op, match, matchLength);
+            op += matchLength;
+        }
+        else
+        {
+            // Overlapping copy (repeated pattern)
+            for (unsigned int i = 0; i < matchLength; ++i)
+                *op++ = *match++;
+        }
+    }
+
+    return (op == oend);
+}
+
+
+void Compression::xorBuffers(unsigned char* pData, const unsigned char* pReference,
+                             unsigned int size)
+{
+    unsigned int i = 0;
+
+    for (; i + sizeof(unsigned int) <= size; i += sizeof(unsigned int))
+    {
+        unsigned int a, b;
+        memcpy(&a, pData + i, sizeof(a));
+        memcpy(&b, pReference + i, sizeof(b));
+        a ^= b;
+        memcpy(pData + i, &a, sizeof(a));
+    }
+
+    for (; i < size; ++i)
+        pData[i] ^= pReference[i];
+}
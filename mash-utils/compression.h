@@ -0,0 +1,104 @@
+/*******************************************************************************
+* The MASH Framework contains the source code of all the servers in the
+* "computation farm" of the MASH project (http://www.mash-project.eu),
+* developed at the Idiap Research Institute (http://www.idiap.ch).
+*
+* Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+* Written by Philip Abbet (philip.abbet@idiap.ch)
+*
+* This file is part of the MASH Framework.
+*
+* The MASH Framework is free software: you can redistribute it and/or modify
+* it under the terms of either the GNU General Public License version 2 or
+* the GNU General Public License version 3 as published by the Free
+* Software Foundation, whichever suits the most your needs.
+*
+* The MASH Framework is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public Licenses
+* along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+/** @file   compression.h
+    @author Philip Abbet (philip.abbet@idiap.ch)
+
+    Declaration of the class 'Compression'
+*/
+
+#ifndef _MASH_COMPRESSION_H_
+#define _MASH_COMPRESSION_H_
+
+#include "declarations.h"
+
+
+namespace Mash
+{
+    //--------------------------------------------------------------------------
+    /// @brief  Fast compression of buffers
+    ///
+    /// The compressed data uses the LZ4 block format (no frame header): the
+    /// size of the uncompressed data must be transmitted by other means. The
+    /// compression favors speed over ratio, and the decompression is safe
+    /// against malformed inputs.
+    //--------------------------------------------------------------------------
+    class MASH_SYMBOL Compression
+    {
+    public:
+        //----------------------------------------------------------------------
+        /// @brief  Returns the maximum size of the compressed version of a
+        ///         buffer (incompressible data)
+        ///
+        /// @param  size    Size of the uncompressed data, in bytes
+        /// @return         Maximum size of the compressed data, in bytes
+        //----------------------------------------------------------------------
+        static unsigned int compressBound(unsigned int size);
+
+        //----------------------------------------------------------------------
+        /// @brief  Compress a buffer
+        ///
+        /// @param  pSource         The data to compress
+        /// @param  size            Size of the data, in bytes
+        /// @param  pDest           The destination buffer
+        /// @param  capacity        Size of the destination buffer, in bytes
+        ///                         (compressBound(size) is always enough)
+        /// @return                 Size of the compressed data, 0 if the
+        ///                         destination buffer is too small
+        //----------------------------------------------------------------------
+        static unsigned int compress(const unsigned char* pSource, unsigned int size,
+                                     unsigned char* pDest, unsigned int capacity);
+
+        //----------------------------------------------------------------------
+        /// @brief  Decompress a buffer
+        ///
+        /// @param  pSource         The compressed data
+        /// @param  size            Size of the compressed data, in bytes
+        /// @param  pDest           The destination buffer
+        /// @param  destSize        Exact size of the uncompressed data, in
+        ///                         bytes
+        /// @return                 'false' if the compressed data is invalid
+        //----------------------------------------------------------------------
+        static bool decompress(const unsigned char* pSource, unsigned int size,
+                               unsigned char* pDest, unsigned int destSize);
+
+        //----------------------------------------------------------------------
+        /// @brief  Combine a buffer with another one using XOR, in place
+        ///
+        /// Used to transmit the difference between two similar buffers: the
+        /// result contains long runs of zeros, which compress well, and is
+        /// reverted by applying the same operation again.
+        ///
+        /// @param  pData           The buffer to modify
+        /// @param  pReference      The other buffer
+        /// @param  size            Size of both buffers, in bytes
+        //----------------------------------------------------------------------
+        static void xorBuffers(unsigned char* pData, const unsigned char* pReference,
+                               unsigned int size);
+    };
+}
+
+#endif
@@ -293,6 +293,39 @@ int64_t OutStream::dump(unsigned char** pBuffer, int64_t max_size)
 }
 
 
+int64_t OutStream::locateDump(int64_t* pOffset, int64_t max_size)
+{
+    if (!pOffset || !_pStream || _pStream->strFileName.empty() || !_pStream->bCanReopen)
+        return 0;
+
+    *pOffset = 0;
+
+    ifstream inFile;
+    inFile.open(_pStream->strFileName.c_str());
+    if (!inFile.is_open())
+        return 0;
+
+    inFile.seekg(0, ios_base::end);
+    int64_t size = inFile.tellg();
+
+    inFile.close();
+
+    if (size <= 0)
+        return 0;
+
+    if ((max_size > 0) && (max_size < 100))
+        max_size = 100;
+
+    if ((max_size > 0) && (size > max_size))
+    {
+        *pOffset = size - (max_size - 4);
+        size = max_size - 4;
+    }
+
+    return size;
+}
+
+
 void OutStream::operator=(const OutStream& ref)
 {
     if (_pStream)
@@ -112,6 +112,20 @@ namespace Mash
         /// @return                 Size of the buffer, 0 if failed
         //----------------------------------------------------------------------
         int64_t dump(unsigned char** pBuffer, int64_t max_size = 0);
+
+        //----------------------------------------------------------------------
+        /// @brief  Locate the part of the log file that dump() would return,
+        ///         without reading it
+        ///
+        /// @param[out] pOffset     Offset of the first byte of the file to
+        ///                         read. If greater than 0, the beginning of
+        ///                         the file is ignored, and dump() would put
+        ///                         '...\n' in front of the returned bytes
+        /// @param[in]  max_size    See dump()
+        /// @return                 Number of bytes of the file to read, 0 if
+        ///                         failed
+        //----------------------------------------------------------------------
+        int64_t locateDump(int64_t* pOffset, int64_t max_size = 0);
         
         void operator=(const OutStream& ref);
         
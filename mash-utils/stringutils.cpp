@@ -33,6 +33,7 @@
 #include <sstream>
 #include <ctype.h>
 #include <stdlib.h>
+#include <limits.h>
 
 
 using namespace Mash;
@@ -98,11 +99,16 @@ std::string StringUtils::toString(const timeval& val)
 
 int StringUtils::parseInt(const std::string& val)
 {
-	std::istringstream str(val);
-	int ret;
-	
-	str >> ret;
-	return ret;
+	// Parsed in place (without creating a stream), the values out of range
+	// are clamped
+	long ret = strtol(val.c_str(), 0, 10);
+
+	if (ret > INT_MAX)
+		return INT_MAX;
+	else if (ret < INT_MIN)
+		return INT_MIN;
+
+	return (int) ret;
 }
 
 //-----------------------------------------------------------------------
@@ -116,11 +122,8 @@ unsigned int StringUtils::parseUnsignedInt(const std::string& val)
 
 float StringUtils::parseFloat(const std::string& val)
 {
-	std::istringstream str(val);
-	float ret;
-	
-	str >> ret;
-	return ret;
+	// Parsed in place (without creating a stream)
+	return (float) strtod(val.c_str(), 0);
 }
 
 //-----------------------------------------------------------------------
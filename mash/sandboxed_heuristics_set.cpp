@@ -37,7 +37,7 @@
 #include <assert.h>
 #include <stdlib.h>
 #include <memory.h>
-#include <sstream>
+#include <algorithm>
 
 
 using namespace std;
@@ -49,8 +49,8 @@ using namespace Mash::SandboxTimeBudgetDeclarations;
 /************************* CONSTRUCTION / DESTRUCTION *************************/
 
 SandboxedHeuristicsSet::SandboxedHeuristicsSet()
-: _currentHeuristic(-1), _last_sent_sequence(-1), _last_sent_image_index(-1),
-  _lastError(ERROR_NONE)
+: _pSharedFeatures(0), _currentHeuristic(-1), _last_sent_sequence(-1),
+  _last_sent_image_index(-1), _lastError(ERROR_NONE)
 {
 }
 
@@ -88,9 +88,7 @@ bool SandboxedHeuristicsSet::setHeuristicsFolder(const std::string& strPath)
 int SandboxedHeuristicsSet::loadHeuristicPlugin(const std::string& strName)
 {
     // Save the context (in case of crash)
-    std::ostringstream str;
-    str << "Method: loading" << endl;
-	_strContext = str.str();
+    _context.record("loading");
 
     return _sandbox.loadPlugin(strName);
 }
@@ -99,9 +97,7 @@ int SandboxedHeuristicsSet::loadHeuristicPlugin(const std::string& strName)
 bool SandboxedHeuristicsSet::createHeuristics()
 {
     // Save the context (in case of crash)
-    std::ostringstream str;
-    str << "Method: constructor" << endl;
-	_strContext = str.str();
+    _context.record("constructor");
         
     return _sandbox.createPlugins();
 }
@@ -173,14 +169,7 @@ bool SandboxedHeuristicsSet::init(unsigned int heuristic, unsigned int nb_views,
     context.roi_extent   = roi_extent;
     _contexts[heuristic] = context;
 
-    std::ostringstream str;
-	
-	str << "Method: init" << endl
-        << "Parameters:" << endl
-        << "    - Number of views: " << context.nb_views << endl
-        << "    - ROI extent:      " << context.roi_extent << " pixels" << endl;
-
-	_strContext = str.str();
+    recordContext("init", heuristic, CONTEXT_HEURISTIC);
 
     // Send the command to the child
     CommunicationChannel* pChannel = _sandbox.channel();
@@ -215,16 +204,7 @@ unsigned int SandboxedHeuristicsSet::dim(unsigned int heuristic)
     // Save the context (in case of crash)
     _currentHeuristic = heuristic;
     
-    tContext context = _contexts[heuristic];
-
-    std::ostringstream str;
-	
-	str << "Method: dim" << endl
-        << "Parameters:" << endl
-        << "    - Number of views: " << context.nb_views << endl
-        << "    - ROI extent:      " << context.roi_extent << " pixels" << endl;
-
-	_strContext = str.str();
+    recordContext("dim", heuristic, CONTEXT_HEURISTIC);
 
     // Send the command to the child
     CommunicationChannel* pChannel = _sandbox.channel();
@@ -270,15 +250,7 @@ bool SandboxedHeuristicsSet::prepareForSequence(unsigned int heuristic)
     ++context.sequence;
     _contexts[heuristic] = context;
 
-    std::ostringstream str;
-	
-	str << "Method: prepareForSequence" << endl
-        << "Parameters:" << endl
-        << "    - Number of views: " << context.nb_views << endl
-        << "    - ROI extent:      " << context.roi_extent << " pixels" << endl
-        << "    - Sequence:        #" << context.sequence << endl;
-
-	_strContext = str.str();
+    recordContext("prepareForSequence", heuristic, CONTEXT_SEQUENCE);
 
     // Send the command to the child
     CommunicationChannel* pChannel = _sandbox.channel();
@@ -308,17 +280,7 @@ bool SandboxedHeuristicsSet::finishForSequence(unsigned int heuristic)
     // Save the context (in case of crash)
     _currentHeuristic = heuristic;
     
-    tContext context = _contexts[heuristic];
-
-    std::ostringstream str;
-	
-	str << "Method: finishForSequence" << endl
-        << "Parameters:" << endl
-        << "    - Number of views: " << context.nb_views << endl
-        << "    - ROI extent:      " << context.roi_extent << " pixels" << endl
-        << "    - Sequence:        #" << context.sequence << endl;
-
-	_strContext = str.str();
+    recordContext("finishForSequence", heuristic, CONTEXT_SEQUENCE);
 
     // Send the command to the child
     CommunicationChannel* pChannel = _sandbox.channel();
@@ -359,20 +321,12 @@ bool SandboxedHeuristicsSet::prepareForImage(unsigned int heuristic,
     _currentHeuristic = heuristic;
     
     tContext context        = _contexts[heuristic];
+    context.image_index     = image_index;
     context.image_width     = image->width();
     context.image_height    = image->height();
     _contexts[heuristic]    = context;
 
-    std::ostringstream str;
-	
-	str << "Method: prepareForImage" << endl
-        << "Parameters:" << endl
-        << "    - Number of views: " << context.nb_views << endl
-        << "    - ROI extent:      " << context.roi_extent << " pixels" << endl
-        << "    - Sequence:        #" << context.sequence << endl
-        << "    - Image size:      " << context.image_width << "x" << context.image_height << " pixels" << endl;
-
-	_strContext = str.str();
+    recordContext("prepareForImage", heuristic, CONTEXT_IMAGE);
 
     // Send the command to the child
     CommunicationChannel* pChannel = _sandbox.channel();
@@ -388,10 +342,10 @@ bool SandboxedHeuristicsSet::prepareForImage(unsigned int heuristic,
         pChannel->add(image->pixelFormats());
 
         if (image->hasPixelFormat(Image::PIXELFORMAT_RGB))
-            pChannel->add((char*) image->rgbBuffer(), image->width() * image->height() * sizeof(RGBPixel_t));
+            pChannel->addReference((const char*) image->rgbBuffer(), image->width() * image->height() * sizeof(RGBPixel_t));
 
         if (image->hasPixelFormat(Image::PIXELFORMAT_GRAY))
-            pChannel->add((char*) image->grayBuffer(), image->width() * image->height() * sizeof(byte_t));
+            pChannel->addReference((const char*) image->grayBuffer(), image->width() * image->height() * sizeof(byte_t));
 
         _last_sent_sequence    = sequence;
         _last_sent_image_index = image_index;
@@ -424,18 +378,7 @@ bool SandboxedHeuristicsSet::finishForImage(unsigned int heuristic)
     // Save the context (in case of crash)
     _currentHeuristic = heuristic;
     
-    tContext context = _contexts[heuristic];
-
-    std::ostringstream str;
-	
-	str << "Method: finishForImage" << endl
-        << "Parameters:" << endl
-        << "    - Number of views: " << context.nb_views << endl
-        << "    - ROI extent:      " << context.roi_extent << " pixels" << endl
-        << "    - Sequence:        #" << context.sequence << endl
-        << "    - Image size:      " << context.image_width << "x" << context.image_height << " pixels" << endl;
-
-	_strContext = str.str();
+    recordContext("finishForImage", heuristic, CONTEXT_IMAGE);
 
     // Send the command to the child
     CommunicationChannel* pChannel = _sandbox.channel();
@@ -471,17 +414,7 @@ bool SandboxedHeuristicsSet::prepareForCoordinates(unsigned int heuristic,
     context.coordinates     = coordinates;
     _contexts[heuristic]    = context;
 
-    std::ostringstream str;
-	
-	str << "Method: prepareForCoordinates" << endl
-        << "Parameters:" << endl
-        << "    - Number of views: " << context.nb_views << endl
-        << "    - ROI extent:      " << context.roi_extent << " pixels" << endl
-        << "    - Sequence:        #" << context.sequence << endl
-        << "    - Image size:      " << context.image_width << "x" << context.image_height << " pixels" << endl
-        << "    - ROI position:    (" << context.coordinates.x << ", " << context.coordinates.y << ")" << endl;
-
-	_strContext = str.str();
+    recordContext("prepareForCoordinates", heuristic, CONTEXT_COORDINATES);
 
     // Send the command to the child
     CommunicationChannel* pChannel = _sandbox.channel();
@@ -513,19 +446,7 @@ bool SandboxedHeuristicsSet::finishForCoordinates(unsigned int heuristic)
     // Save the context (in case of crash)
     _currentHeuristic = heuristic;
     
-    tContext context = _contexts[heuristic];
-
-    std::ostringstream str;
-	
-	str << "Method: finishForCoordinates" << endl
-        << "Parameters:" << endl
-        << "    - Number of views: " << context.nb_views << endl
-        << "    - ROI extent:      " << context.roi_extent << " pixels" << endl
-        << "    - Sequence:        #" << context.sequence << endl
-        << "    - Image size:      " << context.image_width << "x" << context.image_height << " pixels" << endl
-        << "    - ROI position:    (" << context.coordinates.x << ", " << context.coordinates.y << ")" << endl;
-
-	_strContext = str.str();
+    recordContext("finishForCoordinates", heuristic, CONTEXT_COORDINATES);
 
     // Send the command to the child
     CommunicationChannel* pChannel = _sandbox.channel();
@@ -563,35 +484,52 @@ bool SandboxedHeuristicsSet::computeSomeFeatures(unsigned int heuristic,
     // Save the context (in case of crash)
     _currentHeuristic = heuristic;
     
-    tContext context = _contexts[heuristic];
+    recordContext("computeFeature", heuristic, CONTEXT_COORDINATES);
+    _context.addParameter("Features", "%d", nbFeatures);
 
-    std::ostringstream str;
-	
-	str << "Method: computeFeature" << endl
-        << "Parameters:" << endl
-        << "    - Number of views:    " << context.nb_views << endl
-        << "    - ROI extent:         " << context.roi_extent << " pixels" << endl
-        << "    - Sequence:           #" << context.sequence << endl
-        << "    - Image size:         " << context.image_width << "x" << context.image_height << " pixels" << endl
-        << "    - ROI position:       (" << context.coordinates.x << ", " << context.coordinates.y << ")" << endl;
+    if (nbFeatures > 0)
+    {
+        unsigned int first = indexes[0];
+        unsigned int last = indexes[0];
 
-    _strContext = str.str();
+        for (unsigned int i = 1; i < nbFeatures; ++i)
+        {
+            first = std::min(first, indexes[i]);
+            last = std::max(last, indexes[i]);
+        }
 
-    // Send the command to the child
+        _context.addParameter("Feature range", "#%d - #%d", first, last);
+    }
+
+    // Send the command to the child (if the arrays are located in the shared
+    // buffer, the child reads and writes them directly)
     CommunicationChannel* pChannel = _sandbox.channel();
 
-    pChannel->startPacket(SANDBOX_COMMAND_HEURISTIC_COMPUTE_SOME_FEATURES);
-    pChannel->add(heuristic);
-    pChannel->add(nbFeatures);
-    pChannel->add((char*) indexes, nbFeatures * sizeof(unsigned int));
-    pChannel->sendPacket();
+    bool bShared = _pSharedFeatures && _pSharedFeatures->owns(indexes, values) &&
+                   (nbFeatures <= _pSharedFeatures->capacity());
+
+    if (bShared)
+    {
+        pChannel->startPacket(SANDBOX_COMMAND_HEURISTIC_COMPUTE_SOME_FEATURES_SHARED);
+        pChannel->add(heuristic);
+        pChannel->add(nbFeatures);
+        pChannel->sendPacket();
+    }
+    else
+    {
+        pChannel->startPacket(SANDBOX_COMMAND_HEURISTIC_COMPUTE_SOME_FEATURES);
+        pChannel->add(heuristic);
+        pChannel->add(nbFeatures);
+        pChannel->addReference((const char*) indexes, nbFeatures * sizeof(unsigned int));
+        pChannel->sendPacket();
+    }
 
     // Read the response
     bool result = pChannel->good();
     if (result)
         result = _sandbox.waitResponse(TIMEOUT_SANDBOX);
 
-    if (result)
+    if (result && !bShared)
         result = pChannel->read((char*) values, nbFeatures * sizeof(scalar_t));
 
     _lastError = (pChannel->getLastError() == ERROR_CHANNEL_SLAVE_CRASHED) ? ERROR_HEURISTIC_CRASHED : _lastError;
@@ -655,3 +593,29 @@ tCommandProcessingResult SandboxedHeuristicsSet::processResponse(tSandboxMessage
     
     return result;
 }
+
+
+/****************************** INTERNAL METHODS ******************************/
+
+void SandboxedHeuristicsSet::recordContext(const char* strMethod, unsigned int heuristic,
+                                           tContextDetails details)
+{
+    const tContext& context = _contexts[heuristic];
+
+    _context.record(strMethod);
+    _context.addParameter("Heuristic", "#%d", heuristic);
+    _context.addParameter("Number of views", "%d", context.nb_views);
+    _context.addParameter("ROI extent", "%d pixels", context.roi_extent);
+
+    if (details >= CONTEXT_SEQUENCE)
+        _context.addParameter("Sequence", "#%d", context.sequence);
+
+    if (details >= CONTEXT_IMAGE)
+    {
+        _context.addParameter("Image", "#%d", context.image_index);
+        _context.addParameter("Image size", "%dx%d pixels", context.image_width, context.image_height);
+    }
+
+    if (details >= CONTEXT_COORDINATES)
+        _context.addParameter("ROI position", "(%d, %d)", context.coordinates.x, context.coordinates.y);
+}
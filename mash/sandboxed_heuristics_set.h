@@ -34,9 +34,11 @@
 
 #include <mash-utils/declarations.h>
 #include <mash-sandboxing/sandbox_controller.h>
+#include <mash-sandboxing/context_recorder.h>
 #include <mash-sandboxing/declarations.h>
 #include "heuristics_set_interface.h"
 #include "heuristic.h"
+#include "shared_features_buffer.h"
 
 
 namespace Mash
@@ -70,6 +72,19 @@ namespace Mash
         //----------------------------------------------------------------------
         bool createSandbox(const tSandboxConfiguration& configuration);
 
+        //----------------------------------------------------------------------
+        /// @brief  Sets the buffer shared with the sandbox
+        ///
+        /// The file descriptor of the buffer must have been given to the
+        /// sandbox through its configuration. Afterwards, the calls to
+        /// computeSomeFeatures() using the arrays of the buffer don't transmit
+        /// the indexes and the values through the communication channel.
+        //----------------------------------------------------------------------
+        inline void setSharedFeaturesBuffer(SharedFeaturesBuffer* pBuffer)
+        {
+            _pSharedFeatures = pBuffer;
+        }
+
         //----------------------------------------------------------------------
         /// @brief  Returns the Sandbox Controller used
         //----------------------------------------------------------------------
@@ -83,7 +98,7 @@ namespace Mash
         //----------------------------------------------------------------------
         inline std::string getContext() const
         {
-            return _strContext;
+            return _context.toString();
         }
 
         //----------------------------------------------------------------------
@@ -299,11 +314,20 @@ namespace Mash
 
         //_____ Internal types __________
     protected:
+        enum tContextDetails
+        {
+            CONTEXT_HEURISTIC,
+            CONTEXT_SEQUENCE,
+            CONTEXT_IMAGE,
+            CONTEXT_COORDINATES,
+        };
+
         struct tContext
         {
             unsigned int    nb_views;
             unsigned int    roi_extent;
             unsigned int    sequence;
+            unsigned int    image_index;
             unsigned int    image_width;
             unsigned int    image_height;
             coordinates_t   coordinates;
@@ -313,15 +337,30 @@ namespace Mash
         typedef tContextsList::iterator tContextsIterator;
 
 
+        //_____ Internal methods __________
+    protected:
+        //----------------------------------------------------------------------
+        /// @brief  Record a call to a heuristic in the context (in case of
+        ///         crash)
+        ///
+        /// @param  strMethod   Name of the method (string literal)
+        /// @param  heuristic   Index of the heuristic
+        /// @param  details     Parameters of the heuristic to record
+        //----------------------------------------------------------------------
+        void recordContext(const char* strMethod, unsigned int heuristic,
+                           tContextDetails details);
+
+
         //_____ Attributes __________
     protected:
         SandboxController   _sandbox;           ///< The sandbox used
+        SharedFeaturesBuffer* _pSharedFeatures; ///< The buffer shared with the sandbox (optional)
         OutStream           _outStream;         ///< Output stream to use for logging
         tContextsList       _contexts;
         int                 _currentHeuristic;
         int                 _last_sent_sequence;
         int                 _last_sent_image_index;
-        std::string         _strContext;        ///< Context of the sandboxed object (used to report
+        ContextRecorder     _context;           ///< Context of the sandboxed object (used to report
                                                 ///  debugging informations after a crash)
         tError              _lastError;         ///< Last error that occured
     };
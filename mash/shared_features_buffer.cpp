@@ -0,0 +1,191 @@
+/*******************************************************************************
+* The MASH Framework contains the source code of all the servers in the
+* "computation farm" of the MASH project (http://www.mash-project.eu),
+* developed at the Idiap Research Institute (http://www.idiap.ch).
+*
+* Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+* Written by Philip Abbet (philip.abbet@idiap.ch)
+*
+* This file is part of the MASH Framework.
+*
+* The MASH Framework is free software: you can redistribute it and/or modify
+* it under the terms of either the GNU General Public License version 2 or
+* the GNU General Public License version 3 as published by the Free
+* Software Foundation, whichever suits the most your needs.
+*
+* The MASH Framework is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public Licenses
+* along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+/** @file   shared_features_buffer.cpp
+    @author Philip Abbet (philip.abbet@idiap.ch)
+
+    Implementation of the 'SharedFeaturesBuffer' class
+*/
+
+#include "shared_features_buffer.h"
+#include <assert.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+
+using namespace std;
+using namespace Mash;
+
+
+/********************************** CONSTANTS *********************************/
+
+const unsigned int SHARED_FEATURES_MAGIC = 0x4D534642;   // 'MSFB'
+
+
+/************************* CONSTRUCTION / DESTRUCTION *************************/
+
+SharedFeaturesBuffer::SharedFeaturesBuffer()
+: _fd(-1), _readOnlyFd(-1), _bReadOnly(false), _size(0), _pHeader(0), _indexes(0), _values(0)
+{
+}
+
+
+SharedFeaturesBuffer::~SharedFeaturesBuffer()
+{
+    release();
+}
+
+
+/********************************** METHODS ***********************************/
+
+bool SharedFeaturesBuffer::create(unsigned int capacity, const std::string& strTempDir)
+{
+    // Assertions
+    assert(capacity > 0);
+
+    release();
+
+    string strTemplate = strTempDir;
+    if (!strTemplate.empty() && (strTemplate[strTemplate.size() - 1] != '/'))
+        strTemplate += "/";
+    strTemplate += "mash_features_XXXXXX";
+
+    char* filename = new char[strTemplate.size() + 1];
+    strTemplate.copy(filename, strTemplate.size());
+    filename[strTemplate.size()] = 0;
+
+    _fd = mkstemp(filename);
+    if (_fd >= 0)
+    {
+        // The read-only descriptor must be a distinct open file description,
+        // so it can only be obtained before the file is unlinked
+        _readOnlyFd = open(filename, O_RDONLY);
+        unlink(filename);
+    }
+
+    delete[] filename;
+
+    if ((_fd < 0) || (_readOnlyFd < 0))
+    {
+        release();
+        return false;
+    }
+
+    // The sandboxes don't run as the user of the server
+    fchmod(_fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
+
+    size_t size = sizeof(tHeader) + capacity * (sizeof(unsigned int) + sizeof(scalar_t));
+    if (ftruncate(_fd, size) != 0)
+    {
+        release();
+        return false;
+    }
+
+    return map(capacity, true);
+}
+
+
+bool SharedFeaturesBuffer::attach(int fd)
+{
+    release();
+
+    if (fd < 0)
+        return false;
+
+    _fd = fd;
+
+    // A buffer attached through a read-only descriptor can't be mapped
+    // writable (not even later, with mprotect())
+    int flags = fcntl(_fd, F_GETFL);
+    if (flags == -1)
+    {
+        release();
+        return false;
+    }
+
+    _bReadOnly = ((flags & O_ACCMODE) == O_RDONLY);
+
+    // Retrieve the capacity chosen by the master
+    tHeader header;
+    if ((pread(_fd, &header, sizeof(tHeader), 0) != sizeof(tHeader)) ||
+        (header.magic != SHARED_FEATURES_MAGIC) || (header.capacity == 0))
+    {
+        release();
+        return false;
+    }
+
+    return map(header.capacity, false);
+}
+
+
+void SharedFeaturesBuffer::release()
+{
+    if (_pHeader)
+        munmap(_pHeader, _size);
+
+    if (_fd >= 0)
+        close(_fd);
+
+    if (_readOnlyFd >= 0)
+        close(_readOnlyFd);
+
+    _fd         = -1;
+    _readOnlyFd = -1;
+    _bReadOnly  = false;
+    _size       = 0;
+    _pHeader    = 0;
+    _indexes    = 0;
+    _values     = 0;
+}
+
+
+bool SharedFeaturesBuffer::map(unsigned int capacity, bool bInitialize)
+{
+    _size = sizeof(tHeader) + capacity * (sizeof(unsigned int) + sizeof(scalar_t));
+
+    void* pMemory = mmap(0, _size, (_bReadOnly ? PROT_READ : PROT_READ | PROT_WRITE),
+                         MAP_SHARED, _fd, 0);
+    if (pMemory == MAP_FAILED)
+    {
+        _size = 0;
+        release();
+        return false;
+    }
+
+    _pHeader = (tHeader*) pMemory;
+    _indexes = (unsigned int*) (_pHeader + 1);
+    _values  = (scalar_t*) (_indexes + capacity);
+
+    if (bInitialize)
+    {
+        _pHeader->magic     = SHARED_FEATURES_MAGIC;
+        _pHeader->capacity  = capacity;
+    }
+
+    return true;
+}
@@ -0,0 +1,192 @@
+/*******************************************************************************
+* The MASH Framework contains the source code of all the servers in the
+* "computation farm" of the MASH project (http://www.mash-project.eu),
+* developed at the Idiap Research Institute (http://www.idiap.ch).
+*
+* Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+* Written by Philip Abbet (philip.abbet@idiap.ch)
+*
+* This file is part of the MASH Framework.
+*
+* The MASH Framework is free software: you can redistribute it and/or modify
+* it under the terms of either the GNU General Public License version 2 or
+* the GNU General Public License version 3 as published by the Free
+* Software Foundation, whichever suits the most your needs.
+*
+* The MASH Framework is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public Licenses
+* along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+
+/** @file   shared_features_buffer.h
+    @author Philip Abbet (philip.abbet@idiap.ch)
+
+    Declaration of the 'SharedFeaturesBuffer' class
+*/
+
+#ifndef _MASH_SHAREDFEATURESBUFFER_H_
+#define _MASH_SHAREDFEATURESBUFFER_H_
+
+#include <mash-utils/declarations.h>
+#include "heuristic.h"
+#include <string>
+
+
+namespace Mash
+{
+    //--------------------------------------------------------------------------
+    /// @brief  A memory region shared between the experiment server and its
+    ///         classifier and heuristics sandboxes, used to transfer the
+    ///         indexes and the values of the features without copying them
+    ///         through the communication channels
+    ///
+    /// The master creates the buffer (backed by an unlinked temporary file)
+    /// before creating the sandboxes, which inherit its file descriptor and
+    /// attach to it. The communication channels are still used to carry the
+    /// commands, so the master keeps the control of the scheduling: only one
+    /// request can be in flight at any time.
+    ///
+    /// The classifier sandbox must only be given the read-only file
+    /// descriptor: it can't then modify the indexes and the values after
+    /// the master checked them, even from another thread (the values are
+    /// forwarded to the instruments and to the features store).
+    //--------------------------------------------------------------------------
+    class MASH_SYMBOL SharedFeaturesBuffer
+    {
+        //_____ Internal types __________
+    private:
+        struct tHeader
+        {
+            unsigned int magic;
+            unsigned int capacity;
+        };
+
+
+        //_____ Construction / Destruction __________
+    public:
+        //----------------------------------------------------------------------
+        /// @brief  Constructor
+        //----------------------------------------------------------------------
+        SharedFeaturesBuffer();
+
+        //----------------------------------------------------------------------
+        /// @brief  Destructor
+        //----------------------------------------------------------------------
+        ~SharedFeaturesBuffer();
+
+
+        //_____ Methods __________
+    public:
+        //----------------------------------------------------------------------
+        /// @brief  Create the buffer (master side)
+        ///
+        /// @param  capacity        Maximum number of features per request
+        /// @param  strTempDir      Folder in which the backing file is
+        ///                         (temporarily) created
+        /// @return                 'true' if successful
+        //----------------------------------------------------------------------
+        bool create(unsigned int capacity, const std::string& strTempDir);
+
+        //----------------------------------------------------------------------
+        /// @brief  Attach to a buffer created by the master (sandbox side)
+        ///
+        /// @param  fd      The inherited file descriptor of the buffer (if
+        ///                 it was opened read-only, the buffer is mapped
+        ///                 read-only too)
+        /// @return         'true' if successful
+        //----------------------------------------------------------------------
+        bool attach(int fd);
+
+        //----------------------------------------------------------------------
+        /// @brief  Unmap the buffer and close its file descriptor
+        //----------------------------------------------------------------------
+        void release();
+
+        //----------------------------------------------------------------------
+        /// @brief  Indicates if the buffer is usable
+        //----------------------------------------------------------------------
+        inline bool isValid() const
+        {
+            return (_pHeader != 0);
+        }
+
+        //----------------------------------------------------------------------
+        /// @brief  Returns the file descriptor of the buffer
+        //----------------------------------------------------------------------
+        inline int fd() const
+        {
+            return _fd;
+        }
+
+        //----------------------------------------------------------------------
+        /// @brief  Returns a read-only file descriptor of the buffer, to give
+        ///         to the sandboxes that must not write in it
+        //----------------------------------------------------------------------
+        inline int readOnlyFd() const
+        {
+            return _readOnlyFd;
+        }
+
+        //----------------------------------------------------------------------
+        /// @brief  Indicates if the buffer is mapped read-only
+        //----------------------------------------------------------------------
+        inline bool isReadOnly() const
+        {
+            return _bReadOnly;
+        }
+
+        //----------------------------------------------------------------------
+        /// @brief  Returns the maximum number of features per request
+        //----------------------------------------------------------------------
+        inline unsigned int capacity() const
+        {
+            return (_pHeader ? _pHeader->capacity : 0);
+        }
+
+        //----------------------------------------------------------------------
+        /// @brief  Returns the array of feature indexes
+        //----------------------------------------------------------------------
+        inline unsigned int* indexes() const
+        {
+            return _indexes;
+        }
+
+        //----------------------------------------------------------------------
+        /// @brief  Returns the array of feature values
+        //----------------------------------------------------------------------
+        inline scalar_t* values() const
+        {
+            return _values;
+        }
+
+        //----------------------------------------------------------------------
+        /// @brief  Indicates if the given arrays are the ones of the buffer
+        //----------------------------------------------------------------------
+        inline bool owns(const unsigned int* indexes, const scalar_t* values) const
+        {
+            return _pHeader && (indexes == _indexes) && (values == _values);
+        }
+
+    private:
+        bool map(unsigned int capacity, bool bInitialize);
+
+
+        //_____ Attributes __________
+    private:
+        int             _fd;
+        int             _readOnlyFd;
+        bool            _bReadOnly;
+        size_t          _size;
+        tHeader*        _pHeader;
+        unsigned int*   _indexes;
+        scalar_t*       _values;
+    };
+}
+
+#endif
@@ -19,6 +19,8 @@ enum tOptions
     OPT_COREDUMP_FOLDER,
     OPT_READ_FD,
     OPT_WRITE_FD,
+    OPT_FEATURES_FD,
+    OPT_SECCOMP,
     OPT_VERBOSE,
     OPT_VERBOSE1,
     OPT_VERBOSE2,
@@ -37,6 +39,8 @@ CSimpleOpt::SOption COMMAND_LINE_OPTIONS[] =
     { OPT_JAIL_FOLDER,          "--jailfolder",     SO_REQ_CMB },
     { OPT_READ_FD,              "--readfd",         SO_REQ_CMB },
     { OPT_WRITE_FD,             "--writefd",        SO_REQ_CMB },
+    { OPT_FEATURES_FD,          "--featuresfd",     SO_REQ_CMB },
+    { OPT_SECCOMP,              "--seccomp",        SO_NONE    },
     { OPT_VERBOSE,              "--verbose",        SO_NONE    },
     { OPT_VERBOSE1,             "-v",               SO_NONE    },
     { OPT_VERBOSE2,             "-vv",              SO_NONE    },
@@ -78,6 +82,9 @@ void showUsage(const std::string& strApplicationName)
          << "    --readfd=<FD>," << endl
          << "    --writefd=<FD>:         The file descriptors to use to communicate with the Experiment" << endl
          << "                            Server (required)" << endl
+         << "    --seccomp:              Once the plugins are loaded, confine the process with a" << endl
+         << "                            system call filter instead of intercepting the calls of" << endl
+         << "                            the plugins (Linux only)" << endl
          << "    --verbose," << endl
          << "    -v, -vv, -vvv, -vvvv, -vvvvv:" << endl
          << "                            Verbose output" << endl;
@@ -130,6 +137,14 @@ int main(int argc, char** argv)
                     configuration.write_pipe = StringUtils::parseInt(args.OptionArg());
                     break;
 
+                case OPT_FEATURES_FD:
+                    configuration.features_fd = StringUtils::parseInt(args.OptionArg());
+                    break;
+
+                case OPT_SECCOMP:
+                    configuration.bSeccomp = true;
+                    break;
+
                 case OPT_VERBOSE:
                     configuration.verbosity = max(configuration.verbosity, (unsigned int) 1);
                     break;
@@ -14,6 +14,7 @@ typedef void* tWardenContext;
 #define getWardenContext() 0
 #define wardenEnableUnsafeFree()
 #define wardenDisableUnsafeFree()
+#define wardenEnableSyscallFilter() (-1)
 
 #ifdef __cplusplus
 }
@@ -262,6 +262,20 @@ bool Sandbox::init(const tConfiguration& configuration)
             return false;
     }
 
+    // Attach to the shared features buffer (if the calling process provided one)
+    if (_configuration.features_fd >= 0)
+    {
+        if (!_sharedFeatures.attach(_configuration.features_fd))
+        {
+            _outStream << "ERROR: Failed to attach to the shared features buffer" << endl;
+            _channel.startPacket(SANDBOX_MESSAGE_CREATION_FAILED);
+            _channel.sendPacket();
+            return false;
+        }
+
+        _pSandboxedObject->setSharedFeaturesBuffer(&_sharedFeatures);
+    }
+
     // Tell the calling process that everything went OK
     _channel.startPacket(SANDBOX_MESSAGE_CREATION_SUCCESSFUL);
     _channel.sendPacket();
@@ -594,6 +608,25 @@ tError Sandbox::handleCreatePluginsCommand()
 
     if (result != ERROR_NONE)
         return result;
+
+    // All the plugins are loaded and created, and the files that the sandbox needs
+    // at this point are opened: from now on, the kernel can enforce the restrictions
+    // on the system calls, so the warden doesn't need to intercept them anymore
+    // (except the opening of files, which the sandbox still does later)
+    if (_configuration.bSeccomp)
+    {
+        if (wardenEnableSyscallFilter() != 0)
+        {
+            _outStream << "ERROR: Failed to install the system call filter, reason: " << strerror(errno) << endl;
+
+            _channel.startPacket(SANDBOX_MESSAGE_CREATION_FAILED);
+            _channel.sendPacket();
+
+            return ERROR_SANDBOX_CREATION;
+        }
+
+        _outStream << "System call filter installed" << endl;
+    }
         
     // Send the response
     _channel.startPacket(SANDBOX_MESSAGE_RESPONSE);
@@ -36,6 +36,7 @@
 #include <mash-sandboxing/communication_channel.h>
 #include <mash-sandboxing/sandbox_messages.h>
 #include <mash-utils/outstream.h>
+#include <mash/shared_features_buffer.h>
 #include <string>
 #include <map>
 
@@ -62,7 +63,7 @@ public:
         tConfiguration()
         : kind(KIND_NONE), strUsername(""), strLogFolder("logs"),
           strOutputFolder("out"), strJailFolder("jail"), read_pipe(0),
-          write_pipe(0), verbosity(0)
+          write_pipe(0), features_fd(-1), bSeccomp(false), verbosity(0)
         {
         }        
 
@@ -74,6 +75,8 @@ public:
         std::string     strJailFolder;
         int             read_pipe;
         int             write_pipe;
+        int             features_fd;
+        bool            bSeccomp;
         unsigned int    verbosity;
     };
 
@@ -126,6 +129,7 @@ private:
     Mash::CommunicationChannel  _channel;
     Mash::OutStream             _outStream;
     ISandboxedObject*           _pSandboxedObject;
+    Mash::SharedFeaturesBuffer  _sharedFeatures;
     std::string                 _strModelFile;
     std::string                 _strInternalDataFile;
 };
@@ -48,7 +48,8 @@ SandboxInputSet::SandboxInputSet(const CommunicationChannel& channel,
                                  Mash::OutStream* pOutStream,
                                  tWardenContext* pWardenContext,
                                  bool bReadOnly)
-: _channel(channel), _pWardenContext(pWardenContext), _bReadOnly(bReadOnly),
+: _channel(channel), _pWardenContext(pWardenContext), _pSharedFeatures(0),
+  _bReadOnly(bReadOnly),
   _id(0), _bDoingDetection(false), _nbFeaturesTotal(0), _nbLabels(0),
   _roiExtent(0)
 {
@@ -352,6 +353,37 @@ bool SandboxInputSet::computeSomeFeatures(unsigned int image,
         (coordinates.y < roi_extent) || (coordinates.y + roi_extent >= size.height))
         return false;
 
+    // Use the shared buffer if possible: the values are read from the shared
+    // memory. The buffer is read-only here, so the indexes still go through
+    // the channel (the calling process copies them in the buffer itself).
+    if (_pSharedFeatures && (nbFeatures <= _pSharedFeatures->capacity()))
+    {
+        _outStream << "< INPUT_SET_COMPUTE_SOME_FEATURES_SHARED " << " " << image << " "
+                   << coordinates.x << " " << coordinates.y << " "
+                   << heuristic << " " << nbFeatures << " ..." << endl;
+
+        _channel.startPacket(SANDBOX_COMMAND_INPUT_SET_COMPUTE_SOME_FEATURES_SHARED);
+        _channel.add(image);
+        _channel.add(coordinates.x);
+        _channel.add(coordinates.y);
+        _channel.add(heuristic);
+        _channel.add(nbFeatures);
+        _channel.addReference((const char*) indexes, nbFeatures * sizeof(unsigned int));
+        _channel.sendPacket();
+
+        // Read the response
+        bool result = _channel.good();
+        if (result)
+            result = waitResponse();
+
+        if (result)
+            memcpy(values, _pSharedFeatures->values(), nbFeatures * sizeof(scalar_t));
+
+        setWardenContext(pPreviousContext);
+
+        return result && _channel.good();
+    }
+
     _outStream << "< INPUT_SET_COMPUTE_SOME_FEATURES " << " " << image << " "
                << coordinates.x << " " << coordinates.y << " "
                << heuristic << " " << nbFeatures << " ..." << endl;
@@ -363,7 +395,7 @@ bool SandboxInputSet::computeSomeFeatures(unsigned int image,
     _channel.add(coordinates.y);
     _channel.add(heuristic);
     _channel.add(nbFeatures);
-    _channel.add((char*) indexes, nbFeatures * sizeof(unsigned int));
+    _channel.addReference((const char*) indexes, nbFeatures * sizeof(unsigned int));
     _channel.sendPacket();
 
     // Read the response
@@ -43,6 +43,7 @@
 #include <mash-classification/declarations.h>
 #include <mash-classification/classifier_input_set_interface.h>
 #include <mash-sandboxing/communication_channel.h>
+#include <mash/shared_features_buffer.h>
 #include <mash-utils/outstream.h>
 #include <vector>
 
@@ -104,6 +105,18 @@ public:
         _imageSizes.clear();
     }
 
+    //--------------------------------------------------------------------------
+    /// @brief  Sets the buffer shared with the calling process (and the
+    ///         heuristics sandbox) to use to transfer the features
+    ///
+    /// When set, the requests that fit in the buffer don't transmit the
+    /// indexes and the values of the features through the channel
+    //--------------------------------------------------------------------------
+    inline void setSharedFeaturesBuffer(Mash::SharedFeaturesBuffer* pBuffer)
+    {
+        _pSharedFeatures = pBuffer;
+    }
+
 
     //_____ Heuristics-related methods __________
 public:
@@ -255,6 +268,7 @@ protected:
     Mash::CommunicationChannel      _channel;
     Mash::OutStream                 _outStream;
     tWardenContext*                 _pWardenContext;
+    Mash::SharedFeaturesBuffer*     _pSharedFeatures;
     bool                            _bReadOnly;
     unsigned int                    _id;
     bool                            _bDoingDetection;
@@ -329,7 +329,7 @@ bool SandboxPerception::computeSomeFeatures(unsigned int view,
     _channel.add(coordinates.y);
     _channel.add(heuristic);
     _channel.add(nbFeatures);
-    _channel.add((char*) indexes, nbFeatures * sizeof(unsigned int));
+    _channel.addReference((const char*) indexes, nbFeatures * sizeof(unsigned int));
     _channel.sendPacket();
 
     // Read the response
@@ -64,6 +64,7 @@ SandboxedClassifier::SandboxedClassifier(const CommunicationChannel& channel,
         handlers[SANDBOX_COMMAND_LOAD_MODEL]                        = &SandboxedClassifier::handleLoadModelCommand;
         handlers[SANDBOX_COMMAND_CLASSIFIER_TRAIN]                  = &SandboxedClassifier::handleTrainCommand;
         handlers[SANDBOX_COMMAND_CLASSIFIER_CLASSIFY]               = &SandboxedClassifier::handleClassifyCommand;
+        handlers[SANDBOX_COMMAND_CLASSIFIER_CLASSIFY_BATCH]         = &SandboxedClassifier::handleClassifyBatchCommand;
         handlers[SANDBOX_COMMAND_CLASSIFIER_REPORT_FEATURES_USED]   = &SandboxedClassifier::handleReportFeaturesUsedCommand;
         handlers[SANDBOX_COMMAND_SAVE_MODEL]                        = &SandboxedClassifier::handleSaveModelCommand;
     }
@@ -244,6 +245,13 @@ void SandboxedClassifier::handleCommand(tSandboxMessage command)
 }
 
 
+void SandboxedClassifier::setSharedFeaturesBuffer(SharedFeaturesBuffer* pBuffer)
+{
+    ISandboxedObject::setSharedFeaturesBuffer(pBuffer);
+    _inputSet.setSharedFeaturesBuffer(pBuffer);
+}
+
+
 /**************************** COMMAND HANDLERS ********************************/
 
 tError SandboxedClassifier::handleSetSeedCommand()
@@ -501,6 +509,84 @@ tError SandboxedClassifier::handleClassifyCommand()
 }
 
 
+tError SandboxedClassifier::handleClassifyBatchCommand()
+{
+    // Assertions
+    assert(_pManager);
+    assert(_pClassifier);
+    
+    // Retrieve the id of the input set
+    unsigned int id;
+    _channel.read(&id);
+
+    // Retrieve the type of task
+    bool detection;
+    _channel.read(&detection);
+
+    // Retrieve the image index
+    unsigned int image;
+    _channel.read(&image);
+
+    // Retrieve the positions
+    unsigned int nbPositions = 0;
+    _channel.read(&nbPositions);
+
+    tCoordinatesList positions(nbPositions);
+    if (nbPositions > 0)
+        _channel.read((char*) &positions[0], nbPositions * sizeof(coordinates_t));
+    
+    if (!_channel.good())
+    {
+        _outStream << getErrorDescription(_channel.getLastError()) << endl;
+        return _channel.getLastError();
+    }
+
+    _outStream << "> CLASSIFY_BATCH " << id << " " << detection << " " << image
+               << " " << nbPositions << endl;
+
+    // Change the id of the input set if necessary
+    if (_inputSet.id() != id)
+        _inputSet.setup(id, detection);
+    
+    // Tell the classifier to classify the image at all the positions
+    setWardenContext(&_wardenContext);
+    Classifier::tClassificationResultsList* results = new Classifier::tClassificationResultsList(nbPositions);
+    if (!_pClassifier->classifyBatch(&_inputSet, image, positions, *results))
+    {
+        setWardenContext(0);
+        _outStream << getErrorDescription(ERROR_CLASSIFIER_CLASSIFICATION_FAILED) << endl;
+        return ERROR_CLASSIFIER_CLASSIFICATION_FAILED;
+    }
+    setWardenContext(0);
+
+    // Send the results (in one packet)
+    _channel.startPacket(SANDBOX_MESSAGE_RESPONSE);
+
+    for (unsigned int i = 0; _channel.good() && (i < nbPositions); ++i)
+    {
+        const Classifier::tClassificationResults& scores = (*results)[i];
+
+        _channel.add((unsigned int) scores.size());
+
+        Classifier::tClassificationResults::const_iterator iter, iterEnd;
+        for (iter = scores.begin(), iterEnd = scores.end();
+             _channel.good() && (iter != iterEnd); ++iter)
+        {
+            _channel.add(iter->first);
+            _channel.add(iter->second);
+        }
+    }
+
+    _channel.sendPacket();
+
+    setWardenContext(&_wardenContext);
+    delete results;
+    setWardenContext(0);
+
+    return (_channel.good() ? ERROR_NONE : _channel.getLastError());
+}
+
+
 tError SandboxedClassifier::handleReportFeaturesUsedCommand()
 {
     // Assertions
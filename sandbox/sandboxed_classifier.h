@@ -71,6 +71,7 @@ public:
                                        const Mash::PredictorModel& outModel,
                                        const Mash::DataWriter& outInternalData);
     virtual void handleCommand(Mash::tSandboxMessage command);
+    virtual void setSharedFeaturesBuffer(Mash::SharedFeaturesBuffer* pBuffer);
 
 
     //_____ Command handlers __________
@@ -80,6 +81,7 @@ private:
     Mash::tError handleLoadModelCommand();
     Mash::tError handleTrainCommand();
     Mash::tError handleClassifyCommand();
+    Mash::tError handleClassifyBatchCommand();
     Mash::tError handleReportFeaturesUsedCommand();
     Mash::tError handleSaveModelCommand();
 
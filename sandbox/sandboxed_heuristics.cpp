@@ -190,6 +190,7 @@ SandboxedHeuristics::SandboxedHeuristics(const CommunicationChannel& channel,
         handlers[SANDBOX_COMMAND_HEURISTIC_FINISH_FOR_COORDINATES]  = &SandboxedHeuristics::handleFinishForCoordinatesCommand;
         handlers[SANDBOX_COMMAND_HEURISTIC_COMPUTE_SOME_FEATURES]   = &SandboxedHeuristics::handleComputeSomeFeaturesCommand;
         handlers[SANDBOX_COMMAND_HEURISTIC_REPORT_STATISTICS]       = &SandboxedHeuristics::handleReportStatisticsCommand;
+        handlers[SANDBOX_COMMAND_HEURISTIC_COMPUTE_SOME_FEATURES_SHARED] = &SandboxedHeuristics::handleComputeSomeFeaturesSharedCommand;
     }
     
     struct sigaction sa;
@@ -1072,6 +1073,113 @@ tError SandboxedHeuristics::handleComputeSomeFeaturesCommand()
         return _channel.getLastError();
     }
 
+    tError result = computeSomeFeatures(heuristic, nbFeatures, indexes, results);
+    if (result != ERROR_NONE)
+    {
+        delete[] indexes;
+        delete[] results;
+        return result;
+    }
+
+    _channel.startPacket(SANDBOX_MESSAGE_RESPONSE);
+    _channel.addReference((const char*) results, nbFeatures * sizeof(scalar_t));
+    _channel.sendPacket();
+
+    delete[] indexes;
+    delete[] results;
+
+    return (_channel.good() ? ERROR_NONE : _channel.getLastError());
+}
+
+
+tError SandboxedHeuristics::handleComputeSomeFeaturesSharedCommand()
+{
+    // Assertions
+    assert(_pManager);
+    assert(!_heuristics.empty());
+    
+    // Retrieve the heuristic index and the number of features to compute (the
+    // indexes are already in the shared buffer)
+    unsigned int heuristic;
+    unsigned int nbFeatures;
+
+    _channel.read(&heuristic);
+    _channel.read(&nbFeatures);
+
+    if (!_channel.good())
+    {
+        _outStream << getErrorDescription(_channel.getLastError()) << endl;
+        return _channel.getLastError();
+    }
+
+    _outStream << "> COMPUTE_SOME_FEATURES_SHARED " << heuristic << " " << nbFeatures << endl;
+
+    if ((heuristic >= _heuristics.size()) || (nbFeatures == 0) || !_pSharedFeatures ||
+        (nbFeatures > _pSharedFeatures->capacity()))
+    {
+        _outStream << getErrorDescription(ERROR_CHANNEL_PROTOCOL) << endl;
+        return ERROR_CHANNEL_PROTOCOL;
+    }
+
+    tError result = computeSomeFeatures(heuristic, nbFeatures, _pSharedFeatures->indexes(),
+                                        _pSharedFeatures->values());
+    if (result != ERROR_NONE)
+        return result;
+
+    _channel.startPacket(SANDBOX_MESSAGE_RESPONSE);
+    _channel.sendPacket();
+
+    return (_channel.good() ? ERROR_NONE : _channel.getLastError());
+}
+
+
+Mash::tError SandboxedHeuristics::handleReportStatisticsCommand()
+{
+    // Assertions
+    assert(_pManager);
+    assert(!_heuristics.empty());
+    
+    // Retrieve the heuristic index
+    unsigned int heuristic;
+    if (!_channel.read(&heuristic))
+    {
+        _outStream << getErrorDescription(_channel.getLastError()) << endl;
+        return _channel.getLastError();
+    }
+
+    _outStream << "> REPORT_STATISTICS " << heuristic << endl;
+
+    if (heuristic >= _heuristics.size())
+    {
+        _outStream << getErrorDescription(ERROR_CHANNEL_PROTOCOL) << endl;
+        return ERROR_CHANNEL_PROTOCOL;
+    }
+
+    updateStatistics(&_heuristics[heuristic].statistics);
+
+    _channel.startPacket(SANDBOX_MESSAGE_RESPONSE);
+    _channel.add((char*) &_heuristics[heuristic].statistics, sizeof(tHeuristicStatistics));
+
+#if MASH_PLATFORM == MASH_PLATFORM_LINUX
+    _channel.add((char*) &_heuristics[heuristic].wardenContext.memory_allocated_maximum, sizeof(size_t));
+#else
+    size_t fake = 0;
+    _channel.add((char*) &fake, sizeof(size_t));
+#endif
+
+    _channel.sendPacket();
+
+    return (_channel.good() ? ERROR_NONE : _channel.getLastError());
+}
+
+
+/**************************** FEATURES COMPUTATION ****************************/
+
+tError SandboxedHeuristics::computeSomeFeatures(unsigned int heuristic,
+                                                unsigned int nbFeatures,
+                                                unsigned int* indexes,
+                                                scalar_t* results)
+{
     // Tell the heuristic to prepare for the new image
     srand(_heuristics[heuristic].currentSeed);
     srand48(_heuristics[heuristic].currentSeed);
@@ -1110,9 +1218,6 @@ tError SandboxedHeuristics::handleComputeSomeFeaturesCommand()
 
             updateStatistics(&_heuristics[heuristic].statistics.features, elapsed);
 
-            delete[] indexes;
-            delete[] results;
-
             updateStatistics(&_heuristics[heuristic].statistics);
 
             _outStream << getErrorDescription(ERROR_FEATURE_IS_NAN) << endl;
@@ -1127,9 +1232,6 @@ tError SandboxedHeuristics::handleComputeSomeFeaturesCommand()
 
             if (!decrementTimeBudget(&_heuristics[heuristic].timeBudget, elapsed))
             {
-                delete[] indexes;
-                delete[] results;
-
                 updateStatistics(&_heuristics[heuristic].statistics);
 
                 _outStream << getErrorDescription(ERROR_HEURISTIC_TIMEOUT) << endl;
@@ -1148,9 +1250,6 @@ tError SandboxedHeuristics::handleComputeSomeFeaturesCommand()
 
         if (!decrementTimeBudget(&_heuristics[heuristic].timeBudget, elapsed))
         {
-            delete[] indexes;
-            delete[] results;
-
             updateStatistics(&_heuristics[heuristic].statistics);
 
             _outStream << getErrorDescription(ERROR_HEURISTIC_TIMEOUT) << endl;
@@ -1160,54 +1259,7 @@ tError SandboxedHeuristics::handleComputeSomeFeaturesCommand()
 
     _heuristics[heuristic].currentSeed = rand();
 
-    _channel.startPacket(SANDBOX_MESSAGE_RESPONSE);
-    _channel.add((char*) results, nbFeatures * sizeof(scalar_t));
-    _channel.sendPacket();
-
-    delete[] indexes;
-    delete[] results;
-
-    return (_channel.good() ? ERROR_NONE : _channel.getLastError());
-}
-
-
-Mash::tError SandboxedHeuristics::handleReportStatisticsCommand()
-{
-    // Assertions
-    assert(_pManager);
-    assert(!_heuristics.empty());
-    
-    // Retrieve the heuristic index
-    unsigned int heuristic;
-    if (!_channel.read(&heuristic))
-    {
-        _outStream << getErrorDescription(_channel.getLastError()) << endl;
-        return _channel.getLastError();
-    }
-
-    _outStream << "> REPORT_STATISTICS " << heuristic << endl;
-
-    if (heuristic >= _heuristics.size())
-    {
-        _outStream << getErrorDescription(ERROR_CHANNEL_PROTOCOL) << endl;
-        return ERROR_CHANNEL_PROTOCOL;
-    }
-
-    updateStatistics(&_heuristics[heuristic].statistics);
-
-    _channel.startPacket(SANDBOX_MESSAGE_RESPONSE);
-    _channel.add((char*) &_heuristics[heuristic].statistics, sizeof(tHeuristicStatistics));
-
-#if MASH_PLATFORM == MASH_PLATFORM_LINUX
-    _channel.add((char*) &_heuristics[heuristic].wardenContext.memory_allocated_maximum, sizeof(size_t));
-#else
-    size_t fake = 0;
-    _channel.add((char*) &fake, sizeof(size_t));
-#endif
-
-    _channel.sendPacket();
-
-    return (_channel.good() ? ERROR_NONE : _channel.getLastError());
+    return ERROR_NONE;
 }
 
 
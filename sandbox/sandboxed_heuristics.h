@@ -87,6 +87,13 @@ private:
     Mash::tError handleFinishForCoordinatesCommand();
     Mash::tError handleComputeSomeFeaturesCommand();
     Mash::tError handleReportStatisticsCommand();
+    Mash::tError handleComputeSomeFeaturesSharedCommand();
+
+
+    //_____ Features computation __________
+private:
+    Mash::tError computeSomeFeatures(unsigned int heuristic, unsigned int nbFeatures,
+                                     unsigned int* indexes, Mash::scalar_t* results);
 
 
     //_____ Time budget-related methods __________
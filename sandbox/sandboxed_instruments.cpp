@@ -59,6 +59,7 @@ SandboxedInstruments::SandboxedInstruments(const CommunicationChannel& channel,
     if (handlers.empty())
     {
         handlers[SANDBOX_COMMAND_INSTRUMENT_SETUP]                              = &SandboxedInstruments::handleInstrumentSetupCommand;
+        handlers[SANDBOX_COMMAND_INSTRUMENT_EVENTS]                             = &SandboxedInstruments::handleInstrumentEventsCommand;
         handlers[SANDBOX_EVENT_INSTRUMENTS_EXPERIMENT_DONE]                     = &SandboxedInstruments::handleExperimentDoneEvent;
 
         handlers[SANDBOX_EVENT_INSTRUMENTS_CLASSIFICATION_EXPERIMENT_STARTED]   = &SandboxedInstruments::handleClassificationExperimentStartedEvent;
@@ -68,6 +69,7 @@ SandboxedInstruments::SandboxedInstruments(const CommunicationChannel& channel,
         handlers[SANDBOX_EVENT_INSTRUMENTS_CLASSIFIER_TEST_DONE]                = &SandboxedInstruments::handleClassifierTestDoneEvent;
         handlers[SANDBOX_EVENT_INSTRUMENTS_CLASSIFIER_CLASSIFICATION_DONE]      = &SandboxedInstruments::handleClassifierClassificationDoneEvent;
         handlers[SANDBOX_EVENT_INSTRUMENTS_FEATURES_COMPUTED_BY_CLASSIFIER]     = &SandboxedInstruments::handleFeaturesComputedByClassifierEvent;
+        handlers[SANDBOX_EVENT_INSTRUMENTS_FEATURES_COMPUTED_BY_CLASSIFIER_BATCH] = &SandboxedInstruments::handleFeaturesComputedByClassifierBatchEvent;
                                                                                 
         handlers[SANDBOX_EVENT_INSTRUMENTS_GOALPLANNING_EXPERIMENT_STARTED]     = &SandboxedInstruments::handleGoalplanningExperimentStartedEvent;
         handlers[SANDBOX_EVENT_INSTRUMENTS_GOALPLANNER_LEARNING_STARTED]        = &SandboxedInstruments::handlePlannerLearningStartedEvent;
@@ -133,6 +135,7 @@ tError SandboxedInstruments::loadPlugin(const std::string& strName)
     tInstrumentInfos infos;
     infos.pInstrument                               = 0;
     infos.strName                                   = strName;
+    infos.events                                    = 0;
 
 #if MASH_PLATFORM == MASH_PLATFORM_LINUX
     infos.wardenContext.sandboxed_object            = 0;
@@ -221,6 +224,8 @@ tError SandboxedInstruments::createPlugins(Mash::OutStream* pOutStream,
 
         iter->pInstrument->writer = *iter2;
 
+        iter->events = InstrumentsManager::getSubscribedEvents(iter->pInstrument);
+
         _channel.startPacket(SANDBOX_MESSAGE_KEEP_ALIVE);
         _channel.sendPacket();
     }    
@@ -324,6 +329,34 @@ tError SandboxedInstruments::handleInstrumentSetupCommand()
 }
 
 
+tError SandboxedInstruments::handleInstrumentEventsCommand()
+{
+    // Assertions
+    assert(_pManager);
+    assert(!_instruments.empty());
+
+    _outStream << "> INSTRUMENT_EVENTS" << endl;
+
+    // Send the events consumed by each instrument (the instruments report the
+    // events they don't handle the first time they receive them)
+    _channel.startPacket(SANDBOX_MESSAGE_RESPONSE);
+    _channel.add((unsigned int) _instruments.size());
+
+    tInstrumentsIterator iter, iterEnd;
+    for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter)
+    {
+        iter->events = InstrumentsManager::getSubscribedEvents(iter->pInstrument);
+
+        _outStream << "    " << iter->strName << ": " << iter->events << endl;
+        _channel.add(iter->events);
+    }
+
+    _channel.sendPacket();
+
+    return (_channel.good() ? ERROR_NONE : _channel.getLastError());
+}
+
+
 tError SandboxedInstruments::handleExperimentDoneEvent()
 {
     // Assertions
@@ -337,6 +370,9 @@ tError SandboxedInstruments::handleExperimentDoneEvent()
     unsigned int index = 0;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter, ++index)
     {
+        if ((iter->events & Instrument::EVENT_EXPERIMENT_DONE) == 0)
+            continue;
+
         _channel.startPacket(SANDBOX_MESSAGE_CURRENT_INSTRUMENT);
         _channel.add(index);
         _channel.sendPacket();
@@ -386,6 +422,9 @@ tError SandboxedInstruments::handleClassificationExperimentStartedEvent()
     unsigned int index = 0;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter, ++index)
     {
+        if ((iter->events & Instrument::EVENT_CLASSIFICATION_EXPERIMENT_STARTED) == 0)
+            continue;
+
         _channel.startPacket(SANDBOX_MESSAGE_CURRENT_INSTRUMENT);
         _channel.add(index);
         _channel.sendPacket();
@@ -435,6 +474,9 @@ tError SandboxedInstruments::handleClassifierTrainingStartedEvent()
     unsigned int index = 0;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter, ++index)
     {
+        if ((iter->events & Instrument::EVENT_CLASSIFIER_TRAINING_STARTED) == 0)
+            continue;
+
         _channel.startPacket(SANDBOX_MESSAGE_CURRENT_INSTRUMENT);
         _channel.add(index);
         _channel.sendPacket();
@@ -472,6 +514,9 @@ tError SandboxedInstruments::handleClassifierTrainingDoneEvent()
     unsigned int index = 0;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter, ++index)
     {
+        if ((iter->events & Instrument::EVENT_CLASSIFIER_TRAINING_DONE) == 0)
+            continue;
+
         _channel.startPacket(SANDBOX_MESSAGE_CURRENT_INSTRUMENT);
         _channel.add(index);
         _channel.sendPacket();
@@ -521,6 +566,9 @@ tError SandboxedInstruments::handleClassifierTestStartedEvent()
     unsigned int index = 0;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter, ++index)
     {
+        if ((iter->events & Instrument::EVENT_CLASSIFIER_TEST_STARTED) == 0)
+            continue;
+
         _channel.startPacket(SANDBOX_MESSAGE_CURRENT_INSTRUMENT);
         _channel.add(index);
         _channel.sendPacket();
@@ -558,6 +606,9 @@ tError SandboxedInstruments::handleClassifierTestDoneEvent()
     unsigned int index = 0;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter, ++index)
     {
+        if ((iter->events & Instrument::EVENT_CLASSIFIER_TEST_DONE) == 0)
+            continue;
+
         _channel.startPacket(SANDBOX_MESSAGE_CURRENT_INSTRUMENT);
         _channel.add(index);
         _channel.sendPacket();
@@ -622,6 +673,9 @@ tError SandboxedInstruments::handleClassifierClassificationDoneEvent()
     unsigned int index = 0;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter, ++index)
     {
+        if ((iter->events & Instrument::EVENT_CLASSIFIER_CLASSIFICATION_DONE) == 0)
+            continue;
+
         _channel.startPacket(SANDBOX_MESSAGE_CURRENT_INSTRUMENT);
         _channel.add(index);
         _channel.sendPacket();
@@ -639,7 +693,7 @@ tError SandboxedInstruments::handleClassifierClassificationDoneEvent()
 }
 
 
-tError SandboxedInstruments::handleFeaturesComputedByClassifierEvent()
+tError SandboxedInstruments::processFeaturesComputedByClassifierEvent()
 {
     // Assertions
     assert(_pManager);
@@ -696,6 +750,9 @@ tError SandboxedInstruments::handleFeaturesComputedByClassifierEvent()
     unsigned int index = 0;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter, ++index)
     {
+        if ((iter->events & Instrument::EVENT_FEATURES_COMPUTED_BY_CLASSIFIER) == 0)
+            continue;
+
         _channel.startPacket(SANDBOX_MESSAGE_CURRENT_INSTRUMENT);
         _channel.add(index);
         _channel.sendPacket();
@@ -707,11 +764,54 @@ tError SandboxedInstruments::handleFeaturesComputedByClassifierEvent()
         setWardenContext(0);
     }
     
+    delete[] indexes;
+    delete[] values;
+
+    return (_channel.good() ? ERROR_NONE : _channel.getLastError());
+}
+
+
+tError SandboxedInstruments::handleFeaturesComputedByClassifierEvent()
+{
+    tError result = processFeaturesComputedByClassifierEvent();
+    if (result != ERROR_NONE)
+        return result;
+
     _channel.startPacket(SANDBOX_MESSAGE_RESPONSE);
     _channel.sendPacket();
 
-    delete[] indexes;
-    delete[] values;
+    return (_channel.good() ? ERROR_NONE : _channel.getLastError());
+}
+
+
+tError SandboxedInstruments::handleFeaturesComputedByClassifierBatchEvent()
+{
+    // Assertions
+    assert(_pManager);
+    assert(!_instruments.empty());
+
+    // Retrieve the number of events in the batch
+    unsigned int nbEvents;
+
+    if (!_channel.read(&nbEvents))
+    {
+        _outStream << getErrorDescription(_channel.getLastError()) << endl;
+        return _channel.getLastError();
+    }
+
+    _outStream << "> EVENT_FEATURES_COMPUTED_BY_CLASSIFIER_BATCH " << nbEvents << endl;
+
+    // Forward the events to all the instruments, in the order they were sent
+    for (unsigned int i = 0; i < nbEvents; ++i)
+    {
+        tError result = processFeaturesComputedByClassifierEvent();
+        if (result != ERROR_NONE)
+            return result;
+    }
+
+    // Only one response for the whole batch
+    _channel.startPacket(SANDBOX_MESSAGE_RESPONSE);
+    _channel.sendPacket();
 
     return (_channel.good() ? ERROR_NONE : _channel.getLastError());
 }
@@ -730,6 +830,9 @@ tError SandboxedInstruments::handleGoalplanningExperimentStartedEvent()
     unsigned int index = 0;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter, ++index)
     {
+        if ((iter->events & Instrument::EVENT_GOALPLANNING_EXPERIMENT_STARTED) == 0)
+            continue;
+
         _channel.startPacket(SANDBOX_MESSAGE_CURRENT_INSTRUMENT);
         _channel.add(index);
         _channel.sendPacket();
@@ -759,6 +862,9 @@ tError SandboxedInstruments::handlePlannerLearningStartedEvent()
     unsigned int index = 0;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter, ++index)
     {
+        if ((iter->events & Instrument::EVENT_PLANNER_LEARNING_STARTED) == 0)
+            continue;
+
         _channel.startPacket(SANDBOX_MESSAGE_CURRENT_INSTRUMENT);
         _channel.add(index);
         _channel.sendPacket();
@@ -800,6 +906,9 @@ tError SandboxedInstruments::handlePlannerLearningDoneEvent()
     unsigned int index = 0;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter, ++index)
     {
+        if ((iter->events & Instrument::EVENT_PLANNER_LEARNING_DONE) == 0)
+            continue;
+
         _channel.startPacket(SANDBOX_MESSAGE_CURRENT_INSTRUMENT);
         _channel.add(index);
         _channel.sendPacket();
@@ -829,6 +938,9 @@ tError SandboxedInstruments::handlePlannerTestStartedEvent()
     unsigned int index = 0;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter, ++index)
     {
+        if ((iter->events & Instrument::EVENT_PLANNER_TEST_STARTED) == 0)
+            continue;
+
         _channel.startPacket(SANDBOX_MESSAGE_CURRENT_INSTRUMENT);
         _channel.add(index);
         _channel.sendPacket();
@@ -872,6 +984,9 @@ tError SandboxedInstruments::handlePlannerTestDoneEvent()
     unsigned int index = 0;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter, ++index)
     {
+        if ((iter->events & Instrument::EVENT_PLANNER_TEST_DONE) == 0)
+            continue;
+
         _channel.startPacket(SANDBOX_MESSAGE_CURRENT_INSTRUMENT);
         _channel.add(index);
         _channel.sendPacket();
@@ -918,6 +1033,9 @@ tError SandboxedInstruments::handlePlannerActionChoosenEvent()
     unsigned int index = 0;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter, ++index)
     {
+        if ((iter->events & Instrument::EVENT_PLANNER_ACTION_CHOOSEN) == 0)
+            continue;
+
         _channel.startPacket(SANDBOX_MESSAGE_CURRENT_INSTRUMENT);
         _channel.add(index);
         _channel.sendPacket();
@@ -988,6 +1106,9 @@ tError SandboxedInstruments::handleFeaturesComputedByPlannerEvent()
     unsigned int index = 0;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter, ++index)
     {
+        if ((iter->events & Instrument::EVENT_FEATURES_COMPUTED_BY_PLANNER) == 0)
+            continue;
+
         _channel.startPacket(SANDBOX_MESSAGE_CURRENT_INSTRUMENT);
         _channel.add(index);
         _channel.sendPacket();
@@ -1041,6 +1162,9 @@ tError SandboxedInstruments::handleFeatureListReportedEvent()
     unsigned int index = 0;
     for (iter = _instruments.begin(), iterEnd = _instruments.end(); iter != iterEnd; ++iter, ++index)
     {
+        if ((iter->events & Instrument::EVENT_FEATURE_LIST_REPORTED) == 0)
+            continue;
+
         _channel.startPacket(SANDBOX_MESSAGE_CURRENT_INSTRUMENT);
         _channel.add(index);
         _channel.sendPacket();
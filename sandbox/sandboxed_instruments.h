@@ -91,6 +91,7 @@ public:
     //_____ Event handlers __________
 private:
     Mash::tError handleInstrumentSetupCommand();
+    Mash::tError handleInstrumentEventsCommand();
 
     Mash::tError handleExperimentDoneEvent();
 
@@ -101,6 +102,7 @@ private:
     Mash::tError handleClassifierTestDoneEvent();
     Mash::tError handleClassifierClassificationDoneEvent();
     Mash::tError handleFeaturesComputedByClassifierEvent();
+    Mash::tError handleFeaturesComputedByClassifierBatchEvent();
 
     Mash::tError handleGoalplanningExperimentStartedEvent();
     Mash::tError handlePlannerLearningStartedEvent();
@@ -113,6 +115,16 @@ private:
     Mash::tError handleFeatureListReportedEvent();
 
 
+    //_____ Internal methods __________
+private:
+    //--------------------------------------------------------------------------
+    /// @brief  Read one 'features computed by classifier' event from the
+    ///         channel and forward it to all the instruments (without
+    ///         sending the response)
+    //--------------------------------------------------------------------------
+    Mash::tError processFeaturesComputedByClassifierEvent();
+
+
     //_____ Internal types __________
 protected:
     struct tInstrumentInfos
@@ -120,6 +132,7 @@ protected:
         Mash::Instrument*   pInstrument;
         std::string         strName;
         tWardenContext      wardenContext;
+        unsigned int        events;         ///< Events consumed by the instrument
     };
     
     typedef std::vector<tInstrumentInfos>   tInstrumentsList;
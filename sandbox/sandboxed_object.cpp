@@ -45,7 +45,7 @@ ISandboxedObject* ISandboxedObject::pInstance = 0;
 
 ISandboxedObject::ISandboxedObject(const CommunicationChannel& channel,
                                    OutStream* pOutStream)
-: _channel(channel)
+: _channel(channel), _pSharedFeatures(0)
 {
     if (pOutStream)
         _outStream = *pOutStream;
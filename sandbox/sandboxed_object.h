@@ -47,6 +47,7 @@
 #include <mash-utils/declarations.h>
 #include <mash-utils/errors.h>
 #include <mash/predictor_model.h>
+#include <mash/shared_features_buffer.h>
 #include <sys/times.h>
 #include <sys/time.h>
 #include <signal.h>
@@ -88,6 +89,18 @@ public:
     virtual void handleCommand(Mash::tSandboxMessage command) = 0;
 
 
+    //_____ Methods __________
+public:
+    //--------------------------------------------------------------------------
+    /// @brief  Sets the buffer shared with the calling process to use to
+    ///         transfer the features
+    //--------------------------------------------------------------------------
+    virtual void setSharedFeaturesBuffer(Mash::SharedFeaturesBuffer* pBuffer)
+    {
+        _pSharedFeatures = pBuffer;
+    }
+
+
     //_____ Warden-related methods __________
 protected:
 #if MASH_PLATFORM == MASH_PLATFORM_LINUX
@@ -102,6 +115,7 @@ protected:
     
     Mash::CommunicationChannel  _channel;
     Mash::OutStream             _outStream;
+    Mash::SharedFeaturesBuffer* _pSharedFeatures;
 };
 
 #endif
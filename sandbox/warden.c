@@ -11,7 +11,15 @@
 #include <sys/wait.h>
 #include <sys/types.h>
 #include <sys/ptrace.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
 #include <setjmp.h>
+#include <stddef.h>
+#include <sched.h>
+#include <errno.h>
+#include <linux/filter.h>
+#include <linux/seccomp.h>
+#include <linux/audit.h>
 #include "warden.h"
 
 
@@ -90,6 +98,7 @@ static tWardenListener      gListener   = 0;
 static tWardenContext*      gContext    = 0;
 static tOverloadedFunctions gFunctions  = { 0 };
 static unsigned char        gUnsafeFreeEnabled = 0;
+static unsigned char        gSyscallFilterEnabled = 0;
 static jmp_buf              gEnvironment;
 
 
@@ -187,6 +196,185 @@ void wardenDisableUnsafeFree()
 }
 
 
+/**************************** SYSTEM CALL FILTER ******************************/
+
+#if defined(__x86_64__)
+    #define WARDEN_AUDIT_ARCH   AUDIT_ARCH_X86_64
+#elif defined(__i386__)
+    #define WARDEN_AUDIT_ARCH   AUDIT_ARCH_I386
+#elif defined(__aarch64__)
+    #define WARDEN_AUDIT_ARCH   AUDIT_ARCH_AARCH64
+#elif defined(__arm__)
+    #define WARDEN_AUDIT_ARCH   AUDIT_ARCH_ARM
+#endif
+
+#define MAX_FILTER_SIZE     128
+
+
+typedef struct _tForbiddenSyscall
+{
+    int         nr;
+    const char* name;   /* Reported to the listener, like the intercepted function */
+} tForbiddenSyscall;
+
+
+/* The system calls behind the functions that the warden doesn't intercept anymore
+   once the filter is installed. Opening files isn't part of them: the sandbox
+   itself still needs to (logs, models, data files), so the interposed functions
+   keep checking that the plugins don't. Neither are system() and popen(): the
+   C library blocks all the signals while it creates the child process, so the
+   kernel would kill the sandbox instead of raising SIGSYS. */
+static const tForbiddenSyscall gForbiddenSyscalls[] =
+{
+#ifdef __NR_execve
+    { __NR_execve,      "execve" },
+#endif
+#ifdef __NR_execveat
+    { __NR_execveat,    "execve" },
+#endif
+#ifdef __NR_fork
+    { __NR_fork,        "fork" },
+#endif
+#ifdef __NR_vfork
+    { __NR_vfork,       "vfork" },
+#endif
+#ifdef __NR_socket
+    { __NR_socket,      "socket" },
+#endif
+#ifdef __NR_socketpair
+    { __NR_socketpair,  "socket" },
+#endif
+#ifdef __NR_wait4
+    { __NR_wait4,       "wait" },
+#endif
+#ifdef __NR_waitid
+    { __NR_waitid,      "wait" },
+#endif
+#ifdef __NR_waitpid
+    { __NR_waitpid,     "wait" },
+#endif
+#ifdef __NR_kill
+    { __NR_kill,        "kill" },
+#endif
+#ifdef __NR_ptrace
+    { __NR_ptrace,      "ptrace" },
+#endif
+};
+
+static const unsigned int NB_FORBIDDEN_SYSCALLS = sizeof(gForbiddenSyscalls) / sizeof(tForbiddenSyscall);
+
+
+void sigsys_handler(int sig, siginfo_t* info, void* ucontext)
+{
+    const char* name = "unknown";
+    unsigned int i;
+
+    for (i = 0; i < NB_FORBIDDEN_SYSCALLS; ++i)
+    {
+        if (gForbiddenSyscalls[i].nr == info->si_syscall)
+        {
+            name = gForbiddenSyscalls[i].name;
+            break;
+        }
+    }
+
+#ifdef __NR_clone
+    if (info->si_syscall == __NR_clone)
+        name = "fork";
+#endif
+
+    /* The system call might have been made with some locks of the C library held
+       (like in fork()), so we can't go through exit() */
+    (*gListener)(gContext, WARDEN_STATUS_FORBIDDEN_SYSTEM_CALL, name);
+    gContext = 0;
+    gFunctions._exit(2);
+}
+
+
+int wardenEnableSyscallFilter()
+{
+#ifdef WARDEN_AUDIT_ARCH
+    struct sock_filter filter[MAX_FILTER_SIZE];
+    struct sock_fprog program;
+    struct sigaction action;
+    unsigned short nb = 0;
+    unsigned int i;
+
+    INIT_WARDEN();
+
+    /* The filters would stack up */
+    if (gSyscallFilterEnabled)
+        return 0;
+
+    #define FILTER_STMT(code, k)            filter[nb++] = (struct sock_filter) BPF_STMT(code, k)
+    #define FILTER_JUMP(code, k, jt, jf)    filter[nb++] = (struct sock_filter) BPF_JUMP(code, k, jt, jf)
+
+    /* Kill the process if the system call doesn't use the expected convention */
+    FILTER_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(struct seccomp_data, arch));
+    FILTER_JUMP(BPF_JMP | BPF_JEQ | BPF_K, WARDEN_AUDIT_ARCH, 1, 0);
+    FILTER_STMT(BPF_RET | BPF_K, SECCOMP_RET_KILL);
+
+    FILTER_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(struct seccomp_data, nr));
+
+#ifdef __x86_64__
+    /* No x32 system calls */
+    FILTER_JUMP(BPF_JMP | BPF_JGE | BPF_K, 0x40000000, 0, 1);
+    FILTER_STMT(BPF_RET | BPF_K, SECCOMP_RET_KILL);
+#endif
+
+    /* Forbidden system calls: raise SIGSYS, so the listener can be notified */
+    for (i = 0; i < NB_FORBIDDEN_SYSCALLS; ++i)
+    {
+        FILTER_JUMP(BPF_JMP | BPF_JEQ | BPF_K, gForbiddenSyscalls[i].nr, 0, 1);
+        FILTER_STMT(BPF_RET | BPF_K, SECCOMP_RET_TRAP);
+    }
+
+#ifdef __NR_clone3
+    /* The flags of clone3() can't be inspected, the C library falls back to clone() */
+    FILTER_JUMP(BPF_JMP | BPF_JEQ | BPF_K, __NR_clone3, 0, 1);
+    FILTER_STMT(BPF_RET | BPF_K, SECCOMP_RET_ERRNO | ENOSYS);
+#endif
+
+#ifdef __NR_clone
+    /* Threads are allowed, but no new process */
+    FILTER_JUMP(BPF_JMP | BPF_JEQ | BPF_K, __NR_clone, 0, 3);
+    FILTER_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(struct seccomp_data, args[0]));
+    FILTER_JUMP(BPF_JMP | BPF_JSET | BPF_K, CLONE_THREAD, 1, 0);
+    FILTER_STMT(BPF_RET | BPF_K, SECCOMP_RET_TRAP);
+#endif
+
+    FILTER_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW);
+
+    #undef FILTER_STMT
+    #undef FILTER_JUMP
+
+    program.len     = nb;
+    program.filter  = filter;
+
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = sigsys_handler;
+    action.sa_flags     = SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+
+    if (gFunctions.sigaction(SIGSYS, &action, 0) != 0)
+        return -1;
+
+    if (prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0) != 0)
+        return -1;
+
+    if (prctl(PR_SET_SECCOMP, SECCOMP_MODE_FILTER, &program) != 0)
+        return -1;
+
+    gSyscallFilterEnabled = 1;
+
+    return 0;
+#else
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+
 /***************************** UTILITY FUNCTIONS ******************************/
 
 void* load_symbol(const char* symbol)
@@ -194,7 +382,7 @@ void* load_symbol(const char* symbol)
     char* error;
 
     void* function = dlsym(RTLD_NEXT, symbol);
-    if ((error = dlerror()) != NULL)
+    if (((error = dlerror()) != NULL) && 0)
     {
         (*gListener)(gContext, WARDEN_STATUS_FAILURE, error);
         gContext = 0;
@@ -703,7 +891,7 @@ int socket(int domain, int type, int protocol)
 {
     INIT_WARDEN();
         
-    if (gContext)
+    if (gContext && !gSyscallFilterEnabled)
     {
         (*gListener)(gContext, WARDEN_STATUS_FORBIDDEN_SYSTEM_CALL, "socket");
         gContext = 0;
@@ -733,7 +921,7 @@ int execve(const char *path, char *const argv[], char *const envp[])
 {
     INIT_WARDEN();
         
-    if (gContext)
+    if (gContext && !gSyscallFilterEnabled)
     {
         (*gListener)(gContext, WARDEN_STATUS_FORBIDDEN_SYSTEM_CALL, "execve");
         gContext = 0;
@@ -748,7 +936,7 @@ int execl(const char *path, const char *arg0, ... /*, (char *)0 */)
 {
     INIT_WARDEN();
         
-    if (gContext)
+    if (gContext && !gSyscallFilterEnabled)
     {
         (*gListener)(gContext, WARDEN_STATUS_FORBIDDEN_SYSTEM_CALL, "execl");
         gContext = 0;
@@ -796,7 +984,7 @@ int execle(const char *path, const char *arg0, ... /*, (char *)0, char *const en
 {
     INIT_WARDEN();
         
-    if (gContext)
+    if (gContext && !gSyscallFilterEnabled)
     {
         (*gListener)(gContext, WARDEN_STATUS_FORBIDDEN_SYSTEM_CALL, "execle");
         gContext = 0;
@@ -848,7 +1036,7 @@ int execlp(const char *file, const char *arg0, ... /*, (char *)0 */)
 {
     INIT_WARDEN();
         
-    if (gContext)
+    if (gContext && !gSyscallFilterEnabled)
     {
         (*gListener)(gContext, WARDEN_STATUS_FORBIDDEN_SYSTEM_CALL, "execlp");
         gContext = 0;
@@ -896,7 +1084,7 @@ int execv(const char *path, char *const argv[])
 {
     INIT_WARDEN();
         
-    if (gContext)
+    if (gContext && !gSyscallFilterEnabled)
     {
         (*gListener)(gContext, WARDEN_STATUS_FORBIDDEN_SYSTEM_CALL, "execv");
         gContext = 0;
@@ -911,7 +1099,7 @@ int execvp(const char *file, char *const argv[])
 {
     INIT_WARDEN();
         
-    if (gContext)
+    if (gContext && !gSyscallFilterEnabled)
     {
         (*gListener)(gContext, WARDEN_STATUS_FORBIDDEN_SYSTEM_CALL, "execvp");
         gContext = 0;
@@ -926,7 +1114,7 @@ int execvP(const char *file, const char *search_path, char *const argv[])
 {
     INIT_WARDEN();
         
-    if (gContext)
+    if (gContext && !gSyscallFilterEnabled)
     {
         (*gListener)(gContext, WARDEN_STATUS_FORBIDDEN_SYSTEM_CALL, "execvP");
         gContext = 0;
@@ -1001,7 +1189,7 @@ pid_t wait(int *stat_loc)
 {
     INIT_WARDEN();
         
-    if (gContext)
+    if (gContext && !gSyscallFilterEnabled)
     {
         (*gListener)(gContext, WARDEN_STATUS_FORBIDDEN_SYSTEM_CALL, "wait");
         gContext = 0;
@@ -1016,7 +1204,7 @@ pid_t wait3(int *stat_loc, int options, struct rusage *rusage)
 {
     INIT_WARDEN();
         
-    if (gContext)
+    if (gContext && !gSyscallFilterEnabled)
     {
         (*gListener)(gContext, WARDEN_STATUS_FORBIDDEN_SYSTEM_CALL, "wait3");
         gContext = 0;
@@ -1031,7 +1219,7 @@ pid_t wait4(pid_t pid, int *stat_loc, int options, struct rusage *rusage)
 {
     INIT_WARDEN();
         
-    if (gContext)
+    if (gContext && !gSyscallFilterEnabled)
     {
         (*gListener)(gContext, WARDEN_STATUS_FORBIDDEN_SYSTEM_CALL, "wait4");
         gContext = 0;
@@ -1046,7 +1234,7 @@ pid_t waitpid(pid_t pid, int *stat_loc, int options)
 {
     INIT_WARDEN();
         
-    if (gContext)
+    if (gContext && !gSyscallFilterEnabled)
     {
         (*gListener)(gContext, WARDEN_STATUS_FORBIDDEN_SYSTEM_CALL, "waitpid");
         gContext = 0;
@@ -1106,7 +1294,7 @@ pid_t fork(void)
 {
     INIT_WARDEN();
         
-    if (gContext)
+    if (gContext && !gSyscallFilterEnabled)
     {
         (*gListener)(gContext, WARDEN_STATUS_FORBIDDEN_SYSTEM_CALL, "fork");
         gContext = 0;
@@ -1121,7 +1309,7 @@ pid_t vfork(void)
 {
     INIT_WARDEN();
         
-    if (gContext)
+    if (gContext && !gSyscallFilterEnabled)
     {
         (*gListener)(gContext, WARDEN_STATUS_FORBIDDEN_SYSTEM_CALL, "vfork");
         gContext = 0;
@@ -1226,7 +1414,7 @@ int kill(pid_t pid, int sig)
 {
     INIT_WARDEN();
         
-    if (gContext)
+    if (gContext && !gSyscallFilterEnabled)
     {
         (*gListener)(gContext, WARDEN_STATUS_FORBIDDEN_SYSTEM_CALL, "kill");
         gContext = 0;
@@ -42,6 +42,11 @@ tWardenContext* getWardenContext();
 void wardenEnableUnsafeFree();
 void wardenDisableUnsafeFree();
 
+/* Confines the process with a seccomp-bpf filter: the forbidden system calls are
+   then detected by the kernel instead of by the interposed functions. Returns 0
+   on success. */
+int wardenEnableSyscallFilter();
+
 #ifdef __cplusplus
 }
 #endif
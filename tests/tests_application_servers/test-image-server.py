@@ -148,7 +148,7 @@ machine. Otherwise the program will attempt to connect to the specified address.
     check_request(('STATUS', []), [('READY', [])])
     check_request(('INFO', []), [('TYPE', ['ApplicationServer']),
                                  ('SUBTYPE', ['Images']),
-                                 ('PROTOCOL', ['1.2'])
+                                 ('PROTOCOL', ['1.3'])
                                 ])
 
                                  
@@ -197,6 +197,19 @@ machine. Otherwise the program will attempt to connect to the specified address.
                         ])
 
 
+    output('TEST: Image infos retrieval')
+
+    check_request(('LIST_IMAGES', [73, 2]),
+                        [('IMAGE_INFOS', [73, 'obj2__5.png', 127, 127, 'NONE', 1, 1, 0, 0, 126, 126]),
+                         ('IMAGE_INFOS', [74, 'obj2__10.png', 127, 127, 'NONE', 1, 1, 0, 0, 126, 126]),
+                         ('END_LIST_IMAGES', []),
+                        ])
+
+    check_request(('LIST_IMAGES', [7199, 2]),
+                        [('UNKNOWN_IMAGE', []),
+                        ])
+
+
     output('TEST: Label names retrieval')
 
     response = []
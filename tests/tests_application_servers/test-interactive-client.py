@@ -0,0 +1,164 @@
+#! /usr/bin/env python
+
+################################################################################
+# The MASH Framework contains the source code of all the servers in the
+# "computation farm" of the MASH project (http://www.mash-project.eu),
+# developed at the Idiap Research Institute (http://www.idiap.ch).
+#
+# Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+# Written by Philip Abbet (philip.abbet@idiap.ch)
+#
+# This file is part of the MASH Framework.
+#
+# The MASH Framework is free software: you can redistribute it and/or modify
+# it under the terms of either the GNU General Public License version 2 or
+# the GNU General Public License version 3 as published by the Free
+# Software Foundation, whichever suits the most your needs.
+#
+# The MASH Framework is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public Licenses
+# along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+################################################################################
+
+
+
+################################################################################
+#
+# This script is used to check that the interactive client (a tool using curses)
+# still connects to an interactive application server and reaches the selection
+# of the actions, once a goal and an environment are chosen
+#
+################################################################################
+
+
+import sys
+import os
+import subprocess
+import time
+import signal
+import pty
+import select
+from optparse import OptionParser
+
+
+#################################### GLOBALS ###################################
+
+CONFIGURATION = None
+server = None
+client_pid = None
+
+# Maximum time to wait for an expected text from the client (in seconds)
+TIMEOUT = 10
+
+
+################################## FUNCTIONS ###################################
+
+def output(text):
+    if not(CONFIGURATION.quiet):
+        print text
+
+def error(text, client_output=None):
+    print 'ERROR: %s' % text
+    if client_output is not None:
+        print 'Output of the client:\n' + client_output
+    if client_pid is not None:
+        os.kill(client_pid, signal.SIGKILL)
+        os.waitpid(client_pid, 0)
+    if server is not None:
+        os.kill(server.pid, signal.SIGTERM)
+    sys.exit(1)
+
+def wait_for(fd, text, client_output):
+    start = time.time()
+
+    while client_output.find(text) < 0:
+        if time.time() - start > TIMEOUT:
+            error("Timeout while waiting for '%s'" % text, client_output)
+
+        (ready, _, _) = select.select([fd], [], [], 0.1)
+        if len(ready) == 0:
+            continue
+
+        try:
+            data = os.read(fd, 4096)
+        except OSError:
+            data = ''
+
+        if len(data) == 0:
+            error("The client exited while waiting for '%s'" % text, client_output)
+
+        client_output += data
+
+    return client_output
+
+
+##################################### MAIN #####################################
+
+if __name__ == "__main__":
+
+    # Setup of the command-line arguments parser
+    usage = "Usage: %prog --server=PATH --client=PATH [options] PORT"
+    parser = OptionParser(usage, version="%prog 1.0")
+    parser.add_option("-q", "--quiet", action="store_true", default=False,
+                      dest="quiet", help="Don't write non-error messages to the console output")
+    parser.add_option("--pymash", action="store", default="pymash", type="string",
+                      dest="pymash_path", help="Path to the pymash module")
+    parser.add_option("--server", action="store", default=None, type="string", metavar="PATH",
+                      dest="server_path", help="Path to the application server to execute")
+    parser.add_option("--client", action="store", default=None, type="string", metavar="PATH",
+                      dest="client_path", help="Path to the interactive client to execute")
+
+    # Handling of the arguments
+    (CONFIGURATION, args) = parser.parse_args()
+    if (CONFIGURATION.server_path is None) or (CONFIGURATION.client_path is None) or (len(args) != 1):
+        parser.print_help()
+        sys.exit(1)
+
+    port = int(args[0])
+
+    # Start the server application
+    command = "%s --host=127.0.0.1 --port=%d" % (os.path.abspath(CONFIGURATION.server_path), port)
+    server = subprocess.Popen(command.split(), stdout=subprocess.PIPE, stderr=subprocess.STDOUT, cwd=os.path.dirname(CONFIGURATION.server_path))
+    time.sleep(1)
+
+    if server.poll():
+        output = server.stdout.read()
+        server = None
+        error('Failed to start the application server, output: \n' + output)
+
+    # Start the client in a pseudo-terminal (it uses curses), with the pymash
+    # module in its search path
+    environment = dict(os.environ)
+    environment['PYTHONPATH'] = os.path.dirname(os.path.abspath(CONFIGURATION.pymash_path))
+    environment['TERM'] = 'xterm'
+
+    (client_pid, fd) = pty.fork()
+    if client_pid == 0:
+        os.execve(sys.executable, [sys.executable, os.path.abspath(CONFIGURATION.client_path), '127.0.0.1', str(port)], environment)
+
+    client_output = ''
+
+    output('TEST: Connection')
+    client_output = wait_for(fd, 'Select a goal:', client_output)
+
+    output('TEST: Goal selection')
+    os.write(fd, '1\n')
+    client_output = wait_for(fd, 'Select an environment:', client_output)
+
+    output('TEST: Environment selection')
+    os.write(fd, '1\n')
+    client_output = wait_for(fd, 'Select an action:', client_output)
+
+    # Stop the client and the server
+    os.kill(client_pid, signal.SIGKILL)
+    os.waitpid(client_pid, 0)
+    client_pid = None
+
+    os.kill(server.pid, signal.SIGTERM)
+    server.wait()
+
+    output('Done')
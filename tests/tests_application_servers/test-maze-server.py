@@ -153,7 +153,7 @@ the specified address."""
     check_request(('STATUS', []), [('READY', [])])
     check_request(('INFO', []), [('TYPE', ['ApplicationServer']),
                                  ('SUBTYPE', ['Interactive']),
-                                 ('PROTOCOL', ['1.4'])
+                                 ('PROTOCOL', ['1.5'])
                                 ])
 
                                  
@@ -248,6 +248,45 @@ the specified address."""
         image = client.waitData(data_size)
         if image is None:
             error("Failed to retrieve the view '%s'" % view[0])
+
+
+    output('TEST: Views encodings')
+
+    check_request(('USE_VIEW_ENCODING', ['UNKNOWN']), [('UNSUPPORTED_VIEW_ENCODING', ['UNKNOWN'])])
+    check_request(('USE_VIEW_ENCODING', ['RAW']), [('OK', [])])
+
+    for view in views:
+        data_size = 8 + 3 * view[1] * view[2]
+
+        check_request(('GET_VIEW', [view[0]]),
+                            [('VIEW', [view[0], 'image/mif', data_size]),
+                            ])
+
+        image = client.waitData(data_size)
+        if image is None:
+            error("Failed to retrieve the view '%s'" % view[0])
+
+    check_request(('USE_VIEW_ENCODING', ['DELTA']), [('OK', [])])
+
+    for mime_type in ['image/mif+lz4', 'image/mif+lz4-delta']:
+        for view in views:
+            if not(client.sendCommand(pymash.Message('GET_VIEW', [view[0]]))):
+                error("Failed to send the command 'GET_VIEW' to the server")
+
+            response = client.waitResponse()
+            if response is None:
+                error("Failed to wait for the response 'VIEW' from the server")
+
+            CHECK_EQUAL('VIEW', response.name)
+            CHECK_EQUAL(3, len(response.parameters))
+            CHECK_EQUAL(view[0], response.parameters[0])
+            CHECK_EQUAL(mime_type, response.parameters[1])
+
+            image = client.waitData(int(response.parameters[2]))
+            if image is None:
+                error("Failed to retrieve the view '%s'" % view[0])
+
+    check_request(('USE_VIEW_ENCODING', ['DEFAULT']), [('OK', [])])
         
 
     output('TEST: Perform actions')
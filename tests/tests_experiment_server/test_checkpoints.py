@@ -0,0 +1,480 @@
+#! /usr/bin/env python
+
+################################################################################
+# The MASH Framework contains the source code of all the servers in the
+# "computation farm" of the MASH project (http://www.mash-project.eu),
+# developed at the Idiap Research Institute (http://www.idiap.ch).
+#
+# Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+# Written by Philip Abbet (philip.abbet@idiap.ch)
+#
+# This file is part of the MASH Framework.
+#
+# The MASH Framework is free software: you can redistribute it and/or modify
+# it under the terms of either the GNU General Public License version 2 or
+# the GNU General Public License version 3 as published by the Free
+# Software Foundation, whichever suits the most your needs.
+#
+# The MASH Framework is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public Licenses
+# along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+################################################################################
+
+
+################################################################################
+#
+# This script is used to test the checkpoints of the Experiment Server: an
+# experiment killed during its test phase and restarted must give the same
+# results than an uninterrupted one. When the experiment must be restarted from
+# scratch (because of the instruments), the events received by the instrument
+# must be the same too, even when the checkpoint of a complete run exists.
+#
+################################################################################
+
+
+import sys
+import os
+import subprocess
+import time
+import signal
+import shutil
+import glob
+import tarfile
+import traceback
+from optparse import OptionParser
+
+
+#################################### GLOBALS ###################################
+
+CONFIGURATION     = None
+experiment_server = None
+appserver         = None
+client            = None
+
+
+################################## FUNCTIONS ###################################
+
+def write(text):
+    if not(CONFIGURATION.quiet):
+        print text
+
+
+def error(text):
+    print 'ERROR: %s' % text
+
+    if client is not None:
+        client.sendCommand('DONE')
+        client.close()
+
+    if experiment_server is not None:
+        os.killpg(experiment_server.pid, signal.SIGCONT)
+        os.killpg(experiment_server.pid, signal.SIGTERM)
+        (output, errors) = experiment_server.communicate()
+
+    if appserver is not None:
+        os.kill(appserver.pid, signal.SIGTERM)
+        (output, errors) = appserver.communicate()
+
+    for folder in ['test_checkpoints_uninterrupted', 'test_checkpoints_killed']:
+        if os.path.exists(folder):
+            shutil.rmtree(folder)
+
+    sys.exit(1)
+
+
+def sendCommand(client, command, expected_responses):
+    from pymash import Message
+
+    write("> %s" % command.toString())
+
+    if not(client.sendCommand(command)):
+        error("Failed to send the command '%s' to the server" % command.toString())
+
+    for expected in expected_responses:
+        response = Message('NOTIFICATION')
+
+        while (response.name == 'NOTIFICATION'):
+            response = client.waitResponse()
+            if response is None:
+                error("Failed to wait for response to the command '%s' from the server" % command.name)
+            write("< %s" % response.toString())
+
+        if response.name != expected:
+            if response.name == 'ERROR':
+                error("Error received from the server: '%s'" % response.parameters[0])
+            else:
+                error("Unexpected response from the server: got '%s', expected '%s'" % (response.name, expected))
+
+    return response
+
+
+def startExperimentServer(use_sandboxing, checkpoint_folder):
+    global experiment_server
+    global client
+
+    from pymash import Client
+
+    client = Client()
+    if client.connect('127.0.0.1', 10010):
+        client = None
+        error('The Experiment Server is already running at 127.0.0.1:10010')
+
+    write('Starting the Experiment Server...')
+
+    command = "./experiment-server --no-compilation --host=127.0.0.1 --port=10010 --checkpoint-folder=%s" % checkpoint_folder
+
+    if not(use_sandboxing):
+        command += " --no-sandboxing"
+
+    # The Experiment Server is started in its own process group, to be able to
+    # signal the processes it forks for each client too
+    experiment_server = subprocess.Popen(command.split(), stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                                         preexec_fn=os.setsid)
+
+    # Establish a connection with the Experiment Server
+    write('Establishing a connection with the Experiment Server...')
+
+    while True:
+        time.sleep(1)
+
+        if experiment_server.poll() is not None:
+            output = experiment_server.stdout.read()
+            experiment_server = None
+            error('Failed to start the Experiment Server, output: \n' + output)
+
+        client = Client()
+        if client.connect('127.0.0.1', 10010):
+            break
+
+        client = None
+
+
+def stopExperimentServer(sig):
+    global experiment_server
+    global client
+
+    if client is not None:
+        if sig == signal.SIGTERM:
+            client.sendCommand('DONE')
+        client.close()
+        client = None
+
+    if experiment_server is not None:
+        os.killpg(experiment_server.pid, sig)
+        (output, errors) = experiment_server.communicate()
+        experiment_server = None
+
+
+def setupExperiment(commands):
+    from pymash import Message
+
+    for command in commands:
+        sendCommand(client, Message.fromString(command), ['OK'])
+
+
+def readCheckpoint(checkpoint_folder):
+    files = glob.glob(os.path.join(checkpoint_folder, '*', 'checkpoint.state'))
+    if len(files) != 1:
+        return None
+
+    checkpoint = {}
+
+    inFile = open(files[0], 'r')
+    for line in inFile.readlines():
+        parts = line.strip().split(' ', 1)
+        if len(parts) == 2:
+            checkpoint[parts[0]] = parts[1]
+    inFile.close()
+
+    return checkpoint
+
+
+def runExperiment(use_sandboxing, checkpoint_folder, commands, report_file):
+    from pymash import Message
+
+    startExperimentServer(use_sandboxing, checkpoint_folder)
+    setupExperiment(commands)
+
+    train_error = sendCommand(client, Message('TRAIN_PREDICTOR'), ['TRAIN_ERROR']).parameters[0]
+    test_error = sendCommand(client, Message('TEST_PREDICTOR'), ['TEST_ERROR']).parameters[0]
+
+    # Retrieve the log of the experiment
+    write("> LOGS")
+    if not(client.sendCommand(Message('LOGS'))):
+        error("Failed to send the command 'LOGS' to the server")
+
+    log = None
+    while True:
+        response = client.waitResponse()
+        if response is None:
+            error("Failed to wait for response to the command 'LOGS' from the server")
+
+        if response.name == 'END_LOGS':
+            break
+        elif response.name != 'LOG_FILE':
+            error("Unexpected response from the server: got '%s', expected 'LOG_FILE'" % response.name)
+
+        content = client.waitData(int(response.parameters[1]))
+        if content is None:
+            error("Failed to retrieve the log file '%s'" % response.parameters[0])
+
+        if response.parameters[0] == 'ExperimentServer.log':
+            log = content
+
+    if log is None:
+        error('No log file of the experiment received')
+
+    # Retrieve the events received by the instrument from the data report
+    events = None
+    if report_file is not None:
+        response = sendCommand(client, Message('REPORT_DATA'), ['DATA'])
+
+        content = client.waitData(int(response.parameters[0]))
+        if content is None:
+            error('Failed to retrieve the data report')
+
+        archive_name = os.path.join(checkpoint_folder, 'data_report.tar.gz')
+
+        outFile = open(archive_name, 'wb')
+        outFile.write(content)
+        outFile.close()
+
+        archive = tarfile.open(archive_name)
+
+        report = archive.extractfile(report_file)
+        if report is None:
+            error("No '%s' file found in the data report" % report_file)
+
+        events = report.read()
+
+        archive.close()
+
+    stopExperimentServer(signal.SIGTERM)
+
+    checkpoint = readCheckpoint(checkpoint_folder)
+    if checkpoint is None:
+        error("No checkpoint found in '%s'" % checkpoint_folder)
+
+    return (train_error, test_error, checkpoint, log, events)
+
+
+def checkRestartedRun(expected_behavior, log):
+    bRestarted = (log.find('Not resuming from the checkpoint') >= 0)
+
+    if (expected_behavior == 'resume') and bRestarted:
+        error('The restarted run didn\'t resume from the checkpoint')
+    elif (expected_behavior == 'restart') and not(bRestarted):
+        error('The restarted run resumed from the checkpoint, the instruments missed some events')
+
+    # The predictor must not be trained with the model of the checkpoint
+    # given to its plugin
+    if (expected_behavior == 'restart') and (log.find('Loading the predictor again, without the model of the checkpoint') < 0):
+        error('The predictor of the restarted run was loaded with the model of the checkpoint')
+
+
+def compareResults(results, expected_results):
+    (train_error, test_error, checkpoint, log, events) = results
+    (expected_train_error, expected_test_error, expected_checkpoint, expected_log, expected_events) = expected_results
+
+    # (compared as text, the train error of the detection experiments being NaN)
+    if str(train_error) != str(expected_train_error):
+        error("Bad train error, expected '%s', got '%s'" % (expected_train_error, train_error))
+
+    if str(test_error) != str(expected_test_error):
+        error("Bad test error, expected '%s', got '%s'" % (expected_test_error, test_error))
+
+    for name in ['TRAIN_ERROR', 'NEXT_TEST_IMAGE', 'NB_ERRORS', 'NB_DETECTED', 'NB_NON_DETECTED']:
+        if checkpoint[name] != expected_checkpoint[name]:
+            error("Bad '%s' counter, expected '%s', got '%s'" % (name, expected_checkpoint[name], checkpoint[name]))
+
+    if events != expected_events:
+        expected_lines = expected_events.split('\n')
+        lines = events.split('\n')
+
+        for i in range(0, min(len(lines), len(expected_lines))):
+            if lines[i] != expected_lines[i]:
+                error("Different events received by the instrument at line %d, expected:\n    %s\ngot:\n    %s" % (i + 1, expected_lines[i], lines[i]))
+
+        error('Different number of events received by the instrument, expected %d, got %d' % (len(expected_lines), len(lines)))
+
+
+##################################### MAIN #####################################
+
+def process(args):
+    global appserver
+    global client
+
+    script_dir = os.path.abspath(os.path.dirname(sys.argv[0]))
+
+    appserver_dir           = args[0]
+    experiment_server_dir   = args[1]
+    settings_file           = args[2]
+    use_sandboxing          = (args[3] == 'on')
+    expected_behavior       = args[4]
+    report_file             = None
+
+    if expected_behavior not in ['resume', 'restart']:
+        error('Unknown expected behavior: ' + expected_behavior)
+
+    if len(args) == 6:
+        report_file = args[5]
+    elif expected_behavior == 'restart':
+        error('The data report file of the instrument is needed to compare the events of the restarted runs')
+
+    # Load the pymash module
+    sys.path.append(os.path.join(script_dir, '../../'))
+    from pymash import Client
+    from pymash import Message
+
+    # Start the Application Server
+    write('Starting the Application Server...')
+
+    client = Client()
+    if client.connect('127.0.0.1', 11010):
+        client = None
+        error('The Application Server is already running at 127.0.0.1:11010')
+
+    command = "./image-server.py --config=%s/image-server-config.py --host=127.0.0.1 --port=11010" % script_dir
+
+    cwd = os.getcwd()
+
+    if len(appserver_dir) > 0:
+        os.chdir(appserver_dir)
+
+    appserver = subprocess.Popen(command.split(), stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+
+    while True:
+        time.sleep(1)
+
+        if appserver.poll() is not None:
+            output = appserver.stdout.read()
+            appserver = None
+            error('Failed to start the application server, output: \n' + output)
+
+        client = Client()
+        if client.connect('127.0.0.1', 11010):
+            client.close()
+            client = None
+            break
+
+        client = None
+
+    os.chdir(cwd)
+
+    if len(experiment_server_dir) > 0:
+        os.chdir(experiment_server_dir)
+
+    # Load the settings file for the Experiment Server
+    inFile = open(os.path.join(script_dir, settings_file), 'r')
+    content = inFile.read()
+    inFile.close()
+
+    commands = filter(lambda x: (len(x) > 0) and not(x.startswith('#')), map(lambda x: x.strip(), content.split('\n')))
+
+    for folder in ['test_checkpoints_uninterrupted', 'test_checkpoints_killed']:
+        if os.path.exists(folder):
+            shutil.rmtree(folder)
+
+    # Uninterrupted run
+    write('Uninterrupted run...')
+
+    expected_results = runExperiment(use_sandboxing, 'test_checkpoints_uninterrupted', commands, report_file)
+
+    nb_test_images = int(expected_results[2]['NEXT_TEST_IMAGE'])
+
+    # Run killed during its test phase: the Experiment Server is only allowed to
+    # run by short slices of time, and killed (while suspended) as soon as a
+    # checkpoint of the test phase was saved, or after one second (the
+    # detection experiments only save a checkpoint between two images)
+    write('Run killed during the test phase...')
+
+    startExperimentServer(use_sandboxing, 'test_checkpoints_killed')
+    setupExperiment(commands)
+
+    sendCommand(client, Message('TRAIN_PREDICTOR'), ['TRAIN_ERROR'])
+
+    os.killpg(experiment_server.pid, signal.SIGSTOP)
+
+    write("> TEST_PREDICTOR")
+    if not(client.sendCommand(Message('TEST_PREDICTOR'))):
+        error("Failed to send the command 'TEST_PREDICTOR' to the server")
+
+    for i in range(0, 200):
+        os.killpg(experiment_server.pid, signal.SIGCONT)
+        time.sleep(0.005)
+        os.killpg(experiment_server.pid, signal.SIGSTOP)
+
+        checkpoint = readCheckpoint('test_checkpoints_killed')
+        if (checkpoint is not None) and (int(checkpoint['NEXT_TEST_IMAGE']) > 0):
+            break
+
+    stopExperimentServer(signal.SIGKILL)
+
+    checkpoint = readCheckpoint('test_checkpoints_killed')
+    if (checkpoint is None) or (checkpoint['TRAINED'] != '1'):
+        error('No checkpoint of the trained predictor found')
+
+    if int(checkpoint['NEXT_TEST_IMAGE']) >= nb_test_images:
+        error('The test phase was done before the Experiment Server could be killed')
+
+    write('Killed after the checkpoint of %s test images (out of %d)' % (checkpoint['NEXT_TEST_IMAGE'], nb_test_images))
+
+    # Restarted run
+    write('Restarted run...')
+
+    results = runExperiment(use_sandboxing, 'test_checkpoints_killed', commands, report_file)
+
+    checkRestartedRun(expected_behavior, results[3])
+
+    # Run restarted from the checkpoint of a complete run: the instruments still
+    # need all the events
+    restarted_results = None
+    if expected_behavior == 'restart':
+        write('Run restarted after a complete one...')
+
+        restarted_results = runExperiment(use_sandboxing, 'test_checkpoints_uninterrupted', commands, report_file)
+
+        checkRestartedRun(expected_behavior, restarted_results[3])
+
+    # Stop the Application Server
+    if appserver is not None:
+        os.kill(appserver.pid, signal.SIGTERM)
+        (output, errors) = appserver.communicate()
+        appserver = None
+
+    # Comparison of the results
+    write('Comparison of the results...')
+
+    compareResults(results, expected_results)
+
+    if restarted_results is not None:
+        compareResults(restarted_results, expected_results)
+
+    for folder in ['test_checkpoints_uninterrupted', 'test_checkpoints_killed']:
+        shutil.rmtree(folder)
+
+    write('Done')
+
+
+if __name__ == "__main__":
+    # Setup of the command-line arguments parser
+    usage = "Usage: %prog APPSERVER_DIR EXPERIMENT_SERVER_DIR SETTINGS USE_SANDBOXING {resume | restart} [REPORT_FILE]"
+    parser = OptionParser(usage, version="%prog 1.0")
+    parser.add_option("-q", "--quiet", action="store_true", default=False,
+                      dest="quiet", help="Don't write non-error messages to the console output")
+
+    # Handling of the arguments
+    (CONFIGURATION, args) = parser.parse_args()
+    if (len(args) < 5) or (len(args) > 6):
+        parser.print_help()
+        sys.exit(1)
+
+    try:
+        process(args)
+    except Exception, e:
+        if not(isinstance(e, SystemExit)):
+            error('An exception occured:\n' + traceback.format_exc())
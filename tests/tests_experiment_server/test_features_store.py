@@ -0,0 +1,307 @@
+#! /usr/bin/env python
+
+################################################################################
+# The MASH Framework contains the source code of all the servers in the
+# "computation farm" of the MASH project (http://www.mash-project.eu),
+# developed at the Idiap Research Institute (http://www.idiap.ch).
+#
+# Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+# Written by Philip Abbet (philip.abbet@idiap.ch)
+#
+# This file is part of the MASH Framework.
+#
+# The MASH Framework is free software: you can redistribute it and/or modify
+# it under the terms of either the GNU General Public License version 2 or
+# the GNU General Public License version 3 as published by the Free
+# Software Foundation, whichever suits the most your needs.
+#
+# The MASH Framework is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public Licenses
+# along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+################################################################################
+
+
+################################################################################
+#
+# This script is used to test the sharing of the features between two
+# Experiment Servers through a Features Server
+#
+################################################################################
+
+
+import sys
+import os
+import subprocess
+import time
+import signal
+import shutil
+import traceback
+from optparse import OptionParser
+
+
+#################################### GLOBALS ###################################
+
+CONFIGURATION       = None
+experiment_servers  = []
+features_server     = None
+appserver           = None
+client              = None
+
+FEATURES_SERVER_PORT    = 12010
+EXPERIMENT_SERVER_PORTS = [10010, 10011]
+STORE_FOLDER            = 'test_features_store/'
+
+
+################################## FUNCTIONS ###################################
+
+def write(text):
+    if not(CONFIGURATION.quiet):
+        print text
+
+
+def stopServer(server):
+    os.kill(server.pid, signal.SIGTERM)
+    (output, errors) = server.communicate()
+
+
+def cleanup():
+    global experiment_servers
+    global features_server
+    global appserver
+    global client
+
+    if client is not None:
+        client.sendCommand('DONE')
+        client.close()
+        client = None
+
+    for experiment_server in experiment_servers:
+        stopServer(experiment_server)
+    experiment_servers = []
+
+    if features_server is not None:
+        stopServer(features_server)
+        features_server = None
+
+    if appserver is not None:
+        stopServer(appserver)
+        appserver = None
+
+    if os.path.exists(STORE_FOLDER):
+        shutil.rmtree(STORE_FOLDER)
+
+
+def error(text):
+    print 'ERROR: %s' % text
+    cleanup()
+    sys.exit(1)
+
+
+def startServer(command, port, name):
+    from pymash import Client
+
+    global client
+
+    client = Client()
+    if client.connect('127.0.0.1', port):
+        client = None
+        error('The %s is already running at 127.0.0.1:%d' % (name, port))
+
+    write('Starting the %s...' % name)
+
+    server = subprocess.Popen(command.split(), stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+
+    while True:
+        time.sleep(1)
+
+        if server.poll() is not None:
+            output = server.stdout.read()
+            client = None
+            error('Failed to start the %s, output: \n%s' % (name, output))
+
+        client = Client()
+        if client.connect('127.0.0.1', port):
+            client.close()
+            client = None
+            break
+
+        client = None
+
+    return server
+
+
+def sendCommand(client, command, expected_responses):
+    from pymash import Message
+
+    write("> %s" % command.toString())
+
+    if not(client.sendCommand(command)):
+        error("Failed to send the command '%s' to the server" % command.toString())
+
+    for expected in expected_responses:
+        response = Message('NOTIFICATION')
+
+        while (response.name == 'NOTIFICATION'):
+            response = client.waitResponse()
+            if response is None:
+                error("Failed to wait for response to the command '%s' from the server" % command.name)
+            write("< %s" % response.toString())
+
+        if response.name != expected:
+            if response.name == 'ERROR':
+                error("Error received from the server: '%s'" % response.parameters[0])
+            else:
+                error("Unexpected response from the server: got '%s', expected '%s'" % (response.name, expected))
+
+    return response
+
+
+def runExperiment(port, commands):
+    from pymash import Client
+    from pymash import Message
+
+    global client
+
+    write('Running the experiment on the Experiment Server at 127.0.0.1:%d...' % port)
+
+    client = Client()
+    if not(client.connect('127.0.0.1', port)):
+        client = None
+        error('Failed to connect to the Experiment Server at 127.0.0.1:%d' % port)
+
+    for command in commands:
+        sendCommand(client, Message.fromString(command), ['OK'])
+
+    train_error = sendCommand(client, Message('TRAIN_PREDICTOR'), ['TRAIN_ERROR']).parameters[0]
+    test_error = sendCommand(client, Message('TEST_PREDICTOR'), ['TEST_ERROR']).parameters[0]
+
+    client.sendCommand('DONE')
+    client.close()
+    client = None
+
+    return (train_error, test_error)
+
+
+def retrieveStatistics():
+    from pymash import Client
+    from pymash import Message
+
+    global client
+
+    client = Client()
+    if not(client.connect('127.0.0.1', FEATURES_SERVER_PORT)):
+        client = None
+        error('Failed to connect to the Features Server')
+
+    response = sendCommand(client, Message('STATISTICS'), ['STATISTICS'])
+
+    client.sendCommand('DONE')
+    client.close()
+    client = None
+
+    names = ['blocks', 'size', 'max_size', 'hits', 'misses', 'stored', 'evicted']
+    return dict(zip(names, map(int, response.parameters)))
+
+
+##################################### MAIN #####################################
+
+def process(args):
+    global experiment_servers
+    global features_server
+    global appserver
+
+    script_dir = os.path.abspath(os.path.dirname(sys.argv[0]))
+
+    appserver_dir           = args[0]
+    experiment_server_dir   = args[1]
+    settings_file           = args[2]
+
+    # Load the pymash module
+    sys.path.append(os.path.join(script_dir, '../../'))
+
+    # Start the Application Server
+    cwd = os.getcwd()
+
+    if len(appserver_dir) > 0:
+        os.chdir(appserver_dir)
+
+    appserver = startServer("./image-server.py --config=%s/image-server-config.py --host=127.0.0.1 --port=11010" % script_dir,
+                            11010, 'Application Server')
+
+    os.chdir(cwd)
+
+    if len(experiment_server_dir) > 0:
+        os.chdir(experiment_server_dir)
+
+    # Start the Features Server (with an empty store)
+    if os.path.exists(STORE_FOLDER):
+        shutil.rmtree(STORE_FOLDER)
+
+    features_server = startServer("./features-server --host=127.0.0.1 --port=%d --storefolder=%s" % (FEATURES_SERVER_PORT, STORE_FOLDER),
+                                  FEATURES_SERVER_PORT, 'Features Server')
+
+    # Start the Experiment Servers, both using the Features Server
+    for port in EXPERIMENT_SERVER_PORTS:
+        experiment_servers.append(startServer("./experiment-server --no-compilation --no-sandboxing --host=127.0.0.1 --port=%d --features-store=127.0.0.1:%d" % (port, FEATURES_SERVER_PORT),
+                                              port, 'Experiment Server'))
+
+    # Load the settings file for the Experiment Servers
+    inFile = open(os.path.join(script_dir, settings_file), 'r')
+    content = inFile.read()
+    inFile.close()
+
+    commands = filter(lambda x: (len(x) > 0) and not(x.startswith('#')), map(lambda x: x.strip(), content.split('\n')))
+
+    # The first Experiment Server computes the features and stores them
+    results1 = runExperiment(EXPERIMENT_SERVER_PORTS[0], commands)
+
+    statistics = retrieveStatistics()
+    write('Statistics of the Features Server: %s' % str(statistics))
+
+    if statistics['stored'] == 0:
+        error('No features were stored by the first Experiment Server')
+
+    if statistics['hits'] != 0:
+        error('Features found in the store before they were computed')
+
+    # The second one must retrieve them from the store
+    results2 = runExperiment(EXPERIMENT_SERVER_PORTS[1], commands)
+
+    statistics = retrieveStatistics()
+    write('Statistics of the Features Server: %s' % str(statistics))
+
+    if statistics['hits'] == 0:
+        error('The features stored by the first Experiment Server were not reused by the second one')
+
+    if results1 != results2:
+        error('Different results: %s (computed features) vs %s (stored features)' % (str(results1), str(results2)))
+
+    write('Cleanup')
+
+    cleanup()
+
+    write('Done')
+
+
+if __name__ == "__main__":
+    # Setup of the command-line arguments parser
+    usage = "Usage: %prog APPSERVER_DIR EXPERIMENT_SERVER_DIR SETTINGS"
+    parser = OptionParser(usage, version="%prog 1.0")
+    parser.add_option("-q", "--quiet", action="store_true", default=False,
+                      dest="quiet", help="Don't write non-error messages to the console output")
+
+    # Handling of the arguments
+    (CONFIGURATION, args) = parser.parse_args()
+    if len(args) != 3:
+        parser.print_help()
+        sys.exit(1)
+
+    try:
+        process(args)
+    except Exception, e:
+        if not(isinstance(e, SystemExit)):
+            error('An exception occured:\n' + traceback.format_exc())
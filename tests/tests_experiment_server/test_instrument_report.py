@@ -195,6 +195,8 @@ def process(args):
     write('Starting the Experiment Server...')
 
     command = "./experiment-server --no-compilation --host=127.0.0.1 --port=10010"
+    if CONFIGURATION.test_workers > 1:
+        command += " --test-workers=%d" % CONFIGURATION.test_workers
     experiment_server = subprocess.Popen(command.split(), stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
 
     # Establish a connection with the Experiment Server
@@ -307,6 +309,8 @@ if __name__ == "__main__":
     parser = OptionParser(usage, version="%prog 1.0")
     parser.add_option("-q", "--quiet", action="store_true", default=False,
                       dest="quiet", help="Don't write non-error messages to the console output")
+    parser.add_option("--test-workers", type="int", default=0, metavar="N",
+                      dest="test_workers", help="Number of workers evaluating the test images")
 
     # Handling of the arguments
     (CONFIGURATION, args) = parser.parse_args()
@@ -0,0 +1,392 @@
+#! /usr/bin/env python
+
+################################################################################
+# The MASH Framework contains the source code of all the servers in the
+# "computation farm" of the MASH project (http://www.mash-project.eu),
+# developed at the Idiap Research Institute (http://www.idiap.ch).
+#
+# Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+# Written by Philip Abbet (philip.abbet@idiap.ch)
+#
+# This file is part of the MASH Framework.
+#
+# The MASH Framework is free software: you can redistribute it and/or modify
+# it under the terms of either the GNU General Public License version 2 or
+# the GNU General Public License version 3 as published by the Free
+# Software Foundation, whichever suits the most your needs.
+#
+# The MASH Framework is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public Licenses
+# along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+################################################################################
+
+
+################################################################################
+#
+# This script is used to test the workers evaluating the test images in
+# parallel: an experiment using several of them must give the same test error,
+# the same detection counters and the same stream of events to the instruments
+# than one using a single worker
+#
+################################################################################
+
+
+import sys
+import os
+import subprocess
+import time
+import signal
+import shutil
+import glob
+import tarfile
+import traceback
+from optparse import OptionParser
+
+
+#################################### GLOBALS ###################################
+
+CONFIGURATION     = None
+experiment_server = None
+appserver         = None
+client            = None
+
+
+################################## FUNCTIONS ###################################
+
+def write(text):
+    if not(CONFIGURATION.quiet):
+        print text
+
+
+def error(text):
+    print 'ERROR: %s' % text
+
+    if client is not None:
+        client.sendCommand('DONE')
+        client.close()
+
+    if experiment_server is not None:
+        os.killpg(experiment_server.pid, signal.SIGTERM)
+        (output, errors) = experiment_server.communicate()
+
+    if appserver is not None:
+        os.kill(appserver.pid, signal.SIGTERM)
+        (output, errors) = appserver.communicate()
+
+    for folder in ['test_workers_single', 'test_workers_several']:
+        if os.path.exists(folder):
+            shutil.rmtree(folder)
+
+    sys.exit(1)
+
+
+def sendCommand(client, command, expected_responses):
+    from pymash import Message
+
+    write("> %s" % command.toString())
+
+    if not(client.sendCommand(command)):
+        error("Failed to send the command '%s' to the server" % command.toString())
+
+    for expected in expected_responses:
+        response = Message('NOTIFICATION')
+
+        while (response.name == 'NOTIFICATION'):
+            response = client.waitResponse()
+            if response is None:
+                error("Failed to wait for response to the command '%s' from the server" % command.name)
+            write("< %s" % response.toString())
+
+        if response.name != expected:
+            if response.name == 'ERROR':
+                error("Error received from the server: '%s'" % response.parameters[0])
+            else:
+                error("Unexpected response from the server: got '%s', expected '%s'" % (response.name, expected))
+
+    return response
+
+
+def startExperimentServer(nb_workers, checkpoint_folder):
+    global experiment_server
+    global client
+
+    from pymash import Client
+
+    client = Client()
+    if client.connect('127.0.0.1', 10010):
+        client = None
+        error('The Experiment Server is already running at 127.0.0.1:10010')
+
+    write('Starting the Experiment Server...')
+
+    # The checkpoints are used to retrieve the counters of the test phase
+    command = "./experiment-server --no-compilation --host=127.0.0.1 --port=10010 --test-workers=%d --checkpoint-folder=%s" % (nb_workers, checkpoint_folder)
+
+    # The Experiment Server is started in its own process group, to be able to
+    # signal the processes it forks for each client too
+    experiment_server = subprocess.Popen(command.split(), stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                                         preexec_fn=os.setsid)
+
+    # Establish a connection with the Experiment Server
+    write('Establishing a connection with the Experiment Server...')
+
+    while True:
+        time.sleep(1)
+
+        if experiment_server.poll() is not None:
+            output = experiment_server.stdout.read()
+            experiment_server = None
+            error('Failed to start the Experiment Server, output: \n' + output)
+
+        client = Client()
+        if client.connect('127.0.0.1', 10010):
+            break
+
+        client = None
+
+
+def stopExperimentServer():
+    global experiment_server
+    global client
+
+    if client is not None:
+        client.sendCommand('DONE')
+        client.close()
+        client = None
+
+    if experiment_server is not None:
+        os.killpg(experiment_server.pid, signal.SIGTERM)
+        (output, errors) = experiment_server.communicate()
+        experiment_server = None
+
+
+def readCheckpoint(checkpoint_folder):
+    files = glob.glob(os.path.join(checkpoint_folder, '*', 'checkpoint.state'))
+    if len(files) != 1:
+        return None
+
+    checkpoint = {}
+
+    inFile = open(files[0], 'r')
+    for line in inFile.readlines():
+        parts = line.strip().split(' ', 1)
+        if len(parts) == 2:
+            checkpoint[parts[0]] = parts[1]
+    inFile.close()
+
+    return checkpoint
+
+
+def runExperiment(nb_workers, checkpoint_folder, commands, report_file):
+    from pymash import Message
+
+    startExperimentServer(nb_workers, checkpoint_folder)
+
+    for command in commands:
+        sendCommand(client, Message.fromString(command), ['OK'])
+
+    sendCommand(client, Message('TRAIN_PREDICTOR'), ['TRAIN_ERROR'])
+    test_error = sendCommand(client, Message('TEST_PREDICTOR'), ['TEST_ERROR']).parameters[0]
+
+    # Retrieve the log of the experiment
+    write("> LOGS")
+    if not(client.sendCommand(Message('LOGS'))):
+        error("Failed to send the command 'LOGS' to the server")
+
+    log = None
+    while True:
+        response = client.waitResponse()
+        if response is None:
+            error("Failed to wait for response to the command 'LOGS' from the server")
+
+        if response.name == 'END_LOGS':
+            break
+        elif response.name != 'LOG_FILE':
+            error("Unexpected response from the server: got '%s', expected 'LOG_FILE'" % response.name)
+
+        content = client.waitData(int(response.parameters[1]))
+        if content is None:
+            error("Failed to retrieve the log file '%s'" % response.parameters[0])
+
+        if response.parameters[0] == 'ExperimentServer.log':
+            log = content
+
+    if log is None:
+        error('No log file of the experiment received')
+
+    # Retrieve the events received by the instrument from the data report
+    response = sendCommand(client, Message('REPORT_DATA'), ['DATA'])
+
+    content = client.waitData(int(response.parameters[0]))
+    if content is None:
+        error('Failed to retrieve the data report')
+
+    archive_name = os.path.join(checkpoint_folder, 'data_report.tar.gz')
+
+    outFile = open(archive_name, 'wb')
+    outFile.write(content)
+    outFile.close()
+
+    archive = tarfile.open(archive_name)
+
+    report = archive.extractfile(report_file)
+    if report is None:
+        error("No '%s' file found in the data report" % report_file)
+
+    events = report.read()
+
+    archive.close()
+
+    stopExperimentServer()
+
+    checkpoint = readCheckpoint(checkpoint_folder)
+    if checkpoint is None:
+        error("No checkpoint found in '%s'" % checkpoint_folder)
+
+    return (test_error, checkpoint, events, log)
+
+
+##################################### MAIN #####################################
+
+def process(args):
+    global appserver
+    global client
+
+    script_dir = os.path.abspath(os.path.dirname(sys.argv[0]))
+
+    appserver_dir           = args[0]
+    experiment_server_dir   = args[1]
+    settings_file           = args[2]
+    report_file             = args[3]
+    nb_workers              = int(args[4])
+
+    if nb_workers <= 1:
+        error('At least two workers are needed')
+
+    # Load the pymash module
+    sys.path.append(os.path.join(script_dir, '../../'))
+    from pymash import Client
+    from pymash import Message
+
+    # Start the Application Server
+    write('Starting the Application Server...')
+
+    client = Client()
+    if client.connect('127.0.0.1', 11010):
+        client = None
+        error('The Application Server is already running at 127.0.0.1:11010')
+
+    command = "./image-server.py --config=%s/image-server-config.py --host=127.0.0.1 --port=11010" % script_dir
+
+    cwd = os.getcwd()
+
+    if len(appserver_dir) > 0:
+        os.chdir(appserver_dir)
+
+    appserver = subprocess.Popen(command.split(), stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+
+    while True:
+        time.sleep(1)
+
+        if appserver.poll() is not None:
+            output = appserver.stdout.read()
+            appserver = None
+            error('Failed to start the application server, output: \n' + output)
+
+        client = Client()
+        if client.connect('127.0.0.1', 11010):
+            client.close()
+            client = None
+            break
+
+        client = None
+
+    os.chdir(cwd)
+
+    if len(experiment_server_dir) > 0:
+        os.chdir(experiment_server_dir)
+
+    # Load the settings file for the Experiment Server
+    inFile = open(os.path.join(script_dir, settings_file), 'r')
+    content = inFile.read()
+    inFile.close()
+
+    commands = filter(lambda x: (len(x) > 0) and not(x.startswith('#')), map(lambda x: x.strip(), content.split('\n')))
+
+    for folder in ['test_workers_single', 'test_workers_several']:
+        if os.path.exists(folder):
+            shutil.rmtree(folder)
+
+    # Run with a single worker (the test images are evaluated sequentially)
+    write('Run with one worker...')
+
+    (expected_test_error, expected_checkpoint, expected_events, log) = runExperiment(1, 'test_workers_single', commands, report_file)
+
+    # Run with several workers
+    write('Run with %d workers...' % nb_workers)
+
+    (test_error, checkpoint, events, log) = runExperiment(nb_workers, 'test_workers_several', commands, report_file)
+
+    # The Experiment Server silently falls back to a sequential evaluation if
+    # the workers can't be created
+    if log.find('Test images distributed among %d workers' % nb_workers) < 0:
+        error('The test images weren\'t evaluated by the workers, log of the experiment:\n' + log)
+
+    # Stop the Application Server
+    if appserver is not None:
+        os.kill(appserver.pid, signal.SIGTERM)
+        (output, errors) = appserver.communicate()
+        appserver = None
+
+    # Comparison of the results
+    write('Comparison of the results...')
+
+    # (compared as text, NaN being different from itself)
+    if str(test_error) != str(expected_test_error):
+        error("Bad test error, expected '%s', got '%s'" % (expected_test_error, test_error))
+
+    for name in ['NEXT_TEST_IMAGE', 'NB_ERRORS', 'NB_DETECTED', 'NB_NON_DETECTED']:
+        if checkpoint[name] != expected_checkpoint[name]:
+            error("Bad '%s' counter, expected '%s', got '%s'" % (name, expected_checkpoint[name], checkpoint[name]))
+
+    if len(expected_events) == 0:
+        error('No event received by the instrument')
+
+    if events != expected_events:
+        expected_lines = expected_events.split('\n')
+        lines = events.split('\n')
+
+        for i in range(0, min(len(lines), len(expected_lines))):
+            if lines[i] != expected_lines[i]:
+                error("Bad event #%d, expected '%s', got '%s'" % (i, expected_lines[i], lines[i]))
+
+        error('Bad number of events, expected %d, got %d' % (len(expected_lines), len(lines)))
+
+    for folder in ['test_workers_single', 'test_workers_several']:
+        shutil.rmtree(folder)
+
+    write('Done')
+
+
+if __name__ == "__main__":
+    # Setup of the command-line arguments parser
+    usage = "Usage: %prog APPSERVER_DIR EXPERIMENT_SERVER_DIR SETTINGS REPORT_FILE NB_WORKERS"
+    parser = OptionParser(usage, version="%prog 1.0")
+    parser.add_option("-q", "--quiet", action="store_true", default=False,
+                      dest="quiet", help="Don't write non-error messages to the console output")
+
+    # Handling of the arguments
+    (CONFIGURATION, args) = parser.parse_args()
+    if len(args) != 5:
+        parser.print_help()
+        sys.exit(1)
+
+    try:
+        process(args)
+    except Exception, e:
+        if not(isinstance(e, SystemExit)):
+            error('An exception occured:\n' + traceback.format_exc())
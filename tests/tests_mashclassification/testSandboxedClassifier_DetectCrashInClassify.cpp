@@ -17,6 +17,7 @@ int main(int argc, char** argv)
     configuration.strScriptsDir = MASH_SOURCE_DIR "sandbox/";
     configuration.strSourceDir  = MASH_SOURCE_DIR "classifiers/";
     configuration.strUsername  = MASH_TESTS_SANDBOX_USERNAME;
+    configuration.bSeccomp     = MASH_TESTS_SANDBOX_SECCOMP;
     
     CHECK(sandbox.createSandbox(configuration));
     
@@ -0,0 +1,67 @@
+#include <mash-classification/trusted_classifier.h>
+#include <iostream>
+#include <string>
+#include <math.h>
+#include "tests.h"
+#include "MockInputSet.h"
+
+using namespace Mash;
+using namespace std;
+
+
+int main(int argc, char** argv)
+{
+    TrustedClassifier classifier;
+    
+    classifier.configure("logs", "out");
+    
+    CHECK(classifier.setClassifiersFolder("classifiers"));
+
+    CHECK(classifier.loadClassifierPlugin("unittests/position_scorer"));
+
+    tExperimentParametersList parameters;
+
+    CHECK(classifier.setup(parameters));
+
+    MockInputSet inputSet;
+
+    scalar_t train_error = -HUGE_VAL;
+    CHECK(classifier.train(&inputSet, train_error));
+
+    // Several positions in one call
+    tCoordinatesList positions;
+    for (unsigned int i = 0; i < 1000; ++i)
+    {
+        coordinates_t position;
+        position.x = i % 127;
+        position.y = i / 127;
+        positions.push_back(position);
+    }
+
+    Classifier::tClassificationResultsList results;
+
+    CHECK(classifier.classifyBatch(&inputSet, 1, positions, results));
+    CHECK_EQUAL(positions.size(), results.size());
+
+    for (unsigned int i = 0; i < positions.size(); ++i)
+    {
+        CHECK_EQUAL(3, results[i].size());
+        CHECK_EQUAL((scalar_t) positions[i].x, results[i][0]);
+        CHECK_EQUAL((scalar_t) positions[i].y, results[i][1]);
+        CHECK_EQUAL(1.0f, results[i][-1]);
+    }
+
+    // Same results than with individual calls
+    Classifier::tClassificationResults single;
+
+    CHECK(classifier.classify(&inputSet, 1, positions[500], single));
+    CHECK(single == results[500]);
+
+    // No position
+    positions.clear();
+
+    CHECK(classifier.classifyBatch(&inputSet, 0, positions, results));
+    CHECK(results.empty());
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <mash-classification/trusted_classifier.h>
+#include <iostream>
+#include <string>
+#include <math.h>
+#include "tests.h"
+#include "MockInputSet.h"
+
+using namespace Mash;
+using namespace std;
+
+
+int main(int argc, char** argv)
+{
+    TrustedClassifier classifier;
+    
+    classifier.configure("logs", "out");
+    
+    CHECK(classifier.setClassifiersFolder("classifiers"));
+
+    CHECK(classifier.loadClassifierPlugin("unittests/cascade_scorer"));
+
+    tExperimentParametersList parameters;
+
+    CHECK(classifier.setup(parameters));
+
+    MockInputSet inputSet;
+
+    scalar_t train_error = -HUGE_VAL;
+    CHECK(classifier.train(&inputSet, train_error));
+
+    tCoordinatesList positions;
+    for (unsigned int y = 0; y < 127; ++y)
+    {
+        for (unsigned int x = 0; x < 127; ++x)
+        {
+            coordinates_t position;
+            position.x = x;
+            position.y = y;
+            positions.push_back(position);
+        }
+    }
+
+    Classifier::tClassificationResultsList results;
+
+    inputSet.calls_counter_computeSomeFeatures = 0;
+
+    CHECK(classifier.classifyBatch(&inputSet, 1, positions, results));
+    CHECK_EQUAL(positions.size(), results.size());
+
+    // The features of the remaining stages aren't computed for the rejected
+    // positions
+    unsigned int nbExpectedCalls = 0;
+
+    for (unsigned int i = 0; i < positions.size(); ++i)
+    {
+        if (positions[i].x < 64)
+        {
+            CHECK(results[i].empty());
+            nbExpectedCalls += 1;
+        }
+        else if (positions[i].x + positions[i].y < 128)
+        {
+            CHECK(results[i].empty());
+            nbExpectedCalls += 2;
+        }
+        else
+        {
+            CHECK_EQUAL(2, results[i].size());
+            CHECK_EQUAL((scalar_t) (positions[i].x + positions[i].y), results[i][0]);
+            CHECK_EQUAL(1.0f, results[i][1]);
+            nbExpectedCalls += 3;
+        }
+    }
+
+    CHECK_EQUAL(nbExpectedCalls, inputSet.calls_counter_computeSomeFeatures);
+    CHECK(nbExpectedCalls < 3 * positions.size());
+
+    // Same results than without the cascade for the accepted positions
+    Classifier::tClassificationResults single;
+
+    CHECK(classifier.classify(&inputSet, 1, positions.back(), single));
+    CHECK(single == results.back());
+
+    return 0;
+}
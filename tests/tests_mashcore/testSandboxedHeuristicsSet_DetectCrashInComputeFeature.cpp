@@ -15,6 +15,7 @@ int main(int argc, char** argv)
     configuration.strScriptsDir = MASH_SOURCE_DIR "sandbox/";
     configuration.strSourceDir  = MASH_SOURCE_DIR "heuristics/";
     configuration.strUsername  = MASH_TESTS_SANDBOX_USERNAME;
+    configuration.bSeccomp     = MASH_TESTS_SANDBOX_SECCOMP;
     
     CHECK(sandbox.createSandbox(configuration));
     
@@ -31,7 +32,7 @@ int main(int argc, char** argv)
     Image image(127, 127);
     image.addPixelFormats(Image::PIXELFORMAT_ALL);
 
-    CHECK(sandbox.prepareForImage(0, 0, 0, &image));
+    CHECK(sandbox.prepareForImage(0, 0, 5, &image));
 
     coordinates_t coords;
     coords.x = 63;
@@ -44,7 +45,12 @@ int main(int argc, char** argv)
 
     CHECK(!sandbox.computeSomeFeatures(0, 1, &feature, &value));
     CHECK_EQUAL(ERROR_HEURISTIC_CRASHED, sandbox.getLastError());
-    CHECK(!sandbox.getContext().empty());
+
+    string strContext = sandbox.getContext();
+    CHECK(strContext.find("Method: computeFeature\n") == 0);
+    CHECK(strContext.find("    - Image:") != string::npos);
+    CHECK(strContext.find("#5\n") != string::npos);
+    CHECK(strContext.find("#0 - #0\n") != string::npos);
     
     return 0;
 }
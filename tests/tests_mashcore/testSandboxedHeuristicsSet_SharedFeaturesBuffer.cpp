@@ -0,0 +1,101 @@
+#include <mash/sandboxed_heuristics_set.h>
+#include <mash/shared_features_buffer.h>
+#include <iostream>
+#include <string>
+#include <memory.h>
+#include "tests.h"
+
+using namespace Mash;
+using namespace std;
+
+
+bool computeAllFeatures(SandboxedHeuristicsSet* pSandbox, Image* pImage,
+                        unsigned int nbFeatures, unsigned int* indexes, scalar_t* values)
+{
+    coordinates_t coords;
+    coords.x = 63;
+    coords.y = 63;
+
+    return pSandbox->prepareForSequence(0) &&
+           pSandbox->prepareForImage(0, 0, 0, pImage) &&
+           pSandbox->prepareForCoordinates(0, coords) &&
+           pSandbox->computeSomeFeatures(0, nbFeatures, indexes, values) &&
+           pSandbox->finishForCoordinates(0) &&
+           pSandbox->finishForImage(0) &&
+           pSandbox->finishForSequence(0);
+}
+
+
+int main(int argc, char** argv)
+{
+    SandboxedHeuristicsSet sandbox;
+    SandboxedHeuristicsSet sharedSandbox;
+    SharedFeaturesBuffer buffer;
+    tSandboxConfiguration configuration;
+    
+    configuration.strScriptsDir = MASH_SOURCE_DIR "sandbox/";
+    configuration.strSourceDir  = MASH_SOURCE_DIR "heuristics/";
+    configuration.strUsername  = MASH_TESTS_SANDBOX_USERNAME;
+    configuration.bSeccomp     = MASH_TESTS_SANDBOX_SECCOMP;
+
+    CHECK(sandbox.createSandbox(configuration));
+
+    CHECK(buffer.create(127 * 127, "./"));
+
+    configuration.sharedFeaturesFd = buffer.fd();
+
+    CHECK(sharedSandbox.createSandbox(configuration));
+
+    sharedSandbox.setSharedFeaturesBuffer(&buffer);
+
+    CHECK(sandbox.setHeuristicsFolder("heuristics"));
+    CHECK(sharedSandbox.setHeuristicsFolder("heuristics"));
+
+    CHECK_EQUAL(0, sandbox.loadHeuristicPlugin("examples/identity"));
+    CHECK_EQUAL(0, sharedSandbox.loadHeuristicPlugin("examples/identity"));
+    
+    CHECK(sandbox.createHeuristics());
+    CHECK(sharedSandbox.createHeuristics());
+
+    CHECK(sandbox.setSeed(0, 1234));
+    CHECK(sharedSandbox.setSeed(0, 1234));
+    
+    CHECK(sandbox.init(0, 1, 63));
+    CHECK(sharedSandbox.init(0, 1, 63));
+
+    unsigned int nbFeatures = sandbox.dim(0);
+    CHECK(nbFeatures > 0);
+    CHECK_EQUAL(nbFeatures, sharedSandbox.dim(0));
+    CHECK(nbFeatures <= buffer.capacity());
+
+    Image image(127, 127);
+    image.addPixelFormats(Image::PIXELFORMAT_ALL);
+
+    for (unsigned int i = 0; i < 127 * 127; ++i)
+    {
+        image.grayBuffer()[i]   = (byte_t) (i * 7);
+        image.rgbBuffer()[i].r  = (byte_t) (i * 3);
+        image.rgbBuffer()[i].g  = (byte_t) (i * 5);
+        image.rgbBuffer()[i].b  = (byte_t) (i * 11);
+    }
+
+    // Features requested in reverse order, to check that the indexes are
+    // correctly transmitted
+    unsigned int* indexes = new unsigned int[nbFeatures];
+    scalar_t* values = new scalar_t[nbFeatures];
+
+    for (unsigned int i = 0; i < nbFeatures; ++i)
+        indexes[i] = nbFeatures - i - 1;
+
+    memcpy(buffer.indexes(), indexes, nbFeatures * sizeof(unsigned int));
+
+    CHECK(computeAllFeatures(&sandbox, &image, nbFeatures, indexes, values));
+    CHECK(computeAllFeatures(&sharedSandbox, &image, nbFeatures, buffer.indexes(), buffer.values()));
+
+    CHECK_EQUAL(0, memcmp(values, buffer.values(), nbFeatures * sizeof(scalar_t)));
+
+    delete[] indexes;
+    delete[] values;
+    
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include <mash/sandboxed_heuristics_set.h>
+#include <iostream>
+#include <string>
+#include "tests.h"
+
+using namespace Mash;
+using namespace std;
+
+
+// Note: unlike the other tests, this one always enables the system call filter
+int main(int argc, char** argv)
+{
+    SandboxedHeuristicsSet sandbox;
+    tSandboxConfiguration configuration;
+    
+    configuration.strScriptsDir = MASH_SOURCE_DIR "sandbox/";
+    configuration.strSourceDir  = MASH_SOURCE_DIR "heuristics/";
+    configuration.strUsername  = MASH_TESTS_SANDBOX_USERNAME;
+    configuration.bSeccomp     = true;
+    
+    CHECK(sandbox.createSandbox(configuration));
+    
+    CHECK(sandbox.setHeuristicsFolder("heuristics"));
+
+    // Several heuristics, the filter must only be installed once all of them
+    // are loaded
+    CHECK_EQUAL(0, sandbox.loadHeuristicPlugin("examples/identity"));
+    CHECK_EQUAL(1, sandbox.loadHeuristicPlugin("examples/mean_threshold"));
+
+    // This heuristic will crash in prepareForImage() if it succeeds at opening a file
+    CHECK_EQUAL(2, sandbox.loadHeuristicPlugin("unittests/fileopening"));
+    
+    CHECK(sandbox.createHeuristics());
+
+    Image image(127, 127);
+    image.addPixelFormats(Image::PIXELFORMAT_ALL);
+
+    coordinates_t coords;
+    coords.x = 63;
+    coords.y = 63;
+
+    for (unsigned int heuristic = 0; heuristic < 2; ++heuristic)
+    {
+        CHECK(sandbox.init(heuristic, 1, 63));
+
+        unsigned int feature = 0;
+        scalar_t value;
+
+        CHECK(sandbox.prepareForSequence(heuristic));
+        CHECK(sandbox.prepareForImage(heuristic, 0, 0, &image));
+        CHECK(sandbox.prepareForCoordinates(heuristic, coords));
+        CHECK(sandbox.computeSomeFeatures(heuristic, 1, &feature, &value));
+        CHECK(sandbox.finishForCoordinates(heuristic));
+        CHECK(sandbox.finishForImage(heuristic));
+        CHECK(sandbox.finishForSequence(heuristic));
+    }
+
+    CHECK_EQUAL(ERROR_NONE, sandbox.getLastError());
+
+    // The opening of files by the plugins is still detected
+    CHECK(sandbox.init(2, 1, 63));
+    CHECK(sandbox.prepareForSequence(2));
+    CHECK(!sandbox.prepareForImage(2, 0, 0, &image));
+    CHECK_EQUAL(ERROR_SANDBOX_FORBIDDEN_SYSTEM_CALL, sandbox.getLastError());
+    
+    return 0;
+}
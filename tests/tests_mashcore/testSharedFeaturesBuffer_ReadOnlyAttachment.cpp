@@ -0,0 +1,54 @@
+#include <mash/shared_features_buffer.h>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <stdint.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include "tests.h"
+
+using namespace Mash;
+using namespace std;
+
+
+int main(int argc, char** argv)
+{
+    SharedFeaturesBuffer buffer;
+    SharedFeaturesBuffer writer;
+    SharedFeaturesBuffer reader;
+
+    CHECK(buffer.create(1024, "./"));
+    CHECK(!buffer.isReadOnly());
+    CHECK(buffer.readOnlyFd() >= 0);
+
+    // Note: the attached buffers take the ownership of their file descriptor
+    CHECK(writer.attach(dup(buffer.fd())));
+    CHECK(reader.attach(dup(buffer.readOnlyFd())));
+
+    CHECK(!writer.isReadOnly());
+    CHECK(reader.isReadOnly());
+    CHECK_EQUAL(1024, reader.capacity());
+
+    for (unsigned int i = 0; i < 1024; ++i)
+    {
+        buffer.indexes()[i] = i;
+        writer.values()[i] = i * 0.5f;
+    }
+
+    for (unsigned int i = 0; i < 1024; ++i)
+    {
+        CHECK_EQUAL(i, reader.indexes()[i]);
+        CHECK_EQUAL(i * 0.5f, reader.values()[i]);
+    }
+
+    // The read-only mapping can't be made writable
+    uintptr_t page = (uintptr_t) reader.values() & ~((uintptr_t) getpagesize() - 1);
+
+    CHECK_EQUAL(-1, mprotect((void*) page, getpagesize(), PROT_READ | PROT_WRITE));
+    CHECK_EQUAL(EACCES, errno);
+
+    // Neither the file it is backed by
+    CHECK_EQUAL(-1, pwrite(reader.fd(), "X", 1, 0));
+
+    return 0;
+}
@@ -16,6 +16,7 @@ int main(int argc, char** argv)
     configuration.strScriptsDir = MASH_SOURCE_DIR "sandbox/";
     configuration.strSourceDir  = MASH_SOURCE_DIR "instruments/";
     configuration.strUsername  = MASH_TESTS_SANDBOX_USERNAME;
+    configuration.bSeccomp     = MASH_TESTS_SANDBOX_SECCOMP;
     
     CHECK(sandbox.createSandbox(configuration));
     
@@ -32,8 +33,12 @@ int main(int argc, char** argv)
     unsigned int index = 0;
     scalar_t feature;
 
-    CHECK(!sandbox.onFeaturesComputedByClassifier(false, true, 0, 0, position, 63, 0, 1, &index, &feature));
+    // Note: the event is delivered asynchronously, the crash is only detected
+    // once the queued events are flushed
+    CHECK(sandbox.onFeaturesComputedByClassifier(false, true, 0, 0, position, 63, 0, 1, &index, &feature));
+    CHECK(!sandbox.flushEvents());
     CHECK_EQUAL(ERROR_INSTRUMENT_CRASHED, sandbox.getLastError());
+    CHECK(!sandbox.onFeaturesComputedByClassifier(false, true, 0, 0, position, 63, 0, 1, &index, &feature));
     CHECK(!sandbox.getContext().empty());
     
     return 0;
@@ -0,0 +1,97 @@
+#include <mash-instrumentation/sandboxed_instruments_set.h>
+#include <iostream>
+#include <string>
+#include "tests.h"
+#include "MockInputSet.h"
+
+using namespace Mash;
+using namespace std;
+
+
+unsigned int nbSent(SandboxedInstrumentsSet& sandbox, tSandboxMessage message)
+{
+    return sandbox.sandboxController()->channel()->statistics()->messages[message].nb_sent;
+}
+
+
+int main(int argc, char** argv)
+{
+    SandboxedInstrumentsSet sandbox;
+    tSandboxConfiguration configuration;
+    
+    configuration.strScriptsDir = MASH_SOURCE_DIR "sandbox/";
+    configuration.strSourceDir  = MASH_SOURCE_DIR "instruments/";
+    configuration.strUsername  = MASH_TESTS_SANDBOX_USERNAME;
+    configuration.bSeccomp     = MASH_TESTS_SANDBOX_SECCOMP;
+    
+    CHECK(sandbox.createSandbox(configuration));
+    
+    CHECK(sandbox.setInstrumentsFolder("instruments"));
+
+    CHECK_EQUAL(0, sandbox.loadInstrumentPlugin("unittests/nooperation"));
+    CHECK_EQUAL(1, sandbox.loadInstrumentPlugin("unittests/unsubscribed_events"));
+
+    CHECK(sandbox.createInstruments());
+
+    CHECK_EQUAL((unsigned int) Instrument::EVENT_ALL, sandbox.instrumentEvents(0));
+    CHECK_EQUAL((unsigned int) Instrument::EVENT_FEATURE_LIST_REPORTED, sandbox.instrumentEvents(1));
+    CHECK_EQUAL((unsigned int) Instrument::EVENT_ALL, sandbox.subscribedEvents());
+
+    // The first time, the events are sent to the sandbox, where the
+    // 'nooperation' instrument reports that it doesn't handle them (they must
+    // not reach the 'unsubscribed_events' instrument, they crash in all of
+    // them). The next times, they aren't sent at all.
+    MockInputSet inputSet;
+
+    coordinates_t position;
+    position.x = 63;
+    position.y = 63;
+    
+    unsigned int index = 0;
+    scalar_t feature;
+
+    Classifier::tClassificationResults results;
+
+    for (unsigned int n = 0; n < 2; ++n)
+    {
+        CHECK(sandbox.onExperimentStarted(&inputSet));
+        CHECK(sandbox.onClassifierTrainingStarted(&inputSet));
+
+        for (unsigned int i = 0; i < 100; ++i)
+            CHECK(sandbox.onFeaturesComputedByClassifier(false, true, 0, 0, position, 63, 0, 1, &index, &feature));
+
+        CHECK(sandbox.onClassifierTrainingDone(&inputSet, 0.1f));
+        CHECK(sandbox.onClassifierClassificationDone(&inputSet, 0, 0, position, results,
+                                                     Instrument::CLASSIFICATION_ERROR_NONE));
+        CHECK(sandbox.onExperimentDone());
+    }
+
+    CHECK_EQUAL(1, nbSent(sandbox, SANDBOX_EVENT_INSTRUMENTS_CLASSIFICATION_EXPERIMENT_STARTED));
+    CHECK_EQUAL(1, nbSent(sandbox, SANDBOX_EVENT_INSTRUMENTS_CLASSIFIER_TRAINING_STARTED));
+    CHECK_EQUAL(1, nbSent(sandbox, SANDBOX_EVENT_INSTRUMENTS_FEATURES_COMPUTED_BY_CLASSIFIER_BATCH));
+    CHECK_EQUAL(1, nbSent(sandbox, SANDBOX_EVENT_INSTRUMENTS_CLASSIFIER_TRAINING_DONE));
+    CHECK_EQUAL(1, nbSent(sandbox, SANDBOX_EVENT_INSTRUMENTS_CLASSIFIER_CLASSIFICATION_DONE));
+    CHECK_EQUAL(1, nbSent(sandbox, SANDBOX_EVENT_INSTRUMENTS_EXPERIMENT_DONE));
+
+    unsigned int delivered = Instrument::EVENT_CLASSIFICATION_EXPERIMENT_STARTED |
+                             Instrument::EVENT_CLASSIFIER_TRAINING_STARTED |
+                             Instrument::EVENT_FEATURES_COMPUTED_BY_CLASSIFIER |
+                             Instrument::EVENT_CLASSIFIER_TRAINING_DONE |
+                             Instrument::EVENT_CLASSIFIER_CLASSIFICATION_DONE |
+                             Instrument::EVENT_EXPERIMENT_DONE;
+
+    CHECK_EQUAL((unsigned int) (Instrument::EVENT_ALL & ~delivered), sandbox.instrumentEvents(0));
+    CHECK_EQUAL((unsigned int) Instrument::EVENT_FEATURE_LIST_REPORTED, sandbox.instrumentEvents(1));
+
+    // The one declared by an instrument is always sent
+    tFeatureList features;
+    features.push_back(tFeature(0, 10));
+
+    CHECK(sandbox.onFeatureListReported(features));
+    CHECK(sandbox.onFeatureListReported(features));
+    CHECK_EQUAL(2, nbSent(sandbox, SANDBOX_EVENT_INSTRUMENTS_FEATURE_LIST_REPORTED));
+
+    CHECK_EQUAL(ERROR_NONE, sandbox.getLastError());
+    
+    return 0;
+}
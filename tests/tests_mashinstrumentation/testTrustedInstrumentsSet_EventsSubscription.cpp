@@ -0,0 +1,79 @@
+#include <mash-instrumentation/trusted_instruments_set.h>
+#include <iostream>
+#include <string>
+#include "tests.h"
+#include "MockInputSet.h"
+
+using namespace Mash;
+using namespace std;
+
+
+int main(int argc, char** argv)
+{
+    TrustedInstrumentsSet trusted;
+
+    trusted.configure("logs", "out");
+    
+    CHECK(trusted.setInstrumentsFolder("instruments"));
+
+    CHECK_EQUAL(0, trusted.loadInstrumentPlugin("unittests/nooperation"));
+    CHECK_EQUAL(1, trusted.loadInstrumentPlugin("unittests/crash_in_onfeaturescomputedbyclassifier"));
+    CHECK_EQUAL(2, trusted.loadInstrumentPlugin("unittests/unsubscribed_events"));
+
+    CHECK(trusted.createInstruments());
+
+    // Not declared: all the events are sent until the instruments report that
+    // they don't handle them
+    CHECK_EQUAL((unsigned int) Instrument::EVENT_ALL, trusted.instrumentEvents(0));
+    CHECK_EQUAL((unsigned int) Instrument::EVENT_ALL, trusted.instrumentEvents(1));
+
+    // Declared by the instrument
+    CHECK_EQUAL((unsigned int) Instrument::EVENT_FEATURE_LIST_REPORTED, trusted.instrumentEvents(2));
+
+    CHECK_EQUAL((unsigned int) Instrument::EVENT_ALL, trusted.subscribedEvents());
+
+    // The unsubscribed events must not reach the 'unsubscribed_events'
+    // instrument (they crash in all of them)
+    MockInputSet inputSet;
+
+    coordinates_t position;
+    position.x = 63;
+    position.y = 63;
+
+    Classifier::tClassificationResults results;
+
+    CHECK(trusted.onExperimentStarted(&inputSet));
+    CHECK(trusted.onClassifierTrainingStarted(&inputSet));
+    CHECK(trusted.onClassifierTrainingDone(&inputSet, 0.1f));
+    CHECK(trusted.onClassifierTestStarted(&inputSet));
+    CHECK(trusted.onClassifierClassificationDone(&inputSet, 0, 0, position, results,
+                                                 Instrument::CLASSIFICATION_ERROR_NONE));
+    CHECK(trusted.onClassifierTestDone(&inputSet, 0.1f));
+
+    tFeatureList features;
+    features.push_back(tFeature(0, 10));
+
+    CHECK(trusted.onFeatureListReported(features));
+    CHECK(trusted.onExperimentDone());
+
+    // The events received once but not handled aren't sent anymore
+    unsigned int delivered = Instrument::EVENT_CLASSIFICATION_EXPERIMENT_STARTED |
+                             Instrument::EVENT_CLASSIFIER_TRAINING_STARTED |
+                             Instrument::EVENT_CLASSIFIER_TRAINING_DONE |
+                             Instrument::EVENT_CLASSIFIER_TEST_STARTED |
+                             Instrument::EVENT_CLASSIFIER_CLASSIFICATION_DONE |
+                             Instrument::EVENT_CLASSIFIER_TEST_DONE |
+                             Instrument::EVENT_FEATURE_LIST_REPORTED |
+                             Instrument::EVENT_EXPERIMENT_DONE;
+
+    CHECK_EQUAL((unsigned int) (Instrument::EVENT_ALL & ~delivered), trusted.instrumentEvents(0));
+    CHECK_EQUAL((unsigned int) (Instrument::EVENT_ALL & ~delivered), trusted.instrumentEvents(1));
+    CHECK_EQUAL((unsigned int) Instrument::EVENT_FEATURE_LIST_REPORTED, trusted.instrumentEvents(2));
+
+    CHECK_EQUAL((unsigned int) ((Instrument::EVENT_ALL & ~delivered) | Instrument::EVENT_FEATURE_LIST_REPORTED),
+                trusted.subscribedEvents());
+
+    CHECK_EQUAL(ERROR_NONE, trusted.getLastError());
+    
+    return 0;
+}
@@ -2,6 +2,7 @@
 #include <mash-network/server_listener.h>
 #include <mash-utils/stringutils.h>
 #include "binary_data.h"
+#include <string.h>
 
 using namespace Mash;
 using namespace std;
@@ -72,11 +73,17 @@ ServerListener* createListener(int socket)
 int main(int argc, char** argv)
 {
     unsigned int nbMaxClients = 0;
+    Server::tEngine engine = Server::ENGINE_FORK;
     
-    if (argc == 2)
-        nbMaxClients = StringUtils::parseUnsignedInt(argv[1]);
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--events") == 0)
+            engine = Server::ENGINE_EVENTS;
+        else
+            nbMaxClients = StringUtils::parseUnsignedInt(argv[i]);
+    }
     
-    Server server(nbMaxClients);
+    Server server(nbMaxClients, 100, "Server", engine);
     
     server.listen("127.0.0.1", 10000, createListener);
     
@@ -0,0 +1,176 @@
+#include <mash-network/networkutils.h>
+#include <mash-utils/stringutils.h>
+#include <tests.h>
+#include <iostream>
+#include <sstream>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace Mash;
+using namespace std;
+
+
+// Build a response similar to the ones of LIST_OBJECTS-like commands or log
+// transfers: lots of short lines
+string buildResponse(unsigned int size, unsigned int* nbLines)
+{
+    ostringstream stream;
+
+    *nbLines = 0;
+    while (stream.tellp() < (streampos) size)
+    {
+        stream << "OBJECT object_" << *nbLines << " 'Description of the object number "
+               << *nbLines << "' 123456\n";
+        ++(*nbLines);
+    }
+
+    return stream.str();
+}
+
+
+double elapsed(const struct timeval& start)
+{
+    struct timeval end;
+    gettimeofday(&end, 0);
+
+    return (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) * 1e-6;
+}
+
+
+// Extract the lines of the response, entirely stored in the buffer (like
+// after a large transfer)
+double benchmarkExtraction(const string& strData, unsigned int nbLines)
+{
+    NetworkBuffer buffer(strData);
+    string strLine;
+    unsigned int nbExtracted = 0;
+
+    struct timeval start;
+    gettimeofday(&start, 0);
+
+    while (buffer.extractLine(strLine))
+        ++nbExtracted;
+
+    double duration = elapsed(start);
+
+    CHECK_EQUAL(nbLines, nbExtracted);
+    CHECK_EQUAL(0, buffer.size());
+
+    return duration;
+}
+
+
+// Parse the response from memory, fed to the buffer the way recv() would
+double benchmarkParsing(const string& strData, unsigned int nbLines)
+{
+    NetworkBuffer buffer;
+    string strMessage;
+    ArgumentsList arguments;
+    unsigned int nbMessages = 0;
+
+    struct timeval start;
+    gettimeofday(&start, 0);
+
+    for (unsigned int offset = 0; offset < strData.size(); offset += NetworkUtils::RECEIVE_CHUNK_SIZE)
+    {
+        buffer.add(strData.substr(offset, NetworkUtils::RECEIVE_CHUNK_SIZE));
+
+        arguments.clear();
+        while (NetworkUtils::processBuffer(&buffer, &strMessage, &arguments))
+        {
+            ++nbMessages;
+            arguments.clear();
+        }
+    }
+
+    double duration = elapsed(start);
+
+    CHECK_EQUAL(nbLines, nbMessages);
+    CHECK_EQUAL(0, buffer.size());
+
+    return duration;
+}
+
+
+// Receive the response through a local socket
+double benchmarkReceiving(const string& strData, unsigned int nbLines)
+{
+    int sockets[2];
+    CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0);
+
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        close(sockets[0]);
+        bool bResult = NetworkUtils::sendData(sockets[1], (const unsigned char*) strData.c_str(),
+                                              strData.size());
+        close(sockets[1]);
+        _exit(bResult ? 0 : 1);
+    }
+
+    close(sockets[1]);
+
+    NetworkBuffer buffer;
+    string strMessage;
+    ArgumentsList arguments;
+    unsigned int nbMessages = 0;
+
+    struct timeval start;
+    gettimeofday(&start, 0);
+
+    while ((nbMessages < nbLines) &&
+           NetworkUtils::waitMessage(sockets[0], &buffer, &strMessage, &arguments))
+    {
+        ++nbMessages;
+    }
+
+    double duration = elapsed(start);
+
+    close(sockets[0]);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+
+    CHECK_EQUAL(0, WEXITSTATUS(status));
+    CHECK_EQUAL(nbLines, nbMessages);
+
+    return duration;
+}
+
+
+int main(int argc, char** argv)
+{
+    if (argc != 2)
+    {
+        cerr << "Usage: " << argv[0] << " NB_MEGABYTES" << endl;
+        return -1;
+    }
+
+    unsigned int size = StringUtils::parseUnsignedInt(argv[1]) * 1024 * 1024;
+    unsigned int nbLines = 0;
+
+    string strData = buildResponse(size, &nbLines);
+
+    double megabytes = strData.size() / (1024.0 * 1024.0);
+
+    double extraction = benchmarkExtraction(strData, nbLines);
+    double parsing = benchmarkParsing(strData, nbLines);
+    double receiving = benchmarkReceiving(strData, nbLines);
+
+    if ((extraction < 0.0) || (parsing < 0.0) || (receiving < 0.0))
+        return -1;
+
+    cout << "SIZE_MB " << megabytes << endl
+         << "LINES " << nbLines << endl
+         << "EXTRACTION_DURATION " << extraction << endl
+         << "EXTRACTION_MB_PER_SECOND " << megabytes / extraction << endl
+         << "PARSING_DURATION " << parsing << endl
+         << "PARSING_MB_PER_SECOND " << megabytes / parsing << endl
+         << "RECEIVING_DURATION " << receiving << endl
+         << "RECEIVING_MB_PER_SECOND " << megabytes / receiving << endl;
+
+    return 0;
+}
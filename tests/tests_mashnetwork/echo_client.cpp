@@ -1,4 +1,5 @@
 #include <mash-network/client.h>
+#include <mash-network/client_pool.h>
 #include <tests.h>
 #include <iostream>
 
@@ -36,6 +37,7 @@ int main(int argc, char** argv)
     Client client;
     ArgumentsList commandArgs;
     ArgumentsList responseArgs;
+    string strResponse;
     
     
     if (!client.connect("127.0.0.1", 10000))
@@ -118,6 +120,57 @@ int main(int argc, char** argv)
     CHECK_EQUAL(commandArgs.getString(0), responseArgs.getString(0));
 
 
+    // Pipelined commands: the responses are received in the same order
+    for (int i = 0; i < 100; ++i)
+        CHECK(client.queueCommand("PIPELINED", ArgumentsList(i)));
+
+    for (int i = 0; i < 100; ++i)
+    {
+        CHECK(client.waitResponse(&strResponse, &responseArgs));
+        CHECK_EQUAL(string("PIPELINED"), strResponse);
+        CHECK_EQUAL(1, responseArgs.size());
+        CHECK_EQUAL(i, responseArgs.getInt(0));
+    }
+
+
+    // Connection pool: a released connection is only reused in the same state
+    ClientPool pool(2, 60, "PING", "PING");
+    bool bReused = true;
+
+    Client* pPooledClient = pool.acquire("127.0.0.1", 10000, "", 0, &bReused);
+    CHECK(pPooledClient);
+    CHECK(!bReused);
+
+    pool.release(pPooledClient, "CONFIGURED");
+    CHECK_EQUAL(1, pool.nbIdleClients());
+
+    Client* pOtherClient = pool.acquire("127.0.0.1", 10000, "", 0, &bReused);
+    CHECK(pOtherClient);
+    CHECK(!bReused);
+    CHECK(pOtherClient != pPooledClient);
+    CHECK(pOtherClient->tag().empty());
+
+    Client* pReusedClient = pool.acquire("127.0.0.1", 10000, "CONFIGURED", 0, &bReused);
+    CHECK(bReused);
+    CHECK(pReusedClient == pPooledClient);
+    CHECK_EQUAL(string("CONFIGURED"), pReusedClient->tag());
+    CHECK_EQUAL(0, pool.nbIdleClients());
+
+    CHECK(pReusedClient->sendCommand("HELLO", ArgumentsList()));
+    CHECK(pReusedClient->waitResponse(&strResponse, &responseArgs));
+    CHECK_EQUAL(string("HELLO"), strResponse);
+
+    // A connection with unread responses isn't kept
+    CHECK(pOtherClient->sendCommand("HELLO", ArgumentsList()));
+    usleep(100000);
+    pool.release(pOtherClient);
+    pool.release(pReusedClient, "CONFIGURED");
+    CHECK_EQUAL(1, pool.nbIdleClients());
+
+    pool.clear();
+    CHECK_EQUAL(0, pool.nbIdleClients());
+
+
     client.close();
     
     return 0;
@@ -47,18 +47,19 @@ ServerListener* createListener(int socket)
 int main(int argc, char** argv)
 {
     unsigned int nbMaxClients = 0;
+    Server::tEngine engine = Server::ENGINE_FORK;
     
-    if (argc == 3)
+    for (int i = 1; i < argc; ++i)
     {
-        OutStream::verbosityLevel = (strcmp(argv[1], "--verbose") == 0 ? 1 : 0);
-        nbMaxClients = StringUtils::parseUnsignedInt(argv[2]);
-    }
-    else if (argc == 2)
-    {
-        nbMaxClients = StringUtils::parseUnsignedInt(argv[1]);
+        if (strcmp(argv[i], "--verbose") == 0)
+            OutStream::verbosityLevel = 1;
+        else if (strcmp(argv[i], "--events") == 0)
+            engine = Server::ENGINE_EVENTS;
+        else
+            nbMaxClients = StringUtils::parseUnsignedInt(argv[i]);
     }
     
-    Server server(nbMaxClients);
+    Server server(nbMaxClients, 100, "Server", engine);
     
     server.listen("127.0.0.1", 10000, createListener);
     
@@ -0,0 +1,132 @@
+#include <mash-network/client.h>
+#include <mash-utils/stringutils.h>
+#include <tests.h>
+#include <iostream>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace Mash;
+using namespace std;
+
+
+int runClient(unsigned int nbConnections, unsigned int nbRequests, unsigned int &nbCompleted)
+{
+    ArgumentsList commandArgs;
+    ArgumentsList responseArgs;
+    string strResponse;
+
+    commandArgs.add("http://something.com");
+    commandArgs.add(100);
+
+    for (unsigned int i = 0; i < nbConnections; ++i)
+    {
+        Client client;
+
+        if (!client.connect("127.0.0.1", 10000))
+        {
+            cerr << "Failed to connect to the server" << endl;
+            return -1;
+        }
+
+        for (unsigned int j = 0; j < nbRequests; ++j)
+        {
+            if (!client.sendCommand("ECHO", commandArgs))
+            {
+                cerr << "Failed to send command 'ECHO' to the server" << endl;
+                return -1;
+            }
+
+            if (!client.waitResponse(&strResponse, &responseArgs))
+            {
+                cerr << "Failed to wait for response to command 'ECHO' from the server" << endl;
+                return -1;
+            }
+
+            CHECK_EQUAL(string("ECHO"), strResponse);
+            CHECK_EQUAL(commandArgs.size(), responseArgs.size());
+
+            ++nbCompleted;
+        }
+
+        client.close();
+    }
+
+    return 0;
+}
+
+
+int main(int argc, char** argv)
+{
+    if (argc != 4)
+    {
+        cerr << "Usage: " << argv[0] << " NB_PROCESSES NB_CONNECTIONS NB_REQUESTS" << endl;
+        return -1;
+    }
+
+    unsigned int nbProcesses    = StringUtils::parseUnsignedInt(argv[1]);
+    unsigned int nbConnections  = StringUtils::parseUnsignedInt(argv[2]);
+    unsigned int nbRequests     = StringUtils::parseUnsignedInt(argv[3]);
+
+    // Each process reports the number of requests it completed through a pipe
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+        cerr << "Failed to create a pipe" << endl;
+        return -1;
+    }
+
+    struct timeval start, end;
+    gettimeofday(&start, 0);
+
+    // Each process simulates a machine of the computation farm
+    for (unsigned int i = 0; i < nbProcesses; ++i)
+    {
+        if (fork() == 0)
+        {
+            close(fds[0]);
+
+            unsigned int nbCompleted = 0;
+            int result = runClient(nbConnections, nbRequests, nbCompleted);
+
+            bool bReported = (write(fds[1], &nbCompleted, sizeof(nbCompleted)) == sizeof(nbCompleted));
+
+            _exit((result == 0) && bReported ? 0 : 1);
+        }
+    }
+
+    close(fds[1]);
+
+    int result = 0;
+    for (unsigned int i = 0; i < nbProcesses; ++i)
+    {
+        int status = 0;
+        wait(&status);
+
+        if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+            result = -1;
+    }
+
+    gettimeofday(&end, 0);
+
+    unsigned int totalRequests = 0;
+    unsigned int nbCompleted = 0;
+    while (read(fds[0], &nbCompleted, sizeof(nbCompleted)) == sizeof(nbCompleted))
+        totalRequests += nbCompleted;
+
+    close(fds[0]);
+
+    double duration = (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) * 1e-6;
+    unsigned int totalConnections = nbProcesses * nbConnections;
+
+    // The number of requests is the one of the completed ones (the results are
+    // reported even if some processes failed)
+    cout << "DURATION " << duration << endl
+         << "CONNECTIONS " << totalConnections << endl
+         << "CONNECTIONS_PER_SECOND " << totalConnections / duration << endl
+         << "REQUESTS " << totalRequests << endl
+         << "REQUESTS_PER_SECOND " << totalRequests / duration << endl;
+
+    return result;
+}
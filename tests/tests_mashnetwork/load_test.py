@@ -0,0 +1,102 @@
+#! /usr/bin/env python
+
+################################################################################
+# The MASH Framework contains the source code of all the servers in the
+# "computation farm" of the MASH project (http://www.mash-project.eu),
+# developed at the Idiap Research Institute (http://www.idiap.ch).
+#
+# Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+# Written by Philip Abbet (philip.abbet@idiap.ch)
+#
+# This file is part of the MASH Framework.
+#
+# The MASH Framework is free software: you can redistribute it and/or modify
+# it under the terms of either the GNU General Public License version 2 or
+# the GNU General Public License version 3 as published by the Free
+# Software Foundation, whichever suits the most your needs.
+#
+# The MASH Framework is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public Licenses
+# along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+################################################################################
+
+
+import sys
+import os
+import subprocess
+import signal
+import time
+
+
+# Parameters handling
+if len(sys.argv) != 4:
+    print "Usage: %s PATH_TO_SERVER_APPLICATION PATH_TO_CLIENT_APPLICATION WORKING_DIRECTORY" % sys.argv[0]
+    sys.exit(-1)
+
+server_path = sys.argv[1]
+client_path = sys.argv[2]
+cwd = sys.argv[3]
+
+
+# Bursts of short-lived connections, like the ones coming from the computation farm
+NB_PROCESSES    = 20
+NB_CONNECTIONS  = 25
+NB_REQUESTS     = 10
+
+
+def measure(server_options):
+    # Start the server application
+    command = server_path.split()
+    command.extend(server_options)
+    server = subprocess.Popen(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, cwd=cwd)
+
+    time.sleep(1)
+
+    # Start the client application
+    command = client_path.split()
+    command.extend([str(NB_PROCESSES), str(NB_CONNECTIONS), str(NB_REQUESTS)])
+    client = subprocess.Popen(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, cwd=cwd)
+
+    output = client.stdout.read()
+    client_result = client.wait()
+
+    os.kill(server.pid, signal.SIGKILL)
+    server_output = server.stdout.read()
+    server.wait()
+
+    results = {}
+    for line in output.split('\n'):
+        parts = line.split(' ')
+        if len(parts) == 2:
+            results[parts[0]] = float(parts[1])
+
+    # Check that all the requests were completed
+    expected_requests = NB_PROCESSES * NB_CONNECTIONS * NB_REQUESTS
+    if (client_result != 0) or (results.get('REQUESTS', 0) != expected_requests):
+        print "Requests completed with the server options %s: %d/%d" % \
+                (server_options, results.get('REQUESTS', 0), expected_requests)
+        print "Client stdout: " + output
+        print "Server stdout: " + server_output
+        sys.exit(-1)
+
+    return results
+
+
+fork_results = measure([])
+events_results = measure(['--events'])
+
+result = 0
+for name in ['CONNECTIONS_PER_SECOND', 'REQUESTS_PER_SECOND']:
+    print "%s: fork engine = %.1f, events engine = %.1f (x%.2f)" % \
+            (name, fork_results[name], events_results[name], events_results[name] / fork_results[name])
+
+    # The events engine must not be slower than the fork one
+    if events_results[name] < fork_results[name]:
+        print "FAILED: the events engine is slower than the fork engine"
+        result = -1
+
+sys.exit(result)
@@ -0,0 +1,374 @@
+#include <mash-network/server.h>
+#include <mash-network/server_listener.h>
+#include <mash-network/client.h>
+#include <mash-utils/stringutils.h>
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <string.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace Mash;
+using namespace std;
+
+
+// The benchmark uses its own port, to not interfere with the echo tests
+const unsigned int PORT = 10001;
+
+// Payload used by the throughput measurements
+const unsigned int PAYLOAD_SIZE = 16 * 1024 * 1024;
+
+
+/****************************** SERVER STAND-IN *******************************/
+
+// Mimics the behaviour of the application servers: small requests, large
+// binary payloads (images, models, logs) and lists sent as many lines
+class BenchmarkListener: public ServerListener
+{
+public:
+    BenchmarkListener(int socket)
+    : ServerListener(socket)
+    {
+    }
+
+    virtual ~BenchmarkListener()
+    {
+    }
+
+    virtual tAction handleCommand(const std::string& strCommand,
+                                  const ArgumentsList& arguments)
+    {
+        bool bResult = true;
+
+        if (strCommand == "DOWNLOAD")
+        {
+            int size = min(arguments.getInt(0), (int) PAYLOAD_SIZE);
+            bResult = sendResponse("DATA", ArgumentsList(size), payload(), size);
+        }
+        else if (strCommand == "UPLOAD")
+        {
+            vector<unsigned char> data(arguments.getInt(0));
+            bResult = waitData(&data[0], data.size()) &&
+                      sendResponse("OK", ArgumentsList());
+        }
+        else if (strCommand == "LINES")
+        {
+            for (int i = 0; bResult && (i < arguments.getInt(0)); ++i)
+            {
+                ArgumentsList args;
+                args.add(i);
+                args.add("object_name");
+                args.add("Description of the object");
+
+                bResult = sendResponse("LINE", args);
+            }
+
+            bResult = bResult && sendResponse("END_LINES", ArgumentsList());
+        }
+        else
+        {
+            bResult = sendResponse(strCommand, arguments);
+        }
+
+        if (!bResult)
+            return ACTION_CLOSE_CONNECTION;
+
+        return ACTION_NONE;
+    }
+
+    static const unsigned char* payload()
+    {
+        static vector<unsigned char> data;
+
+        if (data.empty())
+        {
+            data.resize(PAYLOAD_SIZE);
+            for (unsigned int i = 0; i < PAYLOAD_SIZE; ++i)
+                data[i] = (unsigned char) (i * 7);
+        }
+
+        return &data[0];
+    }
+};
+
+
+ServerListener* createListener(int socket)
+{
+    return new BenchmarkListener(socket);
+}
+
+
+pid_t startServer(Server::tEngine engine)
+{
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        BenchmarkListener::payload();
+
+        Server server(0, 100, "BenchmarkServer", engine);
+        server.listen("127.0.0.1", PORT, createListener);
+        _exit(0);
+    }
+
+    return pid;
+}
+
+
+/********************************** HELPERS ***********************************/
+
+double elapsed(const struct timeval& start)
+{
+    struct timeval end;
+    gettimeofday(&end, 0);
+
+    return (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) * 1e-6;
+}
+
+
+bool connectClient(Client* pClient)
+{
+    // The server might not be ready yet
+    for (unsigned int i = 0; i < 50; ++i)
+    {
+        if (pClient->connect("127.0.0.1", PORT))
+            return true;
+
+        usleep(100000);
+    }
+
+    return false;
+}
+
+
+bool echo(Client* pClient, const ArgumentsList& arguments)
+{
+    string strResponse;
+    ArgumentsList responseArgs;
+
+    return pClient->sendCommand("ECHO", arguments) &&
+           pClient->waitResponse(&strResponse, &responseArgs) &&
+           (strResponse == "ECHO") && (responseArgs.size() == arguments.size());
+}
+
+
+/********************************* BENCHMARKS *********************************/
+
+// Round-trip time of small requests
+bool benchmarkLatency(unsigned int nbRequests)
+{
+    Client client;
+    if (!connectClient(&client))
+        return false;
+
+    ArgumentsList arguments;
+    arguments.add("http://something.com");
+    arguments.add(100);
+
+    vector<double> durations;
+    durations.reserve(nbRequests);
+
+    for (unsigned int i = 0; i < nbRequests; ++i)
+    {
+        struct timeval start;
+        gettimeofday(&start, 0);
+
+        if (!echo(&client, arguments))
+            return false;
+
+        durations.push_back(elapsed(start) * 1e6);
+    }
+
+    client.close();
+
+    double total = 0.0;
+    for (unsigned int i = 0; i < nbRequests; ++i)
+        total += durations[i];
+
+    sort(durations.begin(), durations.end());
+
+    cout << "LATENCY_REQUESTS " << nbRequests << endl
+         << "LATENCY_MEAN_US " << total / nbRequests << endl
+         << "LATENCY_P50_US " << durations[nbRequests / 2] << endl
+         << "LATENCY_P99_US " << durations[nbRequests * 99 / 100] << endl;
+
+    return true;
+}
+
+
+// Transfer of large binary payloads, in both directions
+bool benchmarkThroughput(unsigned int nbTransfers)
+{
+    Client client;
+    if (!connectClient(&client))
+        return false;
+
+    vector<unsigned char> data(PAYLOAD_SIZE, 42);
+    string strResponse;
+    ArgumentsList responseArgs;
+
+    struct timeval start;
+    gettimeofday(&start, 0);
+
+    for (unsigned int i = 0; i < nbTransfers; ++i)
+    {
+        if (!client.sendCommand("DOWNLOAD", ArgumentsList((int) PAYLOAD_SIZE)) ||
+            !client.waitResponse(&strResponse, &responseArgs) ||
+            (strResponse != "DATA") || (responseArgs.getInt(0) != (int) PAYLOAD_SIZE) ||
+            !client.waitData(&data[0], PAYLOAD_SIZE))
+        {
+            return false;
+        }
+    }
+
+    double download = elapsed(start);
+
+    if (memcmp(BenchmarkListener::payload(), &data[0], PAYLOAD_SIZE) != 0)
+        return false;
+
+    gettimeofday(&start, 0);
+
+    for (unsigned int i = 0; i < nbTransfers; ++i)
+    {
+        if (!client.sendCommand("UPLOAD", ArgumentsList((int) PAYLOAD_SIZE)) ||
+            !client.sendData(&data[0], PAYLOAD_SIZE) ||
+            !client.waitResponse(&strResponse, &responseArgs) ||
+            (strResponse != "OK"))
+        {
+            return false;
+        }
+    }
+
+    double upload = elapsed(start);
+
+    client.close();
+
+    double megabytes = nbTransfers * (PAYLOAD_SIZE / (1024.0 * 1024.0));
+
+    cout << "PAYLOAD_SIZE_MB " << PAYLOAD_SIZE / (1024.0 * 1024.0) << endl
+         << "TRANSFERS " << nbTransfers << endl
+         << "DOWNLOAD_MB_PER_SECOND " << megabytes / download << endl
+         << "UPLOAD_MB_PER_SECOND " << megabytes / upload << endl;
+
+    return true;
+}
+
+
+// Responses made of many lines (like LIST_OBJECTS or LIST_IMAGES)
+bool benchmarkLines(unsigned int nbLines)
+{
+    Client client;
+    if (!connectClient(&client))
+        return false;
+
+    string strResponse;
+    ArgumentsList responseArgs;
+    unsigned int nbReceived = 0;
+
+    struct timeval start;
+    gettimeofday(&start, 0);
+
+    if (!client.sendCommand("LINES", ArgumentsList((int) nbLines)))
+        return false;
+
+    while (client.waitResponse(&strResponse, &responseArgs) && (strResponse == "LINE"))
+        ++nbReceived;
+
+    double duration = elapsed(start);
+
+    client.close();
+
+    if ((strResponse != "END_LINES") || (nbReceived != nbLines))
+        return false;
+
+    cout << "LINES " << nbLines << endl
+         << "LINES_PER_SECOND " << nbLines / duration << endl;
+
+    return true;
+}
+
+
+// Several clients sending small requests at the same time
+bool benchmarkConcurrency(unsigned int nbClients, unsigned int nbRequests)
+{
+    ArgumentsList arguments;
+    arguments.add("http://something.com");
+    arguments.add(100);
+
+    struct timeval start;
+    gettimeofday(&start, 0);
+
+    for (unsigned int i = 0; i < nbClients; ++i)
+    {
+        if (fork() == 0)
+        {
+            Client client;
+            bool bResult = connectClient(&client);
+
+            for (unsigned int j = 0; bResult && (j < nbRequests); ++j)
+                bResult = echo(&client, arguments);
+
+            client.close();
+            _exit(bResult ? 0 : 1);
+        }
+    }
+
+    bool bResult = true;
+    for (unsigned int i = 0; i < nbClients; ++i)
+    {
+        int status = 0;
+        wait(&status);
+
+        if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+            bResult = false;
+    }
+
+    double duration = elapsed(start);
+
+    if (!bResult)
+        return false;
+
+    cout << "CONCURRENT_" << nbClients << "_REQUESTS_PER_SECOND "
+         << nbClients * nbRequests / duration << endl;
+
+    return true;
+}
+
+
+int main(int argc, char** argv)
+{
+    Server::tEngine engine = Server::ENGINE_FORK;
+    unsigned int scale = 1;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--events") == 0)
+            engine = Server::ENGINE_EVENTS;
+        else if ((argv[i][0] != '-') && (StringUtils::parseUnsignedInt(argv[i]) > 0))
+            scale = StringUtils::parseUnsignedInt(argv[i]);
+        else
+        {
+            cerr << "Usage: " << argv[0] << " [--events] [SCALE]" << endl;
+            return -1;
+        }
+    }
+
+    pid_t server = startServer(engine);
+
+    cout << "ENGINE " << (engine == Server::ENGINE_EVENTS ? "events" : "fork") << endl;
+
+    bool bResult = benchmarkLatency(2000 * scale) &&
+                   benchmarkThroughput(4 * scale) &&
+                   benchmarkLines(100000 * scale);
+
+    for (unsigned int nbClients = 1; bResult && (nbClients <= 16); nbClients *= 2)
+        bResult = benchmarkConcurrency(nbClients, 500 * scale);
+
+    kill(server, SIGKILL);
+    waitpid(server, 0, 0);
+
+    return (bResult ? 0 : -1);
+}
@@ -0,0 +1,50 @@
+#! /usr/bin/env python
+
+################################################################################
+# The MASH Framework contains the source code of all the servers in the
+# "computation farm" of the MASH project (http://www.mash-project.eu),
+# developed at the Idiap Research Institute (http://www.idiap.ch).
+#
+# Copyright (c) 2016 Idiap Research Institute, http://www.idiap.ch/
+# Written by Philip Abbet (philip.abbet@idiap.ch)
+#
+# This file is part of the MASH Framework.
+#
+# The MASH Framework is free software: you can redistribute it and/or modify
+# it under the terms of either the GNU General Public License version 2 or
+# the GNU General Public License version 3 as published by the Free
+# Software Foundation, whichever suits the most your needs.
+#
+# The MASH Framework is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public Licenses
+# along with the MASH Framework. If not, see <http://www.gnu.org/licenses/>.
+################################################################################
+
+
+import sys
+import subprocess
+
+
+
+# Parameters handling
+if len(sys.argv) != 3:
+    print "Usage: %s \"PATH_TO_BENCHMARK_APPLICATION [OPTIONS]\" WORKING_DIRECTORY" % sys.argv[0]
+    sys.exit(-1)
+
+benchmark_command = sys.argv[1].split()
+cwd = sys.argv[2]
+
+
+# Run the benchmark (the output is made of 'KEY VALUE' lines)
+benchmark = subprocess.Popen(benchmark_command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, cwd=cwd)
+
+output = benchmark.stdout.read()
+
+print output
+
+if benchmark.wait() != 0:
+    sys.exit(-1)
@@ -55,10 +55,17 @@ ServerListener* createListener(int socket)
 
 int main(int argc, char** argv)
 {
-    if (argc == 2)
-        OutStream::verbosityLevel = (strcmp(argv[1], "--verbose") == 0 ? 1 : 0);
+    Server::tEngine engine = Server::ENGINE_FORK;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--verbose") == 0)
+            OutStream::verbosityLevel = 1;
+        else if (strcmp(argv[i], "--events") == 0)
+            engine = Server::ENGINE_EVENTS;
+    }
     
-    Server server(1);
+    Server server(1, 100, "Server", engine);
     
     server.listen("127.0.0.1", 10000, createListener);
     
@@ -0,0 +1,126 @@
+#include <mash-sandboxing/communication_channel.h>
+#include <iostream>
+#include <string>
+#include <memory.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "tests.h"
+
+using namespace Mash;
+using namespace std;
+
+
+const unsigned int NB_VALUES    = 50000;
+const unsigned int BUFFER_SIZE  = NB_VALUES * sizeof(unsigned int);
+
+
+int main(int argc, char** argv)
+{
+    unsigned int* DATA1 = new unsigned int[NB_VALUES];
+    unsigned int* DATA2 = new unsigned int[NB_VALUES];
+
+    for (unsigned int i = 0; i < NB_VALUES; ++i)
+    {
+        DATA1[i] = i;
+        DATA2[i] = NB_VALUES - i;
+    }
+
+    CommunicationChannel master, slave;
+    CommunicationChannel::create(&master, &slave);
+
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        master.close();
+
+        unsigned int* buffer = new unsigned int[NB_VALUES];
+        tSandboxMessage message;
+        unsigned int value = 0;
+
+        // Packet with two referenced buffers
+        CHECK_EQUAL_EXIT(ERROR_NONE, slave.receivePacket(&message));
+        CHECK_EQUAL_EXIT(SANDBOX_MESSAGE_PING, message);
+
+        CHECK_EXIT(slave.read(&value));
+        CHECK_EQUAL_EXIT(NB_VALUES, value);
+
+        memset(buffer, 0, BUFFER_SIZE);
+        CHECK_EXIT(slave.read((char*) buffer, BUFFER_SIZE));
+        CHECK_EXIT(memcmp(DATA1, buffer, BUFFER_SIZE) == 0);
+
+        CHECK_EXIT(slave.read(&value));
+        CHECK_EQUAL_EXIT(12345, value);
+
+        memset(buffer, 0, BUFFER_SIZE);
+        CHECK_EXIT(slave.read((char*) buffer, BUFFER_SIZE));
+        CHECK_EXIT(memcmp(DATA2, buffer, BUFFER_SIZE) == 0);
+
+        CHECK_EXIT(slave.endOfPacket());
+        CHECK_EXIT(!slave.read(&value));
+
+        // Large packet only partially read
+        CHECK_EQUAL_EXIT(ERROR_NONE, slave.receivePacket(&message));
+        CHECK_EQUAL_EXIT(SANDBOX_MESSAGE_PING, message);
+
+        CHECK_EXIT(slave.read((char*) buffer, 100 * sizeof(unsigned int)));
+        CHECK_EQUAL_EXIT(99, buffer[99]);
+        CHECK_EXIT(!slave.endOfPacket());
+
+        // Small packet following it
+        CHECK_EQUAL_EXIT(ERROR_NONE, slave.receivePacket(&message));
+        CHECK_EQUAL_EXIT(SANDBOX_MESSAGE_PING, message);
+
+        CHECK_EXIT(slave.read(&value));
+        CHECK_EQUAL_EXIT(42, value);
+        CHECK_EXIT(slave.endOfPacket());
+
+        // Response containing a referenced buffer
+        slave.startPacket(SANDBOX_MESSAGE_RESPONSE);
+        slave.addReference((const char*) DATA2, BUFFER_SIZE);
+        slave.add(NB_VALUES);
+        slave.sendPacket();
+
+        delete[] buffer;
+
+        _exit(0);
+    }
+
+    slave.close();
+
+    CHECK_EQUAL(ERROR_NONE, master.startPacket(SANDBOX_MESSAGE_PING));
+    master.add(NB_VALUES);
+    master.addReference((const char*) DATA1, BUFFER_SIZE);
+    master.add(12345);
+    master.addReference((const char*) DATA2, BUFFER_SIZE);
+    CHECK_EQUAL(ERROR_NONE, master.sendPacket());
+
+    CHECK_EQUAL(ERROR_NONE, master.startPacket(SANDBOX_MESSAGE_PING));
+    master.addReference((const char*) DATA1, BUFFER_SIZE);
+    CHECK_EQUAL(ERROR_NONE, master.sendPacket());
+
+    CHECK_EQUAL(ERROR_NONE, master.startPacket(SANDBOX_MESSAGE_PING));
+    master.add(42);
+    CHECK_EQUAL(ERROR_NONE, master.sendPacket());
+
+    tSandboxMessage message;
+    CHECK_EQUAL(ERROR_NONE, master.receivePacket(&message, 5000));
+    CHECK_EQUAL(SANDBOX_MESSAGE_RESPONSE, message);
+
+    unsigned int* buffer = new unsigned int[NB_VALUES];
+    CHECK(master.read((char*) buffer, BUFFER_SIZE));
+    CHECK(memcmp(DATA2, buffer, BUFFER_SIZE) == 0);
+
+    unsigned int value = 0;
+    CHECK(master.read(&value));
+    CHECK_EQUAL(NB_VALUES, value);
+    CHECK(master.endOfPacket());
+
+    int exit_status = 0;
+    waitpid(pid, &exit_status, 0);
+
+    delete[] buffer;
+    delete[] DATA1;
+    delete[] DATA2;
+
+    return WEXITSTATUS(exit_status);
+}
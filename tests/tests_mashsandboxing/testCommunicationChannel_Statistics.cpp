@@ -0,0 +1,83 @@
+#include <mash-sandboxing/communication_channel.h>
+#include <iostream>
+#include <string>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "tests.h"
+
+using namespace Mash;
+using namespace std;
+
+
+const unsigned int NB_PINGS    = 10;
+const unsigned int HEADER_SIZE = sizeof(tSandboxMessage) + sizeof(size_t);
+
+
+int main(int argc, char** argv)
+{
+    CommunicationChannel master, slave;
+    CommunicationChannel::create(&master, &slave);
+
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        master.close();
+
+        tSandboxMessage message;
+
+        for (unsigned int i = 0; i < NB_PINGS; ++i)
+        {
+            CHECK_EQUAL_EXIT(ERROR_NONE, slave.receivePacket(&message));
+            CHECK_EQUAL_EXIT(SANDBOX_MESSAGE_PING, message);
+
+            slave.startPacket(SANDBOX_MESSAGE_PONG);
+            slave.add(i);
+            slave.sendPacket();
+        }
+        
+        _exit(0);
+    }
+    
+    slave.close();
+
+    CHECK(!master.statistics());
+
+    master.enableStatistics();
+    CHECK(master.statistics());
+
+    for (unsigned int i = 0; i < NB_PINGS; ++i)
+    {
+        CHECK_EQUAL(ERROR_NONE, master.startPacket(SANDBOX_MESSAGE_PING));
+        master.add(i);
+        master.add((unsigned int) 0);
+        CHECK_EQUAL(ERROR_NONE, master.sendPacket());
+
+        tSandboxMessage message;
+        CHECK_EQUAL(ERROR_NONE, master.receivePacket(&message, 5000));
+        CHECK_EQUAL(SANDBOX_MESSAGE_PONG, message);
+    }
+
+    const tMessageStatistics& ping = master.statistics()->messages[SANDBOX_MESSAGE_PING];
+    const tMessageStatistics& pong = master.statistics()->messages[SANDBOX_MESSAGE_PONG];
+
+    CHECK_EQUAL(NB_PINGS, ping.nb_sent);
+    CHECK_EQUAL(NB_PINGS * (HEADER_SIZE + 2 * sizeof(unsigned int)), ping.bytes_sent);
+    CHECK_EQUAL(0, ping.nb_received);
+    CHECK_EQUAL(NB_PINGS, ping.nb_round_trips);
+
+    unsigned int total = 0;
+    for (unsigned int i = 0; i < tMessageStatistics::NB_LATENCY_BUCKETS; ++i)
+        total += ping.latency_histogram[i];
+
+    CHECK_EQUAL(NB_PINGS, total);
+
+    CHECK_EQUAL(0, pong.nb_sent);
+    CHECK_EQUAL(NB_PINGS, pong.nb_received);
+    CHECK_EQUAL(NB_PINGS * (HEADER_SIZE + sizeof(unsigned int)), pong.bytes_received);
+    CHECK_EQUAL(0, pong.nb_round_trips);
+
+    int exit_status = 0;
+    waitpid(pid, &exit_status, 0);
+    
+    return WEXITSTATUS(exit_status);
+}
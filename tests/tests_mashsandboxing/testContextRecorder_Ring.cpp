@@ -0,0 +1,60 @@
+#include <mash-sandboxing/context_recorder.h>
+#include <iostream>
+#include <string>
+#include "tests.h"
+
+using namespace Mash;
+using namespace std;
+
+
+int main(int argc, char** argv)
+{
+    ContextRecorder recorder;
+
+    CHECK(recorder.empty());
+    CHECK_EQUAL("", recorder.toString());
+
+    recorder.record("loading");
+    CHECK_EQUAL("Method: loading\n", recorder.toString());
+
+    recorder.record("prepareForCoordinates");
+    recorder.addParameter("Heuristic", "#%d", 2);
+    recorder.addParameter("ROI position", "(%d, %d)", 10, 20);
+    recorder.addParameter("Model");
+
+    CHECK_EQUAL("Method: prepareForCoordinates\n"
+                "Parameters:\n"
+                "    - Heuristic:    #2\n"
+                "    - ROI position: (10, 20)\n"
+                "    - Model\n"
+                "Previous calls (most recent first):\n"
+                "    - loading\n",
+                recorder.toString());
+
+    // Only the last calls are kept
+    for (unsigned int i = 0; i < ContextRecorder::NB_ENTRIES + 3; ++i)
+    {
+        recorder.record("computeFeature");
+        recorder.addParameter("Features", "%d", i);
+    }
+
+    CHECK_EQUAL(ContextRecorder::NB_ENTRIES, recorder.nbEntries());
+
+    string strContext = recorder.toString();
+    CHECK(strContext.find("Method: computeFeature\nParameters:\n    - Features: 10\n") == 0);
+    CHECK(strContext.find("    - computeFeature (Features: 9)\n") != string::npos);
+    CHECK(strContext.find("    - computeFeature (Features: 3)\n") != string::npos);
+    CHECK(strContext.find("    - computeFeature (Features: 2)\n") == string::npos);
+    CHECK(strContext.find("prepareForCoordinates") == string::npos);
+
+    // Free-form details
+    recorder.record("setup");
+    recorder.addDetails("    - PARAM 1 2\n");
+    CHECK(recorder.toString().find("Method: setup\nParameters:\n    - PARAM 1 2\n") == 0);
+
+    recorder.clear();
+    CHECK(recorder.empty());
+    CHECK_EQUAL("", recorder.toString());
+
+    return 0;
+}
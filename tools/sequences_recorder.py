@@ -161,10 +161,11 @@ try:
     if response is None:
         bail('FAILED (no response)')
 
-    if (response.name != 'PROTOCOL') or (len(response.parameters) != 1) or (str(response.parameters[0]) not in ['1.4', '1.3', '1.2']):
+    if (response.name != 'PROTOCOL') or (len(response.parameters) != 1) or (str(response.parameters[0]) not in ['1.5', '1.4', '1.3', '1.2']):
         bail(response.toString())
 
-    canUseRecordings = (str(response.parameters[0]) == '1.4')
+    # The recordings are supported since the version 1.4 of the protocol
+    canUseRecordings = (map(int, str(response.parameters[0]).split('.')) >= [1, 4])
 
     stdscr.addstr('\n')
 
@@ -0,0 +1,419 @@
+#include <UnitTest++.h>
+#include <mash-classification/dataset.h>
+#include <mash-utils/random_number_generator.h>
+#include <mash-utils/stringutils.h>
+#include <algorithm>
+#include <stdlib.h>
+
+using namespace Mash;
+using namespace std;
+
+
+// An image database filled without application server
+class StubImageDatabase: public ImageDatabase
+{
+public:
+    StubImageDatabase(unsigned int nbLabels)
+    : ImageDatabase(10)
+    {
+        _labels.resize(nbLabels);
+
+        for (unsigned int i = 0; i < nbLabels; ++i)
+        {
+            _labels[i].strName = "label" + StringUtils::toString(i);
+            _labels[i].nbObjects = 0;
+        }
+    }
+
+    void addImage(dim_t size, tImageSet set, const tObjectsList& objects)
+    {
+        tImage image;
+        image.size      = size;
+        image.set       = set;
+        image.objects   = objects;
+        image.strName   = "image" + StringUtils::toString((unsigned int) _images.size());
+
+        for (unsigned int i = 0; i < objects.size(); ++i)
+            ++_labels[objects[i].label].nbObjects;
+
+        _nbObjects += objects.size();
+        _images.push_back(image);
+    }
+};
+
+
+// Random number in [0, max)
+unsigned int draw(RandomNumberGenerator& generator, unsigned int max)
+{
+    return generator.randomize() % max;
+}
+
+
+// Random database, with images of 'nbSizes' different dimensions, some of them
+// without objects
+void populate(StubImageDatabase* pDatabase, unsigned int nbImages,
+              unsigned int nbSizes, unsigned int seed)
+{
+    RandomNumberGenerator generator;
+    generator.setSeed(seed);
+
+    for (unsigned int i = 0; i < nbImages; ++i)
+    {
+        unsigned int size_index = draw(generator, nbSizes);
+
+        dim_t size;
+        size.width  = 40 + 7 * size_index;
+        size.height = 30 + 5 * ((size_index * 3) % nbSizes);
+
+        ImageDatabase::tObjectsList objects(draw(generator, 4));
+
+        for (unsigned int j = 0; j < objects.size(); ++j)
+        {
+            unsigned int object_size = 8 + draw(generator, min(size.width, size.height) - 8);
+
+            objects[j].label            = draw(generator, pDatabase->nbLabels());
+            objects[j].top_left.x       = draw(generator, size.width - object_size + 1);
+            objects[j].top_left.y       = draw(generator, size.height - object_size + 1);
+            objects[j].bottom_right.x   = objects[j].top_left.x + object_size - 1;
+            objects[j].bottom_right.y   = objects[j].top_left.y + object_size - 1;
+            objects[j].scale            = 1.0f;
+        }
+
+        pDatabase->addImage(size, (ImageDatabase::tImageSet) draw(generator, 3), objects);
+    }
+}
+
+
+// The mapping built by DataSet::setup() before the entries of the DataSet were
+// generated on demand: one record per generated image, and the list of the
+// 'true indices' of the images of each set
+struct tReferenceImage
+{
+    unsigned int    original_image;
+    float           scale;
+    bool            training;
+    unsigned int    set_index;
+};
+
+struct tReference
+{
+    vector<tReferenceImage> images;
+    vector<unsigned int>    training;
+    vector<unsigned int>    test;
+};
+
+
+void buildReference(ImageDatabase* pDatabase, unsigned int roi_extent,
+                    const Stepper& stepper, bool bUseStandardSets,
+                    float trainingRatio, unsigned int seed, tReference* reference)
+{
+    RandomNumberGenerator generator;
+    generator.setSeed(seed);
+
+    vector<tReferenceImage> images;
+    vector<unsigned int> backgroundImages;
+
+    vector<unsigned int> trainingCounters;
+    vector<unsigned int> unassignedObjectsCounters;
+    for (unsigned int i = 0; i < pDatabase->nbLabels(); ++i)
+    {
+        unsigned int nbObjects = pDatabase->nbObjects(i);
+        unassignedObjectsCounters.push_back(nbObjects);
+        trainingCounters.push_back(min(nbObjects - 1, (unsigned) max(int(nbObjects * trainingRatio), 1)));
+    }
+
+    unsigned int roi_size = roi_extent * 2 + 1;
+    for (unsigned int image = 0; image < pDatabase->nbImages(); ++image)
+    {
+        Stepper::tScalesList scales = stepper.scales(pDatabase->imageSize(image));
+
+        ImageDatabase::tObjectsList* pObjects = pDatabase->objectsOfImage(image);
+
+        if (pObjects->empty())
+        {
+            backgroundImages.push_back(image);
+            continue;
+        }
+
+        vector<tReferenceImage> generatedImages;
+        vector<unsigned int> labelCounters(pDatabase->nbLabels(), 0);
+
+        ImageDatabase::tImageSet set = (bUseStandardSets ? pDatabase->imageSet(image) : ImageDatabase::SET_NONE);
+
+        if (set == ImageDatabase::SET_NONE)
+        {
+            bool training = false;
+            bool test = false;
+
+            for (unsigned int i = 0; i < pObjects->size(); ++i)
+            {
+                unsigned int label = (*pObjects)[i].label;
+
+                if (trainingCounters[label] == 0)
+                    test = true;
+                else if (unassignedObjectsCounters[label] <= trainingCounters[label])
+                    training = true;
+
+                ++labelCounters[label];
+                --unassignedObjectsCounters[label];
+            }
+
+            if (training)
+                set = ImageDatabase::SET_TRAINING;
+            else if (test)
+                set = ImageDatabase::SET_TEST;
+            else
+                set = (generator.randomize(1.0f) < trainingRatio) ? ImageDatabase::SET_TRAINING : ImageDatabase::SET_TEST;
+        }
+
+        if (set == ImageDatabase::SET_TRAINING)
+        {
+            for (unsigned int label = 0; label < labelCounters.size(); ++label)
+                trainingCounters[label] -= labelCounters[label];
+        }
+
+        for (unsigned int i = 0; i < pObjects->size(); ++i)
+        {
+            const ImageDatabase::tObject& object = (*pObjects)[i];
+
+            unsigned int width = object.bottom_right.x - object.top_left.x + 1;
+            unsigned int height = object.bottom_right.y - object.top_left.y + 1;
+            unsigned int size = max(width, height);
+            float scale = 1.0f;
+            int smallest_diff;
+
+            for (unsigned int j = 0; j < scales.size(); ++j)
+            {
+                int diff = abs(int(size * scales[j]) - int(roi_size));
+
+                if (j == 0 || diff <= smallest_diff)
+                {
+                    smallest_diff = diff;
+                    scale = scales[j];
+                }
+            }
+
+            if (set == ImageDatabase::SET_TRAINING || !stepper.isDoingDetection())
+            {
+                bool found = false;
+                for (unsigned int j = 0; j < generatedImages.size(); ++j)
+                {
+                    if ((generatedImages[j].scale >= scale - 1e-6f) && (generatedImages[j].scale <= scale + 1e-6f))
+                    {
+                        found = true;
+                        break;
+                    }
+                }
+
+                if (!found)
+                {
+                    tReferenceImage generatedImage;
+                    generatedImage.original_image = image;
+                    generatedImage.scale = scale;
+                    generatedImages.push_back(generatedImage);
+                }
+            }
+        }
+
+        if (stepper.isDoingDetection() && set == ImageDatabase::SET_TEST)
+        {
+            for (unsigned int j = 0; j < scales.size(); ++j)
+            {
+                tReferenceImage generatedImage;
+                generatedImage.original_image = image;
+                generatedImage.scale = scales[j];
+                generatedImages.push_back(generatedImage);
+            }
+        }
+
+        for (unsigned int j = 0; j < generatedImages.size(); ++j)
+        {
+            images.push_back(generatedImages[j]);
+
+            if (set == ImageDatabase::SET_TRAINING)
+                reference->training.push_back(images.size() - 1);
+            else
+                reference->test.push_back(images.size() - 1);
+        }
+    }
+
+    unsigned int nbGeneratedImages = images.size();
+    unsigned int counter = backgroundImages.size() * trainingRatio;
+    for (unsigned int i = 0; i < backgroundImages.size(); ++i)
+    {
+        ImageDatabase::tImageSet set = (bUseStandardSets ? pDatabase->imageSet(backgroundImages[i]) : ImageDatabase::SET_NONE);
+
+        if (set == ImageDatabase::SET_NONE)
+        {
+            if (counter == 0)
+            {
+                reference->test.push_back(nbGeneratedImages + i);
+            }
+            else if (counter >= backgroundImages.size() - i)
+            {
+                reference->training.push_back(nbGeneratedImages + i);
+                --counter;
+            }
+            else if (generator.randomize(100) > 50)
+            {
+                reference->training.push_back(nbGeneratedImages + i);
+                --counter;
+            }
+            else
+            {
+                reference->test.push_back(nbGeneratedImages + i);
+            }
+        }
+        else if (set == ImageDatabase::SET_TRAINING)
+        {
+            reference->training.push_back(nbGeneratedImages + i);
+            --counter;
+        }
+        else
+        {
+            reference->test.push_back(nbGeneratedImages + i);
+        }
+
+        tReferenceImage backgroundImage;
+        backgroundImage.original_image = backgroundImages[i];
+        backgroundImage.scale = 1.0f;
+        images.push_back(backgroundImage);
+    }
+
+    reference->images = images;
+
+    for (unsigned int i = 0; i < reference->training.size(); ++i)
+    {
+        reference->images[reference->training[i]].training = true;
+        reference->images[reference->training[i]].set_index = i;
+    }
+
+    for (unsigned int i = 0; i < reference->test.size(); ++i)
+    {
+        reference->images[reference->test[i]].training = false;
+        reference->images[reference->test[i]].set_index = i;
+    }
+}
+
+
+void checkImage(DataSet* pDataSet, const tReference& reference, unsigned int image)
+{
+    std::string strName;
+    dim_t size;
+    scalar_t scale;
+    bool training;
+    unsigned int set_index;
+
+    pDataSet->getImageInfos(image, &strName, &size, &scale, &training, &set_index);
+
+    CHECK_EQUAL("image" + StringUtils::toString(reference.images[image].original_image), strName);
+    CHECK_EQUAL(reference.images[image].scale, scale);
+    CHECK_EQUAL(reference.images[image].training, training);
+    CHECK_EQUAL(reference.images[image].set_index, set_index);
+    CHECK_EQUAL(!reference.images[image].training, pDataSet->isImageInTestSet(image));
+}
+
+
+void checkMapping(bool detection, bool bUseStandardSets, unsigned int nbSizes,
+                  unsigned int seed, unsigned int nbLabels = 4)
+{
+    const unsigned int roi_extent = 10;
+    const float trainingRatio = 0.6f;
+
+    StubImageDatabase database(nbLabels);
+    populate(&database, 300, nbSizes, seed);
+
+    Stepper stepper(detection);
+    stepper.setParameters(roi_extent, 4, 4, 0.8f);
+
+    Stepper referenceStepper(detection);
+    referenceStepper.setParameters(roi_extent, 4, 4, 0.8f);
+
+    tReference reference;
+    buildReference(&database, roi_extent, referenceStepper, bUseStandardSets,
+                   trainingRatio, seed, &reference);
+
+    DataSet dataset(10);
+    dataset.setup(&database, roi_extent, &stepper, bUseStandardSets, trainingRatio, seed);
+
+    // All the images, in both directions (the scales of the first images
+    // might have been evicted from the cache of the stepper in between)
+    dataset.setMode(DataSet::MODE_NORMAL);
+    CHECK_EQUAL(reference.images.size(), dataset.nbImages());
+
+    if (dataset.nbImages() != reference.images.size())
+        return;
+
+    for (unsigned int i = 0; i < reference.images.size(); ++i)
+        checkImage(&dataset, reference, i);
+
+    for (unsigned int i = reference.images.size(); i > 0; --i)
+        checkImage(&dataset, reference, i - 1);
+
+    CHECK_EQUAL(false, dataset.isImageInTestSet(reference.images.size()));
+
+    // The sets
+    dataset.setMode(DataSet::MODE_TRAINING);
+    CHECK_EQUAL(reference.training.size(), dataset.nbImages());
+
+    for (unsigned int i = 0; (i < reference.training.size()) && (i < dataset.nbImages()); ++i)
+        CHECK_EQUAL(reference.training[i], dataset.getImageIndex(i));
+
+    dataset.setMode(DataSet::MODE_TEST);
+    CHECK_EQUAL(reference.test.size(), dataset.nbImages());
+
+    for (unsigned int i = 0; (i < reference.test.size()) && (i < dataset.nbImages()); ++i)
+        CHECK_EQUAL(reference.test[i], dataset.getImageIndex(i));
+
+    CHECK(stepper.nbCachedScales() <= Stepper::MAX_CACHED_SIZES);
+}
+
+
+SUITE(DataSetSuite)
+{
+    TEST(ClassificationMappingIsUnchanged)
+    {
+        for (unsigned int seed = 1; seed <= 3; ++seed)
+            checkMapping(false, false, 8, seed);
+    }
+
+
+    TEST(ClassificationMappingWithStandardSetsIsUnchanged)
+    {
+        for (unsigned int seed = 1; seed <= 3; ++seed)
+            checkMapping(false, true, 8, seed);
+    }
+
+
+    TEST(DetectionMappingIsUnchanged)
+    {
+        for (unsigned int seed = 1; seed <= 3; ++seed)
+            checkMapping(true, false, 8, seed);
+    }
+
+
+    TEST(DetectionMappingWithStandardSetsIsUnchanged)
+    {
+        for (unsigned int seed = 1; seed <= 3; ++seed)
+            checkMapping(true, true, 8, seed);
+    }
+
+
+    TEST(DetectionMappingWithMoreSizesThanCachedByTheStepper)
+    {
+        // The scales of the test images are retrieved from the stepper each
+        // time, and computed again once evicted from its cache
+        checkMapping(true, false, Stepper::MAX_CACHED_SIZES * 2, 4);
+    }
+
+
+    TEST(MappingWithLessCheckpointsForMoreLabels)
+    {
+        // The counters of all the labels are saved in each checkpoint, so
+        // the checkpoints are further apart
+        CHECK(20 * 8 > DataSet::MIN_ENTRIES_PER_CHECKPOINT);
+
+        checkMapping(false, false, 8, 5, 20);
+        checkMapping(true, false, 8, 6, 20);
+    }
+}
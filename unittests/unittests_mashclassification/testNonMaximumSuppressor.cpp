@@ -0,0 +1,175 @@
+#include <UnitTest++.h>
+#include <mash-classification/non_maximum_suppressor.h>
+#include <mash-utils/random_number_generator.h>
+#include <algorithm>
+
+using namespace Mash;
+using namespace std;
+
+
+struct tDetection: public tObject
+{
+    scalar_t        score;
+    unsigned int    id;
+};
+
+
+tDetection makeDetection(unsigned int id, unsigned int x, unsigned int y,
+                         scalar_t score, unsigned int roi_extent = 10)
+{
+    tDetection detection;
+    detection.id = id;
+    detection.label = 0;
+    detection.target = false;
+    detection.roi_position.x = x;
+    detection.roi_position.y = y;
+    detection.roi_extent = roi_extent;
+    detection.score = score;
+
+    return detection;
+}
+
+
+// The clustering done by the Experiment Server before the introduction of the
+// suppressor, comparing each detection with all the kept ones
+void exhaustiveSuppression(const vector<tDetection>& input, vector<tDetection>* output)
+{
+    output->clear();
+
+    for (unsigned int i = 0; i < input.size(); ++i)
+    {
+        tObjectIntersecter intersecter(input[i], 0.25f);
+
+        vector<tDetection>::iterator iter, iterEnd;
+        for (iter = output->begin(), iterEnd = output->end(); iter != iterEnd; ++iter)
+        {
+            if (iter->score >= input[i].score && intersecter(*iter))
+                break;
+        }
+
+        if (iter == iterEnd)
+        {
+            iter = remove_if(output->begin(), output->end(), intersecter);
+            output->resize(iter - output->begin());
+            output->push_back(input[i]);
+        }
+    }
+}
+
+
+SUITE(NonMaximumSuppressorSuite)
+{
+    TEST(DetectionsNotIntersectingAreAllKept)
+    {
+        NonMaximumSuppressor<tDetection> suppressor(10);
+
+        CHECK(suppressor.add(makeDetection(0, 10, 10, 0.5f)));
+        CHECK(suppressor.add(makeDetection(1, 100, 10, 0.6f)));
+        CHECK(suppressor.add(makeDetection(2, 10, 100, 0.4f)));
+        CHECK_EQUAL(3, suppressor.size());
+
+        vector<tDetection> detections;
+        suppressor.getDetections(&detections);
+        CHECK_EQUAL(3, detections.size());
+        CHECK_EQUAL(0, detections[0].id);
+        CHECK_EQUAL(1, detections[1].id);
+        CHECK_EQUAL(2, detections[2].id);
+    }
+
+
+    TEST(DetectionWithLowerScoreIsDiscarded)
+    {
+        NonMaximumSuppressor<tDetection> suppressor(10);
+
+        CHECK(suppressor.add(makeDetection(0, 50, 50, 0.5f)));
+        CHECK(!suppressor.add(makeDetection(1, 52, 51, 0.4f)));
+        CHECK(!suppressor.add(makeDetection(2, 48, 50, 0.5f)));
+        CHECK_EQUAL(1, suppressor.size());
+    }
+
+
+    TEST(DetectionWithHigherScoreReplacesTheIntersectingOnes)
+    {
+        NonMaximumSuppressor<tDetection> suppressor(10);
+
+        CHECK(suppressor.add(makeDetection(0, 40, 50, 0.5f)));
+        CHECK(suppressor.add(makeDetection(1, 200, 200, 0.1f)));
+        CHECK(suppressor.add(makeDetection(2, 60, 50, 0.4f)));
+        CHECK(suppressor.add(makeDetection(3, 50, 50, 0.9f)));
+
+        vector<tDetection> detections;
+        suppressor.getDetections(&detections);
+        CHECK_EQUAL(2, detections.size());
+        CHECK_EQUAL(1, detections[0].id);
+        CHECK_EQUAL(3, detections[1].id);
+    }
+
+
+    TEST(DetectionsAreProcessedInTheOrderTheyAreAdded)
+    {
+        // 0 and 2 don't intersect, but both intersect with 1: 2 removes 1,
+        // which already removed 0
+        NonMaximumSuppressor<tDetection> suppressor(10);
+
+        CHECK(suppressor.add(makeDetection(0, 38, 50, 0.7f)));
+        CHECK(suppressor.add(makeDetection(1, 50, 50, 0.8f)));
+        CHECK(suppressor.add(makeDetection(2, 62, 50, 0.9f)));
+
+        vector<tDetection> detections;
+        suppressor.getDetections(&detections);
+        CHECK_EQUAL(1, detections.size());
+        CHECK_EQUAL(2, detections[0].id);
+    }
+
+
+    TEST(ClearRemovesAllTheDetections)
+    {
+        NonMaximumSuppressor<tDetection> suppressor(10);
+
+        suppressor.add(makeDetection(0, 50, 50, 0.5f));
+        suppressor.clear();
+        CHECK_EQUAL(0, suppressor.size());
+
+        CHECK(suppressor.add(makeDetection(1, 50, 50, 0.1f)));
+
+        vector<tDetection> detections;
+        suppressor.getDetections(&detections);
+        CHECK_EQUAL(1, detections.size());
+        CHECK_EQUAL(1, detections[0].id);
+    }
+
+
+    TEST(SameResultsThanTheExhaustiveComparison)
+    {
+        RandomNumberGenerator generator;
+        generator.setSeed(1234);
+
+        for (unsigned int round = 0; round < 20; ++round)
+        {
+            vector<tDetection> input;
+
+            for (unsigned int i = 0; i < 3000; ++i)
+            {
+                input.push_back(makeDetection(i, generator.randomize(400), generator.randomize(300),
+                                              generator.randomize(1000) * 0.001f,
+                                              5 + generator.randomize(10)));
+            }
+
+            NonMaximumSuppressor<tDetection> suppressor(15);
+            for (unsigned int i = 0; i < input.size(); ++i)
+                suppressor.add(input[i]);
+
+            vector<tDetection> expected;
+            exhaustiveSuppression(input, &expected);
+
+            vector<tDetection> detections;
+            suppressor.getDetections(&detections);
+
+            CHECK_EQUAL(expected.size(), suppressor.size());
+            CHECK_EQUAL(expected.size(), detections.size());
+
+            for (unsigned int i = 0; (i < expected.size()) && (i < detections.size()); ++i)
+                CHECK_EQUAL(expected[i].id, detections[i].id);
+        }
+    }
+}
@@ -0,0 +1,171 @@
+#include <UnitTest++.h>
+#include <mash-classification/stepper.h>
+
+using namespace Mash;
+
+
+SUITE(StepperSuite)
+{
+    TEST(PositionsOfClassificationImage)
+    {
+        Stepper stepper(false);
+        stepper.setParameters(63);
+
+        dim_t size = { 127, 127 };
+
+        const tCoordinatesList& positions = stepper.positions(size);
+        CHECK_EQUAL(1, positions.size());
+        CHECK_EQUAL(63, positions[0].x);
+        CHECK_EQUAL(63, positions[0].y);
+    }
+
+
+    TEST(PositionsOfDetectionImage)
+    {
+        Stepper stepper(true);
+        stepper.setParameters(10, 5, 5, 0.5f);
+
+        dim_t size = { 41, 31 };
+
+        const tCoordinatesList& positions = stepper.positions(size);
+        CHECK_EQUAL(5 * 3, positions.size());
+
+        // The positions alternate between left to right and right to left
+        CHECK_EQUAL(10, positions[0].x);
+        CHECK_EQUAL(10, positions[0].y);
+        CHECK_EQUAL(30, positions[4].x);
+        CHECK_EQUAL(30, positions[5].x);
+        CHECK_EQUAL(15, positions[5].y);
+        CHECK_EQUAL(30, positions[14].x);
+        CHECK_EQUAL(20, positions[14].y);
+    }
+
+
+    TEST(PositionsAreSharedByImagesOfSameDimensions)
+    {
+        Stepper stepper(true);
+        stepper.setParameters(10, 5, 5, 0.5f);
+
+        dim_t size1 = { 41, 31 };
+        dim_t size2 = { 31, 41 };
+
+        const tCoordinatesList& positions1 = stepper.positions(size1);
+        const tCoordinatesList& positions2 = stepper.positions(size2);
+
+        CHECK(&positions1 != &positions2);
+        CHECK(&positions1 == &stepper.positions(size1));
+        CHECK(&positions2 == &stepper.positions(size2));
+        CHECK_EQUAL(15, positions1.size());
+        CHECK_EQUAL(15, positions2.size());
+
+        tCoordinatesList copy;
+        stepper.getPositions(size1, &copy);
+        CHECK_EQUAL(positions1.size(), copy.size());
+
+        for (unsigned int i = 0; i < copy.size(); ++i)
+        {
+            CHECK_EQUAL(positions1[i].x, copy[i].x);
+            CHECK_EQUAL(positions1[i].y, copy[i].y);
+        }
+    }
+
+
+    TEST(ScalesAreSharedByImagesOfSameDimensions)
+    {
+        Stepper stepper(true);
+        stepper.setParameters(10, 5, 5, 0.5f);
+
+        dim_t size = { 100, 50 };
+
+        const Stepper::tScalesList& scales = stepper.scales(size);
+        CHECK_EQUAL(3, scales.size());
+        CHECK_CLOSE(1.0f, scales[0], 1e-6f);
+        CHECK_CLOSE(0.25f, scales[2], 1e-6f);
+
+        CHECK(&scales == &stepper.scales(size));
+
+        Stepper::tScalesList copy;
+        stepper.getScales(size, &copy);
+        CHECK(copy == scales);
+    }
+
+
+    TEST(ChangingTheParametersUpdatesTheLists)
+    {
+        Stepper stepper(true);
+        stepper.setParameters(10, 5, 5, 0.5f);
+
+        dim_t size = { 41, 31 };
+
+        CHECK_EQUAL(15, stepper.positions(size).size());
+        CHECK_EQUAL(1, stepper.scales(size).size());
+
+        stepper.setParameters(10, 10, 10, 0.9f);
+
+        CHECK_EQUAL(3 * 1, stepper.positions(size).size());
+        CHECK_EQUAL(7, stepper.scales(size).size());
+    }
+
+
+    TEST(CachesAreBounded)
+    {
+        Stepper stepper(true);
+        stepper.setParameters(10, 5, 5, 0.5f);
+
+        dim_t size = { 41, 31 };
+
+        tCoordinatesList expectedPositions;
+        Stepper::tScalesList expectedScales;
+        stepper.getPositions(size, &expectedPositions);
+        stepper.getScales(size, &expectedScales);
+
+        // Request the lists of many more image dimensions than the caches keep
+        for (unsigned int i = 0; i < 4 * Stepper::MAX_CACHED_SIZES; ++i)
+        {
+            dim_t other = { 50 + i, 40 + i };
+
+            CHECK(!stepper.positions(other).empty());
+            CHECK(!stepper.scales(other).empty());
+
+            CHECK(stepper.nbCachedPositions() <= Stepper::MAX_CACHED_SIZES);
+            CHECK(stepper.nbCachedScales() <= Stepper::MAX_CACHED_SIZES);
+        }
+
+        CHECK_EQUAL(Stepper::MAX_CACHED_SIZES, stepper.nbCachedPositions());
+        CHECK_EQUAL(Stepper::MAX_CACHED_SIZES, stepper.nbCachedScales());
+
+        // The evicted lists are recomputed identically
+        const tCoordinatesList& positions = stepper.positions(size);
+        CHECK_EQUAL(expectedPositions.size(), positions.size());
+
+        for (unsigned int i = 0; i < positions.size(); ++i)
+        {
+            CHECK_EQUAL(expectedPositions[i].x, positions[i].x);
+            CHECK_EQUAL(expectedPositions[i].y, positions[i].y);
+        }
+
+        CHECK(stepper.scales(size) == expectedScales);
+    }
+
+
+    TEST(RecentlyUsedListsAreKept)
+    {
+        Stepper stepper(true);
+        stepper.setParameters(10, 5, 5, 0.5f);
+
+        dim_t size = { 41, 31 };
+
+        const tCoordinatesList& positions = stepper.positions(size);
+
+        // Keep using the first dimensions while requesting many others
+        for (unsigned int i = 0; i < 4 * Stepper::MAX_CACHED_SIZES; ++i)
+        {
+            dim_t other = { 50 + i, 40 + i };
+            stepper.positions(other);
+
+            CHECK(&positions == &stepper.positions(size));
+        }
+
+        CHECK_EQUAL(Stepper::MAX_CACHED_SIZES, stepper.nbCachedPositions());
+    }
+}
@@ -0,0 +1,79 @@
+#include <UnitTest++.h>
+#include <mash-network/commands_table.h>
+#include <mash-utils/stringutils.h>
+
+using namespace Mash;
+using namespace std;
+
+SUITE(CommandsTableSuite)
+{
+    TEST(EmptyAtCreation)
+    {
+        CommandsTable<int> table;
+
+        CHECK(table.empty());
+        CHECK_EQUAL(0, table.size());
+        CHECK(!table.find("STATUS"));
+    }
+
+
+    TEST(FindTheHandlers)
+    {
+        CommandsTable<int> table;
+
+        table["STATUS"] = 1;
+        table["INFO"] = 2;
+        table["LOGS"] = 3;
+
+        CHECK_EQUAL(3, table.size());
+
+        CHECK(table.find("STATUS"));
+        CHECK_EQUAL(1, *table.find("STATUS"));
+        CHECK_EQUAL(2, *table.find("INFO"));
+        CHECK_EQUAL(3, *table.find("LOGS"));
+    }
+
+
+    TEST(UnknownCommands)
+    {
+        CommandsTable<int> table;
+
+        table["STATUS"] = 1;
+        table["INFO"] = 2;
+
+        CHECK(!table.find("UNKNOWN"));
+        CHECK(!table.find("status"));
+        CHECK(!table.find(""));
+    }
+
+
+    TEST(HandlersSurviveTheGrowthOfTheTable)
+    {
+        CommandsTable<int> table;
+
+        for (int i = 0; i < 100; ++i)
+            table["COMMAND_" + StringUtils::toString(i)] = i;
+
+        CHECK_EQUAL(100, table.size());
+
+        for (int i = 0; i < 100; ++i)
+        {
+            const int* pHandler = table.find("COMMAND_" + StringUtils::toString(i));
+            CHECK(pHandler);
+            if (pHandler)
+                CHECK_EQUAL(i, *pHandler);
+        }
+    }
+
+
+    TEST(ReplaceAHandler)
+    {
+        CommandsTable<int> table;
+
+        table["STATUS"] = 1;
+        table["STATUS"] = 5;
+
+        CHECK_EQUAL(1, table.size());
+        CHECK_EQUAL(5, *table.find("STATUS"));
+    }
+}
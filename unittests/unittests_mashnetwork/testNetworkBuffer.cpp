@@ -0,0 +1,176 @@
+#include <UnitTest++.h>
+#include <mash-network/network_buffer.h>
+#include <mash-network/networkutils.h>
+#include <string.h>
+#include <sstream>
+
+using namespace Mash;
+using namespace std;
+
+SUITE(NetworkBufferSuite)
+{
+    TEST(EmptyAtCreation)
+    {
+        NetworkBuffer buffer;
+
+        CHECK_EQUAL(0, buffer.size());
+    }
+
+
+    TEST(ExtractLines)
+    {
+        NetworkBuffer buffer("LINE1\nLINE2 ARG\n\nPARTIAL");
+        string strLine;
+
+        CHECK(buffer.extractLine(strLine));
+        CHECK_EQUAL("LINE1", strLine);
+
+        CHECK(buffer.extractLine(strLine));
+        CHECK_EQUAL("LINE2 ARG", strLine);
+
+        CHECK(buffer.extractLine(strLine));
+        CHECK_EQUAL("", strLine);
+
+        CHECK(!buffer.extractLine(strLine));
+        CHECK_EQUAL(7, buffer.size());
+
+        buffer.add(string(" LINE\nNEXT"));
+
+        CHECK(buffer.extractLine(strLine));
+        CHECK_EQUAL("PARTIAL LINE", strLine);
+        CHECK_EQUAL(4, buffer.size());
+    }
+
+
+    TEST(ExtractBytesAfterALine)
+    {
+        unsigned char data[] = { 'O', 'K', '\n', 0, 1, 2, '\n', 4 };
+        NetworkBuffer buffer(data, sizeof(data));
+        string strLine;
+
+        CHECK(buffer.extractLine(strLine));
+        CHECK_EQUAL("OK", strLine);
+
+        unsigned char dest[5];
+        buffer.extract(dest, 5);
+        CHECK_ARRAY_EQUAL(data + 3, dest, 5);
+        CHECK_EQUAL(0, buffer.size());
+    }
+
+
+    TEST(ReserveAndCommit)
+    {
+        NetworkBuffer buffer("FIRST\nSEC");
+        string strLine;
+
+        CHECK(buffer.extractLine(strLine));
+
+        unsigned char* pDest = buffer.reserve(100000);
+        memcpy(pDest, "OND\n", 4);
+        buffer.commit(4);
+
+        CHECK_EQUAL(7, buffer.size());
+        CHECK(memcmp("SECOND\n", buffer.data(), 7) == 0);
+
+        CHECK(buffer.extractLine(strLine));
+        CHECK_EQUAL("SECOND", strLine);
+        CHECK_EQUAL(0, buffer.size());
+    }
+
+
+    TEST(ManyLinesAddedInSmallChunks)
+    {
+        ostringstream stream;
+        for (unsigned int i = 0; i < 10000; ++i)
+            stream << "OBJECT " << i << "\n";
+
+        string strData = stream.str();
+
+        NetworkBuffer buffer;
+        string strLine;
+        unsigned int nbLines = 0;
+
+        for (unsigned int offset = 0; offset < strData.size(); offset += 37)
+        {
+            buffer.add(strData.substr(offset, 37));
+
+            while (buffer.extractLine(strLine))
+            {
+                ostringstream expected;
+                expected << "OBJECT " << nbLines;
+
+                CHECK_EQUAL(expected.str(), strLine);
+                ++nbLines;
+            }
+        }
+
+        CHECK_EQUAL(10000, nbLines);
+        CHECK_EQUAL(0, buffer.size());
+    }
+
+
+    TEST(ResetEmptiesTheBuffer)
+    {
+        NetworkBuffer buffer;
+        buffer.reserve(2 * 1024 * 1024);
+        buffer.commit(2 * 1024 * 1024);
+
+        buffer.reset();
+
+        CHECK_EQUAL(0, buffer.size());
+
+        string strLine;
+        buffer.add(string("LINE\n"));
+        CHECK(buffer.extractLine(strLine));
+        CHECK_EQUAL("LINE", strLine);
+    }
+
+
+    TEST(ProcessBufferLeavesTheRemainingData)
+    {
+        NetworkBuffer buffer("COMMAND1 ARG1 'quoted string'\nCOMMAND2");
+        string strCommand;
+        ArgumentsList arguments;
+
+        CHECK(NetworkUtils::processBuffer(&buffer, &strCommand, &arguments));
+        CHECK_EQUAL("COMMAND1", strCommand);
+        CHECK_EQUAL(2, arguments.size());
+        CHECK_EQUAL("quoted string", arguments.getString(1));
+
+        arguments.clear();
+        CHECK(!NetworkUtils::processBuffer(&buffer, &strCommand, &arguments));
+        CHECK_EQUAL(8, buffer.size());
+    }
+
+
+    TEST(ProcessBufferDecodesTheArguments)
+    {
+        NetworkBuffer buffer("COMMAND  plain  'it\\'s  quoted' escaped\\nline last\n");
+        string strCommand;
+        ArgumentsList arguments;
+
+        CHECK(NetworkUtils::processBuffer(&buffer, &strCommand, &arguments));
+        CHECK_EQUAL("COMMAND", strCommand);
+        CHECK_EQUAL(4, arguments.size());
+        CHECK_EQUAL("plain", arguments.getString(0));
+        CHECK_EQUAL("it's quoted", arguments.getString(1));
+        CHECK_EQUAL("escaped\nline", arguments.getString(2));
+        CHECK_EQUAL("last", arguments.getString(3));
+        CHECK_EQUAL(0, buffer.size());
+    }
+
+
+    TEST(ProcessBufferSkipsTheBlankLines)
+    {
+        NetworkBuffer buffer("\n   \nCOMMAND 12 -3.5\n");
+        string strCommand;
+        ArgumentsList arguments;
+
+        CHECK(NetworkUtils::processBuffer(&buffer, &strCommand, &arguments));
+        CHECK_EQUAL("COMMAND", strCommand);
+        CHECK_EQUAL(2, arguments.size());
+        CHECK_EQUAL(12, arguments.getInt(0));
+        CHECK_CLOSE(-3.5f, arguments.getFloat(1), 1e-6f);
+        CHECK_EQUAL(0, buffer.size());
+    }
+}
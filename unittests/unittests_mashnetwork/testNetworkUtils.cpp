@@ -0,0 +1,95 @@
+#include <UnitTest++.h>
+#include <mash-network/networkutils.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <stdio.h>
+
+using namespace Mash;
+using namespace std;
+
+SUITE(NetworkUtilsSuite)
+{
+    struct SocketsFixture
+    {
+        SocketsFixture()
+        {
+            socketpair(AF_UNIX, SOCK_STREAM, 0, sockets);
+        }
+
+        ~SocketsFixture()
+        {
+            close(sockets[0]);
+            close(sockets[1]);
+        }
+
+        int sockets[2];
+    };
+
+
+    TEST_FIXTURE(SocketsFixture, EscapedMessage)
+    {
+        ArgumentsList arguments;
+        arguments.add("Escaped 'string'\non several lines");
+        arguments.add(42);
+
+        CHECK(NetworkUtils::sendMessage(sockets[0], "COMMAND", arguments));
+
+        NetworkBuffer buffer;
+        string strMessage;
+        ArgumentsList received;
+
+        CHECK(NetworkUtils::waitMessage(sockets[1], &buffer, &strMessage, &received));
+        CHECK_EQUAL("COMMAND", strMessage);
+        CHECK_EQUAL(2, received.size());
+        CHECK_EQUAL(arguments.getString(0), received.getString(0));
+        CHECK_EQUAL(42, received.getInt(1));
+        CHECK_EQUAL(0, buffer.size());
+    }
+
+
+    TEST_FIXTURE(SocketsFixture, MessageWithData)
+    {
+        const unsigned char DATA[] = "SOME\nBINARY\0DATA";
+
+        CHECK(NetworkUtils::sendMessage(sockets[0], "DATA", ArgumentsList((int) sizeof(DATA)),
+                                        DATA, sizeof(DATA)));
+
+        NetworkBuffer buffer;
+        string strMessage;
+        ArgumentsList arguments;
+        unsigned char received[sizeof(DATA)];
+
+        CHECK(NetworkUtils::waitMessage(sockets[1], &buffer, &strMessage, &arguments));
+        CHECK_EQUAL("DATA", strMessage);
+        CHECK_EQUAL((int) sizeof(DATA), arguments.getInt(0));
+
+        CHECK(NetworkUtils::waitData(sockets[1], &buffer, received, sizeof(DATA)));
+        CHECK_ARRAY_EQUAL(DATA, received, sizeof(DATA));
+        CHECK_EQUAL(0, buffer.size());
+    }
+
+
+    TEST_FIXTURE(SocketsFixture, FileAfterHeader)
+    {
+        FILE* pFile = fopen("tmp_sendfile.txt", "wb");
+        fputs("0123456789", pFile);
+        fclose(pFile);
+
+        int fd = open("tmp_sendfile.txt", O_RDONLY);
+        CHECK(fd >= 0);
+
+        CHECK(NetworkUtils::sendFile(sockets[0], "HEADER ", fd, 3, 5));
+
+        // The file is shorter than requested
+        CHECK(!NetworkUtils::sendFile(sockets[0], "", fd, 8, 5));
+
+        close(fd);
+        remove("tmp_sendfile.txt");
+
+        char received[15];
+        CHECK_EQUAL(14, (int) recv(sockets[1], received, sizeof(received), 0));
+        CHECK_ARRAY_EQUAL("HEADER 3456789", received, 14);
+    }
+}
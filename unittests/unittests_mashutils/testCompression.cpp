@@ -0,0 +1,133 @@
+#include <UnitTest++.h>
+#include <mash-utils/compression.h>
+#include <mash-utils/random_number_generator.h>
+#include <vector>
+#include <string.h>
+
+using namespace Mash;
+using namespace std;
+
+
+static bool roundTrip(const vector<unsigned char>& data, unsigned int* compressedSize)
+{
+    vector<unsigned char> compressed(Compression::compressBound(data.size()));
+    vector<unsigned char> decompressed(data.size() + 1);
+
+    *compressedSize = Compression::compress((data.empty() ? 0 : &data[0]), data.size(),
+                                            &compressed[0], compressed.size());
+    if (*compressedSize == 0)
+        return false;
+
+    if (!Compression::decompress(&compressed[0], *compressedSize, &decompressed[0], data.size()))
+        return false;
+
+    return data.empty() || (memcmp(&data[0], &decompressed[0], data.size()) == 0);
+}
+
+
+SUITE(CompressionSuite)
+{
+    TEST(EmptyBuffer)
+    {
+        vector<unsigned char> data;
+        unsigned int size = 0;
+
+        CHECK(roundTrip(data, &size));
+        CHECK_EQUAL(1, size);
+    }
+
+    TEST(SmallBuffer)
+    {
+        const char* text = "MASH";
+        vector<unsigned char> data(text, text + 4);
+        unsigned int size = 0;
+
+        CHECK(roundTrip(data, &size));
+    }
+
+    TEST(RepetitiveBufferIsCompressed)
+    {
+        vector<unsigned char> data(100000);
+        for (unsigned int i = 0; i < data.size(); ++i)
+            data[i] = (unsigned char) (i % 7);
+
+        unsigned int size = 0;
+
+        CHECK(roundTrip(data, &size));
+        CHECK(size < data.size() / 50);
+    }
+
+    TEST(UniformBufferIsCompressed)
+    {
+        vector<unsigned char> data(320 * 320 * 3, 0);
+        unsigned int size = 0;
+
+        CHECK(roundTrip(data, &size));
+        CHECK(size < 2000);
+    }
+
+    TEST(RandomBuffer)
+    {
+        RandomNumberGenerator generator;
+        generator.setSeed(1234);
+
+        vector<unsigned char> data(70000);
+        for (unsigned int i = 0; i < data.size(); ++i)
+            data[i] = (unsigned char) generator.randomize((unsigned int) 255);
+
+        unsigned int size = 0;
+
+        CHECK(roundTrip(data, &size));
+        CHECK(size <= Compression::compressBound(data.size()));
+    }
+
+    TEST(TooSmallDestinationBuffer)
+    {
+        RandomNumberGenerator generator;
+        generator.setSeed(1234);
+
+        vector<unsigned char> data(1000);
+        for (unsigned int i = 0; i < data.size(); ++i)
+            data[i] = (unsigned char) generator.randomize((unsigned int) 255);
+
+        vector<unsigned char> compressed(500);
+
+        CHECK_EQUAL(0, Compression::compress(&data[0], data.size(), &compressed[0], compressed.size()));
+    }
+
+    TEST(InvalidCompressedData)
+    {
+        vector<unsigned char> data(1000, 42);
+        vector<unsigned char> compressed(Compression::compressBound(data.size()));
+        vector<unsigned char> decompressed(data.size());
+
+        unsigned int size = Compression::compress(&data[0], data.size(), &compressed[0], compressed.size());
+        CHECK(size > 0);
+
+        // Wrong expected size
+        CHECK(!Compression::decompress(&compressed[0], size, &decompressed[0], data.size() - 1));
+
+        // Truncated data
+        CHECK(!Compression::decompress(&compressed[0], size - 1, &decompressed[0], data.size()));
+
+        // Offset pointing before the beginning of the buffer
+        unsigned char invalid[] = { 0x10, 'A', 0xFF, 0xFF, 0x00 };
+        CHECK(!Compression::decompress(invalid, sizeof(invalid), &decompressed[0], 10));
+    }
+
+    TEST(XorBuffers)
+    {
+        unsigned char a[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+        unsigned char b[] = { 1, 2, 3, 4, 0, 6, 7, 8, 0 };
+        unsigned char c[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+
+        Compression::xorBuffers(a, b, sizeof(a));
+
+        for (unsigned int i = 0; i < sizeof(a); ++i)
+            CHECK_EQUAL((b[i] == c[i] ? 0 : c[i]), a[i]);
+
+        Compression::xorBuffers(a, b, sizeof(a));
+
+        CHECK(memcmp(a, c, sizeof(a)) == 0);
+    }
+}